@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// An I/O ring is shared between a process and the kernel: The process puts submissions into the submission queue
+// and tells the kernel about them with io_ring_enter(), the kernel puts the results into the completion queue.
+// Both queues are single-producer, single-consumer rings whose head and tail only ever increase (and wrap around).
+//
+// The ring memory is mapped with mmap() on the fd returned by io_ring_create(), its layout is described by IORingLayout.
+
+enum class IORingOpcode : u8 {
+    Nop = 0,
+    Read = 1,
+    Write = 2,
+    Fsync = 3,
+    Accept = 4,
+    Connect = 5,
+};
+
+// Read and Write use the current file offset (and advance it) when given this offset.
+constexpr u64 IO_RING_CURRENT_OFFSET = ~0ull;
+
+struct IORingSubmission {
+    IORingOpcode opcode;
+    u8 reserved1;
+    u16 reserved2;
+    i32 fd;
+    // Read/Write: The file offset, or IO_RING_CURRENT_OFFSET.
+    u64 offset;
+    // Read/Write: The buffer. Accept: An optional sockaddr for the peer address. Connect: The sockaddr to connect to.
+    u64 address;
+    // Read/Write: The buffer size. Connect: The size of the sockaddr.
+    u32 length;
+    // Accept: SOCK_NONBLOCK and SOCK_CLOEXEC.
+    u32 flags;
+    // Accept: The socklen_t for the size of the peer address, if one is requested.
+    u64 address_length;
+    // Passed back as is in the completion.
+    u64 user_data;
+};
+static_assert(sizeof(IORingSubmission) == 48);
+
+struct IORingCompletion {
+    u64 user_data;
+    // What the equivalent syscall would have returned, or a negative errno.
+    i64 result;
+};
+static_assert(sizeof(IORingCompletion) == 16);
+
+struct IORingHeader {
+    // Written by the kernel.
+    u32 submission_head;
+    // Written by the process.
+    u32 submission_tail;
+    // Written by the process.
+    u32 completion_head;
+    // Written by the kernel.
+    u32 completion_tail;
+    u32 submission_entries;
+    u32 completion_entries;
+};
+
+constexpr u32 IO_RING_MAX_ENTRIES = 4096;
+
+struct IORingLayout {
+    // There are twice as many completion as submission entries, so that a full queue of submissions can be submitted
+    // while the completions of the previous one haven't been collected yet.
+    static constexpr u32 completion_entries_for(u32 submission_entries) { return submission_entries * 2; }
+
+    static constexpr size_t submissions_offset() { return sizeof(IORingHeader); }
+    static constexpr size_t completions_offset(u32 submission_entries) { return submissions_offset() + submission_entries * sizeof(IORingSubmission); }
+    static constexpr size_t size(u32 submission_entries) { return completions_offset(submission_entries) + completion_entries_for(submission_entries) * sizeof(IORingCompletion); }
+};
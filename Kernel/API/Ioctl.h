@@ -121,6 +121,7 @@ enum IOCtlNumber {
     SIOCSIFNETMASK,
     SIOCGIFBRDADDR,
     SIOCGIFMTU,
+    SIOCSIFMTU,
     SIOCGIFFLAGS,
     SIOCGIFCONF,
     SIOCADDRT,
@@ -186,6 +187,7 @@ enum IOCtlNumber {
 #define SIOCSIFNETMASK SIOCSIFNETMASK
 #define SIOCGIFBRDADDR SIOCGIFBRDADDR
 #define SIOCGIFMTU SIOCGIFMTU
+#define SIOCSIFMTU SIOCSIFMTU
 #define SIOCGIFFLAGS SIOCGIFFLAGS
 #define SIOCGIFCONF SIOCGIFCONF
 #define SIOCADDRT SIOCADDRT
@@ -17,6 +17,7 @@
 #endif
 
 extern "C" {
+struct epoll_event;
 struct pollfd;
 struct timeval;
 struct timespec;
@@ -69,6 +70,9 @@ enum class NeedsBigProcessLock {
     S(disown, NeedsBigProcessLock::No)                     \
     S(dump_backtrace, NeedsBigProcessLock::No)             \
     S(dup2, NeedsBigProcessLock::No)                       \
+    S(epoll_create1, NeedsBigProcessLock::No)              \
+    S(epoll_ctl, NeedsBigProcessLock::No)                  \
+    S(epoll_pwait, NeedsBigProcessLock::No)                \
     S(execve, NeedsBigProcessLock::Yes)                    \
     S(exit, NeedsBigProcessLock::Yes)                      \
     S(exit_thread, NeedsBigProcessLock::Yes)               \
@@ -112,6 +116,8 @@ enum class NeedsBigProcessLock {
     S(getuid, NeedsBigProcessLock::No)                     \
     S(inode_watcher_add_watch, NeedsBigProcessLock::No)    \
     S(inode_watcher_remove_watch, NeedsBigProcessLock::No) \
+    S(io_ring_create, NeedsBigProcessLock::No)             \
+    S(io_ring_enter, NeedsBigProcessLock::No)              \
     S(ioctl, NeedsBigProcessLock::No)                      \
     S(join_thread, NeedsBigProcessLock::No)                \
     S(kill, NeedsBigProcessLock::No)                       \
@@ -156,6 +162,7 @@ enum class NeedsBigProcessLock {
     S(scheduler_get_parameters, NeedsBigProcessLock::No)   \
     S(scheduler_set_parameters, NeedsBigProcessLock::No)   \
     S(sendfd, NeedsBigProcessLock::No)                     \
+    S(sendfile, NeedsBigProcessLock::No)                   \
     S(sendmsg, NeedsBigProcessLock::Yes)                   \
     S(set_mmap_name, NeedsBigProcessLock::No)              \
     S(setegid, NeedsBigProcessLock::No)                    \
@@ -182,6 +189,7 @@ enum class NeedsBigProcessLock {
     S(sigtimedwait, NeedsBigProcessLock::No)               \
     S(socket, NeedsBigProcessLock::No)                     \
     S(socketpair, NeedsBigProcessLock::No)                 \
+    S(splice, NeedsBigProcessLock::No)                     \
     S(stat, NeedsBigProcessLock::No)                       \
     S(statvfs, NeedsBigProcessLock::No)                    \
     S(symlink, NeedsBigProcessLock::No)                    \
@@ -266,6 +274,14 @@ struct SC_poll_params {
     u32 const* sigmask;
 };
 
+struct SC_epoll_pwait_params {
+    int epfd;
+    struct epoll_event* events;
+    int maxevents;
+    const struct timespec* timeout;
+    u32 const* sigmask;
+};
+
 struct SC_clock_nanosleep_params {
     int clock_id;
     int flags;
@@ -320,6 +336,15 @@ struct SC_socketpair_params {
     int* sv;
 };
 
+struct SC_splice_params {
+    int fd_in;
+    off_t* off_in;
+    int fd_out;
+    off_t* off_out;
+    size_t length;
+    unsigned flags;
+};
+
 struct SC_futex_params {
     u32* userspace_address;
     int futex_op;
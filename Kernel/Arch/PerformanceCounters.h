@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <Kernel/API/POSIX/serenity.h>
+
+namespace Kernel {
+
+enum class PerformanceCounter : u8 {
+    Cycles,
+    Instructions,
+    CacheMisses,
+    BranchMisses,
+    __Count,
+};
+
+static constexpr size_t performance_counter_count = to_underlying(PerformanceCounter::__Count);
+using PerformanceCounterValues = Array<u64, performance_counter_count>;
+
+constexpr StringView performance_counter_name(PerformanceCounter counter)
+{
+    switch (counter) {
+    case PerformanceCounter::Cycles:
+        return "cycles"sv;
+    case PerformanceCounter::Instructions:
+        return "instructions"sv;
+    case PerformanceCounter::CacheMisses:
+        return "cache_misses"sv;
+    case PerformanceCounter::BranchMisses:
+        return "branch_misses"sv;
+    case PerformanceCounter::__Count:
+        break;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// The PERF_EVENT_* type that records a sample whenever the given counter has counted another sample period.
+constexpr int performance_counter_event_type(PerformanceCounter counter)
+{
+    switch (counter) {
+    case PerformanceCounter::Cycles:
+        return PERF_EVENT_CYCLES;
+    case PerformanceCounter::Instructions:
+        return PERF_EVENT_INSTRUCTIONS;
+    case PerformanceCounter::CacheMisses:
+        return PERF_EVENT_CACHE_MISSES;
+    case PerformanceCounter::BranchMisses:
+        return PERF_EVENT_BRANCH_MISSES;
+    case PerformanceCounter::__Count:
+        break;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+constexpr PerformanceCounter performance_counter_for_event_type(int type)
+{
+    switch (type) {
+    case PERF_EVENT_CYCLES:
+        return PerformanceCounter::Cycles;
+    case PERF_EVENT_INSTRUCTIONS:
+        return PerformanceCounter::Instructions;
+    case PERF_EVENT_CACHE_MISSES:
+        return PerformanceCounter::CacheMisses;
+    case PERF_EVENT_BRANCH_MISSES:
+        return PerformanceCounter::BranchMisses;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// Misses are a lot rarer than cycles or instructions, so they are sampled more often to get comparable detail.
+constexpr u64 performance_counter_sample_period(PerformanceCounter counter)
+{
+    switch (counter) {
+    case PerformanceCounter::Cycles:
+    case PerformanceCounter::Instructions:
+        return 1'000'000;
+    case PerformanceCounter::CacheMisses:
+    case PerformanceCounter::BranchMisses:
+        return 10'000;
+    case PerformanceCounter::__Count:
+        break;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static constexpr u64 performance_counter_event_mask = PERF_EVENT_CYCLES | PERF_EVENT_INSTRUCTIONS | PERF_EVENT_CACHE_MISSES | PERF_EVENT_BRANCH_MISSES;
+
+bool performance_counters_are_supported();
+
+// Counting is reference counted like the profile timer. Each processor picks up a change the next time it
+// switches threads, at which point it also decides which counters should interrupt it, based on
+// g_profiling_event_mask.
+bool enable_performance_counters();
+void disable_performance_counters();
+
+// Returns how much each counter advanced on this processor since the last call, or nothing if counting is
+// disabled. Must be called with interrupts disabled.
+Optional<PerformanceCounterValues> update_performance_counters_on_current_processor();
+
+}
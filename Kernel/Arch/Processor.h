@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Function.h>
 #include <AK/SetOnce.h>
 #include <Kernel/Arch/CPUID.h>
@@ -28,6 +29,7 @@ class PageDirectory;
 
 struct TrapFrame;
 class Thread;
+class TicketLock;
 
 class Processor;
 
@@ -59,6 +61,8 @@ public:
     static bool is_smp_enabled();
     static void smp_enable();
     static u32 smp_wake_n_idle_processors(u32 wake_count);
+    // Returns whether the processor was idle, and is now being woken up.
+    static bool smp_wake_idle_processor(u32 cpu);
 
     static void flush_tlb_local(VirtualAddress vaddr, size_t page_count);
     static void flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
@@ -119,6 +123,13 @@ public:
     ALWAYS_INLINE static void set_current_thread(Thread& current_thread);
     ALWAYS_INLINE static Thread* idle_thread();
 
+    // NOTE: This may be called for other processors, so the returned thread
+    // must only be compared against, not dereferenced.
+    ALWAYS_INLINE Thread* running_thread() const
+    {
+        return AK::atomic_load(&m_current_thread, AK::memory_order_relaxed);
+    }
+
     ALWAYS_INLINE static u32 in_critical();
     ALWAYS_INLINE static void enter_critical();
     static void leave_critical();
@@ -183,6 +194,8 @@ protected:
     u8 m_virtual_address_bit_width;
 
 private:
+    friend class TicketLock;
+
     void* m_processor_specific_data[static_cast<size_t>(ProcessorSpecificDataID::__Count)];
     Thread* m_idle_thread;
     Thread* m_current_thread;
@@ -200,6 +213,10 @@ private:
 
     SetOnce m_scheduler_initialized;
 
+    // The ticket lock this processor is spinning for, and its place in line. See TicketLock::lock_contended().
+    TicketLock* m_waiting_for_ticket_lock { nullptr };
+    u16 m_waiting_ticket { 0 };
+
     DeferredCallPool m_deferred_call_pool {};
 };
 
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Arch/PerformanceCounters.h>
+
+namespace Kernel {
+
+// FIXME: Implement these using the PMUv3.
+
+bool performance_counters_are_supported()
+{
+    return false;
+}
+
+bool enable_performance_counters()
+{
+    return false;
+}
+
+void disable_performance_counters()
+{
+}
+
+Optional<PerformanceCounterValues> update_performance_counters_on_current_processor()
+{
+    return {};
+}
+
+}
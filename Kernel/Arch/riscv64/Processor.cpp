@@ -288,6 +288,12 @@ u32 ProcessorBase::smp_wake_n_idle_processors(u32)
     return 0;
 }
 
+bool ProcessorBase::smp_wake_idle_processor(u32)
+{
+    // FIXME: Actually wake up other cores when SMP is supported for riscv64.
+    return false;
+}
+
 void ProcessorBase::initialize_context_switching(Thread& initial_thread)
 {
     VERIFY(initial_thread.process().is_kernel_process());
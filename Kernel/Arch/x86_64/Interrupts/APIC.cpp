@@ -11,6 +11,7 @@
 #include <Kernel/Arch/PageDirectory.h>
 #include <Kernel/Arch/x86_64/Interrupts/APIC.h>
 #include <Kernel/Arch/x86_64/MSR.h>
+#include <Kernel/Arch/x86_64/PerformanceCounters.h>
 #include <Kernel/Arch/x86_64/ProcessorInfo.h>
 #include <Kernel/Arch/x86_64/Time/APICTimer.h>
 #include <Kernel/Debug.h>
@@ -24,6 +25,7 @@
 #include <Kernel/Tasks/Scheduler.h>
 #include <Kernel/Tasks/Thread.h>
 
+#define IRQ_APIC_PERFORMANCE_COUNTER (0xfb - IRQ_VECTOR_BASE)
 #define IRQ_APIC_TIMER (0xfc - IRQ_VECTOR_BASE)
 #define IRQ_APIC_IPI (0xfd - IRQ_VECTOR_BASE)
 #define IRQ_APIC_ERR (0xfe - IRQ_VECTOR_BASE)
@@ -88,6 +90,31 @@ public:
 private:
 };
 
+class APICPerformanceCounterInterruptHandler final : public GenericInterruptHandler {
+public:
+    explicit APICPerformanceCounterInterruptHandler(InterruptNumber interrupt_vector)
+        : GenericInterruptHandler(interrupt_vector, true)
+    {
+    }
+
+    static void initialize(InterruptNumber interrupt_number)
+    {
+        auto* handler = new APICPerformanceCounterInterruptHandler(interrupt_number);
+        handler->register_interrupt_handler();
+    }
+
+    virtual bool handle_interrupt() override;
+
+    virtual bool eoi() override;
+
+    virtual HandlerType type() const override { return HandlerType::IRQHandler; }
+    virtual StringView purpose() const override { return "APIC Performance Counter Handler"sv; }
+    virtual StringView controller() const override { return {}; }
+
+    virtual size_t sharing_devices_count() const override { return 0; }
+    virtual bool is_shared_handler() const override { return false; }
+};
+
 class APICErrInterruptHandler final : public GenericInterruptHandler {
 public:
     explicit APICErrInterruptHandler(InterruptNumber interrupt_vector)
@@ -515,6 +542,8 @@ UNMAP_AFTER_INIT void APIC::enable(u32 cpu)
 
         // register IPI interrupt vector
         APICIPIInterruptHandler::initialize(IRQ_APIC_IPI);
+
+        APICPerformanceCounterInterruptHandler::initialize(IRQ_APIC_PERFORMANCE_COUNTER);
     }
 
     if (!m_is_x2.was_set()) {
@@ -579,6 +608,11 @@ void APIC::broadcast_ipi()
     write_icr({ IRQ_APIC_IPI + IRQ_VECTOR_BASE, 0xffffffff, ICRReg::Fixed, ICRReg::Logical, ICRReg::Assert, ICRReg::TriggerMode::Edge, ICRReg::AllExcludingSelf });
 }
 
+void APIC::enable_performance_counter_interrupt()
+{
+    write_register(APIC_REG_LVT_PERFORMANCE_COUNTER, APIC_LVT(IRQ_APIC_PERFORMANCE_COUNTER + IRQ_VECTOR_BASE, 0));
+}
+
 void APIC::send_ipi(u32 cpu)
 {
     dbgln_if(APIC_SMP_DEBUG, "SMP: Send IPI from CPU #{} to CPU #{}", Processor::current_id(), cpu);
@@ -680,6 +714,18 @@ bool APICIPIInterruptHandler::eoi()
     return true;
 }
 
+bool APICPerformanceCounterInterruptHandler::handle_interrupt()
+{
+    handle_performance_counter_interrupt();
+    return true;
+}
+
+bool APICPerformanceCounterInterruptHandler::eoi()
+{
+    APIC::the().eoi();
+    return true;
+}
+
 bool APICErrInterruptHandler::handle_interrupt()
 {
     dbgln("APIC: SMP error on CPU #{}", Processor::current_id());
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/NumericLimits.h>
+#include <Kernel/Arch/PerformanceCounters.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Arch/x86_64/CPUID.h>
+#include <Kernel/Arch/x86_64/Interrupts/APIC.h>
+#include <Kernel/Arch/x86_64/MSR.h>
+#include <Kernel/Arch/x86_64/PerformanceCounters.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/PerformanceManager.h>
+
+// This uses Intel's architectural performance monitoring (version 2 or later), see the Intel SDM, Volume 3B,
+// "Performance Monitoring". Every PerformanceCounter is assigned the general-purpose counter with the same index.
+#define MSR_IA32_PMC0 0xc1
+#define MSR_IA32_PERFEVTSEL0 0x186
+#define MSR_IA32_PERF_GLOBAL_STATUS 0x38e
+#define MSR_IA32_PERF_GLOBAL_CTRL 0x38f
+#define MSR_IA32_PERF_GLOBAL_OVF_CTRL 0x390
+
+#define PERFEVTSEL_USR (1 << 16)
+#define PERFEVTSEL_OS (1 << 17)
+#define PERFEVTSEL_INT (1 << 20)
+#define PERFEVTSEL_EN (1 << 22)
+
+namespace Kernel {
+
+struct ArchitecturalEvent {
+    u8 event_select;
+    u8 unit_mask;
+    // The bit in CPUID.0AH:EBX that is set if the processor does *not* support this event.
+    u8 unavailable_bit;
+};
+
+static constexpr Array<ArchitecturalEvent, performance_counter_count> s_architectural_events { {
+    { 0x3c, 0x00, 0 }, // UnHalted Core Cycles
+    { 0xc0, 0x00, 1 }, // Instructions Retired
+    { 0x2e, 0x41, 4 }, // LLC Misses
+    { 0xc5, 0x00, 6 }, // Branch Mispredicts Retired
+} };
+
+struct ProcessorCounterState {
+    u32 generation { 0 };
+    bool is_counting { false };
+    u32 sampled_counters { 0 };
+    PerformanceCounterValues last_values {};
+    PerformanceCounterValues pending_values {};
+};
+
+// These are filled in by detect_performance_counters() while the boot processor is initialized, and never change after.
+static u32 s_usable_counters { 0 };
+static u64 s_counter_value_mask { 0 };
+
+static Atomic<u32> s_enable_count { 0 };
+static Atomic<u32> s_generation { 0 };
+static Array<ProcessorCounterState, MAX_CPU_COUNT> s_processor_states;
+
+UNMAP_AFTER_INIT void detect_performance_counters()
+{
+    if (CPUID(0).eax() < 0xa)
+        return;
+    CPUID leaf(0xa);
+    auto version = leaf.eax() & 0xff;
+    auto general_purpose_counter_count = (leaf.eax() >> 8) & 0xff;
+    auto counter_width = (leaf.eax() >> 16) & 0xff;
+    auto event_availability_length = (leaf.eax() >> 24) & 0xff;
+    if (version < 2 || counter_width < 32 || counter_width > 64)
+        return;
+
+    u32 usable_counters = 0;
+    for (size_t i = 0; i < performance_counter_count; ++i) {
+        auto const& event = s_architectural_events[i];
+        if (i >= general_purpose_counter_count || event.unavailable_bit >= event_availability_length)
+            continue;
+        if (leaf.ebx() & (1u << event.unavailable_bit))
+            continue;
+        usable_counters |= 1u << i;
+    }
+    s_counter_value_mask = counter_width == 64 ? NumericLimits<u64>::max() : (1ull << counter_width) - 1;
+    s_usable_counters = usable_counters;
+}
+
+bool performance_counters_are_supported()
+{
+    return s_usable_counters != 0;
+}
+
+bool enable_performance_counters()
+{
+    if (!performance_counters_are_supported())
+        return false;
+    s_enable_count.fetch_add(1);
+    // Processors reprogram themselves even if counting was enabled already, as the set of sampled counters might
+    // have changed with g_profiling_event_mask.
+    s_generation.fetch_add(1);
+    return true;
+}
+
+void disable_performance_counters()
+{
+    if (!performance_counters_are_supported())
+        return;
+    if (s_enable_count.fetch_sub(1) == 1)
+        s_generation.fetch_add(1);
+}
+
+template<typename Callback>
+static void for_each_usable_counter(Callback callback)
+{
+    for (size_t i = 0; i < performance_counter_count; ++i) {
+        if (s_usable_counters & (1u << i))
+            callback(i);
+    }
+}
+
+static u64 read_counter(size_t index)
+{
+    u32 low, high;
+    asm volatile("rdpmc"
+                 : "=a"(low), "=d"(high)
+                 : "c"(index));
+    return ((u64)high << 32) | low;
+}
+
+// Only the low 32 bits of a counter can be written through its legacy MSR, and they get sign-extended to the full
+// counter width. Sample periods are small enough that this is enough to make a counter overflow after that period.
+static u64 write_counter(size_t index, u64 value)
+{
+    MSR(MSR_IA32_PMC0 + index).set(value & 0xffffffff);
+    return static_cast<u64>(static_cast<i64>(static_cast<i32>(value))) & s_counter_value_mask;
+}
+
+static void accumulate_counter(ProcessorCounterState& state, size_t index)
+{
+    auto value = read_counter(index);
+    state.pending_values[index] += (value - state.last_values[index]) & s_counter_value_mask;
+    state.last_values[index] = value;
+}
+
+static u64 initial_counter_value(ProcessorCounterState const& state, size_t index)
+{
+    if (state.sampled_counters & (1u << index))
+        return -performance_counter_sample_period(static_cast<PerformanceCounter>(index));
+    return 0;
+}
+
+static void program_counters(ProcessorCounterState& state, bool should_count)
+{
+    MSR(MSR_IA32_PERF_GLOBAL_CTRL).set(0);
+    for_each_usable_counter([](size_t index) {
+        MSR(MSR_IA32_PERFEVTSEL0 + index).set(0);
+    });
+    MSR(MSR_IA32_PERF_GLOBAL_OVF_CTRL).set(s_usable_counters);
+
+    state.is_counting = should_count;
+    state.sampled_counters = 0;
+    if (!should_count)
+        return;
+
+    for_each_usable_counter([&](size_t index) {
+        auto counter = static_cast<PerformanceCounter>(index);
+        if (g_profiling_event_mask & performance_counter_event_type(counter))
+            state.sampled_counters |= 1u << index;
+
+        state.last_values[index] = write_counter(index, initial_counter_value(state, index));
+        auto const& event = s_architectural_events[index];
+        u64 event_select = event.event_select | (event.unit_mask << 8) | PERFEVTSEL_USR | PERFEVTSEL_OS | PERFEVTSEL_EN;
+        if (state.sampled_counters & (1u << index))
+            event_select |= PERFEVTSEL_INT;
+        MSR(MSR_IA32_PERFEVTSEL0 + index).set(event_select);
+    });
+
+    if (state.sampled_counters != 0)
+        APIC::the().enable_performance_counter_interrupt();
+    MSR(MSR_IA32_PERF_GLOBAL_CTRL).set(s_usable_counters);
+}
+
+static PerformanceCounterValues take_pending_values(ProcessorCounterState& state)
+{
+    for_each_usable_counter([&](size_t index) {
+        accumulate_counter(state, index);
+    });
+    auto values = state.pending_values;
+    state.pending_values = {};
+    return values;
+}
+
+Optional<PerformanceCounterValues> update_performance_counters_on_current_processor()
+{
+    VERIFY(!Processor::are_interrupts_enabled());
+    auto& state = s_processor_states[Processor::current_id()];
+
+    Optional<PerformanceCounterValues> values;
+    if (state.is_counting)
+        values = take_pending_values(state);
+
+    if (auto generation = s_generation.load(AK::MemoryOrder::memory_order_relaxed); generation != state.generation) {
+        state.generation = generation;
+        program_counters(state, s_enable_count.load(AK::MemoryOrder::memory_order_relaxed) > 0);
+    }
+    return values;
+}
+
+void handle_performance_counter_interrupt()
+{
+    auto& state = s_processor_states[Processor::current_id()];
+    auto overflowed_counters = MSR(MSR_IA32_PERF_GLOBAL_STATUS).get() & state.sampled_counters;
+    auto* current_thread = Thread::current();
+
+    for_each_usable_counter([&](size_t index) {
+        if (!(overflowed_counters & (1u << index)))
+            return;
+        accumulate_counter(state, index);
+        state.last_values[index] = write_counter(index, initial_counter_value(state, index));
+
+        // FIXME: Like the profile timer, we don't collect samples while idle.
+        if (current_thread && current_thread != Processor::idle_thread())
+            PerformanceManager::add_performance_counter_sample_event(*current_thread, *current_thread->current_trap()->regs, static_cast<PerformanceCounter>(index));
+    });
+
+    MSR(MSR_IA32_PERF_GLOBAL_OVF_CTRL).set(overflowed_counters);
+    // Delivering the interrupt masked it in the local APIC.
+    if (state.sampled_counters != 0)
+        APIC::the().enable_performance_counter_interrupt();
+}
+
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Platform.h>
+VALIDATE_IS_X86()
+
+namespace Kernel {
+
+// Called once while the boot processor is initialized, before any other processor is started.
+void detect_performance_counters();
+
+// Called from the local APIC's performance counter interrupt, whenever a sampled counter overflowed.
+void handle_performance_counter_interrupt();
+
+}
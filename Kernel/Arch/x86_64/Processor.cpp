@@ -29,6 +29,7 @@
 #include <Kernel/Arch/TrapFrame.h>
 #include <Kernel/Arch/x86_64/CPUID.h>
 #include <Kernel/Arch/x86_64/MSR.h>
+#include <Kernel/Arch/x86_64/PerformanceCounters.h>
 #include <Kernel/Arch/x86_64/ProcessorInfo.h>
 #include <Kernel/Library/ScopedCritical.h>
 
@@ -628,6 +629,7 @@ UNMAP_AFTER_INIT void ProcessorBase::early_initialize(u32 cpu)
     m_cpu = cpu;
     m_in_irq = 0;
     m_in_critical = 0;
+    m_waiting_for_ticket_lock = nullptr;
 
     m_invoke_scheduler_async = false;
     m_in_scheduler = true;
@@ -686,6 +688,8 @@ UNMAP_AFTER_INIT void ProcessorBase::initialize(u32 cpu)
 
         if (has_feature(CPUFeature::HYPERVISOR))
             self->detect_hypervisor();
+
+        detect_performance_counters();
     }
 
     {
@@ -927,6 +931,20 @@ u32 ProcessorBase::smp_wake_n_idle_processors(u32 wake_count)
     return did_wake_count;
 }
 
+bool ProcessorBase::smp_wake_idle_processor(u32 cpu)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    if (!s_smp_enabled || cpu == Processor::current_id())
+        return false;
+
+    // Flip it to busy first, so it's only sent one IPI even if others try to wake it as well.
+    auto was_idle = Processor::s_idle_cpu_mask.fetch_and(~(1u << cpu), AK::MemoryOrder::memory_order_acq_rel) & (1u << cpu);
+    if (!was_idle)
+        return false;
+    APIC::the().send_ipi(cpu);
+    return true;
+}
+
 UNMAP_AFTER_INIT void ProcessorBase::smp_enable()
 {
     size_t msg_pool_size = Processor::count() * 100u;
@@ -61,6 +61,17 @@ auto AsyncDeviceRequest::wait(Duration* timeout) -> RequestWaitResult
     return { get_request_result(), wait_result };
 }
 
+auto AsyncDeviceRequest::wait_until_completed() -> RequestResult
+{
+    VERIFY(!m_parent_request);
+    for (;;) {
+        auto request_result = get_request_result();
+        if (is_completed_result(request_result))
+            return request_result;
+        m_queue.wait_forever_uninterruptibly(name());
+    }
+}
+
 auto AsyncDeviceRequest::get_request_result() const -> RequestResult
 {
     SpinlockLocker lock(m_lock);
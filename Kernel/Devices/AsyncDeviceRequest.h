@@ -61,6 +61,8 @@ public:
     void add_sub_request(NonnullLockRefPtr<AsyncDeviceRequest>);
 
     [[nodiscard]] RequestWaitResult wait(Duration* = nullptr);
+    // Unlike wait(), this can't be interrupted by signals, so it is safe to release the request's buffer afterwards.
+    RequestResult wait_until_completed();
 
     void do_start(SpinlockLocker<Spinlock<LockRank::None>>&& requests_lock)
     {
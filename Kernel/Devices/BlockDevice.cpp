@@ -5,6 +5,7 @@
  */
 
 #include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/Devices/BlockMultiQueue.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/DeviceIdentifiers/BlockDevicesDirectory.h>
 
 namespace Kernel {
@@ -37,6 +38,12 @@ BlockDevice::BlockDevice(MajorAllocation::BlockDeviceFamily block_device_family,
 
 BlockDevice::~BlockDevice() = default;
 
+void BlockDevice::set_multi_queue(NonnullRefPtr<BlockMultiQueue> multi_queue)
+{
+    VERIFY(!m_multi_queue);
+    m_multi_queue = move(multi_queue);
+}
+
 void BlockDevice::after_inserting_add_symlink_to_device_identifier_directory()
 {
     VERIFY(m_symlink_sysfs_component);
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/IntegralMath.h>
+#include <AK/IntrusiveList.h>
 #include <Kernel/API/MajorNumberAllocation.h>
 #include <Kernel/Devices/Device.h>
 #include <Kernel/Library/LockWeakable.h>
@@ -14,6 +15,7 @@
 namespace Kernel {
 
 class AsyncBlockDeviceRequest;
+class BlockMultiQueue;
 
 class BlockDevice : public Device {
 public:
@@ -28,9 +30,15 @@ public:
 
     virtual void start_request(AsyncBlockDeviceRequest&) = 0;
 
+    // Set for devices that use the multi-queue block layer, which can process many requests at once.
+    BlockMultiQueue* multi_queue() const { return m_multi_queue.ptr(); }
+    virtual bool can_process_requests_concurrently() const override { return !m_multi_queue.is_null(); }
+
 protected:
     BlockDevice(MajorAllocation::BlockDeviceFamily, MinorNumber minor, size_t block_size = PAGE_SIZE);
 
+    void set_multi_queue(NonnullRefPtr<BlockMultiQueue>);
+
 protected:
     virtual bool is_block_device() const final { return true; }
 
@@ -44,6 +52,7 @@ private:
 
     size_t m_block_size { 0 };
     u8 m_block_size_log { 0 };
+    RefPtr<BlockMultiQueue> m_multi_queue;
 };
 
 class AsyncBlockDeviceRequest final : public AsyncDeviceRequest {
@@ -55,6 +64,7 @@ public:
     AsyncBlockDeviceRequest(Device& block_device, RequestType request_type,
         u64 block_index, u32 block_count, UserOrKernelBuffer const& buffer, size_t buffer_size);
 
+    BlockDevice& block_device() const { return m_block_device; }
     RequestType request_type() const { return m_request_type; }
     u64 block_index() const { return m_block_index; }
     u32 block_count() const { return m_block_count; }
@@ -76,6 +86,13 @@ public:
         }
     }
 
+private:
+    IntrusiveListNode<AsyncBlockDeviceRequest, LockRefPtr<AsyncBlockDeviceRequest>> m_block_queue_list_node;
+
+public:
+    // Used by the block layer and drivers to keep track of requests waiting for or being processed by the device.
+    using List = IntrusiveList<&AsyncBlockDeviceRequest::m_block_queue_list_node>;
+
 private:
     BlockDevice& m_block_device;
     RequestType const m_request_type;
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Devices/BlockMultiQueue.h>
+
+namespace Kernel {
+
+void BlockHardwareQueue::did_complete_command()
+{
+    if (m_block_queue)
+        m_block_queue->dispatch(m_index);
+}
+
+ErrorOr<NonnullRefPtr<BlockMultiQueue>> BlockMultiQueue::try_create(Vector<NonnullRefPtr<BlockHardwareQueue>> queues)
+{
+    VERIFY(!queues.is_empty());
+    Vector<NonnullOwnPtr<HardwareQueueContext>> contexts;
+    TRY(contexts.try_ensure_capacity(queues.size()));
+    for (auto& queue : queues)
+        contexts.unchecked_append(TRY(adopt_nonnull_own_or_enomem(new (nothrow) HardwareQueueContext { queue })));
+
+    auto block_queue = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) BlockMultiQueue(move(contexts))));
+    for (size_t i = 0; i < queues.size(); ++i) {
+        VERIFY(!queues[i]->m_block_queue);
+        queues[i]->m_block_queue = block_queue.ptr();
+        queues[i]->m_index = i;
+    }
+    return block_queue;
+}
+
+BlockMultiQueue::BlockMultiQueue(Vector<NonnullOwnPtr<HardwareQueueContext>> hardware_queues)
+    : m_hardware_queues(move(hardware_queues))
+{
+}
+
+BlockMultiQueue::~BlockMultiQueue()
+{
+    for (auto& context : m_hardware_queues)
+        context->queue->m_block_queue = nullptr;
+}
+
+size_t BlockMultiQueue::hardware_queue_index_for_current_processor() const
+{
+    return Processor::current_id() % m_hardware_queues.size();
+}
+
+void BlockMultiQueue::submit(AsyncBlockDeviceRequest& request)
+{
+    auto index = hardware_queue_index_for_current_processor();
+    bool is_plugged = m_hardware_queues[index]->state.with([&](auto& state) {
+        state.pending_requests.append(request);
+        return state.plug_count > 0;
+    });
+    if (!is_plugged)
+        dispatch(index);
+}
+
+void BlockMultiQueue::queue_commands(HardwareQueueContext& context, AsyncBlockDeviceRequest::List& requests)
+{
+    auto& queue = *context.queue;
+    while (!requests.is_empty()) {
+        // Merge as many consecutive requests into this command as the device allows.
+        AsyncBlockDeviceRequest::List command;
+        auto& first_request = *requests.first();
+        auto max_blocks = queue.max_blocks_per_command(first_request.block_device());
+        u64 next_block_index = first_request.block_index();
+        u32 block_count = 0;
+        while (!requests.is_empty()) {
+            auto& request = *requests.first();
+            if (block_count > 0) {
+                if (&request.block_device() != &first_request.block_device()
+                    || request.request_type() != first_request.request_type()
+                    || request.block_index() != next_block_index
+                    || block_count + request.block_count() > max_blocks)
+                    break;
+            }
+            block_count += request.block_count();
+            next_block_index += request.block_count();
+            command.append(*requests.take_first());
+        }
+
+        if (!queue.queue_command(command)) {
+            // The queue is full, so keep the requests around in their original order until a command completes.
+            while (!command.is_empty())
+                requests.prepend(*command.take_last());
+            return;
+        }
+        VERIFY(command.is_empty());
+    }
+}
+
+void BlockMultiQueue::dispatch(size_t hardware_queue_index)
+{
+    auto& context = *m_hardware_queues[hardware_queue_index];
+
+    // Only one processor dispatches on a hardware queue at a time. Anyone else just leaves their requests for it.
+    bool should_dispatch = context.state.with([](auto& state) {
+        if (state.is_dispatching) {
+            state.needs_another_dispatch = true;
+            return false;
+        }
+        state.is_dispatching = true;
+        return true;
+    });
+    if (!should_dispatch)
+        return;
+
+    AsyncBlockDeviceRequest::List requests;
+    while (true) {
+        context.state.with([&](auto& state) {
+            state.needs_another_dispatch = false;
+            while (!state.pending_requests.is_empty())
+                requests.append(*state.pending_requests.take_first());
+        });
+
+        if (!requests.is_empty()) {
+            queue_commands(context, requests);
+            // This is where the doorbell gets rung, once for the whole batch.
+            context.queue->commit_commands();
+        }
+
+        bool is_done = context.state.with([&](auto& state) {
+            // Requests that didn't fit go back to the front, so they are dispatched before anything newer.
+            while (!requests.is_empty())
+                state.pending_requests.prepend(*requests.take_last());
+            if (state.needs_another_dispatch)
+                return false;
+            state.is_dispatching = false;
+            return true;
+        });
+        if (is_done)
+            return;
+    }
+}
+
+BlockMultiQueue::Plug::Plug(BlockMultiQueue& block_queue)
+    : m_block_queue(block_queue)
+    , m_hardware_queue_index(block_queue.hardware_queue_index_for_current_processor())
+{
+    m_block_queue.m_hardware_queues[m_hardware_queue_index]->state.with([](auto& state) {
+        ++state.plug_count;
+    });
+}
+
+BlockMultiQueue::Plug::~Plug()
+{
+    m_block_queue.m_hardware_queues[m_hardware_queue_index]->state.with([](auto& state) {
+        VERIFY(state.plug_count > 0);
+        --state.plug_count;
+    });
+    m_block_queue.dispatch(m_hardware_queue_index);
+}
+
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/AtomicRefCounted.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Vector.h>
+#include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+class BlockMultiQueue;
+
+// A submission queue of a device that can process several commands at once, e.g. an NVMe IO queue.
+class BlockHardwareQueue : public AtomicRefCounted<BlockHardwareQueue> {
+    friend class BlockMultiQueue;
+
+public:
+    virtual ~BlockHardwareQueue() = default;
+
+    // The most blocks a single command may transfer.
+    virtual u32 max_blocks_per_command(BlockDevice const&) const = 0;
+
+    // Puts a command for all of the given requests onto the queue, without notifying the device yet.
+    // The requests are all of the same type and for the same device, and cover consecutive blocks.
+    // On success, the requests are moved out of the list. Returns false if the queue is full.
+    virtual bool queue_command(AsyncBlockDeviceRequest::List&) = 0;
+
+    // Notifies the device of all commands queued since the last call.
+    virtual void commit_commands() = 0;
+
+protected:
+    // Has to be called whenever a command completed, so that requests that didn't fit into the queue can be retried.
+    void did_complete_command();
+
+private:
+    BlockMultiQueue* m_block_queue { nullptr };
+    size_t m_index { 0 };
+};
+
+// The block layer for devices with several hardware queues.
+// Requests go to the hardware queue of the submitting processor. Requests that are waiting to be dispatched are
+// merged with adjacent ones into a single command, and the device is only notified once per dispatched batch.
+class BlockMultiQueue : public AtomicRefCounted<BlockMultiQueue> {
+public:
+    static ErrorOr<NonnullRefPtr<BlockMultiQueue>> try_create(Vector<NonnullRefPtr<BlockHardwareQueue>>);
+    ~BlockMultiQueue();
+
+    void submit(AsyncBlockDeviceRequest&);
+
+    // Holds back dispatching requests that are submitted on this processor's hardware queue, until the plug is
+    // destroyed. This allows for submitting several requests at once, so they can be merged.
+    class Plug {
+        AK_MAKE_NONCOPYABLE(Plug);
+        AK_MAKE_NONMOVABLE(Plug);
+
+    public:
+        explicit Plug(BlockMultiQueue&);
+        ~Plug();
+
+    private:
+        BlockMultiQueue& m_block_queue;
+        size_t m_hardware_queue_index { 0 };
+    };
+
+private:
+    friend class BlockHardwareQueue;
+
+    struct HardwareQueueState {
+        AsyncBlockDeviceRequest::List pending_requests;
+        size_t plug_count { 0 };
+        bool is_dispatching { false };
+        bool needs_another_dispatch { false };
+    };
+
+    struct HardwareQueueContext {
+        NonnullRefPtr<BlockHardwareQueue> queue;
+        SpinlockProtected<HardwareQueueState, LockRank::None> state {};
+    };
+
+    explicit BlockMultiQueue(Vector<NonnullOwnPtr<HardwareQueueContext>>);
+
+    size_t hardware_queue_index_for_current_processor() const;
+    void dispatch(size_t hardware_queue_index);
+    static void queue_commands(HardwareQueueContext&, AsyncBlockDeviceRequest::List& requests);
+
+    Vector<NonnullOwnPtr<HardwareQueueContext>> m_hardware_queues;
+};
+
+}
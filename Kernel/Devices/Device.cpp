@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Find.h>
 #include <AK/Singleton.h>
 #include <Kernel/Devices/BaseDevices.h>
 #include <Kernel/Devices/BlockDevice.h>
@@ -121,11 +122,18 @@ void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceR
 {
     SpinlockLocker lock(m_requests_lock);
     VERIFY(!m_requests.is_empty());
-    VERIFY(m_requests.first().ptr() == &completed_request);
-    m_requests.remove(m_requests.begin());
-    if (!m_requests.is_empty()) {
-        auto* next_request = m_requests.first().ptr();
-        next_request->do_start(move(lock));
+    if (can_process_requests_concurrently()) {
+        // Requests may complete in any order, and all the other ones have been started already.
+        auto it = find_if(m_requests.begin(), m_requests.end(), [&](auto& request) { return request.ptr() == &completed_request; });
+        VERIFY(it != m_requests.end());
+        m_requests.remove(it);
+    } else {
+        VERIFY(m_requests.first().ptr() == &completed_request);
+        m_requests.remove(m_requests.begin());
+        if (!m_requests.is_empty()) {
+            auto* next_request = m_requests.first().ptr();
+            next_request->do_start(move(lock));
+        }
     }
 
     evaluate_block_conditions();
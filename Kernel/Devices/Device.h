@@ -54,6 +54,10 @@ public:
     virtual bool is_openable_by_jailed_processes() const { return false; }
     void process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const&);
 
+    // By default, requests are processed one after another. Devices that can process several at once get each
+    // request started right away, and take care of queueing them themselves.
+    virtual bool can_process_requests_concurrently() const { return false; }
+
     template<typename AsyncRequestType, typename... Args>
     ErrorOr<NonnullLockRefPtr<AsyncRequestType>> try_make_request(Args&&... args)
     {
@@ -61,7 +65,7 @@ public:
         SpinlockLocker lock(m_requests_lock);
         bool was_empty = m_requests.is_empty();
         TRY(m_requests.try_append(request));
-        if (was_empty)
+        if (was_empty || can_process_requests_concurrently())
             request->do_start(move(lock));
         return request;
     }
@@ -213,7 +213,7 @@ ErrorOr<NonnullOwnPtr<KBuffer>> FUSEDevice::send_request_and_wait_for_a_reply(Op
     auto deadline = TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE) + Duration::from_seconds(1);
     auto timer_was_added = TimerQueue::the().add_timer_without_id(*timer, CLOCK_MONOTONIC_COARSE, deadline, [&] {
         set_timed_out();
-    });
+    }, Duration::from_milliseconds(100));
 
     if (!timer_was_added)
         // Somehow, the deadline elapsed before the timer was queued.
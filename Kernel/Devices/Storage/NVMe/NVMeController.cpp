@@ -72,6 +72,13 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::initialize(bool is_queue_polled)
         // qid is zero is used for admin queue
         TRY(create_io_queue(cpuid + 1, queue_type));
     }
+
+    // All namespaces share the IO queues, so they share their block layer as well.
+    Vector<NonnullRefPtr<BlockHardwareQueue>> hardware_queues;
+    TRY(hardware_queues.try_ensure_capacity(m_queues.size()));
+    for (auto& queue : m_queues)
+        hardware_queues.unchecked_append(*queue);
+    m_block_queue = TRY(BlockMultiQueue::try_create(move(hardware_queues)));
     TRY(identify_and_init_namespaces());
     return {};
 }
@@ -211,7 +218,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
 
             dbgln_if(NVME_DEBUG, "NVMe: Block count is {} and Block size is {}", block_counts, block_size);
 
-            TRY(m_namespaces.try_append(TRY(NVMeNameSpace::create(*this, m_queues.clone().release_value_but_fixme_should_propagate_errors(), nsid, block_counts, block_size))));
+            TRY(m_namespaces.try_append(TRY(NVMeNameSpace::create(*this, *m_block_queue, nsid, block_counts, block_size))));
             m_device_count++;
             dbgln_if(NVME_DEBUG, "NVMe: Initialized namespace with NSID: {}", nsid);
         }
@@ -248,6 +255,12 @@ ErrorOr<void> NVMeController::identify_and_init_controller()
         }
     }
 
+    // MDTS is a power of two in units of the minimum memory page size, 0 means there is no limit.
+    if (ctrl.mdts != 0) {
+        m_max_data_transfer_size = CAP_MPSMIN(m_controller_regs->cap) << ctrl.mdts;
+        dbgln_if(NVME_DEBUG, "NVMe: Maximum data transfer size is {} bytes", m_max_data_transfer_size);
+    }
+
     if (ctrl.oacs & ID_CTRL_SHADOW_DBBUF_MASK) {
         OwnPtr<Memory::Region> dbbuf_dma_region;
         OwnPtr<Memory::Region> eventidx_dma_region;
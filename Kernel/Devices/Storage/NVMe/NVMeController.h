@@ -49,6 +49,8 @@ public:
     }
 
     bool is_admin_queue_ready() { return m_admin_queue_ready; }
+    // The most bytes a single IO command may transfer, as reported by the controller.
+    u64 max_data_transfer_size() const { return m_max_data_transfer_size; }
     void set_admin_queue_ready_flag() { m_admin_queue_ready = true; }
 
 private:
@@ -74,12 +76,14 @@ private:
 private:
     LockRefPtr<NVMeQueue> m_admin_queue;
     Vector<NonnullLockRefPtr<NVMeQueue>> m_queues;
+    RefPtr<BlockMultiQueue> m_block_queue;
     Vector<NonnullRefPtr<NVMeNameSpace>> m_namespaces;
     Memory::TypedMapping<ControllerRegister volatile> m_controller_regs;
     RefPtr<Memory::PhysicalRAMPage> m_dbbuf_shadow_page;
     RefPtr<Memory::PhysicalRAMPage> m_dbbuf_eventidx_page;
     bool m_admin_queue_ready { false };
     size_t m_device_count { 0 };
+    u64 m_max_data_transfer_size { NumericLimits<u64>::max() };
     AK::Duration m_ready_timeout;
     PhysicalAddress m_bar { 0 };
     u8 m_dbl_stride { 0 };
@@ -34,14 +34,17 @@ struct IdentifyNamespace {
     u64 rsvd3[488];
 };
 
-// FIXME: For now only one value is used. Once we start using
+// FIXME: For now only a few values are used. Once we start using
 // more values from id_ctrl command, use separate member variables
 // instead of using rsd array.
 struct IdentifyController {
-    u8 rsdv1[256];
+    u8 rsdv1[77];
+    u8 mdts;
+    u8 rsdv2[178];
     u16 oacs;
-    u8 rsdv2[3838];
+    u8 rsdv3[3838];
 };
+static_assert(sizeof(IdentifyController) == 4096);
 
 // DOORBELL
 static constexpr u32 REG_SQ0TDBL_START = 0x1000;
@@ -64,6 +67,14 @@ static constexpr u32 CAP_TO(u64 cap)
     return (cap & CAP_TO_MASK) >> CAP_TO_SHIFT;
 }
 
+static constexpr u8 CAP_MPSMIN_SHIFT = 48;
+static constexpr u64 CAP_MPSMIN_MASK = 0xfull << CAP_MPSMIN_SHIFT;
+// The minimum memory page size of the controller, in bytes
+static constexpr u64 CAP_MPSMIN(u64 cap)
+{
+    return 1ull << (12 + ((cap & CAP_MPSMIN_MASK) >> CAP_MPSMIN_SHIFT));
+}
+
 // CC – Controller Configuration
 static constexpr u8 CC_EN_BIT = 0x0;
 static constexpr u8 CSTS_RDY_BIT = 0x0;
@@ -101,6 +112,17 @@ static constexpr u16 CQ_STATUS_FIELD(u16 x)
 static constexpr u16 ADMIN_QUEUE_SIZE = 2;
 static constexpr u16 IO_QUEUE_SIZE = 64; // TODO:Need to be configurable
 
+// Every IO command transfers its data through a DMA buffer of its own, so this is also the amount of IO commands
+// that can be in flight on a queue at once.
+static constexpr u8 IO_COMMAND_BUFFER_COUNT = 16;
+static constexpr u8 IO_COMMAND_BUFFER_PAGES = 8;
+static_assert(IO_COMMAND_BUFFER_COUNT < IO_QUEUE_SIZE);
+static_assert(IO_COMMAND_BUFFER_COUNT <= 32);
+// Each buffer needs a PRP list for its pages after the first one, they all share a single page.
+static constexpr u16 IO_COMMAND_PRP_LIST_SIZE = 64;
+static_assert((IO_COMMAND_BUFFER_PAGES - 1) * sizeof(u64) <= IO_COMMAND_PRP_LIST_SIZE);
+static_assert(IO_COMMAND_BUFFER_COUNT * IO_COMMAND_PRP_LIST_SIZE <= 4096);
+
 // IDENTIFY
 static constexpr u16 NVMe_IDENTIFY_SIZE = 4096;
 static constexpr u8 NVMe_CNS_ID_NS = 0x0;
@@ -11,15 +11,15 @@
 
 namespace Kernel {
 
-ErrorOr<NonnullLockRefPtr<NVMeInterruptQueue>> NVMeInterruptQueue::try_create(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalRAMPage> rw_dma_page, u16 qid, InterruptNumber irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+ErrorOr<NonnullLockRefPtr<NVMeInterruptQueue>> NVMeInterruptQueue::try_create(PCI::Device& device, Optional<NVMeIOBuffers> io_buffers, u16 qid, InterruptNumber irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
 {
-    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(device, move(rw_dma_region), rw_dma_page, qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))));
+    auto queue = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) NVMeInterruptQueue(device, move(io_buffers), qid, irq, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))));
     queue->initialize_interrupt_queue();
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeInterruptQueue::NVMeInterruptQueue(PCI::Device& device, NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtr<Memory::PhysicalRAMPage> rw_dma_page, u16 qid, InterruptNumber irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
-    : NVMeQueue(move(rw_dma_region), rw_dma_page, qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))
+UNMAP_AFTER_INIT NVMeInterruptQueue::NVMeInterruptQueue(PCI::Device& device, Optional<NVMeIOBuffers> io_buffers, u16 qid, InterruptNumber irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+    : NVMeQueue(move(io_buffers), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs))
     , PCI::IRQHandler(device, irq)
 {
 }
@@ -39,22 +39,18 @@ void NVMeInterruptQueue::submit_sqe(NVMeSubmission& sub)
     NVMeQueue::submit_sqe(sub);
 }
 
-void NVMeInterruptQueue::complete_current_request(u16 cmdid, u16 status)
+void NVMeInterruptQueue::complete_io_commands(u32 io_command_buffers)
 {
-    auto work_item_creation_result = g_io_work->try_queue([this, cmdid, status]() {
-        NVMeQueue::complete_current_request(cmdid, status);
+    // All commands that completed in one interrupt are handed off together, and their requests completed in one go.
+    auto work_item_creation_result = g_io_work->try_queue([this, io_command_buffers]() {
+        NVMeQueue::complete_io_commands(io_command_buffers);
     });
 
     if (work_item_creation_result.is_error()) {
-        m_requests.with([cmdid, status](auto& requests) {
-            auto& request_pdu = requests.get(cmdid).release_value();
-            auto current_request = request_pdu.request;
-
-            current_request->complete(AsyncDeviceRequest::OutOfMemory);
-            if (request_pdu.end_io_handler)
-                request_pdu.end_io_handler(status);
-            request_pdu.clear();
-        });
+        for (u8 io_command_buffer = 0; io_command_buffer < IO_COMMAND_BUFFER_COUNT; ++io_command_buffer) {
+            if (io_command_buffers & (1u << io_command_buffer))
+                fail_io_command(io_command_buffer, AsyncDeviceRequest::OutOfMemory);
+        }
     }
 }
 }
@@ -23,16 +23,17 @@ class NVMeNameSpace : public StorageDevice {
     friend class Device;
 
 public:
-    static ErrorOr<NonnullRefPtr<NVMeNameSpace>> create(NVMeController const&, Vector<NonnullLockRefPtr<NVMeQueue>> queues, u16 nsid, size_t storage_size, size_t lba_size);
+    static ErrorOr<NonnullRefPtr<NVMeNameSpace>> create(NVMeController const&, BlockMultiQueue&, u16 nsid, size_t storage_size, size_t lba_size);
 
     CommandSet command_set() const override { return CommandSet::NVMe; }
     void start_request(AsyncBlockDeviceRequest& request) override;
 
+    u16 nsid() const { return m_nsid; }
+
 private:
-    NVMeNameSpace(LUNAddress, u32 hardware_relative_controller_id, Vector<NonnullLockRefPtr<NVMeQueue>> queues, size_t storage_size, size_t lba_size, u16 nsid);
+    NVMeNameSpace(LUNAddress, u32 hardware_relative_controller_id, size_t storage_size, size_t lba_size, u16 nsid);
 
     u16 m_nsid;
-    Vector<NonnullLockRefPtr<NVMeQueue>> m_queues;
 };
 
 }
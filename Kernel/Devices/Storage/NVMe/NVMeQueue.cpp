@@ -4,10 +4,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BuiltinWrappers.h>
 #include <Kernel/Arch/Delay.h>
 #include <Kernel/Arch/MemoryFences.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeController.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeInterruptQueue.h>
+#include <Kernel/Devices/Storage/NVMe/NVMeNameSpace.h>
 #include <Kernel/Devices/Storage/NVMe/NVMePollQueue.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeQueue.h>
 #include <Kernel/Library/StdLib.h>
@@ -15,33 +17,34 @@
 namespace Kernel {
 ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(NVMeController& device, u16 qid, Optional<InterruptNumber> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type)
 {
-    // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
-    RefPtr<Memory::PhysicalRAMPage> rw_dma_page;
-    // FIXME: Synchronize DMA buffer accesses correctly and set the MemoryType to NonCacheable.
-    auto rw_dma_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_page, Memory::MemoryType::IO));
-
-    if (rw_dma_page.is_null())
-        return ENOMEM;
+    // Note: Only IO queues transfer data, the admin queue commands bring their own buffers.
+    Optional<NVMeIOBuffers> io_buffers;
+    if (qid != 0) {
+        // The command buffers are followed by a page for their PRP lists.
+        Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> io_buffer_pages;
+        // FIXME: Synchronize DMA buffer accesses correctly and set the MemoryType to NonCacheable.
+        auto io_buffer_region = TRY(MM.allocate_dma_buffer_pages((IO_COMMAND_BUFFER_COUNT * IO_COMMAND_BUFFER_PAGES + 1) * PAGE_SIZE, "NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, io_buffer_pages, Memory::MemoryType::IO));
+        auto max_transfer_size = min(static_cast<u64>(IO_COMMAND_BUFFER_PAGES * PAGE_SIZE), device.max_data_transfer_size());
+        io_buffers = NVMeIOBuffers { move(io_buffer_region), move(io_buffer_pages), static_cast<size_t>(max_transfer_size) };
+    }
 
     if (queue_type == QueueType::Polled) {
-        auto queue = NVMePollQueue::try_create(move(rw_dma_region), rw_dma_page.release_nonnull(), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+        auto queue = NVMePollQueue::try_create(move(io_buffers), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
         return queue;
     }
 
-    auto queue = NVMeInterruptQueue::try_create(device, move(rw_dma_region), rw_dma_page.release_nonnull(), qid, irq.release_value(), q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+    auto queue = NVMeInterruptQueue::try_create(device, move(io_buffers), qid, irq.release_value(), q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
     return queue;
 }
 
-UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalRAMPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
-    : m_rw_dma_region(move(rw_dma_region))
-    , m_qid(qid)
+UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(Optional<NVMeIOBuffers> io_buffers, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs)
+    : m_qid(qid)
     , m_admin_queue(qid == 0)
     , m_qdepth(q_depth)
     , m_cq_dma_region(move(cq_dma_region))
     , m_sq_dma_region(move(sq_dma_region))
     , m_db_regs(move(db_regs))
-    , m_rw_dma_page(rw_dma_page)
-
+    , m_io_buffers(move(io_buffers))
 {
     m_requests.with([q_depth](auto& requests) {
         requests.try_ensure_capacity(q_depth).release_value_but_fixme_should_propagate_errors();
@@ -70,32 +73,64 @@ void NVMeQueue::update_cqe_head()
 u32 NVMeQueue::process_cq()
 {
     u32 nr_of_processed_cqes = 0;
-    m_requests.with([this, &nr_of_processed_cqes](auto& requests) {
+    if (is_admin_queue()) {
+        m_requests.with([this, &nr_of_processed_cqes](auto& requests) {
+            while (cqe_available()) {
+                u16 status;
+                u16 cmdid;
+                ++nr_of_processed_cqes;
+                status = CQ_STATUS_FIELD(m_cqe_array[m_cq_head].status);
+                cmdid = m_cqe_array[m_cq_head].command_id;
+                dbgln_if(NVME_DEBUG, "NVMe: Completion with status {:x} and command identifier {}. CQ_HEAD: {}", status, cmdid, m_cq_head);
+
+                if (!requests.contains(cmdid)) {
+                    dmesgln("Bogus cmd id: {}", cmdid);
+                    VERIFY_NOT_REACHED();
+                }
+                complete_current_request_impl(cmdid, status, requests);
+                update_cqe_head();
+            }
+        });
+        if (nr_of_processed_cqes) {
+            update_cq_doorbell();
+        }
+        return nr_of_processed_cqes;
+    }
+
+    u32 completed_io_commands = 0;
+    m_io_commands.with([&](auto& io_commands) {
         while (cqe_available()) {
-            u16 status;
-            u16 cmdid;
             ++nr_of_processed_cqes;
-            status = CQ_STATUS_FIELD(m_cqe_array[m_cq_head].status);
-            cmdid = m_cqe_array[m_cq_head].command_id;
+            u16 status = CQ_STATUS_FIELD(m_cqe_array[m_cq_head].status);
+            u16 cmdid = m_cqe_array[m_cq_head].command_id;
             dbgln_if(NVME_DEBUG, "NVMe: Completion with status {:x} and command identifier {}. CQ_HEAD: {}", status, cmdid, m_cq_head);
 
-            if (!requests.contains(cmdid)) {
+            if (cmdid >= IO_COMMAND_BUFFER_COUNT || !(io_commands.buffers_in_use & (1u << cmdid))) {
                 dmesgln("Bogus cmd id: {}", cmdid);
                 VERIFY_NOT_REACHED();
             }
-            complete_current_request_impl(cmdid, status, requests);
+            io_commands.commands[cmdid].status = status;
+            completed_io_commands |= 1u << cmdid;
             update_cqe_head();
         }
     });
     if (nr_of_processed_cqes) {
         update_cq_doorbell();
+        complete_io_commands(completed_io_commands);
     }
     return nr_of_processed_cqes;
 }
 
-void NVMeQueue::submit_sqe(NVMeSubmission& sub)
+bool NVMeQueue::has_io_commands_in_flight()
 {
-    SpinlockLocker lock(m_sq_lock);
+    return m_io_commands.with([](auto& io_commands) {
+        return io_commands.buffers_in_use != 0;
+    });
+}
+
+void NVMeQueue::queue_sqe(NVMeSubmission& sub)
+{
+    VERIFY(m_sq_lock.is_locked());
 
     memcpy(&m_sqe_array[m_sq_tail], &sub, sizeof(NVMeSubmission));
     {
@@ -107,108 +142,193 @@ void NVMeQueue::submit_sqe(NVMeSubmission& sub)
     }
 
     dbgln_if(NVME_DEBUG, "NVMe: Submission with command identifier {}. SQ_TAIL: {}", sub.cmdid, m_sq_tail);
+}
+
+void NVMeQueue::submit_sqe(NVMeSubmission& sub)
+{
+    SpinlockLocker lock(m_sq_lock);
+    queue_sqe(sub);
     update_sq_doorbell();
 }
 
 void NVMeQueue::complete_current_request_impl(u16 cmdid, u16 status, HashMap<u16, NVMeIO>& requests)
 {
     auto& request_pdu = requests.get(cmdid).release_value();
-    auto current_request = request_pdu.request;
-    AsyncDeviceRequest::RequestResult req_result = AsyncDeviceRequest::Success;
-
-    ScopeGuard guard = [&req_result, status, &request_pdu] {
-        if (request_pdu.request)
-            request_pdu.request->complete(req_result);
-        if (request_pdu.end_io_handler)
-            request_pdu.end_io_handler(status);
-        request_pdu.clear();
-    };
-
-    // There can be submission without any request associated with it such as with
-    // admin queue commands during init. If there is no request, we are done
-    if (!current_request)
-        return;
-
-    if (status) {
-        req_result = AsyncBlockDeviceRequest::Failure;
-        return;
-    }
-
-    if (current_request->request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
-        if (auto result = current_request->write_to_buffer(current_request->buffer(), m_rw_dma_region->vaddr().as_ptr(), current_request->buffer_size()); result.is_error()) {
-            req_result = AsyncBlockDeviceRequest::MemoryFault;
-            return;
-        }
-    }
+    if (request_pdu.end_io_handler)
+        request_pdu.end_io_handler(status);
+    request_pdu.clear();
 }
 
-void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
+u32 NVMeQueue::max_blocks_per_command(BlockDevice const& device) const
 {
-    m_requests.with([this, cmdid, status](auto& requests) {
-        complete_current_request_impl(cmdid, status, requests);
-    });
+    VERIFY(m_io_buffers.has_value());
+    return m_io_buffers->max_transfer_size / device.block_size();
 }
 
-u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
+u8* NVMeQueue::io_command_buffer_data(u8 io_command_buffer) const
 {
-    // For now let's use sq tail as a unique command id.
-    u16 cmd_status;
-    u16 cid = get_request_cid();
-    sub.cmdid = cid;
-
-    m_requests.with([this, &sub, &cmd_status](auto& requests) {
-        requests.set(sub.cmdid, { nullptr, [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); } });
-    });
-    submit_sqe(sub);
-
-    // FIXME: Only sync submissions (usually used for admin commands) use a DeprecatedWaitQueue based IO. Eventually we need to
-    //  move this logic into the block layer instead of sprinkling them in the driver code.
-    m_sync_wait_queue.wait_forever("NVMe sync submit"sv);
-    return cmd_status;
+    return m_io_buffers->region->vaddr().offset(io_command_buffer * IO_COMMAND_BUFFER_PAGES * PAGE_SIZE).as_ptr();
 }
 
-void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+bool NVMeQueue::queue_command(AsyncBlockDeviceRequest::List& requests)
 {
+    VERIFY(m_io_buffers.has_value());
+    auto& first_request = *requests.first();
+    auto& name_space = static_cast<NVMeNameSpace&>(first_request.block_device());
+    auto request_type = first_request.request_type();
+
+    auto maybe_io_command_buffer = m_io_commands.with([](auto& io_commands) -> Optional<u8> {
+        constexpr u32 all_buffers = (IO_COMMAND_BUFFER_COUNT == 32) ? NumericLimits<u32>::max() : (1u << IO_COMMAND_BUFFER_COUNT) - 1;
+        if (io_commands.buffers_in_use == all_buffers)
+            return {};
+        auto io_command_buffer = static_cast<u8>(count_trailing_zeroes(~io_commands.buffers_in_use));
+        io_commands.buffers_in_use |= 1u << io_command_buffer;
+        return io_command_buffer;
+    });
+    if (!maybe_io_command_buffer.has_value())
+        return false;
+    auto io_command_buffer = maybe_io_command_buffer.release_value();
+    auto* data = io_command_buffer_data(io_command_buffer);
+
+    u32 block_count = 0;
+    for (auto& request : requests) {
+        if (request_type == AsyncBlockDeviceRequest::Write) {
+            if (auto result = request.read_from_buffer(request.buffer(), data + block_count * name_space.block_size(), request.buffer_size()); result.is_error()) {
+                while (!requests.is_empty()) {
+                    auto faulted_request = requests.take_first();
+                    faulted_request->complete(AsyncDeviceRequest::MemoryFault);
+                }
+                release_io_command_buffer(io_command_buffer);
+                return true;
+            }
+        }
+        block_count += request.block_count();
+    }
+    VERIFY(block_count * name_space.block_size() <= m_io_buffers->max_transfer_size);
+
     NVMeSubmission sub {};
-    sub.op = OP_NVME_READ;
-    sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
+    sub.op = request_type == AsyncBlockDeviceRequest::Read ? OP_NVME_READ : OP_NVME_WRITE;
+    sub.rw.nsid = name_space.nsid();
+    sub.rw.slba = AK::convert_between_host_and_little_endian(first_request.block_index());
     // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
+    sub.rw.length = AK::convert_between_host_and_little_endian((block_count - 1) & 0xFFFF);
+    sub.cmdid = io_command_buffer;
+
+    auto& pages = m_io_buffers->pages;
+    auto first_page = io_command_buffer * IO_COMMAND_BUFFER_PAGES;
+    auto page_count = ceil_div(block_count * name_space.block_size(), static_cast<size_t>(PAGE_SIZE));
+    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(pages[first_page]->paddr().as_ptr()));
+    if (page_count == 2) {
+        sub.rw.data_ptr.prp2 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(pages[first_page + 1]->paddr().as_ptr()));
+    } else if (page_count > 2) {
+        // PRP2 points to a list of all pages after the first one.
+        auto prp_list_offset = io_command_buffer * IO_COMMAND_PRP_LIST_SIZE;
+        auto& prp_list_page = pages.last();
+        auto* prp_list = reinterpret_cast<LittleEndian<u64>*>(m_io_buffers->region->vaddr().offset((pages.size() - 1) * PAGE_SIZE + prp_list_offset).as_ptr());
+        for (size_t i = 1; i < page_count; ++i)
+            prp_list[i - 1] = reinterpret_cast<u64>(pages[first_page + i]->paddr().as_ptr());
+        sub.rw.data_ptr.prp2 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(prp_list_page->paddr().offset(prp_list_offset).as_ptr()));
+    }
 
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
+    m_io_commands.with([&](auto& io_commands) {
+        auto& command = io_commands.commands[io_command_buffer];
+        VERIFY(command.requests.is_empty());
+        while (!requests.is_empty())
+            command.requests.append(*requests.take_first());
     });
 
     full_memory_fence();
-    submit_sqe(sub);
+    SpinlockLocker lock(m_sq_lock);
+    queue_sqe(sub);
+    return true;
 }
 
-void NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+void NVMeQueue::commit_commands()
 {
-    NVMeSubmission sub {};
+    SpinlockLocker lock(m_sq_lock);
+    update_sq_doorbell();
+}
 
-    sub.op = OP_NVME_WRITE;
-    sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
-    // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
+AsyncBlockDeviceRequest::List NVMeQueue::take_io_command_requests(u8 io_command_buffer, u16& status)
+{
+    AsyncBlockDeviceRequest::List requests;
+    m_io_commands.with([&](auto& io_commands) {
+        auto& command = io_commands.commands[io_command_buffer];
+        status = command.status;
+        while (!command.requests.is_empty())
+            requests.append(*command.requests.take_first());
+    });
+    return requests;
+}
 
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
+void NVMeQueue::release_io_command_buffer(u8 io_command_buffer)
+{
+    m_io_commands.with([io_command_buffer](auto& io_commands) {
+        VERIFY(io_commands.buffers_in_use & (1u << io_command_buffer));
+        io_commands.buffers_in_use &= ~(1u << io_command_buffer);
     });
+}
 
-    if (auto result = request.read_from_buffer(request.buffer(), m_rw_dma_region->vaddr().as_ptr(), request.buffer_size()); result.is_error()) {
-        complete_current_request(sub.cmdid, AsyncDeviceRequest::MemoryFault);
-        return;
+void NVMeQueue::complete_io_command(u8 io_command_buffer)
+{
+    u16 status = 0;
+    auto requests = take_io_command_requests(io_command_buffer, status);
+    auto* data = io_command_buffer_data(io_command_buffer);
+
+    // The buffer has to stay ours until the data of all requests has been copied out of it.
+    while (!requests.is_empty()) {
+        auto request = requests.take_first();
+        auto request_result = AsyncDeviceRequest::Success;
+        if (status) {
+            request_result = AsyncDeviceRequest::Failure;
+        } else if (request->request_type() == AsyncBlockDeviceRequest::Read) {
+            if (auto result = request->write_to_buffer(request->buffer(), data, request->buffer_size()); result.is_error())
+                request_result = AsyncDeviceRequest::MemoryFault;
+        }
+        data += request->block_count() * request->block_device().block_size();
+        request->complete(request_result);
     }
+    release_io_command_buffer(io_command_buffer);
+}
 
-    full_memory_fence();
+void NVMeQueue::fail_io_command(u8 io_command_buffer, AsyncDeviceRequest::RequestResult request_result)
+{
+    u16 status = 0;
+    auto requests = take_io_command_requests(io_command_buffer, status);
+    while (!requests.is_empty()) {
+        auto request = requests.take_first();
+        request->complete(request_result);
+    }
+    release_io_command_buffer(io_command_buffer);
+}
+
+void NVMeQueue::complete_io_commands(u32 io_command_buffers)
+{
+    while (io_command_buffers) {
+        auto io_command_buffer = static_cast<u8>(count_trailing_zeroes(io_command_buffers));
+        io_command_buffers &= ~(1u << io_command_buffer);
+        complete_io_command(io_command_buffer);
+    }
+    // Now that there are free buffers again, requests that didn't fit before can be dispatched.
+    did_complete_command();
+}
+
+u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
+{
+    // For now let's use sq tail as a unique command id.
+    u16 cmd_status;
+    u16 cid = get_request_cid();
+    sub.cmdid = cid;
+
+    m_requests.with([this, &sub, &cmd_status](auto& requests) {
+        requests.set(sub.cmdid, { [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); } });
+    });
     submit_sqe(sub);
+
+    // FIXME: Only sync submissions (usually used for admin commands) use a DeprecatedWaitQueue based IO. Eventually we need to
+    //  move this logic into the block layer instead of sprinkling them in the driver code.
+    m_sync_wait_queue.wait_forever("NVMe sync submit"sv);
+    return cmd_status;
 }
 
 UNMAP_AFTER_INIT NVMeQueue::~NVMeQueue() = default;
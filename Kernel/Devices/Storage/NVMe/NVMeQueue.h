@@ -6,12 +6,13 @@
 
 #pragma once
 
-#include <AK/AtomicRefCounted.h>
+#include <AK/Array.h>
 #include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
 #include <AK/Types.h>
 #include <Kernel/Arch/MemoryFences.h>
 #include <Kernel/Bus/PCI/Device.h>
+#include <Kernel/Devices/BlockMultiQueue.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeDefinitions.h>
 #include <Kernel/Interrupts/IRQHandler.h>
 #include <Kernel/Library/LockRefPtr.h>
@@ -39,31 +40,42 @@ enum class QueueType {
     IRQ
 };
 
-class AsyncBlockDeviceRequest;
-
 struct NVMeIO {
     void clear()
     {
-        request = nullptr;
         end_io_handler = nullptr;
     }
-    RefPtr<AsyncBlockDeviceRequest> request;
     Function<void(u16 status)> end_io_handler;
 };
 
+struct NVMeIOBuffers {
+    NonnullOwnPtr<Memory::Region> region;
+    Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> pages;
+    size_t max_transfer_size { 0 };
+};
+
 class NVMeController;
-class NVMeQueue : public AtomicRefCounted<NVMeQueue> {
+class NVMeQueue : public BlockHardwareQueue {
 public:
     static ErrorOr<NonnullLockRefPtr<NVMeQueue>> try_create(NVMeController& device, u16 qid, Optional<InterruptNumber> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type);
     bool is_admin_queue() { return m_admin_queue; }
     u16 submit_sync_sqe(NVMeSubmission&);
-    void read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
-    void write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
     virtual void submit_sqe(NVMeSubmission&);
     virtual ~NVMeQueue();
 
+    // ^BlockHardwareQueue
+    virtual u32 max_blocks_per_command(BlockDevice const&) const override;
+    virtual bool queue_command(AsyncBlockDeviceRequest::List&) override;
+    virtual void commit_commands() override;
+
 protected:
     u32 process_cq();
+    bool has_io_commands_in_flight();
+
+    // Completes the requests of all commands in the given mask of IO command buffers.
+    virtual void complete_io_commands(u32 io_command_buffers);
+    // Fails the requests of a command without touching their buffers, which is safe to do in IRQ context.
+    void fail_io_command(u8 io_command_buffer, AsyncDeviceRequest::RequestResult);
 
     // Updates the shadow buffer and returns if mmio is needed
     bool update_shadow_buf(u16 new_value, u32* dbbuf, u32* ei)
@@ -85,7 +97,7 @@ protected:
             m_db_regs.mmio_reg->sq_tail = m_sq_tail;
     }
 
-    NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalRAMPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
+    NVMeQueue(Optional<NVMeIOBuffers> io_buffers, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
 
     [[nodiscard]] u32 get_request_cid()
     {
@@ -100,10 +112,13 @@ protected:
         }
     }
 
-    virtual void complete_current_request(u16 cmdid, u16 status);
-
 private:
     void complete_current_request_impl(u16 cmdid, u16 status, HashMap<u16, NVMeIO>& requests);
+    void queue_sqe(NVMeSubmission&);
+    void complete_io_command(u8 io_command_buffer);
+    AsyncBlockDeviceRequest::List take_io_command_requests(u8 io_command_buffer, u16& status);
+    void release_io_command_buffer(u8 io_command_buffer);
+    u8* io_command_buffer_data(u8 io_command_buffer) const;
     bool cqe_available();
     void update_cqe_head();
     void update_cq_doorbell()
@@ -116,7 +131,6 @@ private:
 
 protected:
     SpinlockProtected<HashMap<u16, NVMeIO>, LockRank::None> m_requests;
-    NonnullOwnPtr<Memory::Region> m_rw_dma_region;
 
 private:
     u16 m_qid {};
@@ -133,6 +147,17 @@ private:
     Span<NVMeCompletion> m_cqe_array;
     DeprecatedWaitQueue m_sync_wait_queue;
     Doorbell m_db_regs;
-    NonnullRefPtr<Memory::PhysicalRAMPage const> const m_rw_dma_page;
+
+    // IO commands use the index of their buffer as their command id.
+    struct IOCommand {
+        AsyncBlockDeviceRequest::List requests;
+        u16 status { 0 };
+    };
+    struct IOCommands {
+        Array<IOCommand, IO_COMMAND_BUFFER_COUNT> commands;
+        u32 buffers_in_use { 0 };
+    };
+    SpinlockProtected<IOCommands, LockRank::None> m_io_commands {};
+    Optional<NVMeIOBuffers> m_io_buffers;
 };
 }
@@ -8,6 +8,7 @@
 #include <Kernel/API/Ioctl.h>
 #include <Kernel/API/MajorNumberAllocation.h>
 #include <Kernel/Debug.h>
+#include <Kernel/Devices/BlockMultiQueue.h>
 #include <Kernel/Devices/Device.h>
 #include <Kernel/Devices/Storage/StorageDevice.h>
 #include <Kernel/Devices/Storage/StorageManagement.h>
@@ -75,6 +76,58 @@ StringView StorageDevice::command_set_to_string_view() const
     VERIFY_NOT_REACHED();
 }
 
+// Multi-queue devices can take larger transfers, as they get split up into page sized requests that are all
+// submitted at once, and merged back together by the block layer.
+static constexpr size_t max_pages_per_multi_queue_transfer = 16;
+
+size_t StorageDevice::max_blocks_per_transfer() const
+{
+    if (multi_queue())
+        return m_blocks_per_page * max_pages_per_multi_queue_transfer;
+    return m_blocks_per_page;
+}
+
+ErrorOr<void> StorageDevice::transfer_whole_blocks(AsyncBlockDeviceRequest::RequestType request_type, u64 index, size_t block_count, UserOrKernelBuffer const& buffer)
+{
+    VERIFY(block_count <= max_blocks_per_transfer());
+
+    Vector<NonnullLockRefPtr<AsyncBlockDeviceRequest>, max_pages_per_multi_queue_transfer> requests;
+    auto issue_requests = [&]() -> ErrorOr<void> {
+        if (!multi_queue()) {
+            TRY(requests.try_append(TRY(try_make_request<AsyncBlockDeviceRequest>(request_type, index, block_count, buffer, block_count * block_size()))));
+            return {};
+        }
+        BlockMultiQueue::Plug plug(*multi_queue());
+        for (size_t offset = 0; offset < block_count; offset += m_blocks_per_page) {
+            auto request_block_count = min(m_blocks_per_page, block_count - offset);
+            TRY(requests.try_append(TRY(try_make_request<AsyncBlockDeviceRequest>(request_type, index + offset, request_block_count, buffer.offset(offset * block_size()), request_block_count * block_size()))));
+        }
+        return {};
+    };
+    ErrorOr<void> result = issue_requests();
+
+    // NOTE: Every request we issued transfers into or out of the caller's buffer, so we must not return
+    //       before all of them have completed, even if issuing a later one or one of the transfers failed,
+    //       or a signal arrives in the meantime.
+    for (auto& request : requests) {
+        auto request_result = request->wait_until_completed();
+        if (result.is_error())
+            continue;
+        switch (request_result) {
+        case AsyncDeviceRequest::Failure:
+        case AsyncDeviceRequest::Cancelled:
+            result = EIO;
+            break;
+        case AsyncDeviceRequest::MemoryFault:
+            result = EFAULT;
+            break;
+        default:
+            break;
+        }
+    }
+    return result;
+}
+
 ErrorOr<size_t> StorageDevice::read(OpenFileDescription&, u64 offset, UserOrKernelBuffer& outbuf, size_t len)
 {
     // NOTE: The last available offset is actually just after the last addressable block.
@@ -88,8 +141,8 @@ ErrorOr<size_t> StorageDevice::read(OpenFileDescription&, u64 offset, UserOrKern
 
     // PATAChannel will chuck a wobbly if we try to read more than PAGE_SIZE
     // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= m_blocks_per_page) {
-        whole_blocks = m_blocks_per_page;
+    if (whole_blocks >= max_blocks_per_transfer()) {
+        whole_blocks = max_blocks_per_transfer();
         remaining = 0;
     }
 
@@ -98,21 +151,8 @@ ErrorOr<size_t> StorageDevice::read(OpenFileDescription&, u64 offset, UserOrKern
 
     dbgln_if(STORAGE_DEVICE_DEBUG, "StorageDevice::read() index={}, whole_blocks={}, remaining={}", index, whole_blocks, remaining);
 
-    if (whole_blocks > 0) {
-        auto read_request = TRY(try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Read, index, whole_blocks, outbuf, whole_blocks * block_size()));
-        auto result = read_request->wait();
-        if (result.wait_result().was_interrupted())
-            return EINTR;
-        switch (result.request_result()) {
-        case AsyncDeviceRequest::Failure:
-        case AsyncDeviceRequest::Cancelled:
-            return EIO;
-        case AsyncDeviceRequest::MemoryFault:
-            return EFAULT;
-        default:
-            break;
-        }
-    }
+    if (whole_blocks > 0)
+        TRY(transfer_whole_blocks(AsyncBlockDeviceRequest::Read, index, whole_blocks, outbuf));
 
     off_t pos = whole_blocks * block_size();
 
@@ -120,10 +160,8 @@ ErrorOr<size_t> StorageDevice::read(OpenFileDescription&, u64 offset, UserOrKern
         auto data = TRY(ByteBuffer::create_uninitialized(block_size()));
         auto data_buffer = UserOrKernelBuffer::for_kernel_buffer(data.data());
         auto read_request = TRY(try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Read, index + whole_blocks, 1, data_buffer, block_size()));
-        auto result = read_request->wait();
-        if (result.wait_result().was_interrupted())
-            return EINTR;
-        switch (result.request_result()) {
+        // NOTE: The device reads into our local buffer, so we can't leave before it's done.
+        switch (read_request->wait_until_completed()) {
         case AsyncDeviceRequest::Failure:
             return pos;
         case AsyncDeviceRequest::Cancelled:
@@ -153,8 +191,8 @@ ErrorOr<size_t> StorageDevice::write(OpenFileDescription&, u64 offset, UserOrKer
 
     // PATAChannel will chuck a wobbly if we try to write more than PAGE_SIZE
     // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= m_blocks_per_page) {
-        whole_blocks = m_blocks_per_page;
+    if (whole_blocks >= max_blocks_per_transfer()) {
+        whole_blocks = max_blocks_per_transfer();
         remaining = 0;
     }
 
@@ -169,21 +207,8 @@ ErrorOr<size_t> StorageDevice::write(OpenFileDescription&, u64 offset, UserOrKer
 
     dbgln_if(STORAGE_DEVICE_DEBUG, "StorageDevice::write() index={}, whole_blocks={}, remaining={}", index, whole_blocks, remaining);
 
-    if (whole_blocks > 0) {
-        auto write_request = TRY(try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Write, index, whole_blocks, inbuf, whole_blocks * block_size()));
-        auto result = write_request->wait();
-        if (result.wait_result().was_interrupted())
-            return EINTR;
-        switch (result.request_result()) {
-        case AsyncDeviceRequest::Failure:
-        case AsyncDeviceRequest::Cancelled:
-            return EIO;
-        case AsyncDeviceRequest::MemoryFault:
-            return EFAULT;
-        default:
-            break;
-        }
-    }
+    if (whole_blocks > 0)
+        TRY(transfer_whole_blocks(AsyncBlockDeviceRequest::Write, index, whole_blocks, inbuf));
 
     off_t pos = whole_blocks * block_size();
 
@@ -194,10 +219,7 @@ ErrorOr<size_t> StorageDevice::write(OpenFileDescription&, u64 offset, UserOrKer
         auto data_buffer = UserOrKernelBuffer::for_kernel_buffer(partial_write_block->data());
         {
             auto read_request = TRY(try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Read, index + whole_blocks, 1, data_buffer, block_size()));
-            auto result = read_request->wait();
-            if (result.wait_result().was_interrupted())
-                return EINTR;
-            switch (result.request_result()) {
+            switch (read_request->wait_until_completed()) {
             case AsyncDeviceRequest::Failure:
                 return pos;
             case AsyncDeviceRequest::Cancelled:
@@ -214,10 +236,7 @@ ErrorOr<size_t> StorageDevice::write(OpenFileDescription&, u64 offset, UserOrKer
 
         {
             auto write_request = TRY(try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Write, index + whole_blocks, 1, data_buffer, block_size()));
-            auto result = write_request->wait();
-            if (result.wait_result().was_interrupted())
-                return EINTR;
-            switch (result.request_result()) {
+            switch (write_request->wait_until_completed()) {
             case AsyncDeviceRequest::Failure:
                 return pos;
             case AsyncDeviceRequest::Cancelled:
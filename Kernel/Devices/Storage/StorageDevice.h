@@ -89,6 +89,9 @@ protected:
     virtual StringView class_name() const override;
 
 private:
+    size_t max_blocks_per_transfer() const;
+    ErrorOr<void> transfer_whole_blocks(AsyncBlockDeviceRequest::RequestType, u64 index, size_t block_count, UserOrKernelBuffer const&);
+
     virtual ErrorOr<void> after_inserting() override;
     virtual void will_be_destroyed() override;
 
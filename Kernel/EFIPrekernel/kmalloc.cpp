@@ -46,4 +46,8 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_free = 0;
     stats.kmalloc_call_count = s_kmalloc_call_count;
     stats.kfree_call_count = s_kfree_call_count;
+    stats.magazine_allocation_hits = 0;
+    stats.magazine_allocation_misses = 0;
+    stats.magazine_free_hits = 0;
+    stats.magazine_free_misses = 0;
 }
@@ -5,6 +5,7 @@
  */
 
 #include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/Tasks/Process.h>
@@ -16,18 +17,36 @@ struct CacheEntry {
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    // Set once the block has been accessed a second time while it was cached.
+    bool is_hot { false };
+    // Set for blocks that were only brought in by read-ahead, so their first real access doesn't count as a second one.
+    bool is_read_ahead { false };
+    // Set for blocks whose contents are cached elsewhere, so their data is dropped as soon as they have been written back.
+    bool drop_after_flush { false };
 };
 
+// One shard of a BlockBasedFileSystem's block cache. Every shard has its own lock, and owns every
+// BlockBasedFileSystem::cache_stripe_size_in_blocks()-sized stripe of blocks that maps to it.
+//
+// Clean entries are kept in two LRU lists, approximating LRU-2: blocks that have only been accessed
+// once live on the cold list, and get promoted to the hot list when they're accessed again.
+// Eviction takes from the cold list first, so a single large scan can't push out the working set.
 class DiskCache {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
+    static constexpr size_t EntryCount = 10000 / BlockBasedFileSystem::cache_shard_count;
+
+    // At most this many clean entries are kept on the hot list, the rest is left for newly cached blocks.
+    static constexpr size_t MaximumHotEntryCount = EntryCount * 3 / 4;
+
+    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer, NonnullOwnPtr<KBuffer> cluster_buffer)
         : m_cached_block_data(move(cached_block_data))
+        , m_cluster_buffer(move(cluster_buffer))
+        , m_cluster_capacity_in_blocks(m_cluster_buffer->size() / fs.logical_block_size())
         , m_entries(move(entries_buffer))
     {
         for (size_t i = 0; i < EntryCount; ++i) {
             entries()[i].data = m_cached_block_data->data() + i * fs.logical_block_size();
-            m_clean_list.append(entries()[i]);
+            m_cold_list.append(entries()[i]);
         }
     }
 
@@ -39,55 +58,101 @@ public:
     void mark_all_clean()
     {
         while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+            mark_clean(*entry);
     }
 
     void mark_dirty(CacheEntry& entry)
     {
+        if (m_hot_list.contains(entry))
+            --m_hot_entry_count;
         m_dirty_list.prepend(entry);
     }
 
     void mark_clean(CacheEntry& entry)
     {
-        m_clean_list.prepend(entry);
+        if (entry.drop_after_flush) {
+            // Keep the entry around (it's still hashed), but make it the next one to be reused.
+            entry.drop_after_flush = false;
+            entry.has_data = false;
+            entry.is_hot = false;
+            m_cold_list.append(entry);
+            return;
+        }
+        if (!entry.is_hot) {
+            m_cold_list.prepend(entry);
+            return;
+        }
+        if (!m_hot_list.contains(entry))
+            ++m_hot_entry_count;
+        m_hot_list.prepend(entry);
+
+        if (m_hot_entry_count > MaximumHotEntryCount) {
+            // Demote the least recently used hot entry, it has to prove itself again to stay cached.
+            auto& demoted_entry = *m_hot_list.last();
+            demoted_entry.is_hot = false;
+            --m_hot_entry_count;
+            m_cold_list.prepend(demoted_entry);
+        }
     }
 
-    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
+    // Looks up a block without counting it as an access.
+    CacheEntry* find(BlockBasedFileSystem::BlockIndex block_index)
     {
         auto it = m_hash.find(block_index);
         if (it == m_hash.end())
             return nullptr;
-        auto& entry = const_cast<CacheEntry&>(*it->value);
-        VERIFY(entry.block_index == block_index);
-        if (!entry_is_dirty(entry) && (m_clean_list.first() != &entry)) {
-            // Cache hit! Promote the entry to the front of the list.
-            m_clean_list.prepend(entry);
+        VERIFY(it->value->block_index == block_index);
+        return it->value;
+    }
+
+    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        auto* entry = find(block_index);
+        if (!entry)
+            return nullptr;
+        if (entry->is_read_ahead)
+            entry->is_read_ahead = false;
+        else
+            entry->is_hot = true;
+        // Someone is reading the block through the cache, so it's worth keeping after all.
+        entry->drop_after_flush = false;
+        if (!entry_is_dirty(*entry)) {
+            // Cache hit! Promote the entry to the front of the hot list.
+            mark_clean(*entry);
         }
-        return &entry;
+        return entry;
     }
 
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index, BlockBasedFileSystem& fs) const
+    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index, BlockBasedFileSystem& fs)
     {
         if (auto* entry = get(block_index))
             return entry;
 
-        if (m_clean_list.is_empty()) {
+        if (m_cold_list.is_empty() && m_hot_list.is_empty()) {
             // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            fs.flush_writes_impl();
+            // NOTE: We only flush this shard, as the other shards may be locked by someone who is waiting for us.
+            fs.flush_cache_shard(*this);
             return ensure(block_index, fs);
         }
 
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
+        auto* victim = m_cold_list.last();
+        if (!victim) {
+            victim = m_hot_list.last();
+            --m_hot_entry_count;
+        }
+        auto& new_entry = *victim;
+        if (new_entry.has_data)
+            ++m_statistics.evictions;
 
         m_hash.remove(new_entry.block_index);
         TRY(m_hash.try_set(block_index, &new_entry));
 
         new_entry.block_index = block_index;
         new_entry.has_data = false;
+        new_entry.is_hot = false;
+        new_entry.is_read_ahead = false;
+        new_entry.drop_after_flush = false;
+        m_cold_list.prepend(new_entry);
 
         return &new_entry;
     }
@@ -102,15 +167,27 @@ public:
             callback(entry);
     }
 
+    u8* cluster_buffer() { return m_cluster_buffer->data(); }
+    size_t cluster_capacity_in_blocks() const { return m_cluster_capacity_in_blocks; }
+
+    BlockBasedFileSystem::CacheStatistics& statistics() { return m_statistics; }
+    BlockBasedFileSystem::CacheStatistics const& statistics() const { return m_statistics; }
+
 private:
     NonnullOwnPtr<KBuffer> m_cached_block_data;
+    NonnullOwnPtr<KBuffer> m_cluster_buffer;
+    size_t m_cluster_capacity_in_blocks { 0 };
 
-    // NOTE: m_entries must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
-    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_entries is destroyed.
+    BlockBasedFileSystem::CacheStatistics m_statistics;
+    size_t m_hot_entry_count { 0 };
+
+    // NOTE: m_entries must be declared before the lists because their entries are allocated from it.
+    // We need to ensure that the destructors of the lists are called before m_entries is destroyed.
     NonnullOwnPtr<KBuffer> m_entries;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    IntrusiveList<&CacheEntry::list_node> m_dirty_list;
+    IntrusiveList<&CacheEntry::list_node> m_hot_list;
+    IntrusiveList<&CacheEntry::list_node> m_cold_list;
+    HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
@@ -126,17 +203,79 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(logical_block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * logical_block_size(), Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry), Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
 
-    m_cache.with_exclusive([&](auto& cache) {
-        cache = move(disk_cache);
-    });
+    auto cluster_size = max(maximum_cluster_size, logical_block_size());
+    m_cache_stripe_size_in_blocks = cluster_size / logical_block_size();
+
+    for (auto& shard : m_cache_shards) {
+        auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * logical_block_size(), Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
+        auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry), Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
+        auto cluster_buffer = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache cluster"sv, cluster_size, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
+        auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data), move(cluster_buffer))));
+
+        shard.with_exclusive([&](auto& cache) {
+            cache = move(disk_cache);
+        });
+    }
     return {};
 }
 
-ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBuffer const& data, size_t count, u64 offset, bool allow_cache)
+MutexProtected<OwnPtr<DiskCache>>& BlockBasedFileSystem::cache_shard_for(BlockIndex index) const
+{
+    // Whole stripes map to the same shard, so read-ahead and write-back clustering can work within a single shard.
+    return m_cache_shards[(index.value() / m_cache_stripe_size_in_blocks) % cache_shard_count];
+}
+
+BlockBasedFileSystem::CacheStatistics BlockBasedFileSystem::cache_statistics() const
+{
+    CacheStatistics statistics;
+    for (auto& shard : m_cache_shards) {
+        shard.with_shared([&](auto& cache) {
+            if (!cache)
+                return;
+            statistics.hits += cache->statistics().hits;
+            statistics.misses += cache->statistics().misses;
+            statistics.evictions += cache->statistics().evictions;
+            statistics.read_ahead_blocks += cache->statistics().read_ahead_blocks;
+        });
+    }
+    return statistics;
+}
+
+size_t BlockBasedFileSystem::track_read_for_read_ahead(BlockIndex index, bool is_miss) const
+{
+    return m_read_ahead_streams.with([&](auto& read_ahead) -> size_t {
+        ReadAheadStream* stream = nullptr;
+        for (auto& candidate : read_ahead.streams) {
+            if (candidate.last_used != 0 && candidate.next_block == index.value()) {
+                stream = &candidate;
+                break;
+            }
+        }
+
+        size_t block_count = 1;
+        if (stream) {
+            if (is_miss) {
+                stream->window = min(max(stream->window * 2, initial_read_ahead_blocks), m_cache_stripe_size_in_blocks);
+                block_count = stream->window;
+            }
+        } else {
+            // Not a continuation of any stream we know of, so start tracking a new one in place of the least recently used.
+            // Random access never gets past this point, so it doesn't read ahead and pollute the cache.
+            stream = &read_ahead.streams[0];
+            for (auto& candidate : read_ahead.streams) {
+                if (candidate.last_used < stream->last_used)
+                    stream = &candidate;
+            }
+            stream->window = 0;
+        }
+        stream->next_block = index.value() + 1;
+        stream->last_used = ++read_ahead.access_count;
+        return block_count;
+    });
+}
+
+ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBuffer const& data, size_t count, u64 offset, bool allow_cache, bool keep_after_flush)
 {
     VERIFY(m_device_block_size);
     VERIFY(offset + count <= logical_block_size());
@@ -149,7 +288,7 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return cache_shard_for(index).with_exclusive([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
             flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * logical_block_size() + offset;
@@ -167,6 +306,7 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
         cache->mark_dirty(*entry);
         entry->has_data = true;
+        entry->drop_after_flush = !keep_after_flush;
         return {};
     });
 }
@@ -223,7 +363,7 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     VERIFY(offset + count <= logical_block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    return cache_shard_for(index).with_exclusive([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
             const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * logical_block_size() + offset;
@@ -232,13 +372,15 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
             return {};
         }
 
-        auto* entry = TRY(cache->ensure(index, const_cast<BlockBasedFileSystem&>(*this)));
-        if (!entry->has_data) {
-            auto base_offset = index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-            auto nread = TRY(file_description().read(entry_data_buffer, base_offset, logical_block_size()));
-            VERIFY(nread == logical_block_size());
-            entry->has_data = true;
+        auto* entry = cache->get(index);
+        if (entry && entry->has_data) {
+            ++cache->statistics().hits;
+            track_read_for_read_ahead(index, false);
+        } else {
+            ++cache->statistics().misses;
+            if (!entry)
+                entry = TRY(cache->ensure(index, const_cast<BlockBasedFileSystem&>(*this)));
+            TRY(fill_cache(*cache, index, track_read_for_read_ahead(index, true)));
         }
         if (buffer)
             TRY(buffer->write(entry->data + offset, count));
@@ -246,6 +388,64 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     });
 }
 
+ErrorOr<void> BlockBasedFileSystem::fill_cache(DiskCache& cache, BlockIndex first_block, size_t block_count) const
+{
+    auto& fs = const_cast<BlockBasedFileSystem&>(*this);
+    // Don't read past the end of the stripe, the blocks after it belong to another shard.
+    auto blocks_until_end_of_stripe = m_cache_stripe_size_in_blocks - first_block.value() % m_cache_stripe_size_in_blocks;
+    block_count = clamp(block_count, 1uz, min(blocks_until_end_of_stripe, cache.cluster_capacity_in_blocks()));
+
+    // Only read up to the next block we already have, so everything can be fetched with a single contiguous request.
+    size_t run_length = 1;
+    for (; run_length < block_count; ++run_length) {
+        auto* entry = cache.find(BlockIndex { first_block.value() + run_length });
+        if (entry && entry->has_data)
+            break;
+    }
+
+    auto find_or_create_entry = [&](BlockIndex block_index) -> ErrorOr<CacheEntry*> {
+        if (auto* entry = cache.find(block_index))
+            return entry;
+        return cache.ensure(block_index, fs);
+    };
+
+    if (run_length == 1) {
+        auto* entry = TRY(find_or_create_entry(first_block));
+        auto base_offset = first_block.value() * logical_block_size();
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
+        auto nread = TRY(file_description().read(entry_data_buffer, base_offset, logical_block_size()));
+        VERIFY(nread == logical_block_size());
+        entry->has_data = true;
+        return {};
+    }
+
+    dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::fill_cache {}, count={}", first_block, run_length);
+
+    // NOTE: Allocate all entries up front, as ensure() may have to flush writes, which clobbers the cluster buffer.
+    for (size_t i = 0; i < run_length; ++i)
+        TRY(find_or_create_entry(BlockIndex { first_block.value() + i }));
+
+    auto base_offset = first_block.value() * logical_block_size();
+    auto cluster_buffer = UserOrKernelBuffer::for_kernel_buffer(cache.cluster_buffer());
+    auto nread = TRY(file_description().read(cluster_buffer, base_offset, run_length * logical_block_size()));
+    // Read-ahead may run past the end of the device, but the block that was actually asked for has to be there.
+    auto blocks_read = nread / logical_block_size();
+    VERIFY(blocks_read >= 1);
+
+    for (size_t i = 0; i < blocks_read; ++i) {
+        auto* entry = cache.find(BlockIndex { first_block.value() + i });
+        if (!entry || entry->has_data)
+            continue;
+        memcpy(entry->data, cache.cluster_buffer() + i * logical_block_size(), logical_block_size());
+        entry->has_data = true;
+        if (i != 0) {
+            entry->is_read_ahead = true;
+            ++cache.statistics().read_ahead_blocks;
+        }
+    }
+    return {};
+}
+
 ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count, UserOrKernelBuffer& buffer, bool allow_cache) const
 {
     VERIFY(m_device_block_size);
@@ -253,9 +453,28 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
         return EINVAL;
     if (count == 1)
         return read_block(index, &buffer, logical_block_size(), 0, allow_cache);
+    if (!allow_cache) {
+        // Write out any dirty cached copies first, then fetch all blocks with a single device request.
+        for (unsigned i = 0; i < count; ++i)
+            const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(BlockIndex { index.value() + i });
+        auto nread = TRY(file_description().read(buffer, index.value() * logical_block_size(), count * logical_block_size()));
+        VERIFY(nread == count * logical_block_size());
+        return {};
+    }
+
+    // Fetch whatever isn't cached yet with as few device requests as possible before copying the blocks out.
+    for (unsigned i = 0; i < count; ++i) {
+        BlockIndex block_index { index.value() + i };
+        TRY(cache_shard_for(block_index).with_exclusive([&](auto& cache) -> ErrorOr<void> {
+            auto* entry = cache->find(block_index);
+            if (entry && entry->has_data)
+                return {};
+            return fill_cache(*cache, block_index, count - i);
+        }));
+    }
     auto out = buffer;
     for (unsigned i = 0; i < count; ++i) {
-        TRY(read_block(BlockIndex { index.value() + i }, &out, logical_block_size(), 0, allow_cache));
+        TRY(read_block(BlockIndex { index.value() + i }, &out, logical_block_size()));
         out = out.offset(logical_block_size());
     }
 
@@ -264,10 +483,10 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
 
 void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
 {
-    m_cache.with_exclusive([&](auto& cache) {
+    cache_shard_for(index).with_exclusive([&](auto& cache) {
         if (!cache->is_dirty())
             return;
-        auto* entry = cache->get(index);
+        auto* entry = cache->find(index);
         if (!entry)
             return;
         if (!cache->entry_is_dirty(*entry))
@@ -278,21 +497,74 @@ void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
     });
 }
 
+BlockBasedFileSystem::FlushResult BlockBasedFileSystem::flush_cache_shard(DiskCache& cache)
+{
+    FlushResult result;
+    if (!cache.is_dirty())
+        return result;
+
+    auto write_entry = [&](CacheEntry& entry) {
+        auto base_offset = entry.block_index.value() * logical_block_size();
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+        [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, logical_block_size());
+        ++result.block_count;
+        ++result.request_count;
+    };
+
+    Vector<CacheEntry*> dirty_entries;
+    bool collected_all_entries = true;
+    cache.for_each_dirty_entry([&](CacheEntry& entry) {
+        if (dirty_entries.try_append(&entry).is_error())
+            collected_all_entries = false;
+    });
+
+    if (!collected_all_entries) {
+        // We couldn't sort the dirty blocks, so just write them out one by one.
+        cache.for_each_dirty_entry(write_entry);
+    } else {
+        // Write adjacent dirty blocks with a single request.
+        quick_sort(dirty_entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+        for (size_t i = 0; i < dirty_entries.size();) {
+            auto& first_entry = *dirty_entries[i];
+            size_t run_length = 1;
+            while (i + run_length < dirty_entries.size()
+                && run_length < cache.cluster_capacity_in_blocks()
+                && dirty_entries[i + run_length]->block_index.value() == first_entry.block_index.value() + run_length)
+                ++run_length;
+
+            if (run_length == 1) {
+                write_entry(first_entry);
+            } else {
+                for (size_t j = 0; j < run_length; ++j)
+                    memcpy(cache.cluster_buffer() + j * logical_block_size(), dirty_entries[i + j]->data, logical_block_size());
+                auto base_offset = first_entry.block_index.value() * logical_block_size();
+                auto cluster_buffer = UserOrKernelBuffer::for_kernel_buffer(cache.cluster_buffer());
+                [[maybe_unused]] auto rc = file_description().write(base_offset, cluster_buffer, run_length * logical_block_size());
+                result.block_count += run_length;
+                ++result.request_count;
+            }
+            i += run_length;
+        }
+    }
+
+    cache.mark_all_clean();
+    return result;
+}
+
 void BlockBasedFileSystem::flush_writes_impl()
 {
-    size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, logical_block_size());
-            ++count;
+    FlushResult total;
+    for (auto& shard : m_cache_shards) {
+        shard.with_exclusive([&](auto& cache) {
+            if (!cache)
+                return;
+            auto result = flush_cache_shard(*cache);
+            total.block_count += result.block_count;
+            total.request_count += result.request_count;
         });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
-    });
+    }
+    if (total.block_count > 0)
+        dbgln("{}: Flushed {} blocks to disk in {} requests", class_name(), total.block_count, total.request_count);
 }
 
 ErrorOr<void> BlockBasedFileSystem::flush_writes()
@@ -6,22 +6,41 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Locking/SpinlockProtected.h>
 
 namespace Kernel {
 
 class BlockBasedFileSystem : public FileBackedFileSystem {
+    friend class DiskCache;
+
 public:
     AK_TYPEDEF_DISTINCT_ORDERED_ID(u64, BlockIndex);
 
+    // The block cache is split into this many independently locked shards.
+    static constexpr size_t cache_shard_count = 8;
+
+    struct CacheStatistics {
+        u64 hits { 0 };
+        u64 misses { 0 };
+        u64 evictions { 0 };
+        u64 read_ahead_blocks { 0 };
+    };
+
     virtual ~BlockBasedFileSystem() override;
 
+    virtual bool is_block_based() const override { return true; }
+    virtual bool supports_page_cache() const override { return true; }
+
     u64 device_block_size() const { return m_device_block_size; }
 
     virtual ErrorOr<void> flush_writes() override;
     void flush_writes_impl();
 
+    CacheStatistics cache_statistics() const;
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
@@ -36,15 +55,53 @@ protected:
     ErrorOr<void> raw_read_blocks(BlockIndex index, size_t count, UserOrKernelBuffer&);
     ErrorOr<void> raw_write_blocks(BlockIndex index, size_t count, UserOrKernelBuffer const&);
 
-    ErrorOr<void> write_block(BlockIndex, UserOrKernelBuffer const&, size_t count, u64 offset = 0, bool allow_cache = true);
+    // Blocks written without `keep_after_flush` only stay cached until they have been written back to the device.
+    // This is meant for file contents that the page cache already keeps a copy of.
+    ErrorOr<void> write_block(BlockIndex, UserOrKernelBuffer const&, size_t count, u64 offset = 0, bool allow_cache = true, bool keep_after_flush = true);
     ErrorOr<void> write_blocks(BlockIndex, unsigned count, UserOrKernelBuffer const&, bool allow_cache = true);
 
     u64 m_device_block_size { 512 };
 
 private:
+    // Upper bound for a single device request issued by read-ahead or write-back clustering.
+    static constexpr size_t maximum_cluster_size = 128 * KiB;
+    // Read-ahead starts with this many blocks once a sequential access pattern is detected,
+    // and doubles with every further sequential miss until it reaches maximum_cluster_size.
+    static constexpr size_t initial_read_ahead_blocks = 4;
+    // How many sequential readers are tracked at once, so they don't reset each other's read-ahead window.
+    static constexpr size_t read_ahead_stream_count = 8;
+
+    struct ReadAheadStream {
+        u64 next_block { 0 };
+        size_t window { 0 };
+        u64 last_used { 0 };
+    };
+
+    struct ReadAheadStreams {
+        Array<ReadAheadStream, read_ahead_stream_count> streams;
+        u64 access_count { 0 };
+    };
+
+    struct FlushResult {
+        size_t block_count { 0 };
+        size_t request_count { 0 };
+    };
+
     void flush_specific_block_if_needed(BlockIndex index);
+    FlushResult flush_cache_shard(DiskCache&);
+
+    MutexProtected<OwnPtr<DiskCache>>& cache_shard_for(BlockIndex) const;
+
+    // Reads `block_index` and up to `block_count - 1` following blocks into the cache with one device request.
+    ErrorOr<void> fill_cache(DiskCache&, BlockIndex block_index, size_t block_count) const;
+    // Records a read of `index` and returns how many blocks (including `index` itself) should be fetched
+    // if it missed the cache.
+    size_t track_read_for_read_ahead(BlockIndex index, bool is_miss) const;
+
+    mutable Array<MutexProtected<OwnPtr<DiskCache>>, cache_shard_count> m_cache_shards;
+    size_t m_cache_stripe_size_in_blocks { 1 };
 
-    mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
+    mutable SpinlockProtected<ReadAheadStreams, LockRank::None> m_read_ahead_streams {};
 };
 
 }
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+ErrorOr<NonnullRefPtr<EPoll>> EPoll::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EPoll);
+}
+
+EPoll::~EPoll()
+{
+    (void)close();
+}
+
+bool EPoll::can_read(OpenFileDescription const&, u64) const
+{
+    return m_ready_list.with([](auto const& ready_list) { return !ready_list.is_empty(); });
+}
+
+ErrorOr<void> EPoll::close()
+{
+    m_watches.with_exclusive([this](auto& watches) {
+        for (auto& entry : watches)
+            remove_watch_from_file(*entry.value);
+        watches.clear();
+    });
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EPoll::pseudo_path(OpenFileDescription const&) const
+{
+    return m_watches.with_shared([](auto const& watches) {
+        return KString::formatted("EPoll:({})", watches.size());
+    });
+}
+
+ErrorOr<void> EPoll::add_watch(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    // FIXME: Support nesting, which requires detecting cycles.
+    if (description.is_epoll())
+        return EINVAL;
+
+    return m_watches.with_exclusive([&](auto& watches) -> ErrorOr<void> {
+        if (auto it = watches.find(fd); it != watches.end()) {
+            if (it->value->description.ptr() == &description)
+                return EEXIST;
+            // The fd we were watching has been closed and its number was reused since.
+            remove_watch_from_file(*it->value);
+            watches.remove(it);
+        }
+
+        auto watch = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Watch(*this, description, event)));
+        auto& watch_ref = *watch;
+        TRY(watches.try_set(fd, move(watch)));
+        description.blocker_set().add_observer(watch_ref);
+
+        // The file might be ready already, which the next wait will find out.
+        mark_ready(watch_ref);
+        return {};
+    });
+}
+
+ErrorOr<void> EPoll::modify_watch(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    return m_watches.with_exclusive([&](auto& watches) -> ErrorOr<void> {
+        auto it = watches.find(fd);
+        if (it == watches.end() || it->value->description.ptr() != &description)
+            return ENOENT;
+
+        auto& watch = *it->value;
+        watch.event = event;
+        watch.is_disarmed = false;
+        mark_ready(watch);
+        return {};
+    });
+}
+
+ErrorOr<void> EPoll::remove_watch(int fd)
+{
+    return m_watches.with_exclusive([&](auto& watches) -> ErrorOr<void> {
+        auto it = watches.find(fd);
+        if (it == watches.end())
+            return ENOENT;
+        remove_watch_from_file(*it->value);
+        watches.remove(it);
+        return {};
+    });
+}
+
+void EPoll::remove_watch_from_file(Watch& watch)
+{
+    // Once this returns, the file won't call us anymore.
+    watch.description->blocker_set().remove_observer(watch);
+    m_ready_list.with([&](auto& ready_list) {
+        if (watch.ready_list_node.is_in_list())
+            ready_list.remove(watch);
+    });
+}
+
+void EPoll::mark_ready(Watch& watch)
+{
+    bool was_added = m_ready_list.with([&](auto& ready_list) {
+        if (watch.ready_list_node.is_in_list())
+            return false;
+        ready_list.append(watch);
+        return true;
+    });
+    if (was_added)
+        evaluate_block_conditions();
+}
+
+static u32 ready_events(OpenFileDescription const& description, u32 events)
+{
+    BlockFlags block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp; // EPOLLERR and EPOLLHUP are always reported
+    if (events & EPOLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & EPOLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & EPOLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (events & EPOLLWRBAND)
+        block_flags |= BlockFlags::WritePriority;
+    if (events & EPOLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+
+    auto unblocked_flags = description.should_unblock(block_flags);
+
+    u32 ready_events = 0;
+    if (has_flag(unblocked_flags, BlockFlags::WriteHangUp))
+        ready_events |= EPOLLHUP;
+    if (has_flag(unblocked_flags, BlockFlags::WriteError))
+        ready_events |= EPOLLERR;
+    if (has_flag(unblocked_flags, BlockFlags::Read))
+        ready_events |= EPOLLIN;
+    if (has_flag(unblocked_flags, BlockFlags::ReadPriority))
+        ready_events |= EPOLLPRI;
+    if (!has_flag(unblocked_flags, BlockFlags::WriteHangUp) && has_flag(unblocked_flags, BlockFlags::Write))
+        ready_events |= EPOLLOUT;
+    if (has_flag(unblocked_flags, BlockFlags::WritePriority))
+        ready_events |= EPOLLWRBAND;
+    if (has_flag(unblocked_flags, BlockFlags::ReadHangUp))
+        ready_events |= EPOLLRDHUP;
+    return ready_events;
+}
+
+size_t EPoll::collect_ready_events(Span<epoll_event> events)
+{
+    return m_watches.with_exclusive([&](auto&) {
+        // NOTE: We check the watches with the ready list locked, so a file that changes its state in the meantime
+        //       can't slip through the cracks: It'll either be seen by us, or put back onto the list afterwards.
+        return m_ready_list.with([&](auto& ready_list) {
+            size_t event_count = 0;
+            ReadyList still_ready;
+            while (event_count < events.size() && !ready_list.is_empty()) {
+                auto& watch = *ready_list.take_first();
+                if (watch.is_disarmed)
+                    continue;
+                // Files that turn out not to be ready anymore drop off the list until their state changes again.
+                auto watch_events = ready_events(watch.description, watch.event.events);
+                if (watch_events == 0)
+                    continue;
+
+                events[event_count++] = { watch_events, watch.event.data };
+
+                if (watch.event.events & EPOLLONESHOT)
+                    watch.is_disarmed = true;
+                else if (!(watch.event.events & EPOLLET))
+                    still_ready.append(watch); // Level-triggered watches keep reporting until they aren't ready anymore.
+            }
+            while (!still_ready.is_empty())
+                ready_list.append(*still_ready.take_first());
+            return event_count;
+        });
+    });
+}
+
+}
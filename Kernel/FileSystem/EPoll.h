@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// The kernel side of epoll(7): Unlike poll(), the interest list is set up once and the files on it tell us when their
+// state changes. Those end up on a ready list, so waiting for events only ever looks at files that might actually be ready.
+class EPoll final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<EPoll>> try_create();
+    virtual ~EPoll() override;
+
+    // Readable means there might be events to collect.
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> close() override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EPoll"sv; }
+    virtual bool is_epoll() const override { return true; }
+
+    ErrorOr<void> add_watch(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> modify_watch(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> remove_watch(int fd);
+
+    // Fills in events for up to events.size() ready files and returns how many there were, without blocking.
+    size_t collect_ready_events(Span<epoll_event> events);
+
+private:
+    EPoll() = default;
+
+    struct Watch final : public FileStateObserver {
+        Watch(EPoll& epoll, NonnullRefPtr<OpenFileDescription> description, epoll_event const& event)
+            : epoll(epoll)
+            , description(move(description))
+            , event(event)
+        {
+        }
+
+        virtual void file_state_changed() override { epoll.mark_ready(*this); }
+
+        EPoll& epoll;
+        // NOTE: We hold on to the description until the watch is removed, even if the fd gets closed in the meantime.
+        NonnullRefPtr<OpenFileDescription> description;
+        epoll_event event;
+        // Set for EPOLLONESHOT watches once they reported an event, until they're re-armed with EPOLL_CTL_MOD.
+        bool is_disarmed { false };
+
+        IntrusiveListNode<Watch> ready_list_node;
+    };
+
+    void mark_ready(Watch&);
+    void remove_watch_from_file(Watch&);
+
+    using ReadyList = IntrusiveList<&Watch::ready_list_node>;
+
+    MutexProtected<HashMap<int, NonnullOwnPtr<Watch>>> m_watches;
+    SpinlockProtected<ReadyList, LockRank::None> m_ready_list {};
+};
+
+}
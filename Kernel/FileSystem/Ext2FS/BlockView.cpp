@@ -37,6 +37,14 @@ ErrorOr<void> Ext2FSBlockView::ensure_block(BlockBasedFileSystem::BlockIndex blo
 
 ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSBlockView::get_block(BlockBasedFileSystem::BlockIndex block)
 {
+    if (m_inode.uses_extents()) {
+        auto mapping = TRY(m_inode.m_extent_tree.lookup(block));
+        // Unwritten blocks have to read as zeroes, so treat them like holes.
+        if (!mapping.has_value() || mapping->is_unwritten)
+            return BlockBasedFileSystem::BlockIndex { 0 };
+        return mapping->physical_block;
+    }
+
     MutexLocker block_list_locker(m_block_list_lock);
     TRY(ensure_block(block));
 
@@ -49,8 +57,20 @@ ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSBlockView::get_block(BlockBasedF
     return on_disk_block;
 }
 
-ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSBlockView::get_or_allocate_block(BlockBasedFileSystem::BlockIndex block, bool zero_newly_allocated_block, bool allow_cache)
+ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSBlockView::get_or_allocate_block(BlockBasedFileSystem::BlockIndex block, size_t run_length_hint, bool zero_newly_allocated_block, bool allow_cache)
 {
+    if (m_inode.uses_extents()) {
+        auto mapping = TRY(m_inode.m_extent_tree.lookup(block));
+        if (mapping.has_value()) {
+            // The block is about to be written, so whatever isn't overwritten must not show its stale contents anymore.
+            if (mapping->is_unwritten && zero_newly_allocated_block)
+                TRY(m_inode.zero_block(mapping->physical_block, allow_cache));
+            return mapping->physical_block;
+        }
+        auto goal = TRY(m_inode.m_extent_tree.allocation_goal(block));
+        return m_inode.allocate_block(block, goal, run_length_hint, zero_newly_allocated_block, allow_cache);
+    }
+
     MutexLocker block_list_locker(m_block_list_lock);
     TRY(ensure_block(block));
 
@@ -61,7 +81,14 @@ ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSBlockView::get_or_allocate_block
         return on_disk_block;
     }
 
-    auto on_disk_block = TRY(m_inode.allocate_block(block, zero_newly_allocated_block, allow_cache));
+    // Try to place the block right after the previous one.
+    BlockBasedFileSystem::BlockIndex goal = 0;
+    if (block != 0) {
+        if (auto previous_block = m_block_list.get(block.value() - 1); previous_block.has_value())
+            goal = previous_block->value() + 1;
+    }
+
+    auto on_disk_block = TRY(m_inode.allocate_block(block, goal, run_length_hint, zero_newly_allocated_block, allow_cache));
     TRY(m_block_list.try_set(block, on_disk_block));
 
     return on_disk_block;
@@ -69,6 +96,12 @@ ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSBlockView::get_or_allocate_block
 
 ErrorOr<void> Ext2FSBlockView::write_block_pointer(BlockBasedFileSystem::BlockIndex logical_block_index, BlockBasedFileSystem::BlockIndex on_disk_index)
 {
+    if (m_inode.uses_extents()) {
+        if (on_disk_index == 0)
+            return m_inode.m_extent_tree.unmap(logical_block_index, 1);
+        return m_inode.m_extent_tree.map(logical_block_index, on_disk_index, 1);
+    }
+
     MutexLocker block_list_locker(m_block_list_lock);
 
     TRY(m_inode.write_block_pointer(logical_block_index, on_disk_index));
@@ -208,6 +208,40 @@ struct ext2_dx_countlimit {
     __u16 count;
 };
 
+/*
+ * Extent tree (ext4)
+ */
+#define EXT4_EXT_MAGIC 0xf30a
+#define EXT4_EXT_MAX_DEPTH 5
+/* Extents longer than this are unwritten, and their actual length is ee_len - EXT4_EXT_INIT_MAX_LEN */
+#define EXT4_EXT_INIT_MAX_LEN (1u << 15)
+#define EXT4_EXT_UNWRITTEN_MAX_LEN (EXT4_EXT_INIT_MAX_LEN - 1)
+
+/* Starts every node of the tree, including the root stored in i_block */
+struct ext4_extent_header {
+    __u16 eh_magic;      /* EXT4_EXT_MAGIC */
+    __u16 eh_entries;    /* Number of valid entries following the header */
+    __u16 eh_max;        /* Capacity of the node in entries */
+    __u16 eh_depth;      /* 0 for leaves, otherwise the number of index levels below */
+    __u32 eh_generation; /* Generation of the tree */
+};
+
+/* Leaf entry, maps ee_len blocks starting at ee_block */
+struct ext4_extent {
+    __u32 ee_block;    /* First logical block */
+    __u16 ee_len;      /* Number of blocks */
+    __u16 ee_start_hi; /* High 16 bits of the first physical block */
+    __u32 ee_start_lo; /* Low 32 bits of the first physical block */
+};
+
+/* Index entry, points to the node covering the logical blocks from ei_block on */
+struct ext4_extent_idx {
+    __u32 ei_block;   /* First logical block covered by the node */
+    __u32 ei_leaf_lo; /* Low 32 bits of the node's physical block */
+    __u16 ei_leaf_hi; /* High 16 bits of the node's physical block */
+    __u16 ei_unused;
+};
+
 /*
  * Macro-instructions used to manage group descriptors
  */
@@ -641,7 +675,7 @@ struct ext2_super_block {
 #define EXT4_FEATURE_INCOMPAT_FLEX_BG 0x0200
 
 #define EXT2_FEATURE_COMPAT_SUPP 0
-#define EXT2_FEATURE_INCOMPAT_SUPP (EXT2_FEATURE_INCOMPAT_FILETYPE)
+#define EXT2_FEATURE_INCOMPAT_SUPP (EXT2_FEATURE_INCOMPAT_FILETYPE | EXT3_FEATURE_INCOMPAT_EXTENTS)
 #define EXT2_FEATURE_RO_COMPAT_SUPP (EXT2_FEATURE_RO_COMPAT_SPARSE_SUPER | EXT2_FEATURE_RO_COMPAT_LARGE_FILE | EXT4_FEATURE_RO_COMPAT_DIR_NLINK | EXT2_FEATURE_RO_COMPAT_BTREE_DIR)
 
 /*
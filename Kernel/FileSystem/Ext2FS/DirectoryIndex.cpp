@@ -0,0 +1,726 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryIndex.h>
+#include <Kernel/FileSystem/Ext2FS/Inode.h>
+
+namespace Kernel {
+
+static_assert(sizeof(ext2_dx_root_info) == 8);
+static_assert(sizeof(ext2_dx_entry) == 8);
+static_assert(sizeof(ext2_dx_countlimit) == 4);
+
+// The "." and ".." entries at the start of the root block, followed by the root info.
+static constexpr size_t dot_entry_length = 12;
+static constexpr size_t root_info_offset = 2 * dot_entry_length;
+// Index blocks below the root start with an empty directory entry spanning the whole block.
+static constexpr size_t node_entries_offset = 8;
+
+// Without the largedir feature, there is at most one level of index nodes between the root and the leaves, with it two.
+// We can read both, but only grow indexes up to the former.
+static constexpr size_t max_indirect_levels_for_reading = 2;
+static constexpr size_t max_indirect_levels_for_writing = 1;
+
+// The lowest bit of a hash in the index is used to mark a leaf that continues a run of equal hashes from the one before.
+static constexpr u32 hash_continuation_bit = 1;
+
+static constexpr u32 htree_eof_32bit = 0x7fffffff;
+
+// The name hashes below have to match what the other implementations of ext2/3/4 compute bit for bit, since they
+// determine where an entry is stored. They are adapted from e2fsprogs' lib/ext2fs/dirhash.c.
+
+static u32 rotate_left(u32 value, unsigned shift)
+{
+    return (value << shift) | (value >> (32 - shift));
+}
+
+template<typename CharType>
+static u32 legacy_hash(ReadonlyBytes name)
+{
+    u32 hash0 = 0x12a3fe2d;
+    u32 hash1 = 0x37abe8f9;
+    for (auto byte : name) {
+        u32 hash = hash1 + (hash0 ^ static_cast<u32>(static_cast<int>(static_cast<CharType>(byte)) * 7152373));
+        if (hash & 0x80000000)
+            hash -= 0x7fffffff;
+        hash1 = hash0;
+        hash0 = hash;
+    }
+    return hash0 << 1;
+}
+
+// Packs up to `count` words worth of the name into `words`, padding with a value derived from the name's length.
+template<typename CharType>
+static void name_to_hash_words(ReadonlyBytes name, u32* words, int count)
+{
+    u32 pad = static_cast<u32>(name.size()) | (static_cast<u32>(name.size()) << 8);
+    pad |= pad << 16;
+
+    u32 value = pad;
+    auto length = min(name.size(), static_cast<size_t>(count) * 4);
+    for (size_t i = 0; i < length; ++i) {
+        value = static_cast<u32>(static_cast<int>(static_cast<CharType>(name[i]))) + (value << 8);
+        if ((i % 4) == 3) {
+            *words++ = value;
+            value = pad;
+            --count;
+        }
+    }
+    if (--count >= 0)
+        *words++ = value;
+    while (--count >= 0)
+        *words++ = pad;
+}
+
+static void tea_transform(u32 buffer[4], u32 const input[4])
+{
+    u32 sum = 0;
+    u32 b0 = buffer[0];
+    u32 b1 = buffer[1];
+    u32 a = input[0], b = input[1], c = input[2], d = input[3];
+    for (int n = 0; n < 16; ++n) {
+        sum += 0x9e3779b9;
+        b0 += ((b1 << 4) + a) ^ (b1 + sum) ^ ((b1 >> 5) + b);
+        b1 += ((b0 << 4) + c) ^ (b0 + sum) ^ ((b0 >> 5) + d);
+    }
+    buffer[0] += b0;
+    buffer[1] += b1;
+}
+
+static void half_md4_transform(u32 buffer[4], u32 const input[8])
+{
+    auto f = [](u32 x, u32 y, u32 z) { return z ^ (x & (y ^ z)); };
+    auto g = [](u32 x, u32 y, u32 z) { return (x & y) + ((x ^ y) & z); };
+    auto h = [](u32 x, u32 y, u32 z) { return x ^ y ^ z; };
+    auto round = [](auto function, u32& a, u32 b, u32 c, u32 d, u32 x, unsigned shift) {
+        a = rotate_left(a + function(b, c, d) + x, shift);
+    };
+    static constexpr u32 k1 = 0;
+    static constexpr u32 k2 = 013240474631;
+    static constexpr u32 k3 = 015666365641;
+
+    u32 a = buffer[0], b = buffer[1], c = buffer[2], d = buffer[3];
+
+    round(f, a, b, c, d, input[0] + k1, 3);
+    round(f, d, a, b, c, input[1] + k1, 7);
+    round(f, c, d, a, b, input[2] + k1, 11);
+    round(f, b, c, d, a, input[3] + k1, 19);
+    round(f, a, b, c, d, input[4] + k1, 3);
+    round(f, d, a, b, c, input[5] + k1, 7);
+    round(f, c, d, a, b, input[6] + k1, 11);
+    round(f, b, c, d, a, input[7] + k1, 19);
+
+    round(g, a, b, c, d, input[1] + k2, 3);
+    round(g, d, a, b, c, input[3] + k2, 5);
+    round(g, c, d, a, b, input[5] + k2, 9);
+    round(g, b, c, d, a, input[7] + k2, 13);
+    round(g, a, b, c, d, input[0] + k2, 3);
+    round(g, d, a, b, c, input[2] + k2, 5);
+    round(g, c, d, a, b, input[4] + k2, 9);
+    round(g, b, c, d, a, input[6] + k2, 13);
+
+    round(h, a, b, c, d, input[3] + k3, 3);
+    round(h, d, a, b, c, input[7] + k3, 9);
+    round(h, c, d, a, b, input[2] + k3, 11);
+    round(h, b, c, d, a, input[6] + k3, 15);
+    round(h, a, b, c, d, input[1] + k3, 3);
+    round(h, d, a, b, c, input[5] + k3, 9);
+    round(h, c, d, a, b, input[0] + k3, 11);
+    round(h, b, c, d, a, input[4] + k3, 15);
+
+    buffer[0] += a;
+    buffer[1] += b;
+    buffer[2] += c;
+    buffer[3] += d;
+}
+
+template<typename CharType>
+static u32 block_hash(ReadonlyBytes name, u8 hash_version, u32 const seed[4])
+{
+    u32 buffer[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+    if (seed[0] || seed[1] || seed[2] || seed[3])
+        memcpy(buffer, seed, sizeof(buffer));
+
+    u32 input[8];
+    if (hash_version == EXT2_HASH_TEA) {
+        for (size_t offset = 0; offset < name.size(); offset += 16) {
+            name_to_hash_words<CharType>(name.slice(min(offset, name.size())), input, 4);
+            tea_transform(buffer, input);
+        }
+        return buffer[0];
+    }
+
+    for (size_t offset = 0; offset < name.size(); offset += 32) {
+        name_to_hash_words<CharType>(name.slice(min(offset, name.size())), input, 8);
+        half_md4_transform(buffer, input);
+    }
+    return buffer[1];
+}
+
+static u32 compute_name_hash(ReadonlyBytes name, u8 hash_version, u32 const seed[4])
+{
+    u32 hash = 0;
+    switch (hash_version) {
+    case EXT2_HASH_LEGACY:
+        hash = legacy_hash<i8>(name);
+        break;
+    case EXT2_HASH_LEGACY_UNSIGNED:
+        hash = legacy_hash<u8>(name);
+        break;
+    case EXT2_HASH_HALF_MD4:
+    case EXT2_HASH_TEA:
+        hash = block_hash<i8>(name, hash_version, seed);
+        break;
+    case EXT2_HASH_HALF_MD4_UNSIGNED:
+        hash = block_hash<u8>(name, EXT2_HASH_HALF_MD4, seed);
+        break;
+    case EXT2_HASH_TEA_UNSIGNED:
+        hash = block_hash<u8>(name, EXT2_HASH_TEA, seed);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    hash &= ~hash_continuation_bit;
+    if (hash == (htree_eof_32bit << 1))
+        hash = (htree_eof_32bit - 1) << 1;
+    return hash;
+}
+
+// Calls `callback` for every directory entry in a leaf block, after checking that it doesn't reach outside the block.
+template<typename Callback>
+static ErrorOr<void> for_each_entry_in_block(Bytes block, Callback callback)
+{
+    size_t offset = 0;
+    while (offset < block.size()) {
+        if (offset + 8 > block.size())
+            return EIO;
+        auto& entry = *bit_cast<ext2_dir_entry_2*>(block.offset_pointer(offset));
+        if (entry.rec_len < 8 || entry.rec_len % EXT2_DIR_PAD != 0 || offset + entry.rec_len > block.size() || entry.name_len + 8u > entry.rec_len)
+            return EIO;
+        if (callback(entry) == IterationDecision::Break)
+            return {};
+        offset += entry.rec_len;
+    }
+    return {};
+}
+
+static void write_entry(ext2_dir_entry_2& entry, StringView name, u32 inode, u8 file_type, u16 record_length)
+{
+    entry.inode = inode;
+    entry.rec_len = record_length;
+    entry.name_len = name.length();
+    entry.file_type = file_type;
+    if (!name.is_empty())
+        memcpy(entry.name, name.characters_without_null_termination(), name.length());
+}
+
+// Packs the entries at the start of the block, and lets the last one take up the rest of it.
+template<typename Entries>
+static void write_leaf_entries_to_block(Bytes block, Entries const& entries)
+{
+    block.fill(0);
+    if (entries.is_empty()) {
+        write_entry(*bit_cast<ext2_dir_entry_2*>(block.data()), {}, 0, 0, block.size());
+        return;
+    }
+    size_t offset = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto const& entry = entries[i];
+        size_t record_length = i + 1 == entries.size() ? block.size() - offset : EXT2_DIR_REC_LEN(entry.name.length());
+        write_entry(*bit_cast<ext2_dir_entry_2*>(block.offset_pointer(offset)), entry.name, entry.inode, entry.file_type, record_length);
+        offset += record_length;
+    }
+}
+
+Ext2FSDirectoryIndex::Ext2FSDirectoryIndex(Ext2FSInode& inode)
+    : m_inode(inode)
+{
+}
+
+u8 Ext2FSDirectoryIndex::hash_version(u8 on_disk_hash_version) const
+{
+    // The signedness of the characters that went into the hashes depends on the architecture that created the file
+    // system, so it's recorded in the super block rather than in every directory.
+    if (on_disk_hash_version <= EXT2_HASH_TEA && (m_inode.fs().super_block().s_flags & EXT2_FLAGS_UNSIGNED_HASH))
+        return on_disk_hash_version + EXT2_HASH_LEGACY_UNSIGNED;
+    return on_disk_hash_version;
+}
+
+u32 Ext2FSDirectoryIndex::hash(StringView name, u8 hash_version) const
+{
+    return compute_name_hash(name.bytes(), hash_version, m_inode.fs().super_block().s_hash_seed);
+}
+
+ErrorOr<ByteBuffer> Ext2FSDirectoryIndex::read_directory_block(u32 block)
+{
+    auto const block_size = m_inode.fs().logical_block_size();
+    if ((static_cast<u64>(block) + 1) * block_size > m_inode.size()) {
+        dmesgln("Ext2FSDirectoryIndex[{}]: Index points to block {} past the end of the directory", m_inode.identifier(), block);
+        return EIO;
+    }
+    auto data = TRY(ByteBuffer::create_uninitialized(block_size));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(data.data());
+    auto nread = TRY(m_inode.read_bytes_locked(static_cast<u64>(block) * block_size, block_size, buffer, nullptr));
+    if (nread != block_size)
+        return EIO;
+    return data;
+}
+
+ErrorOr<void> Ext2FSDirectoryIndex::write_directory_block(u32 block, ByteBuffer const& data)
+{
+    auto const block_size = m_inode.fs().logical_block_size();
+    VERIFY(data.size() == block_size);
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data.data()));
+    auto nwritten = TRY(m_inode.prepare_and_write_bytes_locked(static_cast<u64>(block) * block_size, block_size, buffer, nullptr));
+    if (nwritten != block_size)
+        return EIO;
+    return {};
+}
+
+ErrorOr<u32> Ext2FSDirectoryIndex::append_directory_block(ByteBuffer const& data)
+{
+    auto const block_size = m_inode.fs().logical_block_size();
+    u64 block = ceil_div(m_inode.size(), static_cast<u64>(block_size));
+    if (block > NumericLimits<u32>::max())
+        return ENOSPC;
+    TRY(write_directory_block(block, data));
+    return static_cast<u32>(block);
+}
+
+ErrorOr<Ext2FSDirectoryIndex::Path> Ext2FSDirectoryIndex::probe(StringView name, u32& name_hash, u8& directory_hash_version)
+{
+    auto const block_size = m_inode.fs().logical_block_size();
+    auto root = TRY(read_directory_block(0));
+    auto const& info = *bit_cast<ext2_dx_root_info const*>(root.offset_pointer(root_info_offset));
+    if (info.reserved_zero != 0 || info.hash_version > EXT2_HASH_TEA || info.info_length != sizeof(ext2_dx_root_info) || info.indirect_levels > max_indirect_levels_for_reading) {
+        dmesgln("Ext2FSDirectoryIndex[{}]: Unsupported index root (hash version {}, info length {}, {} levels)", m_inode.identifier(), info.hash_version, info.info_length, info.indirect_levels);
+        return EIO;
+    }
+    directory_hash_version = hash_version(info.hash_version);
+    name_hash = hash(name, directory_hash_version);
+    size_t levels = info.indirect_levels + 1;
+
+    Path path;
+    path.unchecked_append({ .block = 0, .data = move(root), .entries_offset = root_info_offset + sizeof(ext2_dx_root_info), .at = 0 });
+    while (true) {
+        auto& frame = path.last();
+        auto const& limits = *bit_cast<ext2_dx_countlimit const*>(frame.data.offset_pointer(frame.entries_offset));
+        auto const* entries = bit_cast<ext2_dx_entry const*>(frame.data.offset_pointer(frame.entries_offset));
+        if (limits.count == 0 || limits.count > limits.limit || limits.limit > (block_size - frame.entries_offset) / sizeof(ext2_dx_entry)) {
+            dmesgln("Ext2FSDirectoryIndex[{}]: Bad index block {} ({}/{} entries)", m_inode.identifier(), frame.block, limits.count, limits.limit);
+            return EIO;
+        }
+
+        // Find the last entry whose hash is not larger than ours. The first entry implicitly has the lowest hash.
+        size_t low = 1;
+        size_t high = limits.count;
+        while (low < high) {
+            auto middle = low + (high - low) / 2;
+            if (entries[middle].hash > name_hash)
+                high = middle;
+            else
+                low = middle + 1;
+        }
+        frame.at = low - 1;
+
+        if (path.size() == levels)
+            return path;
+
+        u32 child_block = entries[frame.at].block;
+        auto child = TRY(read_directory_block(child_block));
+        path.unchecked_append({ .block = child_block, .data = move(child), .entries_offset = node_entries_offset, .at = 0 });
+    }
+}
+
+ErrorOr<bool> Ext2FSDirectoryIndex::advance_to_next_leaf(Path& path, u32 name_hash)
+{
+    // Find the lowest level that has another entry after the one we followed.
+    size_t level = path.size();
+    while (level > 0) {
+        auto const& frame = path[level - 1];
+        auto const& limits = *bit_cast<ext2_dx_countlimit const*>(frame.data.offset_pointer(frame.entries_offset));
+        if (frame.at + 1 < limits.count)
+            break;
+        --level;
+    }
+    if (level == 0)
+        return false;
+
+    // Only if the next leaf continues with our hash could it have the entry we're looking for.
+    auto& frame = path[level - 1];
+    auto const* entries = bit_cast<ext2_dx_entry const*>(frame.data.offset_pointer(frame.entries_offset));
+    if ((entries[frame.at + 1].hash & ~hash_continuation_bit) != name_hash)
+        return false;
+
+    ++frame.at;
+    for (; level < path.size(); ++level) {
+        auto const& parent = path[level - 1];
+        u32 child_block = bit_cast<ext2_dx_entry const*>(parent.data.offset_pointer(parent.entries_offset))[parent.at].block;
+        auto child = TRY(read_directory_block(child_block));
+        path[level] = { .block = child_block, .data = move(child), .entries_offset = node_entries_offset, .at = 0 };
+    }
+    return true;
+}
+
+ErrorOr<Optional<InodeIndex>> Ext2FSDirectoryIndex::lookup(StringView name)
+{
+    VERIFY(m_inode.m_inode_lock.is_locked());
+
+    if (name == "."sv || name == ".."sv) {
+        auto root = TRY(read_directory_block(0));
+        auto const& entry = *bit_cast<ext2_dir_entry_2 const*>(root.offset_pointer(name == "."sv ? 0 : dot_entry_length));
+        return InodeIndex { entry.inode };
+    }
+
+    u32 name_hash = 0;
+    u8 directory_hash_version = 0;
+    auto path = TRY(probe(name, name_hash, directory_hash_version));
+
+    while (true) {
+        auto const& leaf_parent = path.last();
+        u32 leaf_block = bit_cast<ext2_dx_entry const*>(leaf_parent.data.offset_pointer(leaf_parent.entries_offset))[leaf_parent.at].block;
+        auto leaf = TRY(read_directory_block(leaf_block));
+
+        Optional<InodeIndex> result;
+        TRY(for_each_entry_in_block(leaf.bytes(), [&](auto& entry) {
+            if (entry.inode != 0 && StringView { entry.name, entry.name_len } == name) {
+                result = InodeIndex { entry.inode };
+                return IterationDecision::Break;
+            }
+            return IterationDecision::Continue;
+        }));
+        if (result.has_value())
+            return result;
+
+        if (!TRY(advance_to_next_leaf(path, name_hash)))
+            return Optional<InodeIndex> {};
+    }
+}
+
+ErrorOr<void> Ext2FSDirectoryIndex::insert_index_entry(Frame& frame, u32 entry_hash, u32 block)
+{
+    auto& limits = *bit_cast<ext2_dx_countlimit*>(frame.data.offset_pointer(frame.entries_offset));
+    auto* entries = bit_cast<ext2_dx_entry*>(frame.data.offset_pointer(frame.entries_offset));
+    VERIFY(limits.count < limits.limit);
+
+    auto insert_at = frame.at + 1;
+    memmove(&entries[insert_at + 1], &entries[insert_at], (limits.count - insert_at) * sizeof(ext2_dx_entry));
+    entries[insert_at] = { .hash = entry_hash, .block = block };
+    ++limits.count;
+    return write_directory_block(frame.block, frame.data);
+}
+
+ErrorOr<void> Ext2FSDirectoryIndex::split_index_node(Path& path, size_t level)
+{
+    VERIFY(level > 0);
+    auto const block_size = m_inode.fs().logical_block_size();
+    auto& node = path[level];
+    auto& limits = *bit_cast<ext2_dx_countlimit*>(node.data.offset_pointer(node.entries_offset));
+    auto* entries = bit_cast<ext2_dx_entry*>(node.data.offset_pointer(node.entries_offset));
+
+    // Move the upper half of the entries into a new node.
+    size_t kept_count = limits.count / 2;
+    size_t moved_count = limits.count - kept_count;
+    u32 split_hash = entries[kept_count].hash;
+
+    auto new_node = TRY(ByteBuffer::create_zeroed(block_size));
+    write_entry(*bit_cast<ext2_dir_entry_2*>(new_node.data()), {}, 0, 0, block_size);
+    auto* new_entries = bit_cast<ext2_dx_entry*>(new_node.offset_pointer(node_entries_offset));
+    memcpy(new_entries, &entries[kept_count], moved_count * sizeof(ext2_dx_entry));
+    auto& new_limits = *bit_cast<ext2_dx_countlimit*>(new_entries);
+    new_limits.limit = (block_size - node_entries_offset) / sizeof(ext2_dx_entry);
+    new_limits.count = moved_count;
+    auto new_block = TRY(append_directory_block(new_node));
+
+    limits.count = kept_count;
+    TRY(write_directory_block(node.block, node.data));
+    TRY(insert_index_entry(path[level - 1], split_hash, new_block));
+
+    if (node.at >= kept_count) {
+        auto at_in_new_node = node.at - kept_count;
+        path[level - 1].at++;
+        node = { .block = new_block, .data = move(new_node), .entries_offset = node_entries_offset, .at = at_in_new_node };
+    }
+    return {};
+}
+
+ErrorOr<void> Ext2FSDirectoryIndex::make_room_in_index(Path& path)
+{
+    auto is_full = [](Frame const& frame) {
+        auto const& limits = *bit_cast<ext2_dx_countlimit const*>(frame.data.offset_pointer(frame.entries_offset));
+        return limits.count >= limits.limit;
+    };
+
+    // Find the lowest level that has room for one more entry, every level below it has to be split.
+    size_t level = path.size() - 1;
+    while (level > 0 && is_full(path[level]))
+        --level;
+
+    if (level == 0 && is_full(path[0])) {
+        auto& info = *bit_cast<ext2_dx_root_info*>(path[0].data.offset_pointer(root_info_offset));
+        if (info.indirect_levels >= max_indirect_levels_for_writing) {
+            dbgln("Ext2FSDirectoryIndex[{}]: Directory index is full", m_inode.identifier());
+            return ENOSPC;
+        }
+
+        // Grow the tree by one level: the root's entries move into a new node, which becomes the root's only child.
+        auto const block_size = m_inode.fs().logical_block_size();
+        auto& root = path[0];
+        auto& root_limits = *bit_cast<ext2_dx_countlimit*>(root.data.offset_pointer(root.entries_offset));
+        auto* root_entries = bit_cast<ext2_dx_entry*>(root.data.offset_pointer(root.entries_offset));
+
+        auto new_node = TRY(ByteBuffer::create_zeroed(block_size));
+        write_entry(*bit_cast<ext2_dir_entry_2*>(new_node.data()), {}, 0, 0, block_size);
+        memcpy(new_node.offset_pointer(node_entries_offset), root_entries, root_limits.count * sizeof(ext2_dx_entry));
+        auto& new_limits = *bit_cast<ext2_dx_countlimit*>(new_node.offset_pointer(node_entries_offset));
+        new_limits.limit = (block_size - node_entries_offset) / sizeof(ext2_dx_entry);
+        new_limits.count = root_limits.count;
+        auto new_block = TRY(append_directory_block(new_node));
+
+        root_limits.count = 1;
+        root_entries[0].block = new_block;
+        ++info.indirect_levels;
+        TRY(write_directory_block(0, root.data));
+
+        auto old_root_at = root.at;
+        root.at = 0;
+        TRY(path.try_insert(1, { .block = new_block, .data = move(new_node), .entries_offset = node_entries_offset, .at = old_root_at }));
+        level = 1;
+    }
+
+    for (++level; level < path.size(); ++level)
+        TRY(split_index_node(path, level));
+    return {};
+}
+
+ErrorOr<void> Ext2FSDirectoryIndex::add_entry(StringView name, InodeIndex inode, u8 file_type)
+{
+    VERIFY(m_inode.m_inode_lock.is_exclusively_locked_by_current_thread());
+    VERIFY(name.length() <= EXT2_NAME_LEN);
+
+    u32 name_hash = 0;
+    u8 directory_hash_version = 0;
+    auto path = TRY(probe(name, name_hash, directory_hash_version));
+
+    auto leaf_block_of = [](Frame const& frame) {
+        return bit_cast<ext2_dx_entry const*>(frame.data.offset_pointer(frame.entries_offset))[frame.at].block;
+    };
+
+    auto try_insert = [&](ByteBuffer& leaf) -> ErrorOr<bool> {
+        auto needed_length = EXT2_DIR_REC_LEN(name.length());
+        bool inserted = false;
+        TRY(for_each_entry_in_block(leaf.bytes(), [&](auto& entry) {
+            size_t used_length = entry.inode != 0 ? EXT2_DIR_REC_LEN(entry.name_len) : 0;
+            if (entry.rec_len - used_length < needed_length)
+                return IterationDecision::Continue;
+            if (used_length == 0) {
+                write_entry(entry, name, inode.value(), file_type, entry.rec_len);
+            } else {
+                auto& new_entry = *bit_cast<ext2_dir_entry_2*>(bit_cast<u8*>(&entry) + used_length);
+                write_entry(new_entry, name, inode.value(), file_type, entry.rec_len - used_length);
+                entry.rec_len = used_length;
+            }
+            inserted = true;
+            return IterationDecision::Break;
+        }));
+        return inserted;
+    };
+
+    while (true) {
+        u32 leaf_block = leaf_block_of(path.last());
+        auto leaf = TRY(read_directory_block(leaf_block));
+        if (TRY(try_insert(leaf)))
+            return write_directory_block(leaf_block, leaf);
+
+        // The leaf is full, so it has to be split in two, which needs room for one more entry in the index.
+        TRY(make_room_in_index(path));
+        VERIFY(leaf_block_of(path.last()) == leaf_block);
+        TRY(split_leaf(path, leaf_block, leaf, directory_hash_version));
+
+        // Long names might not fit into their half yet, in which case that half is split again.
+        path = TRY(probe(name, name_hash, directory_hash_version));
+    }
+}
+
+ErrorOr<void> Ext2FSDirectoryIndex::split_leaf(Path& path, u32 leaf_block, ByteBuffer& leaf, u8 directory_hash_version)
+{
+    auto const block_size = m_inode.fs().logical_block_size();
+
+    // The entries keep pointing into the copy of the old leaf while both halves are rewritten.
+    auto old_leaf = TRY(ByteBuffer::copy(leaf.bytes()));
+    Vector<LeafEntry> entries;
+    TRY(entries.try_ensure_capacity(block_size / EXT2_DIR_REC_LEN(1)));
+    size_t total_length = 0;
+    TRY(for_each_entry_in_block(old_leaf.bytes(), [&](auto& entry) {
+        if (entry.inode == 0)
+            return IterationDecision::Continue;
+        StringView entry_name { entry.name, entry.name_len };
+        entries.unchecked_append({ .name = entry_name, .inode = entry.inode, .file_type = entry.file_type, .hash = hash(entry_name, directory_hash_version) });
+        total_length += EXT2_DIR_REC_LEN(entry.name_len);
+        return IterationDecision::Continue;
+    }));
+    if (entries.size() < 2)
+        return ENOSPC;
+    quick_sort(entries, [](auto const& a, auto const& b) { return a.hash < b.hash; });
+
+    // Move the upper half of the entries (by size, in hash order) into a new leaf. If the split happens within a run
+    // of equal hashes, the new leaf is marked as continuing it, so lookups know to look at both.
+    size_t kept_count = 0;
+    size_t kept_length = 0;
+    while (kept_count + 1 < entries.size() && (kept_count == 0 || kept_length < total_length / 2))
+        kept_length += EXT2_DIR_REC_LEN(entries[kept_count++].name.length());
+    u32 split_hash = entries[kept_count].hash;
+    if (split_hash == entries[kept_count - 1].hash)
+        split_hash |= hash_continuation_bit;
+
+    auto new_leaf = TRY(ByteBuffer::create_zeroed(block_size));
+    write_leaf_entries_to_block(leaf.bytes(), entries.span().slice(0, kept_count));
+    write_leaf_entries_to_block(new_leaf.bytes(), entries.span().slice(kept_count));
+
+    auto new_leaf_block = TRY(append_directory_block(new_leaf));
+    TRY(write_directory_block(leaf_block, leaf));
+    TRY(insert_index_entry(path.last(), split_hash, new_leaf_block));
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSDirectoryIndex[{}]: Split leaf {} at hash {:#08x} into new leaf {}", m_inode.identifier(), leaf_block, split_hash, new_leaf_block);
+    return {};
+}
+
+ErrorOr<void> Ext2FSDirectoryIndex::remove_entry(StringView name)
+{
+    VERIFY(m_inode.m_inode_lock.is_exclusively_locked_by_current_thread());
+
+    u32 name_hash = 0;
+    u8 directory_hash_version = 0;
+    auto path = TRY(probe(name, name_hash, directory_hash_version));
+
+    while (true) {
+        auto const& leaf_parent = path.last();
+        u32 leaf_block = bit_cast<ext2_dx_entry const*>(leaf_parent.data.offset_pointer(leaf_parent.entries_offset))[leaf_parent.at].block;
+        auto leaf = TRY(read_directory_block(leaf_block));
+
+        bool removed = false;
+        ext2_dir_entry_2* previous_entry = nullptr;
+        TRY(for_each_entry_in_block(leaf.bytes(), [&](auto& entry) {
+            if (entry.inode == 0 || StringView { entry.name, entry.name_len } != name) {
+                previous_entry = &entry;
+                return IterationDecision::Continue;
+            }
+            // Merge the entry into the one before it, or mark it as unused if it's the first one in the block.
+            if (previous_entry)
+                previous_entry->rec_len += entry.rec_len;
+            else
+                entry.inode = 0;
+            removed = true;
+            return IterationDecision::Break;
+        }));
+        if (removed)
+            return write_directory_block(leaf_block, leaf);
+
+        if (!TRY(advance_to_next_leaf(path, name_hash)))
+            return ENOENT;
+    }
+}
+
+ErrorOr<void> Ext2FSDirectoryIndex::set_parent(InodeIndex parent, u8 file_type)
+{
+    VERIFY(m_inode.m_inode_lock.is_exclusively_locked_by_current_thread());
+    auto root = TRY(read_directory_block(0));
+    auto& entry = *bit_cast<ext2_dir_entry_2*>(root.offset_pointer(dot_entry_length));
+    if (entry.name_len != 2 || StringView { entry.name, 2 } != ".."sv)
+        return EIO;
+    entry.inode = parent.value();
+    entry.file_type = file_type;
+    return write_directory_block(0, root);
+}
+
+ErrorOr<bool> Ext2FSDirectoryIndex::build(Vector<Ext2FSDirectoryEntry> const& directory_entries)
+{
+    VERIFY(m_inode.m_inode_lock.is_exclusively_locked_by_current_thread());
+    auto const block_size = m_inode.fs().logical_block_size();
+
+    u8 on_disk_hash_version = m_inode.fs().super_block().s_def_hash_version;
+    if (on_disk_hash_version > EXT2_HASH_TEA)
+        on_disk_hash_version = EXT2_HASH_HALF_MD4;
+
+    Ext2FSDirectoryEntry const* dot = nullptr;
+    Ext2FSDirectoryEntry const* dot_dot = nullptr;
+    Vector<LeafEntry> entries;
+    TRY(entries.try_ensure_capacity(directory_entries.size()));
+    for (auto const& entry : directory_entries) {
+        auto name = entry.name->view();
+        if (name == "."sv)
+            dot = &entry;
+        else if (name == ".."sv)
+            dot_dot = &entry;
+        else
+            entries.unchecked_append({ .name = name, .inode = static_cast<u32>(entry.inode_index.value()), .file_type = entry.file_type, .hash = hash(name, hash_version(on_disk_hash_version)) });
+    }
+    if (!dot || !dot_dot)
+        return false;
+    quick_sort(entries, [](auto const& a, auto const& b) { return a.hash < b.hash; });
+
+    // Fill the leaves in hash order, and remember where each of them starts.
+    struct Leaf {
+        size_t first_entry { 0 };
+        size_t entry_count { 0 };
+        u32 hash { 0 };
+    };
+    Vector<Leaf> leaves;
+    size_t space_in_leaf = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        auto record_length = EXT2_DIR_REC_LEN(entries[i].name.length());
+        if (leaves.is_empty() || record_length > space_in_leaf) {
+            u32 leaf_hash = entries[i].hash;
+            if (i > 0 && entries[i - 1].hash == leaf_hash)
+                leaf_hash |= hash_continuation_bit;
+            TRY(leaves.try_append({ .first_entry = i, .entry_count = 0, .hash = leaf_hash }));
+            space_in_leaf = block_size;
+        }
+        ++leaves.last().entry_count;
+        space_in_leaf -= record_length;
+    }
+    if (leaves.is_empty())
+        TRY(leaves.try_append({}));
+
+    size_t root_limit = (block_size - root_info_offset - sizeof(ext2_dx_root_info)) / sizeof(ext2_dx_entry);
+    if (leaves.size() > root_limit)
+        return false;
+
+    auto directory_data = TRY(ByteBuffer::create_zeroed((leaves.size() + 1) * block_size));
+
+    write_entry(*bit_cast<ext2_dir_entry_2*>(directory_data.data()), "."sv, dot->inode_index.value(), dot->file_type, dot_entry_length);
+    write_entry(*bit_cast<ext2_dir_entry_2*>(directory_data.offset_pointer(dot_entry_length)), ".."sv, dot_dot->inode_index.value(), dot_dot->file_type, block_size - dot_entry_length);
+    auto& info = *bit_cast<ext2_dx_root_info*>(directory_data.offset_pointer(root_info_offset));
+    info.hash_version = on_disk_hash_version;
+    info.info_length = sizeof(ext2_dx_root_info);
+    info.indirect_levels = 0;
+    auto* root_entries = bit_cast<ext2_dx_entry*>(directory_data.offset_pointer(root_info_offset + sizeof(ext2_dx_root_info)));
+
+    for (size_t i = 0; i < leaves.size(); ++i) {
+        auto const& leaf = leaves[i];
+        root_entries[i] = { .hash = leaf.hash, .block = static_cast<u32>(i + 1) };
+        write_leaf_entries_to_block(directory_data.bytes().slice((i + 1) * block_size, block_size), entries.span().slice(leaf.first_entry, leaf.entry_count));
+    }
+    auto& root_limits = *bit_cast<ext2_dx_countlimit*>(root_entries);
+    root_limits.limit = root_limit;
+    root_limits.count = leaves.size();
+
+    TRY(m_inode.resize(directory_data.size()));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(directory_data.data());
+    auto nwritten = TRY(m_inode.prepare_and_write_bytes_locked(0, directory_data.size(), buffer, nullptr));
+    if (nwritten != directory_data.size())
+        return EIO;
+
+    m_inode.m_raw_inode.i_flags |= EXT2_INDEX_FL;
+    m_inode.set_metadata_dirty(true);
+    dbgln_if(EXT2_DEBUG, "Ext2FSDirectoryIndex[{}]: Indexed {} entries in {} leaves", m_inode.identifier(), entries.size(), leaves.size());
+    return true;
+}
+
+}
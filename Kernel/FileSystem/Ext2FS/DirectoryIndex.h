@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryEntry.h>
+#include <Kernel/FileSystem/InodeIdentifier.h>
+
+namespace Kernel {
+
+class Ext2FSInode;
+
+// The hashed index (htree) of a directory, as used by ext3 and ext4.
+// Block 0 of an indexed directory holds the "." and ".." entries, followed by a sorted list of (hash, block) pairs,
+// which point either at the leaf blocks holding the actual directory entries, or at another level of such lists.
+// Any name can be found by hashing it and descending through at most a few index blocks, no matter how many entries
+// the directory has. Readers that don't know about the index see the index blocks as empty directory entries.
+class Ext2FSDirectoryIndex {
+public:
+    explicit Ext2FSDirectoryIndex(Ext2FSInode&);
+
+    // Rewrites the directory as an indexed one, holding `entries` (which must include "." and "..").
+    // Returns false if the entries don't fit into an index with a single level, in which case nothing was changed.
+    ErrorOr<bool> build(Vector<Ext2FSDirectoryEntry> const& entries);
+
+    ErrorOr<Optional<InodeIndex>> lookup(StringView name);
+    ErrorOr<void> add_entry(StringView name, InodeIndex, u8 file_type);
+    ErrorOr<void> remove_entry(StringView name);
+    ErrorOr<void> set_parent(InodeIndex, u8 file_type);
+
+private:
+    // One index block on the path from the root to a leaf, and the entry that was followed in it.
+    struct Frame {
+        u32 block { 0 };
+        ByteBuffer data;
+        size_t entries_offset { 0 };
+        size_t at { 0 };
+    };
+    using Path = Vector<Frame, 3>;
+
+    struct LeafEntry {
+        StringView name;
+        u32 inode { 0 };
+        u8 file_type { 0 };
+        u32 hash { 0 };
+    };
+
+    u8 hash_version(u8 on_disk_hash_version) const;
+    u32 hash(StringView name, u8 hash_version) const;
+
+    ErrorOr<ByteBuffer> read_directory_block(u32 block);
+    ErrorOr<void> write_directory_block(u32 block, ByteBuffer const&);
+    ErrorOr<u32> append_directory_block(ByteBuffer const&);
+
+    // Finds the path through the index to the leaf that `name` belongs in, along with the name's hash.
+    ErrorOr<Path> probe(StringView name, u32& name_hash, u8& directory_hash_version);
+    ErrorOr<bool> advance_to_next_leaf(Path&, u32 hash);
+    ErrorOr<void> make_room_in_index(Path&);
+    ErrorOr<void> split_index_node(Path&, size_t level);
+    ErrorOr<void> insert_index_entry(Frame&, u32 hash, u32 block);
+    ErrorOr<void> split_leaf(Path&, u32 leaf_block, ByteBuffer& leaf, u8 directory_hash_version);
+
+    Ext2FSInode& m_inode;
+};
+
+}
@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/IntegralMath.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/Ext2FS/ExtentTree.h>
+#include <Kernel/FileSystem/Ext2FS/Inode.h>
+
+namespace Kernel {
+
+static_assert(sizeof(ext4_extent_header) == 12);
+static_assert(sizeof(ext4_extent) == 12);
+static_assert(sizeof(ext4_extent_idx) == 12);
+
+// Logical block numbers are 32 bits wide on disk.
+static constexpr u64 max_logical_blocks = 1ull << 32;
+
+static constexpr size_t entries_in_inode = (sizeof(ext2_inode_large::i_block) - sizeof(ext4_extent_header)) / sizeof(ext4_extent);
+
+static size_t entries_in_block(size_t block_size)
+{
+    return (block_size - sizeof(ext4_extent_header)) / sizeof(ext4_extent);
+}
+
+static void write_node_header(u8* node, size_t entry_count, size_t max_entry_count, size_t depth)
+{
+    auto& header = *bit_cast<ext4_extent_header*>(node);
+    header.eh_magic = EXT4_EXT_MAGIC;
+    header.eh_entries = entry_count;
+    header.eh_max = max_entry_count;
+    header.eh_depth = depth;
+    header.eh_generation = 0;
+}
+
+Ext2FSExtentTree::Ext2FSExtentTree(Ext2FSInode& inode)
+    : m_inode(inode)
+{
+}
+
+void Ext2FSExtentTree::initialize_empty_tree(ext2_inode_large& raw_inode)
+{
+    memset(raw_inode.i_block, 0, sizeof(raw_inode.i_block));
+    write_node_header(bit_cast<u8*>(&raw_inode.i_block[0]), 0, entries_in_inode, 0);
+}
+
+bool Ext2FSExtentTree::can_merge(Extent const& first, Extent const& second)
+{
+    if (first.is_unwritten || second.is_unwritten)
+        return false;
+    return first.end() == second.logical_block
+        && first.physical_block + first.length == second.physical_block
+        && first.length + second.length <= EXT4_EXT_INIT_MAX_LEN;
+}
+
+void Ext2FSExtentTree::mark_dirty()
+{
+    m_is_dirty = true;
+    m_inode.set_metadata_dirty(true);
+}
+
+ErrorOr<void> Ext2FSExtentTree::ensure_loaded()
+{
+    VERIFY(m_lock.is_locked());
+    if (m_is_loaded)
+        return {};
+
+    m_extents.clear();
+    m_tree_blocks.clear();
+
+    auto root = ReadonlyBytes { bit_cast<u8 const*>(&m_inode.m_raw_inode.i_block[0]), sizeof(m_inode.m_raw_inode.i_block) };
+    auto const& header = *bit_cast<ext4_extent_header const*>(root.data());
+    if (header.eh_depth > EXT4_EXT_MAX_DEPTH) {
+        dmesgln("Ext2FSExtentTree[{}]: Extent tree is too deep ({} levels)", m_inode.identifier(), header.eh_depth);
+        return EIO;
+    }
+    if (auto result = load_node(root, header.eh_depth); result.is_error()) {
+        m_extents.clear();
+        m_tree_blocks.clear();
+        return result.release_error();
+    }
+
+    m_is_loaded = true;
+    return {};
+}
+
+ErrorOr<void> Ext2FSExtentTree::load_node(ReadonlyBytes node, u16 depth)
+{
+    auto const& header = *bit_cast<ext4_extent_header const*>(node.data());
+    auto capacity = (node.size() - sizeof(ext4_extent_header)) / sizeof(ext4_extent);
+    if (header.eh_magic != EXT4_EXT_MAGIC || header.eh_depth != depth || header.eh_entries > header.eh_max || header.eh_max > capacity) {
+        dmesgln("Ext2FSExtentTree[{}]: Bad extent tree node (magic {:#04x}, depth {}, entries {}/{})", m_inode.identifier(), header.eh_magic, header.eh_depth, header.eh_entries, header.eh_max);
+        return EIO;
+    }
+
+    if (depth == 0) {
+        auto const* entries = bit_cast<ext4_extent const*>(node.offset(sizeof(ext4_extent_header)));
+        for (size_t i = 0; i < header.eh_entries; ++i) {
+            auto const& entry = entries[i];
+            Extent extent {
+                .logical_block = entry.ee_block,
+                .physical_block = (static_cast<u64>(entry.ee_start_hi) << 32) | entry.ee_start_lo,
+                .length = entry.ee_len,
+                .is_unwritten = false,
+            };
+            if (entry.ee_len > EXT4_EXT_INIT_MAX_LEN) {
+                extent.length = entry.ee_len - EXT4_EXT_INIT_MAX_LEN;
+                extent.is_unwritten = true;
+            }
+            // Extents are sorted and don't overlap, which is what makes looking them up with a binary search possible.
+            if (extent.length == 0 || extent.physical_block == 0 || (!m_extents.is_empty() && m_extents.last().end() > extent.logical_block)) {
+                dmesgln("Ext2FSExtentTree[{}]: Bad extent at logical block {}", m_inode.identifier(), extent.logical_block);
+                return EIO;
+            }
+            TRY(m_extents.try_append(extent));
+        }
+        return {};
+    }
+
+    auto const block_size = m_inode.fs().logical_block_size();
+    auto child_storage = TRY(ByteBuffer::create_uninitialized(block_size));
+    auto const* entries = bit_cast<ext4_extent_idx const*>(node.offset(sizeof(ext4_extent_header)));
+    for (size_t i = 0; i < header.eh_entries; ++i) {
+        BlockIndex child_block = (static_cast<u64>(entries[i].ei_leaf_hi) << 32) | entries[i].ei_leaf_lo;
+        if (child_block == 0) {
+            dmesgln("Ext2FSExtentTree[{}]: Bad index entry for logical block {}", m_inode.identifier(), entries[i].ei_block);
+            return EIO;
+        }
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(child_storage.data());
+        TRY(m_inode.fs().read_block(child_block, &buffer, block_size));
+        TRY(m_tree_blocks.try_append(child_block));
+        TRY(load_node(child_storage.bytes(), depth - 1));
+    }
+    return {};
+}
+
+size_t Ext2FSExtentTree::index_of_first_extent_ending_after(u64 logical_block) const
+{
+    size_t low = 0;
+    size_t high = m_extents.size();
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (m_extents[middle].end() <= logical_block)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+ErrorOr<Optional<Ext2FSExtentTree::Mapping>> Ext2FSExtentTree::lookup(BlockIndex logical_block)
+{
+    MutexLocker locker(m_lock);
+    TRY(ensure_loaded());
+
+    auto index = index_of_first_extent_ending_after(logical_block.value());
+    if (index == m_extents.size() || m_extents[index].logical_block > logical_block.value())
+        return Optional<Mapping> {};
+
+    auto const& extent = m_extents[index];
+    return Mapping {
+        .physical_block = extent.physical_block + (logical_block.value() - extent.logical_block),
+        .is_unwritten = extent.is_unwritten,
+    };
+}
+
+ErrorOr<Ext2FSExtentTree::BlockIndex> Ext2FSExtentTree::allocation_goal(BlockIndex logical_block)
+{
+    MutexLocker locker(m_lock);
+    TRY(ensure_loaded());
+
+    auto index = index_of_first_extent_ending_after(logical_block.value());
+    if (index == 0)
+        return BlockIndex { 0 };
+
+    // Leave room for the hole between the previous extent and this block, so it can be filled in contiguously later.
+    auto const& previous = m_extents[index - 1];
+    return BlockIndex { previous.physical_block + previous.length + (logical_block.value() - previous.end()) };
+}
+
+ErrorOr<void> Ext2FSExtentTree::free_blocks(u64 first_block, u64 count)
+{
+    for (u64 i = 0; i < count; ++i) {
+        TRY(m_inode.fs().set_block_allocation_state(first_block + i, false));
+        m_inode.m_raw_inode.i_blocks -= m_inode.fs().i_blocks_increment();
+    }
+    return {};
+}
+
+ErrorOr<void> Ext2FSExtentTree::remove_range(u64 logical_block, u64 count, bool should_free_blocks)
+{
+    VERIFY(m_lock.is_locked());
+    auto end = logical_block + count;
+
+    auto index = index_of_first_extent_ending_after(logical_block);
+    while (index < m_extents.size() && m_extents[index].logical_block < end) {
+        auto& extent = m_extents[index];
+        auto overlap_start = max(extent.logical_block, logical_block);
+        auto overlap_end = min(extent.end(), end);
+        if (should_free_blocks)
+            TRY(free_blocks(extent.physical_block + (overlap_start - extent.logical_block), overlap_end - overlap_start));
+
+        bool keeps_head = overlap_start > extent.logical_block;
+        bool keeps_tail = overlap_end < extent.end();
+        if (keeps_head && keeps_tail) {
+            // The range is in the middle of the extent, so it has to be split in two.
+            Extent tail = extent;
+            tail.logical_block = overlap_end;
+            tail.physical_block += overlap_end - extent.logical_block;
+            tail.length = extent.end() - overlap_end;
+            extent.length = overlap_start - extent.logical_block;
+            TRY(m_extents.try_insert(index + 1, tail));
+            break;
+        }
+        if (keeps_head) {
+            extent.length = overlap_start - extent.logical_block;
+            ++index;
+            continue;
+        }
+        if (keeps_tail) {
+            extent.physical_block += overlap_end - extent.logical_block;
+            extent.length = extent.end() - overlap_end;
+            extent.logical_block = overlap_end;
+            break;
+        }
+        m_extents.remove(index);
+    }
+    return {};
+}
+
+ErrorOr<void> Ext2FSExtentTree::map(BlockIndex logical_block, BlockIndex physical_block, u64 count)
+{
+    VERIFY(physical_block != 0);
+    if (count == 0)
+        return {};
+    if (logical_block.value() + count > max_logical_blocks)
+        return EFBIG;
+
+    MutexLocker locker(m_lock);
+    TRY(ensure_loaded());
+
+    // Rewriting a block pointer with the value it already has is common, and doesn't need to change anything.
+    if (count == 1) {
+        auto index = index_of_first_extent_ending_after(logical_block.value());
+        if (index < m_extents.size()) {
+            auto const& extent = m_extents[index];
+            if (!extent.is_unwritten && extent.logical_block <= logical_block.value() && extent.physical_block + (logical_block.value() - extent.logical_block) == physical_block.value())
+                return {};
+        }
+    }
+
+    TRY(remove_range(logical_block.value(), count, false));
+
+    auto current_logical_block = logical_block.value();
+    auto current_physical_block = physical_block.value();
+    auto remaining_count = count;
+    while (remaining_count > 0) {
+        Extent extent {
+            .logical_block = current_logical_block,
+            .physical_block = current_physical_block,
+            .length = min<u64>(remaining_count, EXT4_EXT_INIT_MAX_LEN),
+            .is_unwritten = false,
+        };
+
+        auto index = index_of_first_extent_ending_after(extent.logical_block);
+        if (index > 0 && can_merge(m_extents[index - 1], extent)) {
+            m_extents[index - 1].length += extent.length;
+            --index;
+        } else {
+            TRY(m_extents.try_insert(index, extent));
+        }
+        if (index + 1 < m_extents.size() && can_merge(m_extents[index], m_extents[index + 1])) {
+            m_extents[index].length += m_extents[index + 1].length;
+            m_extents.remove(index + 1);
+        }
+
+        current_logical_block += extent.length;
+        current_physical_block += extent.length;
+        remaining_count -= extent.length;
+    }
+
+    mark_dirty();
+    return {};
+}
+
+ErrorOr<void> Ext2FSExtentTree::unmap(BlockIndex logical_block, u64 count)
+{
+    MutexLocker locker(m_lock);
+    TRY(ensure_loaded());
+    TRY(remove_range(logical_block.value(), count, false));
+    mark_dirty();
+    return {};
+}
+
+ErrorOr<void> Ext2FSExtentTree::truncate(BlockIndex first_logical_block)
+{
+    MutexLocker locker(m_lock);
+    TRY(ensure_loaded());
+    if (first_logical_block.value() >= max_logical_blocks)
+        return {};
+    TRY(remove_range(first_logical_block.value(), max_logical_blocks - first_logical_block.value(), true));
+    mark_dirty();
+    return {};
+}
+
+ErrorOr<void> Ext2FSExtentTree::free_all_blocks()
+{
+    MutexLocker locker(m_lock);
+    TRY(ensure_loaded());
+
+    for (auto const& extent : m_extents)
+        TRY(free_blocks(extent.physical_block, extent.length));
+    for (auto block : m_tree_blocks)
+        TRY(free_blocks(block.value(), 1));
+
+    m_extents.clear();
+    m_tree_blocks.clear();
+    initialize_empty_tree(m_inode.m_raw_inode);
+    m_is_dirty = false;
+    return {};
+}
+
+ErrorOr<void> Ext2FSExtentTree::flush()
+{
+    MutexLocker locker(m_lock);
+    if (!m_is_dirty)
+        return {};
+    VERIFY(m_is_loaded);
+
+    auto& fs = m_inode.fs();
+    auto const block_size = fs.logical_block_size();
+    auto const max_entries_in_block = entries_in_block(block_size);
+
+    // Figure out the shape of the tree, from the leaves up: Every level gets as many nodes as it takes to point at all
+    // entries of the level below, until the entries fit into the inode itself.
+    Vector<size_t, EXT4_EXT_MAX_DEPTH> nodes_per_level;
+    size_t entry_count = m_extents.size();
+    size_t needed_tree_blocks = 0;
+    while (entry_count > entries_in_inode) {
+        if (nodes_per_level.size() == EXT4_EXT_MAX_DEPTH)
+            return EFBIG;
+        entry_count = ceil_div(entry_count, max_entries_in_block);
+        nodes_per_level.unchecked_append(entry_count);
+        needed_tree_blocks += entry_count;
+    }
+
+    // Reuse the blocks the tree already has, and only allocate or free the difference.
+    while (m_tree_blocks.size() > needed_tree_blocks)
+        TRY(free_blocks(m_tree_blocks.take_last().value(), 1));
+    while (m_tree_blocks.size() < needed_tree_blocks) {
+        auto goal = m_tree_blocks.is_empty() ? BlockIndex { 0 } : BlockIndex { m_tree_blocks.last().value() + 1 };
+        auto run = TRY(fs.allocate_block_run(fs.group_index_from_inode(m_inode.index()), goal, needed_tree_blocks - m_tree_blocks.size()));
+        for (size_t i = 0; i < run.count; ++i) {
+            TRY(m_tree_blocks.try_append(run.first_block.value() + i));
+            m_inode.m_raw_inode.i_blocks += fs.i_blocks_increment();
+        }
+    }
+
+    auto write_extent = [](ext4_extent& entry, Extent const& extent) {
+        entry.ee_block = extent.logical_block;
+        entry.ee_len = extent.length + (extent.is_unwritten ? EXT4_EXT_INIT_MAX_LEN : 0);
+        entry.ee_start_hi = extent.physical_block >> 32;
+        entry.ee_start_lo = extent.physical_block & 0xffffffff;
+    };
+    auto make_index_entry = [](u64 first_logical_block, BlockIndex node_block) {
+        return ext4_extent_idx {
+            .ei_block = static_cast<u32>(first_logical_block),
+            .ei_leaf_lo = static_cast<u32>(node_block.value() & 0xffffffff),
+            .ei_leaf_hi = static_cast<u16>(node_block.value() >> 32),
+            .ei_unused = 0,
+        };
+    };
+
+    auto* root = bit_cast<u8*>(&m_inode.m_raw_inode.i_block[0]);
+    memset(root, 0, sizeof(m_inode.m_raw_inode.i_block));
+
+    if (nodes_per_level.is_empty()) {
+        write_node_header(root, m_extents.size(), entries_in_inode, 0);
+        auto* entries = bit_cast<ext4_extent*>(root + sizeof(ext4_extent_header));
+        for (size_t i = 0; i < m_extents.size(); ++i)
+            write_extent(entries[i], m_extents[i]);
+        m_is_dirty = false;
+        return {};
+    }
+
+    auto node_storage = TRY(ByteBuffer::create_zeroed(block_size));
+    auto node_buffer = UserOrKernelBuffer::for_kernel_buffer(node_storage.data());
+    size_t next_tree_block = 0;
+
+    // The index entries that point at the nodes written so far, which become the entries of the next level.
+    Vector<ext4_extent_idx> child_entries;
+    TRY(child_entries.try_ensure_capacity(nodes_per_level[0]));
+    for (size_t node = 0; node < nodes_per_level[0]; ++node) {
+        auto first_extent = node * max_entries_in_block;
+        auto extent_count = min(max_entries_in_block, m_extents.size() - first_extent);
+        node_storage.zero_fill();
+        write_node_header(node_storage.data(), extent_count, max_entries_in_block, 0);
+        auto* entries = bit_cast<ext4_extent*>(node_storage.offset_pointer(sizeof(ext4_extent_header)));
+        for (size_t i = 0; i < extent_count; ++i)
+            write_extent(entries[i], m_extents[first_extent + i]);
+
+        auto node_block = m_tree_blocks[next_tree_block++];
+        TRY(fs.write_block(node_block, node_buffer, block_size));
+        child_entries.unchecked_append(make_index_entry(m_extents[first_extent].logical_block, node_block));
+    }
+
+    for (size_t level = 1; level < nodes_per_level.size(); ++level) {
+        Vector<ext4_extent_idx> parent_entries;
+        TRY(parent_entries.try_ensure_capacity(nodes_per_level[level]));
+        for (size_t node = 0; node < nodes_per_level[level]; ++node) {
+            auto first_child = node * max_entries_in_block;
+            auto child_count = min(max_entries_in_block, child_entries.size() - first_child);
+            node_storage.zero_fill();
+            write_node_header(node_storage.data(), child_count, max_entries_in_block, level);
+            memcpy(node_storage.offset_pointer(sizeof(ext4_extent_header)), &child_entries[first_child], child_count * sizeof(ext4_extent_idx));
+
+            auto node_block = m_tree_blocks[next_tree_block++];
+            TRY(fs.write_block(node_block, node_buffer, block_size));
+            parent_entries.unchecked_append(make_index_entry(child_entries[first_child].ei_block, node_block));
+        }
+        child_entries = move(parent_entries);
+    }
+
+    VERIFY(child_entries.size() <= entries_in_inode);
+    write_node_header(root, child_entries.size(), entries_in_inode, nodes_per_level.size());
+    memcpy(root + sizeof(ext4_extent_header), child_entries.data(), child_entries.size() * sizeof(ext4_extent_idx));
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSExtentTree[{}]::flush(): Wrote {} extents, {} levels, {} tree blocks", m_inode.identifier(), m_extents.size(), nodes_per_level.size(), m_tree_blocks.size());
+    m_is_dirty = false;
+    return {};
+}
+
+}
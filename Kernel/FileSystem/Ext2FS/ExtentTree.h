@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/FileSystem/Ext2FS/Definitions.h>
+#include <Kernel/Locking/Mutex.h>
+
+namespace Kernel {
+
+class Ext2FSInode;
+
+// The ext4 extent tree of an inode. Instead of one pointer per block, it maps runs of contiguous blocks, so files that
+// were allocated in a few large runs need only a handful of entries, which usually fit into the inode itself.
+// The tree is kept in memory as a sorted list of extents, and is written back as a whole when the inode is flushed.
+class Ext2FSExtentTree {
+public:
+    using BlockIndex = BlockBasedFileSystem::BlockIndex;
+
+    struct Mapping {
+        BlockIndex physical_block;
+        // Unwritten blocks are allocated, but have to read as zeroes.
+        bool is_unwritten { false };
+    };
+
+    explicit Ext2FSExtentTree(Ext2FSInode&);
+
+    static void initialize_empty_tree(ext2_inode_large&);
+
+    ErrorOr<Optional<Mapping>> lookup(BlockIndex logical_block);
+    // Returns the physical block that would keep the blocks in front of `logical_block` contiguous, or 0 if there are none.
+    ErrorOr<BlockIndex> allocation_goal(BlockIndex logical_block);
+
+    // Maps `count` logical blocks to consecutive physical blocks, replacing whatever they were mapped to before.
+    ErrorOr<void> map(BlockIndex logical_block, BlockIndex physical_block, u64 count);
+    // Turns the blocks into a hole, without freeing them.
+    ErrorOr<void> unmap(BlockIndex logical_block, u64 count);
+    // Frees all blocks from `first_logical_block` on. Tree blocks that aren't needed anymore are freed by the next flush().
+    ErrorOr<void> truncate(BlockIndex first_logical_block);
+    ErrorOr<void> free_all_blocks();
+
+    ErrorOr<void> flush();
+
+private:
+    struct Extent {
+        u64 logical_block { 0 };
+        u64 physical_block { 0 };
+        u64 length { 0 };
+        bool is_unwritten { false };
+
+        u64 end() const { return logical_block + length; }
+    };
+
+    static bool can_merge(Extent const&, Extent const&);
+
+    ErrorOr<void> ensure_loaded();
+    ErrorOr<void> load_node(ReadonlyBytes node, u16 depth);
+    size_t index_of_first_extent_ending_after(u64 logical_block) const;
+    ErrorOr<void> remove_range(u64 logical_block, u64 count, bool free_blocks);
+    ErrorOr<void> free_blocks(u64 first_block, u64 count);
+    void mark_dirty();
+
+    Ext2FSInode& m_inode;
+    Vector<Extent> m_extents;
+    // All blocks that hold nodes of the tree, in no particular order.
+    Vector<BlockIndex> m_tree_blocks;
+    bool m_is_loaded { false };
+    bool m_is_dirty { false };
+
+    Mutex m_lock { "Ext2FSExtentTree"sv };
+};
+
+}
@@ -89,7 +89,14 @@ ErrorOr<void> Ext2FS::rename(Inode& old_parent_inode, StringView old_basename, I
         //        Revert the changes made above if we can't write_directory.
         //        Ideally, decrement should be the last operation, but we currently
         //        can't "un-write" a directory entry list.
-        TRY(static_cast<Ext2FSInode&>(*new_inode).write_directory(entries));
+        auto& moved_directory = static_cast<Ext2FSInode&>(*new_inode);
+        if (moved_directory.is_indexed_directory()) {
+            // Rewriting the whole directory would throw away its index, and only ".." has to change anyway.
+            MutexLocker moved_directory_locker(moved_directory.m_inode_lock);
+            TRY(moved_directory.m_directory_index.set_parent(new_parent_inode.index(), has_file_type_attribute ? Ext2FSInode::to_ext2_file_type(new_parent_inode.mode()) : (u8)EXT2_FT_UNKNOWN));
+        } else {
+            TRY(moved_directory.write_directory(entries));
+        }
     }
 
     return {};
@@ -265,6 +272,13 @@ Ext2FS::FeaturesReadOnly Ext2FS::get_features_readonly() const
     return Ext2FS::FeaturesReadOnly::None;
 }
 
+Ext2FS::FeaturesIncompatible Ext2FS::get_features_incompatible() const
+{
+    if (m_super_block.s_rev_level > 0)
+        return static_cast<Ext2FS::FeaturesIncompatible>(m_super_block.s_feature_incompat);
+    return Ext2FS::FeaturesIncompatible::None;
+}
+
 u64 Ext2FS::inodes_per_block() const
 {
     return EXT2_INODES_PER_BLOCK(&super_block());
@@ -394,6 +408,85 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
     return blocks;
 }
 
+auto Ext2FS::allocate_block_run(GroupIndex preferred_group_index, BlockIndex goal, size_t count) -> ErrorOr<BlockRun>
+{
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_block_run(preferred group: {}, goal: {}, count {})", preferred_group_index, goal, count);
+    VERIFY(count > 0);
+
+    MutexLocker locker(m_lock);
+
+    if (super_block().s_free_blocks_count == 0)
+        return Error::from_errno(ENOSPC);
+
+    if (goal >= super_block().s_blocks_count)
+        goal = 0;
+
+    size_t blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
+    auto first_group_index = goal != 0 ? group_index_from_block_index(goal) : preferred_group_index;
+    if (first_group_index == 0 || first_group_index > m_block_group_count)
+        first_group_index = 1;
+    size_t goal_bit_index = goal != 0 ? goal.value() - first_block_of_group(first_group_index).value() : 0;
+
+    auto claim_run = [&](GroupIndex group_index, size_t first_bit_index, size_t length) -> ErrorOr<BlockRun> {
+        BlockIndex first_block = first_block_of_group(group_index).value() + first_bit_index;
+        for (size_t i = 0; i < length; ++i)
+            TRY(set_block_allocation_state(first_block.value() + i, true));
+        dbgln_if(EXT2_DEBUG, "Ext2FS: allocated run of {} blocks at {} [{}]", length, first_block, group_index);
+        return BlockRun { first_block, length };
+    };
+
+    auto next_group_index = [&](GroupIndex group_index) -> GroupIndex {
+        return group_index == m_block_group_count ? GroupIndex { 1 } : GroupIndex { group_index.value() + 1 };
+    };
+
+    // Best case: the blocks right at the goal are free, so the caller's file stays contiguous.
+    if (goal != 0 && group_descriptor(first_group_index).bg_free_blocks_count) {
+        auto* cached_bitmap = TRY(get_bitmap_block(group_descriptor(first_group_index).bg_block_bitmap));
+        auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
+        size_t length = 0;
+        while (length < count && goal_bit_index + length < blocks_in_group && !block_bitmap.get(goal_bit_index + length))
+            ++length;
+        if (length > 0)
+            return claim_run(first_group_index, goal_bit_index, length);
+    }
+
+    // Otherwise, look for a free range of the whole size, starting at the goal and moving on to the following groups.
+    auto group_index = first_group_index;
+    for (size_t i = 0; i < m_block_group_count; ++i, group_index = next_group_index(group_index)) {
+        auto const& bgd = group_descriptor(group_index);
+        if (bgd.bg_free_blocks_count < count)
+            continue;
+        auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+        auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
+
+        size_t first_bit_index = group_index == first_group_index ? goal_bit_index : 0;
+        auto length = block_bitmap.find_next_range_of_unset_bits(first_bit_index, count, count);
+        if (!length.has_value() && group_index == first_group_index && goal_bit_index != 0) {
+            first_bit_index = 0;
+            length = block_bitmap.find_next_range_of_unset_bits(first_bit_index, count, count);
+        }
+        if (length.has_value())
+            return claim_run(group_index, first_bit_index, length.value());
+    }
+
+    // There is no range that large anywhere, so settle for the longest one in the first group that has free blocks.
+    group_index = first_group_index;
+    for (size_t i = 0; i < m_block_group_count; ++i, group_index = next_group_index(group_index)) {
+        auto const& bgd = group_descriptor(group_index);
+        if (!bgd.bg_free_blocks_count)
+            continue;
+        auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+        auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
+
+        size_t length = 0;
+        auto first_bit_index = block_bitmap.find_longest_range_of_unset_bits(count, length);
+        VERIFY(first_bit_index.has_value());
+        return claim_run(group_index, first_bit_index.value(), length);
+    }
+
+    VERIFY_NOT_REACHED();
+}
+
 ErrorOr<InodeIndex> Ext2FS::allocate_inode(GroupIndex preferred_group)
 {
     dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_inode(preferred_group: {})", preferred_group);
@@ -628,6 +721,13 @@ ErrorOr<NonnullRefPtr<Inode>> Ext2FS::create_inode(Ext2FSInode& parent_inode, St
     else if (is_block_device(mode))
         e2inode.i_block[1] = dev;
 
+    // New files and directories are mapped with extents whenever the file system supports them, so they can be
+    // allocated in large contiguous runs.
+    if (has_flag(get_features_incompatible(), FeaturesIncompatible::Extents) && (is_regular_file(mode) || is_directory(mode))) {
+        e2inode.i_flags |= EXT4_EXTENTS_FL;
+        Ext2FSExtentTree::initialize_empty_tree(e2inode);
+    }
+
     auto inode_id = TRY(allocate_inode());
 
     dbgln_if(EXT2_DEBUG, "Ext2FS: writing initial metadata for inode {}", inode_id.value());
@@ -690,8 +790,17 @@ ErrorOr<void> Ext2FS::prepare_to_clear_last_mount(Inode& mount_guest_inode)
     if (any_inode_busy)
         return EBUSY;
 
+    // Blocks that were preallocated for inodes aren't in use, so give them back before the bitmaps are written out.
+    for (auto& it : m_inode_cache) {
+        if (!it.value)
+            continue;
+        MutexLocker inode_locker(it.value->m_inode_lock);
+        TRY(it.value->discard_preallocated_blocks());
+    }
+
     m_inode_cache.clear();
     m_root_inode = nullptr;
+    TRY(flush_writes());
 
     // Mark filesystem as valid before unmount.
     dmesgln("Ext2FS: Clean unmount, setting superblock to valid state");
@@ -21,12 +21,15 @@ class Ext2FSInode;
 
 class Ext2FS final : public BlockBasedFileSystem {
     friend class Ext2FSInode;
+    friend class Ext2FSExtentTree;
+    friend class Ext2FSDirectoryIndex;
 
 public:
     // s_feature_compat
     enum class FeaturesOptional : u32 {
         None = 0,
         ExtendedAttributes = EXT2_FEATURE_COMPAT_EXT_ATTR,
+        DirectoryIndex = EXT2_FEATURE_COMPAT_DIR_INDEX,
     };
     AK_ENUM_BITWISE_FRIEND_OPERATORS(FeaturesOptional);
 
@@ -38,6 +41,14 @@ public:
     };
     AK_ENUM_BITWISE_FRIEND_OPERATORS(FeaturesReadOnly);
 
+    // s_feature_incompat
+    enum class FeaturesIncompatible : u32 {
+        None = 0,
+        FileType = EXT2_FEATURE_INCOMPAT_FILETYPE,
+        Extents = EXT3_FEATURE_INCOMPAT_EXTENTS,
+    };
+    AK_ENUM_BITWISE_FRIEND_OPERATORS(FeaturesIncompatible);
+
     static ErrorOr<NonnullRefPtr<FileSystem>> try_create(OpenFileDescription&, FileSystemSpecificOptions const&);
 
     virtual ~Ext2FS() override;
@@ -48,6 +59,7 @@ public:
     virtual unsigned free_inode_count() const override;
 
     virtual bool supports_watchers() const override { return true; }
+    virtual bool supports_lookup_cache() const override { return true; }
     virtual bool supports_backing_loop_devices() const override { return true; }
 
     virtual ErrorOr<void> rename(Inode& old_parent_inode, StringView old_basename, Inode& new_parent_inode, StringView new_basename) override;
@@ -56,6 +68,7 @@ public:
 
     FeaturesOptional get_features_optional() const;
     FeaturesReadOnly get_features_readonly() const;
+    FeaturesIncompatible get_features_incompatible() const;
 
     u32 i_blocks_increment() { return m_i_blocks_increment; }
 
@@ -103,6 +116,14 @@ private:
     BlockIndex first_block_of_block_group_descriptors() const;
     ErrorOr<InodeIndex> allocate_inode(GroupIndex preferred_group = 0);
     ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count);
+
+    struct BlockRun {
+        BlockIndex first_block { 0 };
+        size_t count { 0 };
+    };
+    // Allocates up to `count` contiguous blocks, preferably starting at `goal` (or in the preferred group if there is none).
+    // The run is shorter than requested if there is no free range that is large enough.
+    ErrorOr<BlockRun> allocate_block_run(GroupIndex preferred_group_index, BlockIndex goal, size_t count);
     GroupIndex group_index_from_inode(InodeIndex) const;
     GroupIndex group_index_from_block_index(BlockIndex) const;
     BlockIndex first_block_of_group(GroupIndex) const;
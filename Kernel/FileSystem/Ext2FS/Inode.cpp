@@ -245,6 +245,7 @@ ErrorOr<void> Ext2FSInode::write_block_pointer(BlockBasedFileSystem::BlockIndex
 
 ErrorOr<Ext2FS::BlockList> Ext2FSInode::compute_block_list(BlockBasedFileSystem::BlockIndex first_block, BlockBasedFileSystem::BlockIndex last_block) const
 {
+    VERIFY(!uses_extents());
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::block_list_for_inode(): i_size={}, i_blocks={}", identifier(), m_raw_inode.i_size, m_raw_inode.i_blocks);
     Ext2FS::BlockList list {};
 
@@ -325,9 +326,14 @@ ErrorOr<void> Ext2FSInode::free_all_blocks()
 
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::free_all_blocks(): i_size={}, i_blocks={}", identifier(), m_raw_inode.i_size, m_raw_inode.i_blocks);
 
+    TRY(discard_preallocated_blocks());
+
     if (Kernel::is_symlink(m_raw_inode.i_mode) && m_raw_inode.i_blocks == 0)
         return {};
 
+    if (uses_extents())
+        return m_extent_tree.free_all_blocks();
+
     unsigned const block_size = fs().logical_block_size();
     unsigned const entries_per_block = EXT2_ADDR_PER_BLOCK(&fs().super_block());
 
@@ -389,15 +395,18 @@ ErrorOr<void> Ext2FSInode::free_all_blocks()
 Ext2FSInode::Ext2FSInode(Ext2FS& fs, InodeIndex index)
     : Inode(fs, index)
     , m_block_view(*this)
+    , m_extent_tree(*this)
+    , m_directory_index(*this)
 {
 }
 
 Ext2FSInode::~Ext2FSInode()
 {
-    if (m_raw_inode.i_links_count == 0) {
-        // Alas, we have nowhere to propagate any errors that occur here.
+    // Alas, we have nowhere to propagate any errors that occur here.
+    if (m_raw_inode.i_links_count == 0)
         (void)fs().free_inode(*this);
-    }
+    else
+        (void)discard_preallocated_blocks();
 }
 
 u64 Ext2FSInode::size() const
@@ -467,6 +476,8 @@ ErrorOr<void> Ext2FSInode::flush_metadata()
         return {};
 
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::flush_metadata(): Flushing inode", identifier());
+    if (uses_extents())
+        TRY(m_extent_tree.flush());
     TRY(fs().write_ext2_inode(index(), m_raw_inode));
     if (is_directory()) {
         // Unless we're about to go away permanently, invalidate the lookup cache.
@@ -480,6 +491,18 @@ ErrorOr<void> Ext2FSInode::flush_metadata()
 }
 
 ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const
+{
+    bool allow_cache = !description || !description->is_direct();
+    return read_bytes_impl(offset, count, buffer, allow_cache);
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer) const
+{
+    // The page cache keeps the contents, caching the blocks as well would only store them twice.
+    return read_bytes_impl(offset, count, buffer, false);
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_impl(off_t offset, size_t count, UserOrKernelBuffer& buffer, bool allow_cache) const
 {
     VERIFY(m_inode_lock.is_locked());
     VERIFY(offset >= 0);
@@ -498,8 +521,6 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
         return nread;
     }
 
-    bool allow_cache = !description || !description->is_direct();
-
     int const block_size = fs().logical_block_size();
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
@@ -520,6 +541,23 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
         if (block_index.value() == 0) {
             // This is a hole, act as if it's filled with zeroes.
             TRY(buffer_offset.memset(0, num_bytes_to_copy));
+        } else if (!allow_cache && num_bytes_to_copy == static_cast<size_t>(block_size)) {
+            // Without the block cache, every request goes to the device, so read physically contiguous blocks in one go.
+            size_t run_length = 1;
+            while ((run_length + 1) * block_size <= static_cast<size_t>(remaining_count) && run_length < max_uncached_read_run_length) {
+                auto next_block_index = TRY(m_block_view.get_block(current_block_logical_index.value() + run_length));
+                if (next_block_index.value() != block_index.value() + run_length)
+                    break;
+                ++run_length;
+            }
+            if (auto result = fs().read_blocks(block_index, run_length, buffer_offset, false); result.is_error()) {
+                dmesgln("Ext2FSInode[{}]::read_bytes(): Failed to read {} blocks at {} (index {})", identifier(), run_length, block_index.value(), current_block_logical_index);
+                return result.release_error();
+            }
+            current_block_logical_index = current_block_logical_index.value() + run_length;
+            remaining_count -= run_length * block_size;
+            nread += run_length * block_size;
+            continue;
         } else {
             if (auto result = fs().read_block(block_index, &buffer_offset, num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
                 dmesgln("Ext2FSInode[{}]::read_bytes(): Failed to read block {} (index {})", identifier(), block_index.value(), current_block_logical_index);
@@ -548,19 +586,26 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
         BlockBasedFileSystem::BlockIndex first_block_logical_index = ceil_div(new_size, block_size);
         BlockBasedFileSystem::BlockIndex last_block_logical_index = size() / block_size;
 
-        for (auto bi = first_block_logical_index; bi <= last_block_logical_index; bi = bi.value() + 1) {
-            auto block = TRY(m_block_view.get_block(bi));
-            if (block == 0) {
-                // This is a hole, skip it.
-                continue;
-            }
-            if (auto result = fs().set_block_allocation_state(block, false); result.is_error()) {
-                dbgln("Ext2FSInode[{}]::resize(): Failed to free block {}: {}", identifier(), block, result.error());
-                return result;
+        if (uses_extents()) {
+            // The extent tree frees whole runs of blocks at once.
+            TRY(m_extent_tree.truncate(first_block_logical_index));
+        } else {
+            for (auto bi = first_block_logical_index; bi <= last_block_logical_index; bi = bi.value() + 1) {
+                auto block = TRY(m_block_view.get_block(bi));
+                if (block == 0) {
+                    // This is a hole, skip it.
+                    continue;
+                }
+                if (auto result = fs().set_block_allocation_state(block, false); result.is_error()) {
+                    dbgln("Ext2FSInode[{}]::resize(): Failed to free block {}: {}", identifier(), block, result.error());
+                    return result;
+                }
+                m_raw_inode.i_blocks -= fs().i_blocks_increment();
+                TRY(m_block_view.write_block_pointer(bi, 0));
             }
-            m_raw_inode.i_blocks -= fs().i_blocks_increment();
-            TRY(m_block_view.write_block_pointer(bi, 0));
         }
+
+        TRY(discard_preallocated_blocks());
     }
 
     m_raw_inode.i_size = new_size;
@@ -592,6 +637,8 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
     }
 
     bool allow_cache = !description || !description->is_direct();
+    // The page cache keeps the contents of regular files, so their blocks only have to stay cached until they are written back.
+    bool keep_after_flush = !Kernel::is_regular_file(m_raw_inode.i_mode);
 
     auto const block_size = fs().logical_block_size();
     auto new_size = max(static_cast<u64>(offset) + count, size());
@@ -611,11 +658,13 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
     while (remaining_count) {
         size_t offset_into_block = (current_block_logical_index == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
-        auto block_index = TRY(m_block_view.get_or_allocate_block(current_block_logical_index, num_bytes_to_copy != block_size, allow_cache));
+        // Let the allocator know how many blocks this write still needs, so it can reserve them as one contiguous run.
+        auto remaining_block_count = ceil_div(offset_into_block + remaining_count, static_cast<size_t>(block_size));
+        auto block_index = TRY(m_block_view.get_or_allocate_block(current_block_logical_index, remaining_block_count, num_bytes_to_copy != block_size, allow_cache));
         TRY(m_block_view.write_block_pointer(current_block_logical_index, block_index));
 
         dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing block {} (offset_into_block: {})", identifier(), block_index, offset_into_block);
-        if (auto result = fs().write_block(block_index, data.offset(nwritten), num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
+        if (auto result = fs().write_block(block_index, data.offset(nwritten), num_bytes_to_copy, offset_into_block, allow_cache, keep_after_flush); result.is_error()) {
             dbgln("Ext2FSInode[{}]::write_bytes_locked(): Failed to write block {} (index {})", identifier(), block_index, current_block_logical_index);
             return result.release_error();
         }
@@ -717,24 +766,36 @@ ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries
 
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(directory_data.data());
     auto nwritten = TRY(prepare_and_write_bytes_locked(0, serialized_bytes_count, buffer, nullptr));
+    // The entries were written as a plain list, so any index the directory had is gone now.
+    m_raw_inode.i_flags &= ~EXT2_INDEX_FL;
     set_metadata_dirty(true);
     if (nwritten != directory_data.size())
         return EIO;
     return {};
 }
 
-ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSInode::allocate_block(BlockBasedFileSystem::BlockIndex block_index, bool zero_newly_allocated_block, bool allow_cache)
+// Appending to a file one block at a time should still end up with contiguous blocks, so allocations reserve at least this many.
+static constexpr size_t preallocation_window_size = 16;
+
+ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSInode::allocate_block(BlockBasedFileSystem::BlockIndex block_index, BlockBasedFileSystem::BlockIndex goal, size_t run_length_hint, bool zero_newly_allocated_block, bool allow_cache)
 {
-    // FIXME: Preallocate some extra blocks here.
-    auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), 1));
-    m_raw_inode.i_blocks += fs().i_blocks_increment();
+    VERIFY(m_inode_lock.is_locked());
 
-    VERIFY(blocks.size() == 1);
-    auto block = blocks.first();
+    // The preallocated blocks are only useful if they continue where the caller wants the block to be.
+    if (m_preallocated_block_count == 0 || (goal != 0 && goal != m_preallocated_first_block)) {
+        TRY(discard_preallocated_blocks());
+        auto run = TRY(fs().allocate_block_run(fs().group_index_from_inode(index()), goal, max(run_length_hint, preallocation_window_size)));
+        m_preallocated_first_block = run.first_block;
+        m_preallocated_block_count = run.count;
+    }
+
+    auto block = m_preallocated_first_block;
+    m_preallocated_first_block = block.value() + 1;
+    --m_preallocated_block_count;
+    m_raw_inode.i_blocks += fs().i_blocks_increment();
 
     if (zero_newly_allocated_block) {
-        u8 zero_buffer[PAGE_SIZE] {};
-        if (auto result = fs().write_block(block, UserOrKernelBuffer::for_kernel_buffer(zero_buffer), fs().logical_block_size(), 0, allow_cache); result.is_error()) {
+        if (auto result = zero_block(block, allow_cache); result.is_error()) {
             dbgln("Ext2FSInode[{}]::allocate_block(): Failed to zero block {} (index {})", identifier(), block, block_index);
             return result.release_error();
         }
@@ -743,6 +804,23 @@ ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSInode::allocate_block(BlockBased
     return block;
 }
 
+ErrorOr<void> Ext2FSInode::zero_block(BlockBasedFileSystem::BlockIndex block, bool allow_cache)
+{
+    u8 zero_buffer[PAGE_SIZE] {};
+    return fs().write_block(block, UserOrKernelBuffer::for_kernel_buffer(zero_buffer), fs().logical_block_size(), 0, allow_cache);
+}
+
+ErrorOr<void> Ext2FSInode::discard_preallocated_blocks()
+{
+    while (m_preallocated_block_count > 0) {
+        TRY(fs().set_block_allocation_state(m_preallocated_first_block, false));
+        m_preallocated_first_block = m_preallocated_first_block.value() + 1;
+        --m_preallocated_block_count;
+    }
+    m_preallocated_first_block = 0;
+    return {};
+}
+
 ErrorOr<NonnullRefPtr<Inode>> Ext2FSInode::create_child(StringView name, mode_t mode, dev_t dev, UserID uid, GroupID gid)
 {
     if (Kernel::is_directory(mode))
@@ -760,6 +838,16 @@ ErrorOr<void> Ext2FSInode::add_child(Inode& child, StringView name, mode_t mode)
 
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::add_child(): Adding inode {} with name '{}' and mode {:o} to directory {}", identifier(), child.index(), name, mode, index());
     bool has_file_type_attribute = has_flag(fs().get_features_optional(), Ext2FS::FeaturesOptional::ExtendedAttributes);
+    u8 file_type = has_file_type_attribute ? to_ext2_file_type(mode) : (u8)EXT2_FT_UNKNOWN;
+
+    if (is_indexed_directory()) {
+        if (TRY(m_directory_index.lookup(name)).has_value())
+            return EEXIST;
+        TRY(child.increment_link_count());
+        TRY(m_directory_index.add_entry(name, child.index(), file_type));
+        did_add_child(child.identifier(), name);
+        return {};
+    }
 
     Vector<Ext2FSDirectoryEntry> entries;
     TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
@@ -773,7 +861,20 @@ ErrorOr<void> Ext2FSInode::add_child(Inode& child, StringView name, mode_t mode)
     TRY(child.increment_link_count());
 
     auto entry_name = TRY(KString::try_create(name));
-    TRY(entries.try_empend(move(entry_name), child.index(), has_file_type_attribute ? to_ext2_file_type(mode) : (u8)EXT2_FT_UNKNOWN));
+    TRY(entries.try_empend(move(entry_name), child.index(), file_type));
+
+    // Once a directory outgrows a single block, finding an entry in it means reading all of its blocks,
+    // so it's turned into an indexed directory if the file system supports that.
+    if (has_flag(fs().get_features_optional(), Ext2FS::FeaturesOptional::DirectoryIndex)) {
+        size_t directory_size = 0;
+        for (auto const& entry : entries)
+            directory_size += EXT2_DIR_REC_LEN(entry.name->length());
+        if (directory_size > fs().logical_block_size() && TRY(m_directory_index.build(entries))) {
+            m_lookup_cache.clear();
+            did_add_child(child.identifier(), name);
+            return {};
+        }
+    }
 
     TRY(write_directory(entries));
     TRY(populate_lookup_cache());
@@ -789,12 +890,19 @@ ErrorOr<void> Ext2FSInode::remove_child_impl(StringView name, RemoveDotEntries r
     MutexLocker locker(m_inode_lock);
     VERIFY(is_directory());
 
-    TRY(populate_lookup_cache());
-
-    auto it = m_lookup_cache.find(name);
-    if (it == m_lookup_cache.end())
-        return ENOENT;
-    auto child_inode_index = (*it).value;
+    InodeIndex child_inode_index;
+    if (is_indexed_directory()) {
+        auto maybe_child_inode_index = TRY(m_directory_index.lookup(name));
+        if (!maybe_child_inode_index.has_value())
+            return ENOENT;
+        child_inode_index = maybe_child_inode_index.value();
+    } else {
+        TRY(populate_lookup_cache());
+        auto it = m_lookup_cache.find(name);
+        if (it == m_lookup_cache.end())
+            return ENOENT;
+        child_inode_index = (*it).value;
+    }
 
     InodeIdentifier child_id { fsid(), child_inode_index };
     auto child_inode = TRY(fs().get_inode(child_id));
@@ -803,20 +911,26 @@ ErrorOr<void> Ext2FSInode::remove_child_impl(StringView name, RemoveDotEntries r
         TRY(static_cast<Ext2FSInode&>(*child_inode).remove_child_impl(".."sv, RemoveDotEntries::No));
     }
 
-    bool has_file_type_attribute = has_flag(fs().get_features_optional(), Ext2FS::FeaturesOptional::ExtendedAttributes);
+    if (is_indexed_directory()) {
+        // "." and ".." are part of the index root, they go away along with the directory itself.
+        if (name != "."sv && name != ".."sv)
+            TRY(m_directory_index.remove_entry(name));
+    } else {
+        bool has_file_type_attribute = has_flag(fs().get_features_optional(), Ext2FS::FeaturesOptional::ExtendedAttributes);
 
-    Vector<Ext2FSDirectoryEntry> entries;
-    TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
-        if (name != entry.name) {
-            auto entry_name = TRY(KString::try_create(entry.name));
-            TRY(entries.try_append({ move(entry_name), entry.inode.index(), has_file_type_attribute ? entry.file_type : (u8)EXT2_FT_UNKNOWN }));
-        }
-        return {};
-    }));
+        Vector<Ext2FSDirectoryEntry> entries;
+        TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
+            if (name != entry.name) {
+                auto entry_name = TRY(KString::try_create(entry.name));
+                TRY(entries.try_append({ move(entry_name), entry.inode.index(), has_file_type_attribute ? entry.file_type : (u8)EXT2_FT_UNKNOWN }));
+            }
+            return {};
+        }));
 
-    TRY(write_directory(entries));
+        TRY(write_directory(entries));
 
-    m_lookup_cache.remove(it);
+        m_lookup_cache.remove(name);
+    }
 
     TRY(child_inode->decrement_link_count());
 
@@ -857,13 +971,22 @@ ErrorOr<NonnullRefPtr<Inode>> Ext2FSInode::lookup(StringView name)
     InodeIndex inode_index;
     {
         MutexLocker locker(m_inode_lock);
-        TRY(populate_lookup_cache());
-        auto it = m_lookup_cache.find(name);
-        if (it == m_lookup_cache.end()) {
-            dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
-            return ENOENT;
+        if (is_indexed_directory()) {
+            auto maybe_inode_index = TRY(m_directory_index.lookup(name));
+            if (!maybe_inode_index.has_value()) {
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
+                return ENOENT;
+            }
+            inode_index = maybe_inode_index.value();
+        } else {
+            TRY(populate_lookup_cache());
+            auto it = m_lookup_cache.find(name);
+            if (it == m_lookup_cache.end()) {
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
+                return ENOENT;
+            }
+            inode_index = it->value;
         }
-        inode_index = it->value;
     }
 
     return fs().get_inode({ fsid(), inode_index });
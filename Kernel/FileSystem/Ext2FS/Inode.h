@@ -10,6 +10,8 @@
 #include <Kernel/FileSystem/Ext2FS/BlockView.h>
 #include <Kernel/FileSystem/Ext2FS/Definitions.h>
 #include <Kernel/FileSystem/Ext2FS/DirectoryEntry.h>
+#include <Kernel/FileSystem/Ext2FS/DirectoryIndex.h>
+#include <Kernel/FileSystem/Ext2FS/ExtentTree.h>
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/UnixTypes.h>
@@ -19,6 +21,8 @@ namespace Kernel {
 class Ext2FSInode final : public Inode {
     friend class Ext2FS;
     friend class Ext2FSBlockView;
+    friend class Ext2FSExtentTree;
+    friend class Ext2FSDirectoryIndex;
 
 public:
     virtual ~Ext2FSInode() override;
@@ -26,10 +30,13 @@ public:
     u64 size() const;
     bool is_symlink() const { return Kernel::is_symlink(m_raw_inode.i_mode); }
     bool is_directory() const { return Kernel::is_directory(m_raw_inode.i_mode); }
+    bool uses_extents() const { return m_raw_inode.i_flags & EXT4_EXTENTS_FL; }
+    bool is_indexed_directory() const { return is_directory() && (m_raw_inode.i_flags & EXT2_INDEX_FL); }
 
 private:
     // ^Inode
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const override;
+    virtual ErrorOr<size_t> read_bytes_for_page_cache_locked(off_t, size_t, UserOrKernelBuffer& buffer) const override;
     virtual InodeMetadata metadata() const override;
     virtual ErrorOr<void> traverse_as_directory(Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)>) const override;
     virtual ErrorOr<NonnullRefPtr<Inode>> lookup(StringView name) override;
@@ -48,11 +55,20 @@ private:
 
     static u8 to_ext2_file_type(mode_t mode);
 
+    // Uncached reads of physically contiguous blocks are merged into device requests of up to this many blocks.
+    static constexpr size_t max_uncached_read_run_length = 64;
+
+    ErrorOr<size_t> read_bytes_impl(off_t, size_t, UserOrKernelBuffer& buffer, bool allow_cache) const;
+
     static time_t decode_seconds_with_extra(i32 seconds, u32 extra) { return (extra & EXT4_EPOCH_MASK) ? static_cast<time_t>(seconds) + (static_cast<time_t>(extra & EXT4_EPOCH_MASK) << 32) : static_cast<time_t>(seconds); }
     static u32 decode_nanoseconds_from_extra(u32 extra) { return (extra & EXT4_NSEC_MASK) >> EXT4_EPOCH_BITS; }
     static u32 encode_time_to_extra(time_t seconds, u32 nanoseconds) { return (((static_cast<time_t>(seconds) - static_cast<i32>(seconds)) >> 32) & EXT4_EPOCH_MASK) | (nanoseconds << EXT4_EPOCH_BITS); }
 
-    ErrorOr<BlockBasedFileSystem::BlockIndex> allocate_block(BlockBasedFileSystem::BlockIndex, bool zero_newly_allocated_block, bool allow_cache);
+    // Allocates a block for `logical_block_index`, preferably at `goal`. Blocks are reserved in runs of at least
+    // `run_length_hint` blocks, and the ones that aren't used right away are kept for the following blocks of the file.
+    ErrorOr<BlockBasedFileSystem::BlockIndex> allocate_block(BlockBasedFileSystem::BlockIndex logical_block_index, BlockBasedFileSystem::BlockIndex goal, size_t run_length_hint, bool zero_newly_allocated_block, bool allow_cache);
+    ErrorOr<void> zero_block(BlockBasedFileSystem::BlockIndex, bool allow_cache);
+    ErrorOr<void> discard_preallocated_blocks();
     ErrorOr<u32> allocate_and_zero_block();
 
     enum class RemoveDotEntries {
@@ -96,8 +112,14 @@ private:
     Ext2FSInode(Ext2FS&, InodeIndex);
 
     mutable Ext2FSBlockView m_block_view;
+    Ext2FSExtentTree m_extent_tree;
+    Ext2FSDirectoryIndex m_directory_index;
     HashMap<NonnullOwnPtr<KString>, InodeIndex> m_lookup_cache;
     ext2_inode_large m_raw_inode {};
+
+    // Blocks that are marked as allocated in the bitmap, but aren't mapped into the file yet.
+    BlockBasedFileSystem::BlockIndex m_preallocated_first_block { 0 };
+    size_t m_preallocated_block_count { 0 };
 };
 
 inline Ext2FS& Ext2FSInode::fs()
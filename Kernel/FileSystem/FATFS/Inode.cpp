@@ -490,6 +490,17 @@ ErrorOr<Vector<FATEntryLocation>> FATInode::allocate_entries(u32 count)
 }
 
 ErrorOr<size_t> FATInode::read_bytes_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription*) const
+{
+    return read_bytes_impl(offset, count, buffer, true);
+}
+
+ErrorOr<size_t> FATInode::read_bytes_for_page_cache_locked(off_t offset, size_t count, UserOrKernelBuffer& buffer) const
+{
+    // The page cache keeps the contents, caching the blocks as well would only store them twice.
+    return read_bytes_impl(offset, count, buffer, false);
+}
+
+ErrorOr<size_t> FATInode::read_bytes_impl(off_t offset, size_t count, UserOrKernelBuffer& buffer, bool allow_cache) const
 {
     VERIFY(m_inode_lock.is_locked());
     VERIFY(offset >= 0);
@@ -516,9 +527,27 @@ ErrorOr<size_t> FATInode::read_bytes_locked(off_t offset, size_t count, UserOrKe
         size_t to_read = min(fs().m_device_block_size - offset_into_block, remaining_count);
         auto buffer_offset = buffer.offset(nread);
 
+        if (!allow_cache && to_read == fs().m_device_block_size) {
+            // Without the block cache, every request goes to the device, so read physically contiguous blocks in one go.
+            u32 run_length = 1;
+            while (block_index + run_length <= last_block_index
+                && (run_length + 1) * fs().m_device_block_size <= static_cast<u64>(remaining_count)
+                && block_list[block_index + run_length].value() == block_list[block_index].value() + run_length)
+                ++run_length;
+
+            dbgln_if(FAT_DEBUG, "FATInode[{}]::read_bytes_locked(): Reading {} block(s) starting at block {}", identifier(), run_length, block_list[block_index]);
+
+            TRY(fs().read_blocks(block_list[block_index], run_length, buffer_offset, false));
+
+            block_index += run_length - 1;
+            nread += run_length * fs().m_device_block_size;
+            remaining_count -= run_length * fs().m_device_block_size;
+            continue;
+        }
+
         dbgln_if(FAT_DEBUG, "FATInode[{}]::read_bytes_locked(): Reading {} byte(s) from block {} at offset {}", identifier(), to_read, block_list[block_index], offset_into_block);
 
-        TRY(fs().read_block(block_list[block_index], &buffer_offset, to_read, offset_into_block));
+        TRY(fs().read_block(block_list[block_index], &buffer_offset, to_read, offset_into_block, allow_cache));
 
         nread += to_read;
         remaining_count -= to_read;
@@ -602,6 +631,9 @@ ErrorOr<size_t> FATInode::write_bytes_locked(off_t offset, size_t size, UserOrKe
 
     size_t offset_into_first_block = offset - first_block_index * fs().m_device_block_size;
 
+    // The page cache keeps the contents of regular files, so their blocks only have to stay cached until they are written back.
+    bool keep_after_flush = has_flag(m_entry.attributes, FATAttributes::Directory);
+
     size_t nwritten = 0;
     size_t remaining_count = size;
     for (u32 block_index = first_block_index; block_index <= last_block_index; ++block_index) {
@@ -610,7 +642,7 @@ ErrorOr<size_t> FATInode::write_bytes_locked(off_t offset, size_t size, UserOrKe
         size_t to_write = min(fs().m_device_block_size - offset_into_block, remaining_count);
         dbgln_if(FAT_DEBUG, "FATInode[{}]::write_bytes_locked(): Writing {} byte(s) to block {} at offset {}", identifier(), to_write, block_list[block_index], offset_into_block);
 
-        TRY(fs().write_block(block_list[block_index], buffer.offset(nwritten), to_write, offset_into_block));
+        TRY(fs().write_block(block_list[block_index], buffer.offset(nwritten), to_write, offset_into_block, true, keep_after_flush));
 
         nwritten += to_write;
         remaining_count -= to_write;
@@ -85,9 +85,12 @@ private:
 
     ErrorOr<void> remove_child_impl(StringView name, FreeClusters free_clusters);
 
+    ErrorOr<size_t> read_bytes_impl(off_t, size_t, UserOrKernelBuffer& buffer, bool allow_cache) const;
+
     // ^Inode
     virtual ErrorOr<size_t> write_bytes_locked(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*) override;
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const override;
+    virtual ErrorOr<size_t> read_bytes_for_page_cache_locked(off_t, size_t, UserOrKernelBuffer& buffer) const override;
 
     virtual InodeMetadata metadata() const override;
     virtual ErrorOr<void> traverse_as_directory(Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)>) const override;
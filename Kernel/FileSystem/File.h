@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -21,6 +22,18 @@ namespace Kernel {
 
 class File;
 
+// Gets told whenever the state of the File it observes might have changed, without having to block a thread on it (see EPoll).
+// Observers are called with the FileBlockerSet locked, so they must not do much more than take note of the change.
+class FileStateObserver {
+public:
+    virtual ~FileStateObserver() = default;
+    virtual void file_state_changed() = 0;
+
+private:
+    friend class FileBlockerSet;
+    IntrusiveListNode<FileStateObserver> m_observer_list_node;
+};
+
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
     FileBlockerSet() { }
@@ -40,7 +53,24 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& observer : m_observers)
+            observer.file_state_changed();
     }
+
+    void add_observer(FileStateObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        m_observers.append(observer);
+    }
+
+    void remove_observer(FileStateObserver& observer)
+    {
+        SpinlockLocker lock(m_lock);
+        m_observers.remove(observer);
+    }
+
+private:
+    IntrusiveList<&FileStateObserver::m_observer_list_node> m_observers;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -119,6 +149,8 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_epoll() const { return false; }
+    virtual bool is_io_ring() const { return false; }
     virtual bool is_mount_file() const { return false; }
     virtual bool is_unshared_resource_file() const { return false; }
     virtual bool is_loop_device() const { return false; }
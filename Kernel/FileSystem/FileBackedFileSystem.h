@@ -21,6 +21,8 @@ public:
     File const& file() const { return m_file_description->file(); }
     OpenFileDescription& file_description() const { return *m_file_description; }
 
+    virtual bool is_block_based() const { return false; }
+
 protected:
     explicit FileBackedFileSystem(OpenFileDescription&);
 
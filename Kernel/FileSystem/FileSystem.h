@@ -31,6 +31,10 @@ public:
     virtual StringView class_name() const = 0;
     virtual Inode& root_inode() = 0;
     virtual bool supports_watchers() const { return false; }
+    virtual bool supports_page_cache() const { return false; }
+    // File systems that report every change to a directory through Inode::did_add_child() and did_remove_child()
+    // can have the results of their lookups cached by the VFS.
+    virtual bool supports_lookup_cache() const { return false; }
 
     virtual ErrorOr<void> rename(Inode& old_parent_inode, StringView old_basename, Inode& new_parent_inode, StringView new_basename) = 0;
 
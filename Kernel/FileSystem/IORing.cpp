@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/NumericLimits.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Net/Socket.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/UnixTypes.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullRefPtr<IORing>> IORing::try_create(Process& owner, u32 submission_entries)
+{
+    if (submission_entries == 0 || submission_entries > IO_RING_MAX_ENTRIES || !is_power_of_two(submission_entries))
+        return EINVAL;
+
+    auto size = TRY(Memory::page_round_up(IORingLayout::size(submission_entries)));
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, size, "IORing"sv, Memory::Region::Access::ReadWrite));
+    memset(region->vaddr().as_ptr(), 0, size);
+
+    auto ring = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) IORing(owner, move(vmobject), move(region), submission_entries)));
+    ring->header().submission_entries = ring->m_submission_entries;
+    ring->header().completion_entries = ring->m_completion_entries;
+    return ring;
+}
+
+IORing::IORing(Process& owner, NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region, u32 submission_entries)
+    : m_owner(owner)
+    , m_vmobject(move(vmobject))
+    , m_region(move(region))
+    , m_submission_entries(submission_entries)
+    , m_completion_entries(IORingLayout::completion_entries_for(submission_entries))
+{
+}
+
+IORing::~IORing()
+{
+    (void)close();
+}
+
+ErrorOr<void> IORing::close()
+{
+    // Operations that never completed are simply dropped, there is nobody left to collect their completions.
+    MutexLocker locker(m_lock);
+    while (!m_parked_operations.is_empty())
+        unpark(*m_parked_operations.first());
+    return {};
+}
+
+bool IORing::is_owned_by(Process const& process) const
+{
+    auto owner = m_owner.strong_ref();
+    return owner && owner.ptr() == &process;
+}
+
+bool IORing::can_read(OpenFileDescription const&, u64) const
+{
+    if (available_completions() > 0)
+        return true;
+    return m_ready_operations.with([](auto const& list) { return !list.is_empty(); });
+}
+
+ErrorOr<File::VMObjectAndMemoryType> IORing::vmobject_and_memory_type_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared)
+{
+    if (offset != 0 || !shared)
+        return EINVAL;
+
+    return VMObjectAndMemoryType {
+        .vmobject = m_vmobject,
+        .memory_type = Memory::MemoryType::Normal,
+    };
+}
+
+ErrorOr<NonnullOwnPtr<KString>> IORing::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::formatted("IORing:({})", m_submission_entries);
+}
+
+IORingSubmission const& IORing::submission_at(u32 index) const
+{
+    auto* submissions = reinterpret_cast<IORingSubmission const*>(m_region->vaddr().offset(IORingLayout::submissions_offset()).as_ptr());
+    return submissions[index & (m_submission_entries - 1)];
+}
+
+IORingCompletion& IORing::completion_at(u32 index) const
+{
+    auto* completions = reinterpret_cast<IORingCompletion*>(m_region->vaddr().offset(IORingLayout::completions_offset(m_submission_entries)).as_ptr());
+    return completions[index & (m_completion_entries - 1)];
+}
+
+u32 IORing::available_completions() const
+{
+    // NOTE: The head is written by userspace, so don't trust it to be anywhere sensible.
+    auto head = AK::atomic_load(&header().completion_head, AK::memory_order_acquire);
+    auto tail = AK::atomic_load(&header().completion_tail, AK::memory_order_relaxed);
+    return min(tail - head, m_completion_entries);
+}
+
+u32 IORing::free_completions() const
+{
+    VERIFY(m_lock.is_locked());
+    auto reserved = available_completions() + m_parked_operation_count;
+    if (reserved >= m_completion_entries)
+        return 0;
+    return m_completion_entries - reserved;
+}
+
+bool IORing::has_parked_operations()
+{
+    MutexLocker locker(m_lock);
+    return m_parked_operation_count > 0;
+}
+
+void IORing::post_completion(u64 user_data, ErrorOr<FlatPtr> const& result)
+{
+    VERIFY(m_lock.is_locked());
+    auto tail = header().completion_tail;
+    auto& completion = completion_at(tail);
+    completion.user_data = user_data;
+    completion.result = result.is_error() ? -static_cast<i64>(result.error().code()) : static_cast<i64>(result.value());
+    AK::atomic_store(&header().completion_tail, tail + 1, AK::memory_order_release);
+}
+
+u32 IORing::submit(Process& process, u32 count)
+{
+    MutexLocker locker(m_lock);
+
+    u32 submitted = 0;
+    // Every operation we start needs to be able to post its completion, even if it has to wait for its file first.
+    while (submitted < count && free_completions() > 0) {
+        // NOTE: Starting an operation may let go of the lock, so someone else might have taken submissions meanwhile.
+        auto head = header().submission_head;
+        auto tail = AK::atomic_load(&header().submission_tail, AK::memory_order_acquire);
+        if (head == tail)
+            break;
+        // NOTE: The submission lives in memory that userspace can modify at any time, so we work on a copy of it.
+        auto submission = submission_at(head);
+        ++submitted;
+        AK::atomic_store(&header().submission_head, head + 1, AK::memory_order_release);
+        start_operation(process, submission, locker);
+    }
+    if (submitted > 0) {
+        m_wait_queue.wake_all();
+        evaluate_block_conditions();
+    }
+    return submitted;
+}
+
+void IORing::start_operation(Process& process, IORingSubmission const& submission, MutexLocker& locker)
+{
+    if (submission.opcode == IORingOpcode::Nop) {
+        post_completion(submission.user_data, 0);
+        return;
+    }
+
+    auto description_or_error = process.open_file_description(submission.fd);
+    if (description_or_error.is_error()) {
+        post_completion(submission.user_data, description_or_error.release_error());
+        return;
+    }
+
+    auto operation = adopt_ref_if_nonnull(new (nothrow) Operation(*this, submission, description_or_error.release_value()));
+    if (!operation) {
+        post_completion(submission.user_data, ENOMEM);
+        return;
+    }
+
+    if (submission.opcode == IORingOpcode::Connect) {
+        start_connect(process, *operation, locker);
+        return;
+    }
+
+    auto result = try_perform(process, *operation);
+    if (result.is_error() && result.error().code() == EAGAIN) {
+        park(*operation);
+        // The file might have become ready before we started observing it.
+        result = try_perform(process, *operation);
+        if (result.is_error() && result.error().code() == EAGAIN)
+            return;
+        unpark(*operation);
+    }
+    post_completion(submission.user_data, result);
+}
+
+void IORing::start_connect(Process& process, Operation& operation, MutexLocker& locker)
+{
+    // Connecting is the only operation that has to be started before we can wait for it.
+    // NOTE: On a blocking socket, connect() waits until the connection is established. The operation is parked
+    //       meanwhile, so its completion stays reserved, but we let go of the ring so nobody else has to wait for it.
+    auto const& submission = operation.submission;
+    auto& description = *operation.description;
+    operation.connect_in_progress = true;
+    park(operation);
+    locker.unlock();
+    auto connect_result = [&]() -> ErrorOr<void> {
+        if (!description.is_socket())
+            return ENOTSOCK;
+        auto& socket = *description.socket();
+        if (socket.domain() == AF_LOCAL)
+            TRY(process.require_promise(Pledge::unix));
+        else
+            TRY(process.require_promise(Pledge::inet));
+        Userspace<sockaddr const*> user_address(static_cast<FlatPtr>(submission.address));
+        return socket.connect(process.credentials(), description, user_address, submission.length);
+    }();
+    locker.lock();
+    operation.connect_in_progress = false;
+
+    // Closing the ring while we were connecting dropped the operation, and there is nobody left to tell about it.
+    if (!operation.parked_list_node.is_in_list())
+        return;
+
+    if (connect_result.is_error() && connect_result.error().code() != EINPROGRESS) {
+        unpark(operation);
+        post_completion(submission.user_data, connect_result.release_error());
+        return;
+    }
+
+    auto result = try_perform(process, operation);
+    if (result.is_error() && result.error().code() == EAGAIN)
+        return;
+    unpark(operation);
+    post_completion(submission.user_data, result);
+}
+
+void IORing::process_ready_operations(Process& process)
+{
+    MutexLocker locker(m_lock);
+
+    // Operations that get marked ready again while we're at it are left for the next time around.
+    auto ready_count = m_ready_operations.with([](auto& list) { return list.size_slow(); });
+
+    bool did_complete = false;
+    for (size_t i = 0; i < ready_count; ++i) {
+        // NOTE: Unparking the operation drops the last reference to it, so keep it alive until we're done.
+        RefPtr<Operation> operation = m_ready_operations.with([](auto& list) { return list.take_first(); });
+        if (!operation)
+            break;
+        auto result = try_perform(process, *operation);
+        if (result.is_error() && result.error().code() == EAGAIN)
+            continue; // It's still parked, and will be marked ready again on the next state change of its file.
+        unpark(*operation);
+        post_completion(operation->submission.user_data, result);
+        did_complete = true;
+    }
+
+    if (did_complete) {
+        m_wait_queue.wake_all();
+        evaluate_block_conditions();
+    }
+}
+
+ErrorOr<void> IORing::wait_for_completions(Process& process, u32 min_complete)
+{
+    while (true) {
+        process_ready_operations(process);
+        if (available_completions() >= min_complete)
+            return {};
+        // Nothing we could wait for is going to produce more completions.
+        if (!has_parked_operations())
+            return {};
+        // NOTE: If an operation gets marked ready before we get to wait, the wait queue remembers the wake-up.
+        if (m_wait_queue.wait_on({}, "IORing"sv).was_interrupted())
+            return EINTR;
+    }
+}
+
+void IORing::park(Operation& operation)
+{
+    VERIFY(m_lock.is_locked());
+    m_parked_operations.append(operation);
+    ++m_parked_operation_count;
+    operation.description->blocker_set().add_observer(operation);
+}
+
+void IORing::unpark(Operation& operation)
+{
+    VERIFY(m_lock.is_locked());
+    // Once this returns, the file won't call us anymore.
+    operation.description->blocker_set().remove_observer(operation);
+    m_ready_operations.with([&](auto& list) {
+        if (operation.ready_list_node.is_in_list())
+            list.remove(operation);
+    });
+    --m_parked_operation_count;
+    m_parked_operations.remove(operation);
+}
+
+void IORing::mark_ready(Operation& operation)
+{
+    bool was_added = m_ready_operations.with([&](auto& list) {
+        if (operation.ready_list_node.is_in_list())
+            return false;
+        list.append(operation);
+        return true;
+    });
+    // Wake up anyone waiting in io_ring_enter(), so they retry the operation.
+    if (was_added) {
+        m_wait_queue.wake_all();
+        evaluate_block_conditions();
+    }
+}
+
+ErrorOr<FlatPtr> IORing::try_perform(Process& process, Operation& operation)
+{
+    auto const& submission = operation.submission;
+    auto& description = *operation.description;
+
+    switch (submission.opcode) {
+    case IORingOpcode::Read: {
+        if (!description.is_readable())
+            return EBADF;
+        if (description.is_directory())
+            return EISDIR;
+        if (submission.length == 0)
+            return 0;
+        if (submission.length > NumericLimits<ssize_t>::max())
+            return EINVAL;
+        if (!description.can_read())
+            return EAGAIN;
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(submission.address), submission.length));
+        if (submission.offset == IO_RING_CURRENT_OFFSET)
+            return TRY(description.read(buffer, submission.length));
+        if (!description.file().is_seekable() || submission.offset > static_cast<u64>(NumericLimits<off_t>::max()))
+            return EINVAL;
+        return TRY(description.read(buffer, submission.offset, submission.length));
+    }
+    case IORingOpcode::Write: {
+        if (!description.is_writable())
+            return EBADF;
+        if (submission.length == 0)
+            return 0;
+        if (submission.length > NumericLimits<ssize_t>::max())
+            return EINVAL;
+        if (!description.can_write())
+            return EAGAIN;
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(submission.address), submission.length));
+        if (submission.offset == IO_RING_CURRENT_OFFSET) {
+            if (description.should_append() && description.file().is_seekable())
+                TRY(description.seek(0, SEEK_END));
+            return TRY(description.write(buffer, submission.length));
+        }
+        if (!description.file().is_seekable() || submission.offset > static_cast<u64>(NumericLimits<off_t>::max()))
+            return EINVAL;
+        return TRY(description.write(submission.offset, buffer, submission.length));
+    }
+    case IORingOpcode::Fsync:
+        TRY(description.sync());
+        return 0;
+    case IORingOpcode::Accept: {
+        TRY(process.require_promise(Pledge::accept));
+        if (!description.is_socket())
+            return ENOTSOCK;
+        if (submission.flags & ~(SOCK_NONBLOCK | SOCK_CLOEXEC))
+            return EINVAL;
+
+        Userspace<sockaddr*> user_address(static_cast<FlatPtr>(submission.address));
+        Userspace<socklen_t*> user_address_size(static_cast<FlatPtr>(submission.address_length));
+        socklen_t address_size = 0;
+        if (user_address)
+            TRY(copy_from_user(&address_size, static_ptr_cast<socklen_t const*>(user_address_size)));
+
+        auto fd_allocation = TRY(process.allocate_fd());
+        auto accepted_socket = description.socket()->accept();
+        if (!accepted_socket)
+            return EAGAIN;
+
+        if (user_address) {
+            sockaddr_un address_buffer {};
+            address_size = min(sizeof(sockaddr_un), static_cast<size_t>(address_size));
+            accepted_socket->get_peer_address((sockaddr*)&address_buffer, &address_size);
+            TRY(copy_to_user(user_address, &address_buffer, address_size));
+            TRY(copy_to_user(user_address_size, &address_size));
+        }
+
+        auto accepted_socket_description = TRY(OpenFileDescription::try_create(*accepted_socket));
+        accepted_socket_description->set_readable(true);
+        accepted_socket_description->set_writable(true);
+        if (submission.flags & SOCK_NONBLOCK)
+            accepted_socket_description->set_blocking(false);
+        int fd_flags = 0;
+        if (submission.flags & SOCK_CLOEXEC)
+            fd_flags |= FD_CLOEXEC;
+
+        process.fds().with_exclusive([&](auto& fds) {
+            fds[fd_allocation.fd].set(move(accepted_socket_description), fd_flags);
+        });
+
+        // NOTE: Moving this state to Completed is what causes connect() to unblock on the client side.
+        accepted_socket->set_setup_state(Socket::SetupState::Completed);
+        return fd_allocation.fd;
+    }
+    case IORingOpcode::Connect: {
+        // The connection was started in start_connect(), so all that's left is to wait for it to be established.
+        if (operation.connect_in_progress)
+            return EAGAIN;
+        auto& socket = *description.socket();
+        auto error = socket.so_error().with([](auto& so_error) -> Optional<ErrnoCode> {
+            if (!so_error.has_value() || so_error.value() == EINPROGRESS)
+                return {};
+            return exchange(so_error, {});
+        });
+        if (error.has_value())
+            return Error::from_errno(error.value());
+        if (!socket.is_connected())
+            return EAGAIN;
+        socket.clear_so_error();
+        return 0;
+    }
+    case IORingOpcode::Nop:
+        VERIFY_NOT_REACHED();
+    }
+    return EINVAL;
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/IntrusiveList.h>
+#include <AK/RefCounted.h>
+#include <Kernel/API/IORing.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Library/LockWeakPtr.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Tasks/DeprecatedWaitQueue.h>
+
+namespace Kernel {
+
+// The kernel side of an I/O ring (see Kernel/API/IORing.h).
+// Operations on files that aren't ready yet don't block: They are parked, and observe their file like an EPoll watch
+// does. Whenever a thread enters the ring, operations whose file changed its state are retried, so a single thread can
+// keep any number of operations in flight.
+// Operations refer to buffers in the address space of the process that created the ring, so only that process can
+// enter it, even if the ring's file descriptor is inherited or passed to another process.
+class IORing final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<IORing>> try_create(Process& owner, u32 submission_entries);
+    virtual ~IORing() override;
+
+    // Readable means there are completions to collect, or operations to retry with io_ring_enter().
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> close() override;
+    virtual ErrorOr<VMObjectAndMemoryType> vmobject_and_memory_type_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "IORing"sv; }
+    virtual bool is_io_ring() const override { return true; }
+
+    // Starts up to `count` operations from the submission queue, and returns how many were taken off of it.
+    // Fewer are taken if there wouldn't be enough room in the completion queue for all of them.
+    u32 submit(Process&, u32 count);
+
+    // Retries parked operations whenever their file changes its state, until there are at least `min_complete`
+    // completions to collect, or there is nothing left to wait for.
+    ErrorOr<void> wait_for_completions(Process&, u32 min_complete);
+
+    u32 available_completions() const;
+
+    bool is_owned_by(Process const&) const;
+
+private:
+    struct Operation final
+        : public RefCounted<Operation>
+        , public FileStateObserver {
+        Operation(IORing& ring, IORingSubmission const& submission, NonnullRefPtr<OpenFileDescription> description)
+            : ring(ring)
+            , submission(submission)
+            , description(move(description))
+        {
+        }
+
+        virtual void file_state_changed() override { ring.mark_ready(*this); }
+
+        IORing& ring;
+        IORingSubmission const submission;
+        NonnullRefPtr<OpenFileDescription> description;
+        // Set while start_connect() is waiting for connect() without holding the ring's lock.
+        bool connect_in_progress { false };
+
+        IntrusiveListNode<Operation, RefPtr<Operation>> parked_list_node;
+        IntrusiveListNode<Operation> ready_list_node;
+    };
+
+    using ParkedList = IntrusiveList<&Operation::parked_list_node>;
+    using ReadyList = IntrusiveList<&Operation::ready_list_node>;
+
+    IORing(Process& owner, NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>, u32 submission_entries);
+
+    IORingHeader& header() const { return *reinterpret_cast<IORingHeader*>(m_region->vaddr().as_ptr()); }
+    IORingSubmission const& submission_at(u32 index) const;
+    IORingCompletion& completion_at(u32 index) const;
+    u32 free_completions() const;
+
+    bool has_parked_operations();
+    void process_ready_operations(Process&);
+    void start_operation(Process&, IORingSubmission const&, MutexLocker&);
+    void start_connect(Process&, Operation&, MutexLocker&);
+    // Returns EAGAIN if the operation has to wait for its file.
+    ErrorOr<FlatPtr> try_perform(Process&, Operation&);
+    void park(Operation&);
+    void unpark(Operation&);
+    void mark_ready(Operation&);
+    void post_completion(u64 user_data, ErrorOr<FlatPtr> const& result);
+
+    LockWeakPtr<Process> const m_owner;
+    NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Memory::Region> m_region;
+    u32 const m_submission_entries { 0 };
+    u32 const m_completion_entries { 0 };
+
+    Mutex m_lock { "IORing"sv };
+    ParkedList m_parked_operations;
+    size_t m_parked_operation_count { 0 };
+    SpinlockProtected<ReadyList, LockRank::None> m_ready_operations {};
+    DeprecatedWaitQueue m_wait_queue;
+};
+
+}
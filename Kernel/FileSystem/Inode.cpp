@@ -12,10 +12,13 @@
 #include <Kernel/FileSystem/Custody.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
+#include <Kernel/FileSystem/LookupCache.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
 #include <Kernel/FileSystem/VFSRootContext.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Library/KBufferBuilder.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Net/LocalSocket.h>
 #include <Kernel/Tasks/Process.h>
@@ -24,6 +27,26 @@ namespace Kernel {
 
 static Singleton<SpinlockProtected<Inode::AllInstancesList, LockRank::None>> s_all_instances;
 
+struct GlobalPageCacheList {
+    Inode::PageCacheList entries;
+    size_t size { 0 };
+};
+
+// Every page in the page cache of any inode, in the order in which eviction looks at them.
+// Eviction only takes this lock and none of the inodes' locks, so it can be done from within the memory manager.
+static Singleton<SpinlockProtected<GlobalPageCacheList, LockRank::None>> s_page_cache_list;
+
+static RefPtr<Memory::PhysicalRAMPage> take_page_cache_entry_page(Inode::PageCacheEntry& entry)
+{
+    return s_page_cache_list->with([&](auto& list) -> RefPtr<Memory::PhysicalRAMPage> {
+        if (!entry.page)
+            return nullptr;
+        list.entries.remove(entry);
+        --list.size;
+        return move(entry.page);
+    });
+}
+
 SpinlockProtected<Inode::AllInstancesList, LockRank::None>& Inode::all_instances()
 {
     return s_all_instances;
@@ -80,6 +103,10 @@ Inode::~Inode()
     m_watchers.for_each([&](auto& watcher) {
         watcher->unregister_by_inode({}, identifier());
     });
+    m_page_cache.with_exclusive([&](auto& page_cache) {
+        for (auto& it : page_cache)
+            (void)take_page_cache_entry_page(*it.value);
+    });
 }
 
 void Inode::will_be_destroyed()
@@ -92,7 +119,10 @@ void Inode::will_be_destroyed()
 ErrorOr<void> Inode::truncate(u64 size)
 {
     MutexLocker locker(m_inode_lock);
-    return truncate_locked(size);
+    TRY(truncate_locked(size));
+    if (uses_page_cache())
+        invalidate_page_cache_locked(size);
+    return {};
 }
 
 ErrorOr<size_t> Inode::write_bytes(off_t offset, size_t length, UserOrKernelBuffer const& target_buffer, OpenFileDescription* open_description)
@@ -105,15 +135,279 @@ ErrorOr<size_t> Inode::prepare_and_write_bytes_locked(off_t offset, size_t lengt
 {
     VERIFY(m_inode_lock.is_locked());
     TRY(prepare_to_write_data());
-    return write_bytes_locked(offset, length, target_buffer, open_description);
+    auto nwritten = TRY(write_bytes_locked(offset, length, target_buffer, open_description));
+    // NOTE: Writes go straight through to the file system, we only have to keep pages we already cached up to date.
+    if (nwritten > 0 && uses_page_cache())
+        TRY(update_page_cache_locked(offset, nwritten, target_buffer));
+    return nwritten;
 }
 
 ErrorOr<size_t> Inode::read_bytes(off_t offset, size_t length, UserOrKernelBuffer& buffer, OpenFileDescription* open_description) const
 {
     MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    if (uses_page_cache() && !(open_description && open_description->is_direct()))
+        return read_bytes_from_page_cache_locked(offset, length, buffer);
     return read_bytes_locked(offset, length, buffer, open_description);
 }
 
+bool Inode::uses_page_cache() const
+{
+    return fs().supports_page_cache() && metadata().is_regular_file();
+}
+
+ErrorOr<RefPtr<Memory::PhysicalRAMPage>> Inode::page_cache_page(size_t page_index) const
+{
+    VERIFY(uses_page_cache());
+    MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    return page_cache_page_locked(page_index);
+}
+
+ErrorOr<RefPtr<Memory::PhysicalRAMPage>> Inode::page_cache_page_locked(size_t page_index) const
+{
+    VERIFY(m_inode_lock.is_locked());
+
+    auto page = find_page_cache_page(page_index);
+    if (!page)
+        page = TRY(fill_page_cache_locked(page_index, page_cache_read_ahead_for_miss(page_index)));
+    m_next_sequential_page_index.store(page_index + 1, AK::MemoryOrder::memory_order_relaxed);
+    return page;
+}
+
+RefPtr<Memory::PhysicalRAMPage> Inode::find_page_cache_page(size_t page_index) const
+{
+    return m_page_cache.with_exclusive([&](auto& page_cache) -> RefPtr<Memory::PhysicalRAMPage> {
+        auto it = page_cache.find(page_index);
+        if (it == page_cache.end())
+            return nullptr;
+        auto& entry = *it->value;
+        return s_page_cache_list->with([&](auto&) {
+            entry.referenced = true;
+            return entry.page;
+        });
+    });
+}
+
+size_t Inode::page_cache_read_ahead_for_miss(size_t page_index) const
+{
+    // NOTE: This is only a heuristic, so concurrent readers racing on it is harmless.
+    if (page_index != m_next_sequential_page_index.load(AK::MemoryOrder::memory_order_relaxed)) {
+        // Random access, reading ahead would only waste memory.
+        m_page_cache_read_ahead_window.store(0, AK::MemoryOrder::memory_order_relaxed);
+        return 1;
+    }
+    auto window = m_page_cache_read_ahead_window.load(AK::MemoryOrder::memory_order_relaxed);
+    window = min(max(window * 2, initial_page_cache_read_ahead_pages), maximum_page_cache_read_ahead_pages);
+    m_page_cache_read_ahead_window.store(window, AK::MemoryOrder::memory_order_relaxed);
+    return window;
+}
+
+ErrorOr<RefPtr<Memory::PhysicalRAMPage>> Inode::fill_page_cache_locked(size_t first_page_index, size_t page_count) const
+{
+    VERIFY(m_inode_lock.is_locked());
+
+    // Only read up to the next page we already have, so everything can be read with a single request.
+    size_t run_length = 1;
+    m_page_cache.with_exclusive([&](auto& page_cache) {
+        while (run_length < page_count && !page_cache.contains(first_page_index + run_length))
+            ++run_length;
+    });
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(run_length * PAGE_SIZE));
+    auto user_or_kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer.data());
+    auto nread = TRY(read_bytes_for_page_cache_locked(first_page_index * PAGE_SIZE, buffer.size(), user_or_kernel_buffer));
+    if (nread == 0)
+        return nullptr;
+
+    // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
+    auto pages_read = ceil_div(nread, PAGE_SIZE);
+    memset(buffer.data() + nread, 0, pages_read * PAGE_SIZE - nread);
+
+    RefPtr<Memory::PhysicalRAMPage> first_page;
+    for (size_t i = 0; i < pages_read; ++i) {
+        auto page_or_error = MM.allocate_physical_page(Memory::MemoryManager::ShouldZeroFill::No);
+        if (page_or_error.is_error()) {
+            // Not caching pages we read ahead is fine, but the page that was asked for has to be there.
+            if (!first_page)
+                return page_or_error.release_error();
+            break;
+        }
+        auto new_page = page_or_error.release_value();
+        {
+            InterruptDisabler disabler;
+            u8* dest_ptr = MM.quickmap_page(*new_page);
+            memcpy(dest_ptr, buffer.data() + i * PAGE_SIZE, PAGE_SIZE);
+            MM.unquickmap_page();
+        }
+
+        auto cached_page_or_error = add_page_to_page_cache(first_page_index + i, move(new_page));
+        if (cached_page_or_error.is_error()) {
+            if (!first_page)
+                return cached_page_or_error.release_error();
+            break;
+        }
+        if (!first_page)
+            first_page = cached_page_or_error.release_value();
+    }
+    return first_page;
+}
+
+ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> Inode::add_page_to_page_cache(size_t page_index, NonnullRefPtr<Memory::PhysicalRAMPage> page) const
+{
+    return m_page_cache.with_exclusive([&](auto& page_cache) -> ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> {
+        // Entries of evicted pages stick around until their page is read again, so drop them once they make up half of the cache.
+        if (auto evicted_entry_count = m_evicted_page_cache_entry_count.load(AK::MemoryOrder::memory_order_relaxed); evicted_entry_count > 0 && evicted_entry_count >= page_cache.size() / 2) {
+            m_evicted_page_cache_entry_count.store(0, AK::MemoryOrder::memory_order_relaxed);
+            page_cache.remove_all_matching([&](size_t, auto& entry) {
+                return s_page_cache_list->with([&](auto&) { return !entry->page; });
+            });
+        }
+
+        auto it = page_cache.find(page_index);
+        if (it == page_cache.end()) {
+            auto new_entry = TRY(adopt_nonnull_own_or_enomem(new (nothrow) PageCacheEntry { .owner = this }));
+            TRY(page_cache.try_set(page_index, move(new_entry)));
+            it = page_cache.find(page_index);
+        }
+
+        auto& entry = *it->value;
+        return s_page_cache_list->with([&](auto& list) -> NonnullRefPtr<Memory::PhysicalRAMPage> {
+            // Another reader may have cached this page while we were reading it.
+            if (entry.page)
+                return *entry.page;
+            entry.page = page;
+            entry.referenced = false;
+            list.entries.append(entry);
+            ++list.size;
+            return page;
+        });
+    });
+}
+
+ErrorOr<size_t> Inode::read_bytes_from_page_cache_locked(off_t offset, size_t length, UserOrKernelBuffer& buffer) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+
+    auto file_size = size();
+    if (static_cast<u64>(offset) >= file_size)
+        return 0;
+    length = min<u64>(length, file_size - offset);
+
+    u8 page_buffer[PAGE_SIZE];
+    size_t nread = 0;
+    while (nread < length) {
+        auto position = offset + nread;
+        auto offset_in_page = position % PAGE_SIZE;
+        auto chunk_size = min(PAGE_SIZE - offset_in_page, length - nread);
+
+        auto page = TRY(page_cache_page_locked(position / PAGE_SIZE));
+        if (!page)
+            break;
+
+        // NOTE: The destination may be a userspace buffer, which could page fault, so we can't copy straight out of a quickmapped page.
+        MM.copy_physical_page(*page, page_buffer);
+        TRY(buffer.write(page_buffer + offset_in_page, nread, chunk_size));
+        nread += chunk_size;
+    }
+    return nread;
+}
+
+ErrorOr<void> Inode::update_page_cache_locked(off_t offset, size_t length, UserOrKernelBuffer const& data)
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(offset >= 0);
+
+    u8 page_buffer[PAGE_SIZE];
+    size_t nupdated = 0;
+    while (nupdated < length) {
+        auto position = offset + nupdated;
+        auto offset_in_page = position % PAGE_SIZE;
+        auto chunk_size = min(PAGE_SIZE - offset_in_page, length - nupdated);
+
+        if (auto page = find_page_cache_page(position / PAGE_SIZE)) {
+            // Only touch the bytes that were written, a shared mapping may be writing to the rest of the page concurrently.
+            TRY(data.read(page_buffer, nupdated, chunk_size));
+            InterruptDisabler disabler;
+            u8* dest_ptr = MM.quickmap_page(*page);
+            memcpy(dest_ptr + offset_in_page, page_buffer, chunk_size);
+            MM.unquickmap_page();
+        }
+        nupdated += chunk_size;
+    }
+    return {};
+}
+
+void Inode::invalidate_page_cache_locked(u64 from_offset)
+{
+    VERIFY(m_inode_lock.is_locked());
+    auto first_page_index = from_offset / PAGE_SIZE;
+    m_page_cache.with_exclusive([&](auto& page_cache) {
+        page_cache.remove_all_matching([&](size_t page_index, auto& entry) {
+            if (page_index < first_page_index)
+                return false;
+            // NOTE: The page is freed once we've let go of the page cache list lock, as that takes the memory manager's lock.
+            (void)take_page_cache_entry_page(*entry);
+            return true;
+        });
+    });
+}
+
+size_t Inode::release_unmapped_page_cache_pages()
+{
+    return m_page_cache.with_exclusive([&](auto& page_cache) {
+        size_t count = 0;
+        page_cache.remove_all_matching([&](size_t, auto& entry) {
+            bool is_mapped = false;
+            auto page = s_page_cache_list->with([&](auto& list) -> RefPtr<Memory::PhysicalRAMPage> {
+                // If anyone but us holds a reference, the page is mapped by an InodeVMObject and wouldn't be freed.
+                if (!entry->page || entry->page->ref_count() != 1) {
+                    is_mapped = !entry->page.is_null();
+                    return nullptr;
+                }
+                list.entries.remove(*entry);
+                --list.size;
+                return move(entry->page);
+            });
+            if (is_mapped)
+                return false;
+            if (page)
+                ++count;
+            return true;
+        });
+        return count;
+    });
+}
+
+size_t Inode::evict_page_cache_pages(size_t max_count)
+{
+    // NOTE: We can't free pages while holding the page cache list lock, so we evict at most this many pages at once.
+    Array<RefPtr<Memory::PhysicalRAMPage>, 32> evicted_pages;
+    max_count = min(max_count, evicted_pages.size());
+
+    size_t evicted_count = 0;
+    s_page_cache_list->with([&](auto& list) {
+        // This is the CLOCK algorithm: pages that were accessed since we last looked at them get moved to the back
+        // of the list instead of being evicted. Looking at every page twice is enough to find all unused ones.
+        for (size_t remaining_steps = list.size * 2; remaining_steps > 0 && evicted_count < max_count; --remaining_steps) {
+            auto* entry = list.entries.first();
+            if (!entry)
+                break;
+            // If anyone but us holds a reference, the page is mapped by an InodeVMObject and wouldn't be freed.
+            if (entry->referenced || entry->page->ref_count() != 1) {
+                entry->referenced = false;
+                list.entries.append(*entry);
+                continue;
+            }
+            list.entries.remove(*entry);
+            --list.size;
+            evicted_pages[evicted_count++] = move(entry->page);
+            entry->owner->m_evicted_page_cache_entry_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        }
+    });
+    // NOTE: The evicted pages are freed when we return, after we've let go of the page cache list lock.
+    return evicted_count;
+}
+
 ErrorOr<size_t> Inode::read_until_filled_or_end(off_t offset, size_t length, UserOrKernelBuffer buffer, OpenFileDescription* open_description) const
 {
     auto remaining_length = length;
@@ -227,6 +521,8 @@ void Inode::set_metadata_dirty(bool metadata_dirty)
 
 void Inode::did_add_child(InodeIdentifier, StringView name)
 {
+    LookupCache::the().did_add_child(*this, name);
+
     m_watchers.for_each([&](auto& watcher) {
         watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::ChildCreated, name);
     });
@@ -234,6 +530,8 @@ void Inode::did_add_child(InodeIdentifier, StringView name)
 
 void Inode::did_remove_child(InodeIdentifier, StringView name)
 {
+    LookupCache::the().did_remove_child(*this, name);
+
     if (name == "." || name == "..") {
         // These are just aliases and are not interesting to userspace.
         return;
@@ -7,8 +7,10 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Error.h>
 #include <AK/Function.h>
+#include <AK/HashMap.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveList.h>
 #include <Kernel/FileSystem/CustodyBase.h>
@@ -20,6 +22,8 @@
 #include <Kernel/Library/ListedRefCounted.h>
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Memory/PhysicalRAMPage.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 
 namespace Kernel {
@@ -90,6 +94,28 @@ public:
     ErrorOr<void> set_shared_vmobject(Memory::SharedInodeVMObject&);
     LockRefPtr<Memory::SharedInodeVMObject> shared_vmobject() const;
 
+    // Regular files on file systems that support it keep their contents in a page cache.
+    // read() and write() go through it, and shared mappings of the inode map the very same physical pages.
+    bool uses_page_cache() const;
+    // Returns the cached page at `page_index`, reading it in if necessary, or nullptr if it's past the end of the file.
+    ErrorOr<RefPtr<Memory::PhysicalRAMPage>> page_cache_page(size_t page_index) const;
+    // Drops all cached pages that aren't mapped anywhere, returns how many pages were freed.
+    size_t release_unmapped_page_cache_pages();
+    // Frees up to `max_count` cached pages of any inode that aren't mapped anywhere, returns how many pages were freed.
+    // This never blocks, so the memory manager can call it when it runs out of physical pages.
+    static size_t evict_page_cache_pages(size_t max_count);
+
+    struct PageCacheEntry {
+        IntrusiveListNode<PageCacheEntry> list_node;
+        Inode const* owner { nullptr };
+        // NOTE: Both of these are protected by the lock of the global page cache list.
+        //       The entry is on that list exactly when it holds a page, an evicted entry is refilled on its next access.
+        RefPtr<Memory::PhysicalRAMPage> page;
+        // Set whenever the page is accessed, eviction gives such pages a second chance.
+        bool referenced { false };
+    };
+    using PageCacheList = IntrusiveList<&PageCacheEntry::list_node>;
+
     static void sync_all();
     void sync();
 
@@ -124,7 +150,26 @@ protected:
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const = 0;
     virtual ErrorOr<void> truncate_locked(u64) { return {}; }
 
+    // Reads file contents into the page cache. File systems that cache blocks should bypass that cache here.
+    virtual ErrorOr<size_t> read_bytes_for_page_cache_locked(off_t offset, size_t length, UserOrKernelBuffer& buffer) const { return read_bytes_locked(offset, length, buffer, nullptr); }
+
 private:
+    // Read-ahead starts with this many pages once a sequential access pattern is detected,
+    // and doubles with every further sequential miss until it reaches maximum_page_cache_read_ahead_pages.
+    static constexpr size_t initial_page_cache_read_ahead_pages = 4;
+    static constexpr size_t maximum_page_cache_read_ahead_pages = 32;
+
+    ErrorOr<RefPtr<Memory::PhysicalRAMPage>> page_cache_page_locked(size_t page_index) const;
+    RefPtr<Memory::PhysicalRAMPage> find_page_cache_page(size_t page_index) const;
+    // Reads `page_index` and up to `page_count - 1` following pages into the page cache, returns the page at `page_index`.
+    ErrorOr<RefPtr<Memory::PhysicalRAMPage>> fill_page_cache_locked(size_t page_index, size_t page_count) const;
+    ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> add_page_to_page_cache(size_t page_index, NonnullRefPtr<Memory::PhysicalRAMPage>) const;
+    // Returns how many pages (including `page_index` itself) should be read for an access that missed the page cache.
+    size_t page_cache_read_ahead_for_miss(size_t page_index) const;
+    ErrorOr<size_t> read_bytes_from_page_cache_locked(off_t, size_t, UserOrKernelBuffer& buffer) const;
+    ErrorOr<void> update_page_cache_locked(off_t, size_t, UserOrKernelBuffer const& data);
+    void invalidate_page_cache_locked(u64 from_offset);
+
     struct Flock {
         off_t start;
         off_t len;
@@ -139,6 +184,11 @@ private:
     FileSystem& m_file_system;
     InodeIndex m_index { 0 };
     LockWeakPtr<Memory::SharedInodeVMObject> m_shared_vmobject;
+    mutable MutexProtected<HashMap<size_t, NonnullOwnPtr<PageCacheEntry>>> m_page_cache;
+    // How many entries of m_page_cache have been evicted since we last dropped the evicted ones.
+    mutable Atomic<size_t> m_evicted_page_cache_entry_count { 0 };
+    mutable Atomic<size_t> m_next_sequential_page_index { 0 };
+    mutable Atomic<size_t> m_page_cache_read_ahead_window { 0 };
     LockWeakPtr<LocalSocket> m_bound_socket;
     SpinlockProtected<HashTable<InodeWatcher*>, LockRank::None> m_watchers {};
     bool m_metadata_dirty { false };
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/LookupCache.h>
+
+namespace Kernel {
+
+static Singleton<LookupCache> s_the;
+
+LookupCache& LookupCache::the()
+{
+    return *s_the;
+}
+
+SpinlockProtected<LookupCache::Shard, LockRank::None>& LookupCache::shard_for(Key const& key)
+{
+    return m_shards[KeyTraits::hash(key) % shard_count];
+}
+
+void LookupCache::remove_entry(Shard& shard, Key const& key)
+{
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end())
+        return;
+    shard.lru_list.remove(*it->value);
+    shard.entries.remove(it);
+}
+
+ErrorOr<NonnullRefPtr<Inode>> LookupCache::lookup(Inode& parent, StringView name)
+{
+    if (!parent.fs().supports_lookup_cache())
+        return parent.lookup(name);
+
+    Key key { parent.identifier(), name };
+    bool is_known_missing = false;
+    RefPtr<Inode> cached_child;
+    auto generation = shard_for(key).with([&](auto& shard) {
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end()) {
+            auto& entry = *it->value;
+            shard.lru_list.remove(entry);
+            shard.lru_list.append(entry);
+            if (!entry.child.is_valid())
+                is_known_missing = true;
+            else if (auto child = entry.child_inode.strong_ref())
+                cached_child = *child;
+        }
+        return shard.generation;
+    });
+
+    if (is_known_missing)
+        return ENOENT;
+    if (cached_child)
+        return cached_child.release_nonnull();
+
+    // A name whose inode has been dropped since is looked up again, and try_insert() refreshes its entry.
+    auto child_or_error = parent.lookup(name);
+    if (child_or_error.is_error()) {
+        if (child_or_error.error().code() == ENOENT)
+            try_insert(key, generation, nullptr);
+        return child_or_error.release_error();
+    }
+    auto child = child_or_error.release_value();
+    try_insert(key, generation, child.ptr());
+    return child;
+}
+
+void LookupCache::try_insert(Key const& key, u64 generation, Inode* child)
+{
+    // The cache is only an optimization, so if we run out of memory here the name simply isn't cached.
+    auto name_or_error = KString::try_create(key.name);
+    if (name_or_error.is_error())
+        return;
+    LockWeakPtr<Inode> weak_child;
+    if (child) {
+        auto weak_child_or_error = child->try_make_weak_ptr<Inode>();
+        if (weak_child_or_error.is_error())
+            return;
+        weak_child = weak_child_or_error.release_value();
+    }
+    auto* new_entry = new (nothrow) Entry {
+        .parent = key.parent,
+        .name = name_or_error.release_value(),
+        .child = child ? child->identifier() : InodeIdentifier {},
+        .child_inode = move(weak_child),
+    };
+    if (!new_entry)
+        return;
+    auto entry = adopt_own(*new_entry);
+
+    shard_for(key).with([&](auto& shard) {
+        // Something changed while the file system was asked, so what it told us may already be out of date.
+        if (shard.generation != generation)
+            return;
+        // NOTE: An entry might already be there if its inode has been dropped since, so replace it with the fresh one.
+        if (shard.entries.contains(key))
+            remove_entry(shard, key);
+        else if (shard.entries.size() >= max_entries_per_shard)
+            remove_entry(shard, shard.lru_list.first()->key());
+
+        auto& entry_ref = *entry;
+        if (shard.entries.try_set(entry_ref.key(), move(entry)).is_error())
+            return;
+        shard.lru_list.append(entry_ref);
+    });
+}
+
+void LookupCache::did_add_child(Inode& parent, StringView name)
+{
+    if (!parent.fs().supports_lookup_cache())
+        return;
+    Key key { parent.identifier(), name };
+    shard_for(key).with([&](auto& shard) {
+        ++shard.generation;
+        remove_entry(shard, key);
+    });
+}
+
+void LookupCache::did_remove_child(Inode& parent, StringView name)
+{
+    // Removing a name and adding it back both make whatever we remember about it wrong.
+    did_add_child(parent, name);
+}
+
+}
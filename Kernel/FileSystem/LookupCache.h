@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/StringView.h>
+#include <Kernel/FileSystem/InodeIdentifier.h>
+#include <Kernel/Library/KString.h>
+#include <Kernel/Library/LockWeakPtr.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+class Inode;
+
+// Remembers what the names in a directory resolved to, so resolving the same paths over and over again doesn't have
+// to ask the file system every time. Names that don't exist are remembered as well, since looking for files that
+// aren't there (e.g. when searching include paths) is just as common.
+// Entries only hold weak references to the inodes, so the cache never keeps an inode alive, and are dropped when
+// the file system reports that the name was added to or removed from the directory.
+class LookupCache {
+public:
+    static LookupCache& the();
+
+    ErrorOr<NonnullRefPtr<Inode>> lookup(Inode& parent, StringView name);
+
+    void did_add_child(Inode& parent, StringView name);
+    void did_remove_child(Inode& parent, StringView name);
+
+private:
+    struct Key {
+        InodeIdentifier parent;
+        StringView name;
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct KeyTraits : public DefaultTraits<Key> {
+        static unsigned hash(Key const& key) { return pair_int_hash(pair_int_hash(key.parent.fsid().value(), u64_hash(key.parent.index().value())), key.name.hash()); }
+    };
+
+    struct Entry {
+        InodeIdentifier parent;
+        NonnullOwnPtr<KString> name;
+        // Not valid for names that don't exist.
+        InodeIdentifier child;
+        LockWeakPtr<Inode> child_inode;
+        IntrusiveListNode<Entry> lru_list_node;
+
+        Key key() const { return { parent, name->view() }; }
+    };
+
+    struct Shard {
+        HashMap<Key, NonnullOwnPtr<Entry>, KeyTraits> entries;
+        IntrusiveList<&Entry::lru_list_node> lru_list;
+        // Bumped on every change to the shard, so a lookup that raced with a change doesn't cache a stale result.
+        u64 generation { 0 };
+    };
+
+    static constexpr size_t shard_count = 16;
+    static constexpr size_t max_entries_per_shard = 512;
+
+    SpinlockProtected<Shard, LockRank::None>& shard_for(Key const&);
+    void remove_entry(Shard&, Key const&);
+    void try_insert(Key const&, u64 generation, Inode* child);
+
+    Array<SpinlockProtected<Shard, LockRank::None>, shard_count> m_shards;
+};
+
+}
@@ -12,7 +12,9 @@
 #include <Kernel/Devices/TTY/MasterPTY.h>
 #include <Kernel/Devices/TTY/TTY.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/EPoll.h>
 #include <Kernel/FileSystem/FIFO.h>
+#include <Kernel/FileSystem/IORing.h>
 #include <Kernel/FileSystem/InodeFile.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
 #include <Kernel/FileSystem/MountFile.h>
@@ -314,6 +316,30 @@ InodeWatcher* OpenFileDescription::inode_watcher()
     return static_cast<InodeWatcher*>(m_file.ptr());
 }
 
+bool OpenFileDescription::is_epoll() const
+{
+    return m_file->is_epoll();
+}
+
+EPoll* OpenFileDescription::epoll()
+{
+    if (!is_epoll())
+        return nullptr;
+    return static_cast<EPoll*>(m_file.ptr());
+}
+
+bool OpenFileDescription::is_io_ring() const
+{
+    return m_file->is_io_ring();
+}
+
+IORing* OpenFileDescription::io_ring()
+{
+    if (!is_io_ring())
+        return nullptr;
+    return static_cast<IORing*>(m_file.ptr());
+}
+
 bool OpenFileDescription::is_unshared_resource_file() const
 {
     return m_file->is_unshared_resource_file();
@@ -80,6 +80,12 @@ public:
     InodeWatcher const* inode_watcher() const;
     InodeWatcher* inode_watcher();
 
+    bool is_epoll() const;
+    EPoll* epoll();
+
+    bool is_io_ring() const;
+    IORing* io_ring();
+
     bool is_mount_file() const;
     MountFile const* mount_file() const;
     MountFile* mount_file();
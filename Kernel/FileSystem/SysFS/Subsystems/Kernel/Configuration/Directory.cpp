@@ -11,6 +11,9 @@
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/CoredumpDirectory.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/Directory.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/DumpKmallocStack.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/LoopbackPacketLoss.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/MutexProfiling.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/PerformanceCounters.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/UBSANDeadly.h>
 
 namespace Kernel {
@@ -21,6 +24,9 @@ UNMAP_AFTER_INIT NonnullRefPtr<SysFSKernelConfigurationDirectory> SysFSKernelCon
     MUST(global_variables_directory->m_child_components.with([&](auto& list) -> ErrorOr<void> {
         list.append(SysFSCapsLockRemap::must_create(*global_variables_directory));
         list.append(SysFSDumpKmallocStacks::must_create(*global_variables_directory));
+        list.append(SysFSLoopbackPacketLoss::must_create(*global_variables_directory));
+        list.append(SysFSMutexProfiling::must_create(*global_variables_directory));
+        list.append(SysFSPerformanceCounters::must_create(*global_variables_directory));
         list.append(SysFSUBSANDeadly::must_create(*global_variables_directory));
         list.append(SysFSCoredumpDirectory::must_create(*global_variables_directory));
         return {};
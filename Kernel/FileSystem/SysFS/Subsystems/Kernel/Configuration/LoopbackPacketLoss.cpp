@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/LoopbackPacketLoss.h>
+#include <Kernel/Net/LoopbackAdapter.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSLoopbackPacketLoss::SysFSLoopbackPacketLoss(SysFSDirectory const& parent_directory)
+    : SysFSSystemBooleanVariable(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSLoopbackPacketLoss> SysFSLoopbackPacketLoss::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSLoopbackPacketLoss(parent_directory)).release_nonnull();
+}
+
+bool SysFSLoopbackPacketLoss::value() const
+{
+    SpinlockLocker locker(m_lock);
+    return g_loopback_packet_loss_enabled;
+}
+
+ErrorOr<void> SysFSLoopbackPacketLoss::set_value(bool new_value)
+{
+    SpinlockLocker locker(m_lock);
+    g_loopback_packet_loss_enabled = new_value;
+    return {};
+}
+
+}
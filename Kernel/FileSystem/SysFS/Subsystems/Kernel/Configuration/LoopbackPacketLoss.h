@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/RefPtr.h>
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/BooleanVariable.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+#include <Kernel/Locking/Spinlock.h>
+
+namespace Kernel {
+
+class SysFSLoopbackPacketLoss final : public SysFSSystemBooleanVariable {
+public:
+    virtual StringView name() const override { return "loopback_packet_loss"sv; }
+    static NonnullRefPtr<SysFSLoopbackPacketLoss> must_create(SysFSDirectory const&);
+
+private:
+    virtual bool value() const override;
+    virtual ErrorOr<void> set_value(bool new_value) override;
+
+    explicit SysFSLoopbackPacketLoss(SysFSDirectory const&);
+
+    mutable Spinlock<LockRank::None> m_lock {};
+};
+
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/MutexProfiling.h>
+#include <Kernel/Locking/MutexProfile.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSMutexProfiling::SysFSMutexProfiling(SysFSDirectory const& parent_directory)
+    : SysFSSystemBooleanVariable(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSMutexProfiling> SysFSMutexProfiling::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSMutexProfiling(parent_directory)).release_nonnull();
+}
+
+bool SysFSMutexProfiling::value() const
+{
+    SpinlockLocker locker(m_lock);
+    return g_mutex_profiling_enabled;
+}
+
+ErrorOr<void> SysFSMutexProfiling::set_value(bool new_value)
+{
+    SpinlockLocker locker(m_lock);
+    g_mutex_profiling_enabled = new_value;
+    return {};
+}
+
+}
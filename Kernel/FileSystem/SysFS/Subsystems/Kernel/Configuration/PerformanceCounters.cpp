@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Arch/PerformanceCounters.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/PerformanceCounters.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSPerformanceCounters::SysFSPerformanceCounters(SysFSDirectory const& parent_directory)
+    : SysFSSystemBooleanVariable(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSPerformanceCounters> SysFSPerformanceCounters::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSPerformanceCounters(parent_directory)).release_nonnull();
+}
+
+bool SysFSPerformanceCounters::value() const
+{
+    SpinlockLocker locker(m_lock);
+    return m_enabled;
+}
+
+ErrorOr<void> SysFSPerformanceCounters::set_value(bool new_value)
+{
+    SpinlockLocker locker(m_lock);
+    if (new_value == m_enabled)
+        return {};
+    if (new_value) {
+        if (!enable_performance_counters())
+            return ENOTSUP;
+    } else {
+        disable_performance_counters();
+    }
+    m_enabled = new_value;
+    return {};
+}
+
+}
@@ -7,6 +7,7 @@
 #include <AK/JsonObjectSerializer.h>
 #include <Kernel/API/POSIX/unistd.h>
 #include <Kernel/Devices/Loop/LoopDevice.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DiskUsage.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
@@ -60,6 +61,16 @@ ErrorOr<void> SysFSDiskUsage::try_generate(KBufferBuilder& builder)
             }
         }
 
+        if (fs.is_file_backed() && static_cast<FileBackedFileSystem const&>(fs).is_block_based()) {
+            auto statistics = static_cast<BlockBasedFileSystem const&>(fs).cache_statistics();
+            auto cache_object = TRY(fs_object.add_object("disk_cache"sv));
+            TRY(cache_object.add("hits"sv, statistics.hits));
+            TRY(cache_object.add("misses"sv, statistics.misses));
+            TRY(cache_object.add("evictions"sv, statistics.evictions));
+            TRY(cache_object.add("read_ahead_blocks"sv, statistics.read_ahead_blocks));
+            TRY(cache_object.finish());
+        }
+
         TRY(fs_object.finish());
         return {};
     }));
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArraySerializer.h>
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/LockStatistics.h>
+#include <Kernel/Locking/LockRank.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSLockStatistics::SysFSLockStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSLockStatistics> SysFSLockStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSLockStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSLockStatistics::try_generate(KBufferBuilder& builder)
+{
+    struct NamedRank {
+        LockRank rank;
+        StringView name;
+    };
+    static constexpr NamedRank ranks[] = {
+        { LockRank::None, "None"sv },
+        { LockRank::MemoryManager, "MemoryManager"sv },
+        { LockRank::Interrupts, "Interrupts"sv },
+        { LockRank::FileSystem, "FileSystem"sv },
+        { LockRank::Thread, "Thread"sv },
+        { LockRank::Process, "Process"sv },
+    };
+
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    for (auto const& rank : ranks) {
+        auto statistics = lock_contention_statistics(rank.rank);
+        auto obj = TRY(array.add_object());
+        TRY(obj.add("rank"sv, rank.name));
+        TRY(obj.add("contended_acquisitions"sv, statistics.contended_acquisitions));
+        TRY(obj.add("spin_iterations"sv, statistics.spin_iterations));
+        TRY(obj.add("max_waiters"sv, statistics.max_waiters));
+        TRY(obj.finish());
+    }
+    TRY(array.finish());
+    return {};
+}
+
+}
@@ -27,6 +27,7 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     get_kmalloc_stats(stats);
 
     auto system_memory = MM.get_system_memory_info();
+    auto huge_pages = MM.get_huge_page_info();
 
     auto json = TRY(JsonObjectSerializer<>::try_create(builder));
     TRY(json.add("kmalloc_allocated"sv, stats.bytes_allocated));
@@ -37,6 +38,14 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+    TRY(json.add("kmalloc_magazine_hits"sv, stats.magazine_allocation_hits));
+    TRY(json.add("kmalloc_magazine_misses"sv, stats.magazine_allocation_misses));
+    TRY(json.add("kfree_magazine_hits"sv, stats.magazine_free_hits));
+    TRY(json.add("kfree_magazine_misses"sv, stats.magazine_free_misses));
+    TRY(json.add("huge_pages_mapped"sv, huge_pages.huge_pages_mapped));
+    TRY(json.add("huge_page_faults"sv, huge_pages.huge_page_faults));
+    TRY(json.add("huge_page_fallbacks"sv, huge_pages.huge_page_fallbacks));
+    TRY(json.add("huge_page_splits"sv, huge_pages.huge_page_splits));
     TRY(json.finish());
     return {};
 }
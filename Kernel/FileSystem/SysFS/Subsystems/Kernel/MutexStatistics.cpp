@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArraySerializer.h>
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/MutexStatistics.h>
+#include <Kernel/Locking/MutexProfile.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSMutexStatistics::SysFSMutexStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSMutexStatistics> SysFSMutexStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSMutexStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSMutexStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    TRY(for_each_mutex_profile_entry([&](auto const& entry) -> ErrorOr<void> {
+        auto obj = TRY(array.add_object());
+        TRY(obj.add("name"sv, entry.name.is_empty() ? "(unnamed)"sv : entry.name));
+        TRY(obj.add("acquisitions"sv, entry.acquisitions));
+        TRY(obj.add("contended_acquisitions"sv, entry.contended_acquisitions));
+        TRY(obj.add("blocked_acquisitions"sv, entry.blocked_acquisitions));
+        TRY(obj.add("total_wait_cycles"sv, entry.total_wait_cycles));
+        TRY(obj.add("max_wait_cycles"sv, entry.max_wait_cycles));
+        TRY(obj.add("exclusive_holds"sv, entry.exclusive_holds));
+        TRY(obj.add("total_hold_cycles"sv, entry.total_hold_cycles));
+        TRY(obj.add("max_hold_cycles"sv, entry.max_hold_cycles));
+        TRY(obj.finish());
+        return {};
+    }));
+    TRY(array.finish());
+    return {};
+}
+
+}
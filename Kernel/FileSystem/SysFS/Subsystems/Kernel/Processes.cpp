@@ -6,6 +6,7 @@
 
 #include <AK/JsonObjectSerializer.h>
 #include <AK/Try.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Devices/TTY/TTY.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Processes.h>
 #include <Kernel/Sections.h>
@@ -125,6 +126,9 @@ ErrorOr<void> SysFSOverallProcesses::try_generate(KBufferBuilder& builder)
             TRY(thread_object.add("times_scheduled"sv, thread.times_scheduled()));
             TRY(thread_object.add("time_user"sv, thread.time_in_user()));
             TRY(thread_object.add("time_kernel"sv, thread.time_in_kernel()));
+            auto const& counter_totals = thread.performance_counter_totals();
+            for (size_t i = 0; i < performance_counter_count; ++i)
+                TRY(thread_object.add(performance_counter_name(static_cast<PerformanceCounter>(i)), counter_totals[i]));
             TRY(thread_object.add("state"sv, thread.state_string()));
             TRY(thread_object.add("cpu"sv, thread.cpu()));
             TRY(thread_object.add("priority"sv, thread.priority()));
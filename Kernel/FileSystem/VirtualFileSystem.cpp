@@ -19,6 +19,7 @@
 #include <Kernel/FileSystem/Custody.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/FileSystem.h>
+#include <Kernel/FileSystem/LookupCache.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/KSyms.h>
@@ -1095,7 +1096,7 @@ ErrorOr<NonnullRefPtr<Custody>> VirtualFileSystem::resolve_path_without_veil(VFS
         }
 
         // Okay, let's look up this part.
-        auto child_or_error = parent.inode().lookup(part);
+        auto child_or_error = LookupCache::the().lookup(parent.inode(), part);
         if (child_or_error.is_error()) {
             if (out_parent) {
                 // ENOENT with a non-null parent custody signals to caller that
@@ -24,8 +24,10 @@ class Device;
 class DeviceControlDevice;
 class DiskCache;
 class DoubleBuffer;
+class EPoll;
 class File;
 class FATInode;
+class IORing;
 class OpenFileDescription;
 class DisplayConnector;
 class FileSystem;
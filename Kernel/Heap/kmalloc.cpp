@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Library/StdLib.h>
@@ -103,6 +104,13 @@ public:
         m_freelist = freelist_entry;
     }
 
+    static KmallocSlabBlock& from_slab(void* ptr)
+    {
+        return *(KmallocSlabBlock*)((FlatPtr)ptr & block_mask);
+    }
+
+    size_t slab_size() const { return m_slab_size; }
+
     bool is_full() const
     {
         return m_freelist == nullptr;
@@ -177,7 +185,7 @@ public:
         memset(ptr, KFREE_SCRUB_BYTE, m_slab_size);
 #endif
 
-        auto* block = (KmallocSlabBlock*)((FlatPtr)ptr & KmallocSlabBlock::block_mask);
+        auto* block = &KmallocSlabBlock::from_slab(ptr);
         bool block_was_full = block->is_full();
         block->deallocate(ptr);
         if (block_was_full)
@@ -423,7 +431,8 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    static constexpr size_t slabheap_count = 6;
+    KmallocSlabheap slabheaps[slabheap_count] = { 16, 32, 64, 128, 256, 512 };
 
     bool expansion_in_progress { false };
 };
@@ -436,6 +445,129 @@ static size_t g_kfree_call_count;
 static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
 
+// Each processor keeps a small magazine of free slabs for every slabheap size class.
+// Allocations and deallocations that can be satisfied by the magazine never touch s_lock;
+// only refilling an empty magazine or flushing a full one does, and then in batches.
+#ifdef HAS_ADDRESS_SANITIZER
+// The magazines would hide use-after-free bugs from the sanitizer, so don't use them.
+static constexpr bool kmalloc_magazines_enabled = false;
+#else
+static constexpr bool kmalloc_magazines_enabled = true;
+#endif
+
+struct KmallocMagazine {
+    static constexpr size_t capacity = 16;
+    static constexpr size_t batch_size = capacity / 2;
+
+    size_t count { 0 };
+    Array<void*, capacity> slabs {};
+};
+
+struct alignas(64) KmallocProcessorCache {
+    KmallocMagazine magazines[KmallocGlobalData::slabheap_count];
+
+    // NOTE: These are only ever modified by the owning processor (with interrupts disabled),
+    //       so reading them from another processor only gives an approximate value.
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+    size_t allocation_hits { 0 };
+    size_t allocation_misses { 0 };
+    size_t free_hits { 0 };
+    size_t free_misses { 0 };
+};
+
+static KmallocProcessorCache s_processor_caches[MAX_CPU_COUNT];
+
+static Optional<size_t> slabheap_index_for(size_t size, size_t alignment)
+{
+    // NOTE: There's no need to take the kmalloc lock, as the kmalloc slab-heaps (and their sizes) are constant
+    for (size_t i = 0; i < KmallocGlobalData::slabheap_count; ++i) {
+        auto slab_size = g_kmalloc_global->slabheaps[i].slab_size();
+        if (size <= slab_size && alignment <= slab_size)
+            return i;
+    }
+    return {};
+}
+
+static void* allocate_from_magazine(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+    if constexpr (!kmalloc_magazines_enabled)
+        return nullptr;
+
+    auto slabheap_index = slabheap_index_for(size, alignment);
+    if (!slabheap_index.has_value())
+        return nullptr;
+    auto& slabheap = g_kmalloc_global->slabheaps[*slabheap_index];
+
+    // Disabling interrupts keeps us on this processor and prevents an IRQ handler from racing us for the magazine.
+    InterruptDisabler disabler;
+    auto& cache = s_processor_caches[Processor::current_id()];
+    auto& magazine = cache.magazines[*slabheap_index];
+
+    if (magazine.count == 0) {
+        ++cache.allocation_misses;
+        SpinlockLocker lock(s_lock);
+        while (magazine.count < KmallocMagazine::batch_size) {
+            auto* slab = slabheap.allocate(slabheap.slab_size(), CallerWillInitializeMemory::Yes);
+            if (!slab)
+                break;
+            magazine.slabs[magazine.count++] = slab;
+        }
+        if (magazine.count == 0)
+            return nullptr;
+    } else {
+        ++cache.allocation_hits;
+    }
+
+    ++cache.kmalloc_call_count;
+    auto* ptr = magazine.slabs[--magazine.count];
+    if (caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, KMALLOC_SCRUB_BYTE, slabheap.slab_size());
+    return ptr;
+}
+
+static bool deallocate_to_magazine(void* ptr, size_t size)
+{
+    if constexpr (!kmalloc_magazines_enabled)
+        return false;
+
+    if (!slabheap_index_for(size, 1).has_value())
+        return false;
+
+    VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+
+    // The allocation may have been placed in a bigger size class due to its alignment,
+    // so ask the slab block which size class it actually belongs to.
+    auto slab_size = KmallocSlabBlock::from_slab(ptr).slab_size();
+    auto slabheap_index = slabheap_index_for(slab_size, 1);
+    VERIFY(slabheap_index.has_value());
+    auto& slabheap = g_kmalloc_global->slabheaps[*slabheap_index];
+    VERIFY(slabheap.slab_size() == slab_size);
+
+    memset(ptr, KFREE_SCRUB_BYTE, slab_size);
+
+    InterruptDisabler disabler;
+    auto& cache = s_processor_caches[Processor::current_id()];
+    auto& magazine = cache.magazines[*slabheap_index];
+
+    if (magazine.count == KmallocMagazine::capacity) {
+        ++cache.free_misses;
+        SpinlockLocker lock(s_lock);
+        // Return the least recently freed half of the magazine, as the most recently freed slabs are the most likely to still be cache-hot.
+        for (size_t i = 0; i < KmallocMagazine::batch_size; ++i)
+            slabheap.deallocate(magazine.slabs[i]);
+        for (size_t i = KmallocMagazine::batch_size; i < magazine.count; ++i)
+            magazine.slabs[i - KmallocMagazine::batch_size] = magazine.slabs[i];
+        magazine.count -= KmallocMagazine::batch_size;
+    } else {
+        ++cache.free_hits;
+    }
+
+    ++cache.kfree_call_count;
+    magazine.slabs[magazine.count++] = ptr;
+    return true;
+}
+
 void kmalloc_enable_expand()
 {
     g_kmalloc_global->enable_expansion();
@@ -460,19 +592,24 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     // Alignment must be a power of two.
     VERIFY(is_power_of_two(alignment));
 
-    Optional<SpinlockLocker<Spinlock<Kernel::LockRank::None>>> maybe_lock = {};
+    void* ptr = nullptr;
     if (caller_has_acquired_lock == CallerHasAcquiredLock::No)
-        maybe_lock = SpinlockLocker(s_lock);
+        ptr = allocate_from_magazine(size, alignment, caller_will_initialize_memory);
 
-    ++g_kmalloc_call_count;
+    if (!ptr) {
+        Optional<SpinlockLocker<Spinlock<Kernel::LockRank::None>>> maybe_lock = {};
+        if (caller_has_acquired_lock == CallerHasAcquiredLock::No)
+            maybe_lock = SpinlockLocker(s_lock);
+
+        ++g_kmalloc_call_count;
+        ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    }
 
     if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available.was_set()) {
         dbgln("kmalloc({})", size);
         Kernel::dump_backtrace();
     }
 
-    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
-
     Thread* current_thread = Thread::current();
     if (!current_thread)
         current_thread = Processor::idle_thread();
@@ -502,6 +639,17 @@ void* kcalloc(size_t count, size_t size)
     return ptr;
 }
 
+static void add_kfree_perf_event(void* ptr)
+{
+    Thread* current_thread = Thread::current();
+    if (!current_thread)
+        current_thread = Processor::idle_thread();
+    if (current_thread) {
+        VERIFY(current_thread->is_allocation_enabled());
+        PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
+    }
+}
+
 void kfree_sized_impl(void* ptr, size_t size)
 {
     VERIFY(s_lock.is_locked());
@@ -513,15 +661,8 @@ void kfree_sized_impl(void* ptr, size_t size)
     ++g_kfree_call_count;
     ++g_nested_kfree_calls;
 
-    if (g_nested_kfree_calls == 1) {
-        Thread* current_thread = Thread::current();
-        if (!current_thread)
-            current_thread = Processor::idle_thread();
-        if (current_thread) {
-            VERIFY(current_thread->is_allocation_enabled());
-            PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
-        }
-    }
+    if (g_nested_kfree_calls == 1)
+        add_kfree_perf_event(ptr);
 
     g_kmalloc_global->deallocate(ptr, size);
     --g_nested_kfree_calls;
@@ -534,6 +675,16 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
+    if (!ptr)
+        return;
+
+    VERIFY(size > 0);
+
+    if (deallocate_to_magazine(ptr, size)) {
+        add_kfree_perf_event(ptr);
+        return;
+    }
+
     SpinlockLocker lock(s_lock);
     kfree_sized_impl(ptr, size);
 }
@@ -624,4 +775,17 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_free = g_kmalloc_global->free_bytes();
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+    stats.magazine_allocation_hits = 0;
+    stats.magazine_allocation_misses = 0;
+    stats.magazine_free_hits = 0;
+    stats.magazine_free_misses = 0;
+
+    for (auto const& cache : s_processor_caches) {
+        stats.kmalloc_call_count += cache.kmalloc_call_count;
+        stats.kfree_call_count += cache.kfree_call_count;
+        stats.magazine_allocation_hits += cache.allocation_hits;
+        stats.magazine_allocation_misses += cache.allocation_misses;
+        stats.magazine_free_hits += cache.free_hits;
+        stats.magazine_free_misses += cache.free_misses;
+    }
 }
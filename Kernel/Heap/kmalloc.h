@@ -52,6 +52,10 @@ struct kmalloc_stats {
     size_t bytes_free;
     size_t kmalloc_call_count;
     size_t kfree_call_count;
+    size_t magazine_allocation_hits;
+    size_t magazine_allocation_misses;
+    size_t magazine_free_hits;
+    size_t magazine_free_misses;
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
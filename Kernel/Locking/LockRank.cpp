@@ -4,6 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/BuiltinWrappers.h>
 #include <Kernel/Locking/LockRank.h>
 #include <Kernel/Tasks/Thread.h>
 
@@ -30,4 +33,45 @@ void track_lock_release(LockRank rank)
     }
 }
 
+struct AtomicLockContentionStatistics {
+    Atomic<u64> contended_acquisitions { 0 };
+    Atomic<u64> spin_iterations { 0 };
+    Atomic<u64> max_waiters { 0 };
+};
+
+// One for LockRank::None, and one for every other rank.
+static Array<AtomicLockContentionStatistics, 6> s_lock_contention_statistics;
+
+static AtomicLockContentionStatistics& statistics_for(LockRank rank)
+{
+    if (rank == LockRank::None)
+        return s_lock_contention_statistics[0];
+    auto index = count_trailing_zeroes(static_cast<unsigned>(rank)) + 1;
+    VERIFY(index < s_lock_contention_statistics.size());
+    return s_lock_contention_statistics[index];
+}
+
+void track_lock_contention(LockRank rank, u16 waiters_ahead, u64 spin_iterations)
+{
+    auto& statistics = statistics_for(rank);
+    statistics.contended_acquisitions.fetch_add(1, AK::memory_order_relaxed);
+    statistics.spin_iterations.fetch_add(spin_iterations, AK::memory_order_relaxed);
+
+    auto max_waiters = statistics.max_waiters.load(AK::memory_order_relaxed);
+    while (waiters_ahead > max_waiters) {
+        if (statistics.max_waiters.compare_exchange_strong(max_waiters, waiters_ahead, AK::memory_order_relaxed))
+            break;
+    }
+}
+
+LockContentionStatistics lock_contention_statistics(LockRank rank)
+{
+    auto& statistics = statistics_for(rank);
+    return {
+        .contended_acquisitions = statistics.contended_acquisitions.load(AK::memory_order_relaxed),
+        .spin_iterations = statistics.spin_iterations.load(AK::memory_order_relaxed),
+        .max_waiters = statistics.max_waiters.load(AK::memory_order_relaxed),
+    };
+}
+
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/EnumBits.h>
+#include <AK/Types.h>
 
 namespace Kernel {
 // To catch bugs where locks are taken out of order, we annotate all locks
@@ -40,4 +41,14 @@ AK_ENUM_BITWISE_OPERATORS(LockRank);
 
 void track_lock_acquire(LockRank);
 void track_lock_release(LockRank);
+
+// How often spinlocks of a rank had to be waited for, which tells us which locks are worth splitting up.
+struct LockContentionStatistics {
+    u64 contended_acquisitions { 0 };
+    u64 spin_iterations { 0 };
+    u64 max_waiters { 0 };
+};
+
+void track_lock_contention(LockRank, u16 waiters_ahead, u64 spin_iterations);
+LockContentionStatistics lock_contention_statistics(LockRank);
 }
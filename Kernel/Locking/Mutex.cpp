@@ -5,11 +5,13 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <AK/SetOnce.h>
 #include <Kernel/Debug.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Locking/LockLocation.h>
 #include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/MutexProfile.h>
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Tasks/Thread.h>
 
@@ -17,6 +19,9 @@ extern SetOnce g_not_in_early_boot;
 
 namespace Kernel {
 
+// Roughly the time a short critical section takes; beyond that, blocking is cheaper than burning more cycles.
+static constexpr size_t max_mutex_spin_iterations = 4096;
+
 void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
 {
     // NOTE: This may be called from an interrupt handler (not an IRQ handler)
@@ -30,8 +35,19 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
     VERIFY(mode != Mode::Unlocked);
     auto* current_thread = Thread::current();
 
+    Optional<u64> requested_at;
+    if (g_mutex_profiling_enabled)
+        requested_at = Processor::read_cycle_count();
+    // Spinning is only an option if we could also be preempted while doing so.
+    bool may_spin = current_thread && Processor::in_critical() == 0;
+
     SpinlockLocker lock(m_lock);
+    bool did_spin = may_spin && spin_while_holder_is_running(*current_thread, lock);
     bool did_block = false;
+    ScopeGuard record_acquisition_guard = [&] {
+        if (requested_at.has_value())
+            record_acquisition(requested_at.value(), did_spin || did_block, did_block);
+    };
     Mode current_mode = m_mode;
     switch (current_mode) {
     case Mode::Unlocked: {
@@ -203,11 +219,56 @@ void Mutex::unlock()
     if (m_times_locked == 0) {
         VERIFY(current_mode == Mode::Exclusive ? !m_holder : m_shared_holders == 0);
 
+        record_release();
         m_mode = Mode::Unlocked;
         unblock_waiters(current_mode);
     }
 }
 
+bool Mutex::spin_while_holder_is_running(Thread& current_thread, SpinlockLocker<Spinlock<LockRank::None>>& lock)
+{
+    // If the holder is running on another processor, it will likely release the lock soon, and spinning until then is
+    // cheaper than blocking: that costs us two context switches, and the holder the work of waking us up again.
+    if (m_behavior != MutexBehavior::Regular || m_mode != Mode::Exclusive || m_holder == bit_cast<uintptr_t>(&current_thread))
+        return false;
+
+    // NOTE: The holder can't go away while it holds the lock and we hold m_lock, but once we let go of m_lock, it may
+    //       exit at any time, so it must only be compared against from then on.
+    auto holder = m_holder;
+    auto const& holder_thread = *bit_cast<Thread*>(holder);
+    if (holder_thread.state() != Thread::State::Running)
+        return false;
+    auto const& holder_processor = Processor::by_id(holder_thread.cpu());
+
+    lock.unlock();
+    for (size_t i = 0; i < max_mutex_spin_iterations; ++i) {
+        if (AK::atomic_load(&m_holder, AK::memory_order_relaxed) != holder)
+            break;
+        if (holder_processor.running_thread() != bit_cast<Thread*>(holder))
+            break;
+        Processor::pause();
+    }
+    lock.lock();
+    return true;
+}
+
+void Mutex::record_acquisition(u64 requested_at, bool was_contended, bool did_block)
+{
+    auto now = Processor::read_cycle_count().value_or(requested_at);
+    record_mutex_acquisition(m_name, now - requested_at, was_contended, did_block);
+    if (m_mode == Mode::Exclusive && m_exclusively_locked_at == 0)
+        m_exclusively_locked_at = now;
+}
+
+void Mutex::record_release()
+{
+    if (m_exclusively_locked_at == 0)
+        return;
+    auto now = Processor::read_cycle_count().value_or(m_exclusively_locked_at);
+    record_mutex_hold(m_name, now - m_exclusively_locked_at);
+    m_exclusively_locked_at = 0;
+}
+
 void Mutex::block(Thread& current_thread, Mode mode, SpinlockLocker<Spinlock<LockRank::None>>& lock, u32 requested_locks)
 {
     if constexpr (LOCK_IN_CRITICAL_DEBUG) {
@@ -313,6 +374,7 @@ auto Mutex::force_unlock_exclusive_if_locked(u32& lock_count_to_restore) -> Mode
         VERIFY(m_times_locked > 0);
         lock_count_to_restore = m_times_locked;
         m_times_locked = 0;
+        record_release();
         m_mode = Mode::Unlocked;
         unblock_waiters(Mode::Exclusive);
         break;
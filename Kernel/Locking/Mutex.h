@@ -87,6 +87,10 @@ private:
     void block(Thread&, Mode, SpinlockLocker<Spinlock<LockRank::None>>&, u32);
     void unblock_waiters(Mode);
 
+    bool spin_while_holder_is_running(Thread&, SpinlockLocker<Spinlock<LockRank::None>>&);
+    void record_acquisition(u64 requested_at, bool was_contended, bool did_block);
+    void record_release();
+
     StringView m_name;
     Mode m_mode { Mode::Unlocked };
 
@@ -104,6 +108,9 @@ private:
     uintptr_t m_holder { 0 };
     size_t m_shared_holders { 0 };
 
+    // The cycle count at which the current exclusive holder acquired this lock, if mutex profiling was enabled then.
+    u64 m_exclusively_locked_at { 0 };
+
     struct BlockedThreadLists {
         BlockedThreadList exclusive;
         BlockedThreadList shared;
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Vector.h>
+#include <Kernel/Locking/MutexProfile.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+bool g_mutex_profiling_enabled { false };
+
+// Mutex names are string literals, so the table can refer to them without copying, and a fixed-size table keeps
+// recording free of allocations. Names that don't fit anymore are simply not recorded.
+static constexpr size_t max_profiled_mutex_names = 256;
+static SpinlockProtected<Array<MutexProfileEntry, max_profiled_mutex_names>, LockRank::None> s_mutex_profile {};
+
+static bool is_unused(MutexProfileEntry const& entry)
+{
+    return entry.acquisitions == 0 && entry.exclusive_holds == 0;
+}
+
+template<typename Callback>
+static void with_entry_for(StringView name, Callback callback)
+{
+    s_mutex_profile.with([&](auto& entries) {
+        auto start_index = name.hash() % max_profiled_mutex_names;
+        for (size_t i = 0; i < max_profiled_mutex_names; ++i) {
+            auto& entry = entries[(start_index + i) % max_profiled_mutex_names];
+            if (is_unused(entry)) {
+                entry.name = name;
+                callback(entry);
+                return;
+            }
+            if (entry.name == name) {
+                callback(entry);
+                return;
+            }
+        }
+    });
+}
+
+void record_mutex_acquisition(StringView name, u64 wait_cycles, bool was_contended, bool did_block)
+{
+    with_entry_for(name, [&](auto& entry) {
+        ++entry.acquisitions;
+        if (was_contended)
+            ++entry.contended_acquisitions;
+        if (did_block)
+            ++entry.blocked_acquisitions;
+        entry.total_wait_cycles += wait_cycles;
+        entry.max_wait_cycles = max(entry.max_wait_cycles, wait_cycles);
+    });
+}
+
+void record_mutex_hold(StringView name, u64 hold_cycles)
+{
+    with_entry_for(name, [&](auto& entry) {
+        ++entry.exclusive_holds;
+        entry.total_hold_cycles += hold_cycles;
+        entry.max_hold_cycles = max(entry.max_hold_cycles, hold_cycles);
+    });
+}
+
+ErrorOr<void> for_each_mutex_profile_entry(Function<ErrorOr<void>(MutexProfileEntry const&)> callback)
+{
+    // Take a snapshot first, so the callback is free to allocate.
+    Vector<MutexProfileEntry> snapshot;
+    TRY(snapshot.try_ensure_capacity(max_profiled_mutex_names));
+    s_mutex_profile.with([&](auto& entries) {
+        for (auto& entry : entries) {
+            if (!is_unused(entry))
+                snapshot.unchecked_append(entry);
+        }
+    });
+    for (auto& entry : snapshot)
+        TRY(callback(entry));
+    return {};
+}
+
+}
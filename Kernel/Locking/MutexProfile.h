@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Function.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// While enabled, every mutex records how long threads waited for it and how long it was held exclusively, in CPU
+// cycles. Mutexes are grouped by name, so e.g. all inode locks are counted together.
+extern bool g_mutex_profiling_enabled;
+
+struct MutexProfileEntry {
+    StringView name;
+    u64 acquisitions { 0 };
+    // Acquisitions that found the mutex held by another thread, and the subset of those that had to block.
+    u64 contended_acquisitions { 0 };
+    u64 blocked_acquisitions { 0 };
+    u64 total_wait_cycles { 0 };
+    u64 max_wait_cycles { 0 };
+    u64 exclusive_holds { 0 };
+    u64 total_hold_cycles { 0 };
+    u64 max_hold_cycles { 0 };
+};
+
+void record_mutex_acquisition(StringView name, u64 wait_cycles, bool was_contended, bool did_block);
+void record_mutex_hold(StringView name, u64 hold_cycles);
+ErrorOr<void> for_each_mutex_profile_entry(Function<ErrorOr<void>(MutexProfileEntry const&)>);
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Locking/Spinlock.h>
+
+namespace Kernel {
+
+void TicketLock::lock_contended(LockRank rank)
+{
+    auto& processor = Processor::current();
+    if (processor.m_waiting_for_ticket_lock != this) {
+        u16 ticket = m_next_ticket.fetch_add(1, AK::memory_order_relaxed);
+        if (m_now_serving.load(AK::memory_order_acquire) != ticket)
+            wait_for_turn(ticket, rank);
+        return;
+    }
+
+    // An SMP message we handled while waiting for this lock wants it as well (e.g. the callback of
+    // Processor::capture_stack_trace() switching address spaces). Taking another ticket would make us wait for
+    // ourselves, so the message borrows our turn instead, and unlock() hands it back to the waiter below it.
+    u16 ticket = processor.m_waiting_ticket;
+    u64 spin_iterations = 0;
+    while (m_now_serving.load(AK::memory_order_acquire) != ticket) {
+        Processor::wait_check();
+        ++spin_iterations;
+    }
+    m_is_borrowed = true;
+    track_lock_contention(rank, 0, spin_iterations);
+}
+
+void TicketLock::wait_for_turn(u16 ticket, LockRank rank)
+{
+    u16 waiters_ahead = ticket - m_now_serving.load(AK::memory_order_relaxed);
+    u64 spin_iterations = 0;
+
+    // NOTE: We're in a critical section with interrupts disabled, so we stay on this processor.
+    auto& processor = Processor::current();
+    auto* previous_lock = exchange(processor.m_waiting_for_ticket_lock, this);
+    auto previous_ticket = exchange(processor.m_waiting_ticket, ticket);
+    // SMP messages are still handled while we wait, as their senders might hold this very lock while waiting for us.
+    while (m_now_serving.load(AK::memory_order_acquire) != ticket) {
+        Processor::wait_check();
+        ++spin_iterations;
+    }
+    processor.m_waiting_for_ticket_lock = previous_lock;
+    processor.m_waiting_ticket = previous_ticket;
+
+    track_lock_contention(rank, waiters_ahead, spin_iterations);
+}
+}
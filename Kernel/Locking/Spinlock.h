@@ -13,6 +13,61 @@
 
 namespace Kernel {
 
+// Hands out the lock in the order in which CPUs started waiting for it. Waiters only read the lock while
+// spinning, so they don't keep stealing its cache line from each other, and a CPU can't be starved by others
+// that keep grabbing the lock just before it.
+class TicketLock {
+    AK_MAKE_NONCOPYABLE(TicketLock);
+    AK_MAKE_NONMOVABLE(TicketLock);
+
+public:
+    TicketLock() = default;
+
+    ALWAYS_INLINE void lock(LockRank rank)
+    {
+        // If the lock is taken, this processor might be waiting for it already, further up the stack.
+        if (is_locked()) [[unlikely]] {
+            lock_contended(rank);
+            return;
+        }
+        u16 ticket = m_next_ticket.fetch_add(1, AK::memory_order_relaxed);
+        if (m_now_serving.load(AK::memory_order_acquire) != ticket) [[unlikely]]
+            wait_for_turn(ticket, rank);
+    }
+
+    ALWAYS_INLINE void unlock()
+    {
+        // A borrowed turn is handed back to the waiter it was borrowed from, see lock_contended().
+        if (m_is_borrowed) [[unlikely]] {
+            m_is_borrowed = false;
+            return;
+        }
+        // Only the owner ever changes m_now_serving, so this doesn't need to be an atomic increment.
+        m_now_serving.store(m_now_serving.load(AK::memory_order_relaxed) + 1, AK::memory_order_release);
+    }
+
+    [[nodiscard]] ALWAYS_INLINE bool is_locked() const
+    {
+        return m_now_serving.load(AK::memory_order_relaxed) != m_next_ticket.load(AK::memory_order_relaxed);
+    }
+
+    ALWAYS_INLINE void initialize()
+    {
+        m_now_serving.store(0, AK::memory_order_relaxed);
+        m_next_ticket.store(0, AK::memory_order_relaxed);
+        m_is_borrowed = false;
+    }
+
+private:
+    NEVER_INLINE void lock_contended(LockRank);
+    NEVER_INLINE void wait_for_turn(u16 ticket, LockRank);
+
+    Atomic<u16> m_now_serving { 0 };
+    Atomic<u16> m_next_ticket { 0 };
+    // Only ever accessed by the processor holding the lock.
+    bool m_is_borrowed { false };
+};
+
 template<LockRank Rank>
 class Spinlock {
     AK_MAKE_NONCOPYABLE(Spinlock);
@@ -26,8 +81,7 @@ public:
         InterruptsState previous_interrupts_state = Processor::interrupts_state();
         Processor::enter_critical();
         Processor::disable_interrupts();
-        while (m_lock.exchange(1, AK::memory_order_acquire) != 0)
-            Processor::wait_check();
+        m_lock.lock(m_rank);
         track_lock_acquire(m_rank);
         return previous_interrupts_state;
     }
@@ -36,7 +90,7 @@ public:
     {
         VERIFY(is_locked());
         track_lock_release(m_rank);
-        m_lock.store(0, AK::memory_order_release);
+        m_lock.unlock();
 
         Processor::leave_critical();
         Processor::restore_interrupts_state(previous_interrupts_state);
@@ -44,16 +98,16 @@ public:
 
     [[nodiscard]] ALWAYS_INLINE bool is_locked() const
     {
-        return m_lock.load(AK::memory_order_relaxed) != 0;
+        return m_lock.is_locked();
     }
 
     ALWAYS_INLINE void initialize()
     {
-        m_lock.store(0, AK::memory_order_relaxed);
+        m_lock.initialize();
     }
 
 private:
-    Atomic<u8> m_lock { 0 };
+    TicketLock m_lock;
     static constexpr LockRank const m_rank { Rank };
 };
 
@@ -72,12 +126,10 @@ public:
         Processor::enter_critical();
         auto& proc = Processor::current();
         FlatPtr cpu = FlatPtr(&proc);
-        FlatPtr expected = 0;
-        while (!m_lock.compare_exchange_strong(expected, cpu, AK::memory_order_acq_rel)) {
-            if (expected == cpu)
-                break;
-            Processor::wait_check();
-            expected = 0;
+        // Only we can store our own CPU here, so if it's there we already hold the lock.
+        if (m_owner.load(AK::memory_order_relaxed) != cpu) {
+            m_lock.lock(m_rank);
+            m_owner.store(cpu, AK::memory_order_relaxed);
         }
         if (m_recursions == 0)
             track_lock_acquire(m_rank);
@@ -89,10 +141,11 @@ public:
     {
         VERIFY_INTERRUPTS_DISABLED();
         VERIFY(m_recursions > 0);
-        VERIFY(m_lock.load(AK::memory_order_relaxed) == FlatPtr(&Processor::current()));
+        VERIFY(m_owner.load(AK::memory_order_relaxed) == FlatPtr(&Processor::current()));
         if (--m_recursions == 0) {
             track_lock_release(m_rank);
-            m_lock.store(0, AK::memory_order_release);
+            m_owner.store(0, AK::memory_order_relaxed);
+            m_lock.unlock();
         }
 
         Processor::leave_critical();
@@ -101,21 +154,23 @@ public:
 
     [[nodiscard]] ALWAYS_INLINE bool is_locked() const
     {
-        return m_lock.load(AK::memory_order_relaxed) != 0;
+        return m_lock.is_locked();
     }
 
     [[nodiscard]] ALWAYS_INLINE bool is_locked_by_current_processor() const
     {
-        return m_lock.load(AK::memory_order_relaxed) == FlatPtr(&Processor::current());
+        return m_owner.load(AK::memory_order_relaxed) == FlatPtr(&Processor::current());
     }
 
     ALWAYS_INLINE void initialize()
     {
-        m_lock.store(0, AK::memory_order_relaxed);
+        m_owner.store(0, AK::memory_order_relaxed);
+        m_lock.initialize();
     }
 
 private:
-    Atomic<FlatPtr> m_lock { 0 };
+    TicketLock m_lock;
+    Atomic<FlatPtr> m_owner { 0 };
     u32 m_recursions { 0 };
     static constexpr LockRank const m_rank { Rank };
 };
@@ -148,6 +148,7 @@ ErrorOr<Region*> AddressSpace::try_allocate_split_region(Region const& source_re
     new_region->set_syscall_region(source_region.is_syscall_region());
     new_region->set_mmap(source_region.is_mmap(), source_region.mmapped_from_readable(), source_region.mmapped_from_writable());
     new_region->set_stack(source_region.is_stack());
+    new_region->set_wants_huge_pages(source_region.wants_huge_pages());
     TRY(m_region_tree.place_specifically(*new_region, range));
     return new_region.leak_ptr();
 }
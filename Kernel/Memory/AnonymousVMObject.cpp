@@ -267,6 +267,39 @@ NonnullRefPtr<PhysicalRAMPage> AnonymousVMObject::allocate_committed_page(Badge<
     return m_unused_committed_pages->take_one();
 }
 
+bool AnonymousVMObject::try_populate_with_huge_page(Badge<Region>, size_t first_page_index)
+{
+    VERIFY(m_lock.is_locked());
+    VERIFY(first_page_index + MemoryManager::pages_per_huge_page <= page_count());
+
+    // Only pages nobody has written to yet can be replaced.
+    size_t lazy_committed_page_count = 0;
+    for (size_t i = 0; i < MemoryManager::pages_per_huge_page; ++i) {
+        auto& page = physical_pages()[first_page_index + i];
+        if (!page || !(page->is_shared_zero_page() || page->is_lazy_committed_page()))
+            return false;
+        if (page->is_lazy_committed_page())
+            ++lazy_committed_page_count;
+    }
+    if (lazy_committed_page_count > 0 && (!m_unused_committed_pages.has_value() || m_unused_committed_pages->page_count() < lazy_committed_page_count))
+        return false;
+
+    auto huge_page_or_error = MM.allocate_huge_page();
+    if (huge_page_or_error.is_error()) {
+        ++MM.m_huge_page_fallbacks;
+        return false;
+    }
+    auto huge_page = huge_page_or_error.release_value();
+
+    // The huge page didn't come from our commitment, so give back what we had committed for these pages.
+    for (size_t i = 0; i < lazy_committed_page_count; ++i)
+        m_unused_committed_pages->uncommit_one();
+
+    for (size_t i = 0; i < MemoryManager::pages_per_huge_page; ++i)
+        physical_pages()[first_page_index + i] = huge_page[i];
+    return true;
+}
+
 void AnonymousVMObject::reset_cow_map()
 {
     for (size_t i = 0; i < page_count(); ++i) {
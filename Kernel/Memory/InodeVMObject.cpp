@@ -20,6 +20,7 @@ InodeVMObject::InodeVMObject(InodeVMObject const& other, FixedArray<RefPtr<Physi
     : VMObject(move(new_physical_pages))
     , m_inode(other.m_inode)
     , m_dirty_pages(move(dirty_pages))
+    , m_maps_page_cache(other.m_maps_page_cache)
 {
     for (size_t i = 0; i < page_count(); ++i)
         m_dirty_pages.set(i, other.m_dirty_pages.get(i));
@@ -69,9 +70,12 @@ int InodeVMObject::try_release_clean_pages(int page_amount)
 {
     SpinlockLocker locker(m_lock);
 
+    // NOTE: Our pages may also be held by the inode's page cache, which can evict them once we have let go of them.
+    auto releasable_ref_count = m_maps_page_cache ? 2u : 1u;
+
     int count = 0;
     for (size_t i = 0; i < page_count() && count < page_amount; ++i) {
-        if (!m_dirty_pages.get(i) && m_physical_pages[i]) {
+        if (!m_dirty_pages.get(i) && m_physical_pages[i] && m_physical_pages[i]->ref_count() <= releasable_ref_count) {
             m_physical_pages[i] = nullptr;
             ++count;
         }
@@ -30,6 +30,9 @@ public:
 
     u32 writable_mappings() const;
 
+    // Shared mappings of inodes with a page cache map the cached pages, which the page cache holds on to as well.
+    bool maps_page_cache() const { return m_maps_page_cache; }
+
 protected:
     explicit InodeVMObject(Inode&, FixedArray<RefPtr<PhysicalRAMPage>>&&, Bitmap dirty_pages);
     explicit InodeVMObject(InodeVMObject const&, FixedArray<RefPtr<PhysicalRAMPage>>&&, Bitmap dirty_pages);
@@ -42,6 +45,7 @@ protected:
 
     NonnullRefPtr<Inode> const m_inode;
     Bitmap m_dirty_pages;
+    bool m_maps_page_cache { false };
 };
 
 }
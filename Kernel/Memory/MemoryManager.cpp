@@ -968,6 +968,11 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     PageDirectoryEntry const& pde = pd[page_directory_index];
     if (!pde.is_present())
         return nullptr;
+#if ARCH(X86_64)
+    // Huge pages don't have a page table.
+    if (pde.is_huge())
+        return nullptr;
+#endif
 
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
@@ -981,6 +986,13 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
     u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+#if ARCH(X86_64)
+    if (pd[page_directory_index].is_present() && pd[page_directory_index].is_huge()) {
+        if (!split_huge_page(page_directory, vaddr))
+            return nullptr;
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+    }
+#endif
     auto& pde = pd[page_directory_index];
     if (pde.is_present())
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
@@ -1022,6 +1034,18 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+#if ARCH(X86_64)
+    if (pd[page_directory_index].is_present() && pd[page_directory_index].is_huge()) {
+        if (!split_huge_page(page_directory, vaddr)) {
+            // We're only asked to unmap things that are going away, so losing the rest of the huge page is better
+            // than keeping this page mapped.
+            dbgln("MM: Unable to split huge page to unmap {}, unmapping all of it", vaddr);
+            (void)unmap_huge_page(page_directory, vaddr);
+            return;
+        }
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+    }
+#endif
     PageDirectoryEntry& pde = pd[page_directory_index];
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
@@ -1046,6 +1070,156 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+bool MemoryManager::supports_huge_pages()
+{
+#if ARCH(X86_64)
+    // 2 MiB pages are always available in long mode.
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool MemoryManager::map_huge_page(PageDirectory& page_directory, VirtualAddress vaddr, PhysicalAddress paddr, bool writable, bool executable, bool user_allowed)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.get() % huge_page_size == 0);
+    VERIFY(paddr.get() % huge_page_size == 0);
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (pde.is_present() && !pde.is_huge()) {
+        // Everything in this page table belongs to the huge page that replaces it.
+        // NOTE: This is matched by the leaked ref in MemoryManager::ensure_pte()
+        get_physical_page_entry(PhysicalAddress { pde.page_table_base() }).allocated.physical_page.unref();
+        pde.clear();
+    }
+    if (!pde.is_present())
+        ++m_huge_pages_mapped;
+
+    pde.clear();
+    pde.set_page_table_base(paddr.get());
+    pde.set_huge(true);
+    pde.set_user_allowed(user_allowed);
+    pde.set_writable(writable);
+    if (Processor::current().has_nx())
+        pde.set_execute_disabled(!executable);
+    pde.set_present(true);
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    (void)paddr;
+    (void)writable;
+    (void)executable;
+    (void)user_allowed;
+    return false;
+#endif
+}
+
+bool MemoryManager::unmap_huge_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    auto* pd = quickmap_pd(page_directory, (vaddr.get() >> 30) & 0x1ff);
+    auto& pde = pd[(vaddr.get() >> 21) & 0x1ff];
+    if (!pde.is_present() || !pde.is_huge())
+        return false;
+    pde.clear();
+    --m_huge_pages_mapped;
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    return false;
+#endif
+}
+
+bool MemoryManager::is_mapped_as_huge_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    auto* pd = quickmap_pd(page_directory, (vaddr.get() >> 30) & 0x1ff);
+    auto& pde = pd[(vaddr.get() >> 21) & 0x1ff];
+    return pde.is_present() && pde.is_huge();
+#else
+    (void)page_directory;
+    (void)vaddr;
+    return false;
+#endif
+}
+
+#if ARCH(X86_64)
+// Replaces the huge page containing vaddr with a page table that maps the same physical pages with the same permissions,
+// so the pages in it can be changed one by one.
+bool MemoryManager::split_huge_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto page_table_or_error = allocate_physical_page(ShouldZeroFill::No);
+    if (page_table_or_error.is_error()) {
+        dbgln("MM: Unable to allocate page table to split huge page at {}", vaddr);
+        return false;
+    }
+    auto page_table = page_table_or_error.release_value();
+
+    // Allocating may have purged memory, which remaps things, so only look at the page directory now.
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    VERIFY(pde.is_present() && pde.is_huge());
+
+    auto* ptes = quickmap_pt(page_table->paddr());
+    for (size_t i = 0; i < pages_per_huge_page; ++i) {
+        auto& pte = ptes[i];
+        pte.clear();
+        pte.set_memory_type(MemoryType::Normal);
+        pte.set_physical_page_base(pde.page_table_base() + i * PAGE_SIZE);
+        pte.set_writable(pde.is_writable());
+        pte.set_user_allowed(pde.is_user_allowed());
+        if (Processor::current().has_nx())
+            pte.set_execute_disabled(pde.is_execute_disabled());
+        pte.set_present(true);
+    }
+
+    pde.clear();
+    pde.set_page_table_base(page_table->paddr().get());
+    pde.set_user_allowed(true);
+    pde.set_present(true);
+    pde.set_writable(true);
+    pde.set_global(&page_directory == m_kernel_page_directory.ptr());
+
+    // NOTE: This leaked ref is matched by the unref in MemoryManager::release_pte()
+    (void)page_table.leak_ref();
+
+    --m_huge_pages_mapped;
+    ++m_huge_page_splits;
+
+    // The new page table maps everything the same way, but the TLB must not hold on to the huge page
+    // once the caller starts changing individual pages.
+    flush_tlb(&page_directory, VirtualAddress { vaddr.get() & ~(huge_page_size - 1) }, pages_per_huge_page);
+    return true;
+}
+#endif
+
+MemoryManager::HugePageInfo MemoryManager::get_huge_page_info() const
+{
+    return {
+        .huge_pages_mapped = m_huge_pages_mapped.load(),
+        .huge_page_faults = m_huge_page_faults.load(),
+        .huge_page_fallbacks = m_huge_page_fallbacks.load(),
+        .huge_page_splits = m_huge_page_splits.load(),
+    };
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     ProcessorSpecific<MemoryManagerData>::initialize();
@@ -1283,17 +1457,24 @@ ErrorOr<NonnullOwnPtr<Region>> MemoryManager::allocate_kernel_region_with_vmobje
 ErrorOr<CommittedPhysicalPageSet> MemoryManager::commit_physical_pages(size_t page_count)
 {
     VERIFY(page_count > 0);
-    auto result = m_global_data.with([&](auto& global_data) -> ErrorOr<CommittedPhysicalPageSet> {
-        if (global_data.system_memory_info.physical_pages_uncommitted < page_count) {
-            dbgln("MM: Unable to commit {} pages, have only {}", page_count, global_data.system_memory_info.physical_pages_uncommitted);
-            return ENOMEM;
-        }
+    auto try_commit = [&] {
+        return m_global_data.with([&](auto& global_data) -> ErrorOr<CommittedPhysicalPageSet> {
+            if (global_data.system_memory_info.physical_pages_uncommitted < page_count)
+                return ENOMEM;
+
+            global_data.system_memory_info.physical_pages_uncommitted -= page_count;
+            global_data.system_memory_info.physical_pages_committed += page_count;
+            return CommittedPhysicalPageSet { {}, page_count };
+        });
+    };
 
-        global_data.system_memory_info.physical_pages_uncommitted -= page_count;
-        global_data.system_memory_info.physical_pages_committed += page_count;
-        return CommittedPhysicalPageSet { {}, page_count };
-    });
+    auto result = try_commit();
+    // Cached file contents take up pages we could otherwise commit, so evict them before giving up.
+    while (result.is_error() && Inode::evict_page_cache_pages(page_cache_eviction_batch_size) > 0)
+        result = try_commit();
     if (result.is_error()) {
+        auto uncommitted_page_count = m_global_data.with([](auto& global_data) { return global_data.system_memory_info.physical_pages_uncommitted; });
+        dbgln("MM: Unable to commit {} pages, have only {}", page_count, uncommitted_page_count);
         Process::for_each_ignoring_process_lists([&](Process const& process) {
             size_t amount_resident = 0;
             size_t amount_shared = 0;
@@ -1398,59 +1579,76 @@ NonnullRefPtr<PhysicalRAMPage> MemoryManager::allocate_committed_physical_page(B
 
 ErrorOr<NonnullRefPtr<PhysicalRAMPage>> MemoryManager::allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge, MemoryType memory_type_for_zero_fill)
 {
-    return m_global_data.with([&](auto& global_data) -> ErrorOr<NonnullRefPtr<PhysicalRAMPage>> {
-        auto page = find_free_physical_page(false, global_data);
-        bool purged_pages = false;
-
-        if (!page) {
-            // We didn't have a single free physical page. Let's try to free something up!
-            // First, we look for a purgeable VMObject in the volatile state.
-            for_each_vmobject([&](auto& vmobject) {
-                if (!vmobject.is_anonymous())
-                    return IterationDecision::Continue;
-                auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
-                if (!anonymous_vmobject.is_purgeable() || !anonymous_vmobject.is_volatile())
-                    return IterationDecision::Continue;
-                if (auto purged_page_count = anonymous_vmobject.purge()) {
-                    dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
-                    page = find_free_physical_page(false, global_data);
-                    purged_pages = true;
-                    VERIFY(page);
-                    return IterationDecision::Break;
-                }
+    auto try_find_free_page = [&] {
+        return m_global_data.with([&](auto& global_data) { return find_free_physical_page(false, global_data); });
+    };
+
+    auto page = try_find_free_page();
+    bool purged_pages = false;
+
+    // NOTE: Everything below frees pages, which takes the global data lock again, so we must not hold it while reclaiming.
+    if (!page) {
+        // We didn't have a single free physical page. Let's try to free something up!
+        // First, we look for a purgeable VMObject in the volatile state.
+        for_each_vmobject([&](auto& vmobject) {
+            if (!vmobject.is_anonymous())
                 return IterationDecision::Continue;
-            });
-        }
-        if (!page) {
-            // Second, we look for a file-backed VMObject with clean pages.
-            for_each_vmobject([&](auto& vmobject) {
-                if (!vmobject.is_inode())
-                    return IterationDecision::Continue;
-                auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
-                if (auto released_page_count = inode_vmobject.try_release_clean_pages(1)) {
-                    dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
-                    page = find_free_physical_page(false, global_data);
-                    VERIFY(page);
-                    return IterationDecision::Break;
-                }
+            auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
+            if (!anonymous_vmobject.is_purgeable() || !anonymous_vmobject.is_volatile())
                 return IterationDecision::Continue;
-            });
-        }
-        if (!page) {
-            dmesgln("MM: no physical pages available");
-            return ENOMEM;
+            if (auto purged_page_count = anonymous_vmobject.purge()) {
+                dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
+                purged_pages = true;
+                return IterationDecision::Break;
+            }
+            return IterationDecision::Continue;
+        });
+        if (purged_pages)
+            page = try_find_free_page();
+    }
+    if (!page) {
+        // Second, we evict cached file contents that aren't mapped anywhere.
+        if (auto evicted_page_count = Inode::evict_page_cache_pages(page_cache_eviction_batch_size)) {
+            dbgln("MM: Page cache eviction saved the day! Evicted {} pages", evicted_page_count);
+            page = try_find_free_page();
         }
+    }
+    while (!page) {
+        // Third, we look for a file-backed VMObject with clean pages.
+        // Pages of shared file mappings are also held by the page cache, so they are only freed once we evict them from there.
+        bool released_pages = false;
+        for_each_vmobject([&](auto& vmobject) {
+            if (!vmobject.is_inode())
+                return IterationDecision::Continue;
+            auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject);
+            if (auto released_page_count = inode_vmobject.try_release_clean_pages(1)) {
+                dbgln("MM: Clean inode release saved the day! Released {} pages from InodeVMObject", released_page_count);
+                released_pages = true;
+                return IterationDecision::Break;
+            }
+            return IterationDecision::Continue;
+        });
+        if (!released_pages)
+            break;
+        page = try_find_free_page();
+        if (!page && Inode::evict_page_cache_pages(page_cache_eviction_batch_size))
+            page = try_find_free_page();
+    }
+    if (!page) {
+        dmesgln("MM: no physical pages available");
+        return ENOMEM;
+    }
 
-        if (should_zero_fill == ShouldZeroFill::Yes) {
-            auto* ptr = quickmap_page(*page, memory_type_for_zero_fill);
-            memset(ptr, 0, PAGE_SIZE);
-            unquickmap_page();
-        }
+    if (should_zero_fill == ShouldZeroFill::Yes) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(*page, memory_type_for_zero_fill);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
 
-        if (did_purge)
-            *did_purge = purged_pages;
-        return page.release_nonnull();
-    });
+    if (did_purge)
+        *did_purge = purged_pages;
+    return page.release_nonnull();
 }
 
 ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::allocate_contiguous_physical_pages(size_t size, MemoryType memory_type_for_zero_fill)
@@ -1484,6 +1682,36 @@ ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::allocate_contiguo
     return physical_pages;
 }
 
+ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> MemoryManager::allocate_huge_page()
+{
+    auto physical_pages = TRY(m_global_data.with([&](auto& global_data) -> ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> {
+        // We need to make sure we don't touch pages that we have committed to
+        if (global_data.system_memory_info.physical_pages_uncommitted < pages_per_huge_page)
+            return ENOMEM;
+
+        for (auto& physical_region : global_data.physical_regions) {
+            auto physical_pages = physical_region->take_contiguous_free_pages(pages_per_huge_page, huge_page_size);
+            if (!physical_pages.is_empty()) {
+                global_data.system_memory_info.physical_pages_uncommitted -= pages_per_huge_page;
+                global_data.system_memory_info.physical_pages_used += pages_per_huge_page;
+                return physical_pages;
+            }
+        }
+        // Callers fall back to regular pages, so this isn't worth complaining about.
+        return ENOMEM;
+    }));
+
+    // NOTE: This is called while handling page faults, so zero the pages one by one through the quickmap
+    //       instead of setting up a kernel region for them.
+    for (auto& page : physical_pages) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(page);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+    return physical_pages;
+}
+
 void MemoryManager::enter_process_address_space(Process& process)
 {
     process.address_space().with([](auto& space) {
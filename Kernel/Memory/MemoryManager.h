@@ -168,6 +168,7 @@ public:
     NonnullRefPtr<PhysicalRAMPage> allocate_committed_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
     ErrorOr<NonnullRefPtr<PhysicalRAMPage>> allocate_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr, MemoryType memory_type_for_zero_fill = MemoryType::Normal);
     ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> allocate_contiguous_physical_pages(size_t size, MemoryType memory_type_for_zero_fill);
+    ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> allocate_huge_page();
     void deallocate_physical_page(PhysicalAddress);
 
     ErrorOr<NonnullOwnPtr<Region>> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, MemoryType = MemoryType::Normal);
@@ -191,6 +192,21 @@ public:
 
     SystemMemoryInfo get_system_memory_info();
 
+    // A huge page is mapped by a single page directory entry instead of a whole page table, so it only takes up one TLB entry.
+    static constexpr size_t huge_page_size = 2 * MiB;
+    static constexpr size_t pages_per_huge_page = huge_page_size / PAGE_SIZE;
+
+    static bool supports_huge_pages();
+
+    struct HugePageInfo {
+        u64 huge_pages_mapped { 0 };
+        u64 huge_page_faults { 0 };
+        u64 huge_page_fallbacks { 0 };
+        u64 huge_page_splits { 0 };
+    };
+
+    HugePageInfo get_huge_page_info() const;
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -235,6 +251,9 @@ private:
     MemoryManager();
     ~MemoryManager();
 
+    // When we run out of physical pages, we evict this many pages from the page cache at once, so the next allocations don't have to reclaim again.
+    static constexpr size_t page_cache_eviction_batch_size = 32;
+
     struct GlobalData {
         GlobalData();
 
@@ -287,6 +306,11 @@ private:
     };
     void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
 
+    bool map_huge_page(PageDirectory&, VirtualAddress, PhysicalAddress, bool writable, bool executable, bool user_allowed);
+    bool unmap_huge_page(PageDirectory&, VirtualAddress);
+    bool is_mapped_as_huge_page(PageDirectory&, VirtualAddress);
+    bool split_huge_page(PageDirectory&, VirtualAddress);
+
     // NOTE: These are outside of GlobalData as they are only assigned on startup,
     //       and then never change. Atomic ref-counting covers that case without
     //       the need for additional synchronization.
@@ -300,6 +324,11 @@ private:
     size_t m_physical_page_entries_count { 0 };
 
     SpinlockProtected<GlobalData, LockRank::None> m_global_data;
+
+    Atomic<u64> m_huge_pages_mapped { 0 };
+    Atomic<u64> m_huge_page_faults { 0 };
+    Atomic<u64> m_huge_page_fallbacks { 0 };
+    Atomic<u64> m_huge_page_splits { 0 };
 };
 
 inline bool PhysicalRAMPage::is_shared_zero_page() const
@@ -118,6 +118,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
         region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
         region->set_shared(m_shared);
         region->set_syscall_region(is_syscall_region());
+        region->set_wants_huge_pages(m_wants_huge_pages);
         return region;
     }
 
@@ -143,6 +144,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
     }
     clone_region->set_syscall_region(is_syscall_region());
     clone_region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
+    clone_region->set_wants_huge_pages(m_wants_huge_pages);
     return clone_region;
 }
 
@@ -276,6 +278,57 @@ bool Region::map_individual_page_impl(size_t page_index, ShouldLockVMObject shou
     return map_individual_page_impl(page_index, page, should_lock_vmobject, readable, writeable);
 }
 
+Optional<size_t> Region::huge_page_containing(size_t page_index) const
+{
+    auto huge_page_base = vaddr_from_page_index(page_index).get() & ~(MemoryManager::huge_page_size - 1);
+    if (huge_page_base < vaddr().get() || huge_page_base + MemoryManager::huge_page_size > vaddr().get() + size())
+        return {};
+    return page_index_from_address(VirtualAddress { huge_page_base });
+}
+
+bool Region::can_map_huge_page(size_t page_index, PhysicalAddress& paddr) const
+{
+    if (!vmobject().is_anonymous() || m_shared || !is_user() || m_memory_type != MemoryType::Normal)
+        return false;
+
+    // The pages have to be physically contiguous and aligned, which is only the case if they were
+    // allocated as a huge page in the first place (see handle_zero_fault()).
+    auto first_page = physical_page_locked(page_index);
+    if (!first_page || first_page->paddr().get() % MemoryManager::huge_page_size != 0)
+        return false;
+    for (size_t i = 0; i < MemoryManager::pages_per_huge_page; ++i) {
+        auto& page = vmobject().physical_pages()[first_page_index() + page_index + i];
+        if (!page || page->paddr() != first_page->paddr().offset(i * PAGE_SIZE))
+            return false;
+        // Pages shared with another process after a fork have to be mapped one by one, so each can be copied on its own.
+        if (should_cow(page_index + i))
+            return false;
+    }
+    paddr = first_page->paddr();
+    return true;
+}
+
+bool Region::try_map_huge_page(size_t page_index, ShouldLockVMObject should_lock_vmobject, bool readable, bool writeable)
+{
+    VERIFY(m_page_directory->get_lock().is_locked_by_current_processor());
+
+    if (!m_wants_huge_pages || !MemoryManager::supports_huge_pages() || (!readable && !writeable))
+        return false;
+    if (huge_page_containing(page_index) != page_index)
+        return false;
+
+    PhysicalAddress paddr;
+    if (should_lock_vmobject == ShouldLockVMObject::Yes) {
+        SpinlockLocker locker(vmobject().m_lock);
+        if (!can_map_huge_page(page_index, paddr))
+            return false;
+    } else if (!can_map_huge_page(page_index, paddr)) {
+        return false;
+    }
+
+    return MM.map_huge_page(*m_page_directory, vaddr_from_page_index(page_index), paddr, writeable, is_executable(), true);
+}
+
 bool Region::remap_vmobject_page(size_t page_index, NonnullRefPtr<PhysicalRAMPage> physical_page, ShouldLockVMObject should_lock_vmobject)
 {
     SpinlockLocker page_lock(m_page_directory->get_lock());
@@ -284,6 +337,12 @@ bool Region::remap_vmobject_page(size_t page_index, NonnullRefPtr<PhysicalRAMPag
     if (!translate_vmobject_page(page_index))
         return false;
 
+    // NOTE: Everyone remapping a page of an anonymous VMObject already holds its lock.
+    if (auto huge_page_index = huge_page_containing(page_index); huge_page_index.has_value() && try_map_huge_page(*huge_page_index, ShouldLockVMObject::No, is_readable(), is_writable())) {
+        MemoryManager::flush_tlb(m_page_directory, vaddr_from_page_index(*huge_page_index), MemoryManager::pages_per_huge_page);
+        return true;
+    }
+
     bool success = map_individual_page_impl(page_index, physical_page, should_lock_vmobject, is_readable(), is_writable());
     MemoryManager::flush_tlb(m_page_directory, vaddr_from_page_index(page_index));
     return success;
@@ -304,6 +363,10 @@ void Region::unmap_with_locks_held(ShouldFlushTLB should_flush_tlb, SpinlockLock
     size_t count = page_count();
     for (size_t i = 0; i < count; ++i) {
         auto vaddr = vaddr_from_page_index(i);
+        if (MemoryManager::supports_huge_pages() && huge_page_containing(i) == i && MM.unmap_huge_page(*m_page_directory, vaddr)) {
+            i += MemoryManager::pages_per_huge_page - 1;
+            continue;
+        }
         MM.release_pte(*m_page_directory, vaddr, i == count - 1 ? MemoryManager::IsLastPTERelease::Yes : MemoryManager::IsLastPTERelease::No);
     }
     if (should_flush_tlb == ShouldFlushTLB::Yes)
@@ -329,6 +392,10 @@ ErrorOr<void> Region::map_impl(PageDirectory& page_directory, ShouldLockVMObject
     set_page_directory(page_directory);
     size_t page_index = 0;
     while (page_index < page_count()) {
+        if (try_map_huge_page(page_index, should_lock_vmobject, readable, writeable)) {
+            page_index += MemoryManager::pages_per_huge_page;
+            continue;
+        }
         if (!map_individual_page_impl(page_index, should_lock_vmobject, readable, writeable))
             break;
         ++page_index;
@@ -499,6 +566,11 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
 
     {
         SpinlockLocker locker(m_page_directory->get_lock());
+
+        // Huge pages are only mapped with the permissions of the region, which we've checked above.
+        if (MM.is_mapped_as_huge_page(*m_page_directory, fault.vaddr()))
+            return PageFaultResponse::Continue;
+
         auto* page_table_entry = MM.pte(*m_page_directory, fault.vaddr());
 
         auto error = [&fault, page_table_entry](StringView message) {
@@ -561,6 +633,29 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (m_wants_huge_pages && !m_shared && is_user() && m_memory_type == MemoryType::Normal && MemoryManager::supports_huge_pages()) {
+        if (auto huge_page_index = huge_page_containing(page_index_in_region); huge_page_index.has_value()) {
+            // Fault in the whole huge page at once, so all of it can be mapped by a single TLB entry.
+            if (anonymous_vmobject.try_populate_with_huge_page({}, translate_to_vmobject_page(*huge_page_index))) {
+                ++MM.m_huge_page_faults;
+                dbgln_if(PAGE_FAULT_DEBUG, "      >> ALLOCATED HUGE PAGE {}", page_slot->paddr());
+
+                SpinlockLocker page_lock(m_page_directory->get_lock());
+                if (!try_map_huge_page(*huge_page_index, ShouldLockVMObject::No, is_readable(), is_writable())) {
+                    // All of these pages were just replaced, so none of them may keep pointing to the shared zero page.
+                    for (size_t i = 0; i < MemoryManager::pages_per_huge_page; ++i) {
+                        if (!map_individual_page_impl(*huge_page_index + i, ShouldLockVMObject::No, is_readable(), is_writable())) {
+                            dmesgln("MM: handle_zero_fault was unable to allocate a physical page");
+                            return PageFaultResponse::OutOfMemory;
+                        }
+                    }
+                }
+                MemoryManager::flush_tlb(m_page_directory, vaddr_from_page_index(*huge_page_index), MemoryManager::pages_per_huge_page);
+                return PageFaultResponse::Continue;
+            }
+        }
+    }
+
     RefPtr<PhysicalRAMPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -650,48 +745,71 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
     if (current_thread)
         current_thread->did_inode_fault();
 
-    u8 page_buffer[PAGE_SIZE];
     auto& inode = inode_vmobject.inode();
 
-    auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
-    auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
+    RefPtr<PhysicalRAMPage> new_physical_page;
+    if (inode_vmobject.maps_page_cache()) {
+        // Shared mappings map the inode's page cache directly, so they see the same data as read() and write().
+        auto page_or_error = inode.page_cache_page(page_index_in_vmobject);
+        if (page_or_error.is_error()) {
+            dmesgln("handle_inode_fault: Error ({}) while reading from inode", page_or_error.error());
+            return PageFaultResponse::ShouldCrash;
+        }
+        // Note: If there is no page, it means we are at the end of file or after it,
+        // which means we should return bus error.
+        new_physical_page = page_or_error.release_value();
+        if (!new_physical_page)
+            return PageFaultResponse::BusError;
+
+        if (is_executable()) {
+            InterruptDisabler disabler;
+            u8* page_ptr = MM.quickmap_page(*new_physical_page);
+            Processor::flush_instruction_cache(VirtualAddress { page_ptr }, PAGE_SIZE);
+            MM.unquickmap_page();
+        }
+    } else {
+        u8 page_buffer[PAGE_SIZE];
 
-    if (result.is_error()) {
-        dmesgln("handle_inode_fault: Error ({}) while reading from inode", result.error());
-        return PageFaultResponse::ShouldCrash;
-    }
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
+        auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
 
-    auto nread = result.value();
-    // Note: If we received 0, it means we are at the end of file or after it,
-    // which means we should return bus error.
-    if (nread == 0)
-        return PageFaultResponse::BusError;
+        if (result.is_error()) {
+            dmesgln("handle_inode_fault: Error ({}) while reading from inode", result.error());
+            return PageFaultResponse::ShouldCrash;
+        }
 
-    // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
-    if (nread < PAGE_SIZE)
-        memset(page_buffer + nread, 0, PAGE_SIZE - nread);
+        auto nread = result.value();
+        // Note: If we received 0, it means we are at the end of file or after it,
+        // which means we should return bus error.
+        if (nread == 0)
+            return PageFaultResponse::BusError;
 
-    // Allocate a new physical page, and copy the read inode contents into it.
-    auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
-    if (new_physical_page_or_error.is_error()) {
-        dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
-        return PageFaultResponse::OutOfMemory;
-    }
-    auto new_physical_page = new_physical_page_or_error.release_value();
-    {
-        InterruptDisabler disabler;
-        u8* dest_ptr = MM.quickmap_page(*new_physical_page);
-        memcpy(dest_ptr, page_buffer, PAGE_SIZE);
+        // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
+        if (nread < PAGE_SIZE)
+            memset(page_buffer + nread, 0, PAGE_SIZE - nread);
 
-        if (is_executable()) {
-            // Some architectures require an explicit synchronization operation after writing to memory that will be executed.
-            // This is required even if no instructions were previously fetched from that (physical) memory location,
-            // because some systems have an I-cache that is not coherent with the D-cache,
-            // resulting in the I-cache being filled with old values if the contents of the D-cache aren't written back yet.
-            Processor::flush_instruction_cache(VirtualAddress { dest_ptr }, PAGE_SIZE);
+        // Allocate a new physical page, and copy the read inode contents into it.
+        auto new_physical_page_or_error = MM.allocate_physical_page(MemoryManager::ShouldZeroFill::No);
+        if (new_physical_page_or_error.is_error()) {
+            dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
+            return PageFaultResponse::OutOfMemory;
         }
+        new_physical_page = new_physical_page_or_error.release_value();
+        {
+            InterruptDisabler disabler;
+            u8* dest_ptr = MM.quickmap_page(*new_physical_page);
+            memcpy(dest_ptr, page_buffer, PAGE_SIZE);
+
+            if (is_executable()) {
+                // Some architectures require an explicit synchronization operation after writing to memory that will be executed.
+                // This is required even if no instructions were previously fetched from that (physical) memory location,
+                // because some systems have an I-cache that is not coherent with the D-cache,
+                // resulting in the I-cache being filled with old values if the contents of the D-cache aren't written back yet.
+                Processor::flush_instruction_cache(VirtualAddress { dest_ptr }, PAGE_SIZE);
+            }
 
-        MM.unquickmap_page();
+            MM.unquickmap_page();
+        }
     }
 
     {
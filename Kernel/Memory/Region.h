@@ -85,6 +85,10 @@ public:
     [[nodiscard]] bool is_stack() const { return m_stack; }
     void set_stack(bool stack) { m_stack = stack; }
 
+    // Anonymous regions with this set get backed by 2 MiB pages where the region is large and aligned enough (see madvise(MADV_HUGEPAGE)).
+    [[nodiscard]] bool wants_huge_pages() const { return m_wants_huge_pages; }
+    void set_wants_huge_pages(bool wants_huge_pages) { m_wants_huge_pages = wants_huge_pages; }
+
     [[nodiscard]] bool is_immutable() const { return m_immutable.was_set(); }
     void set_immutable() { m_immutable.set(); }
 
@@ -261,6 +265,10 @@ private:
 
     void remap_impl(ShouldLockVMObject should_lock_vmobject);
 
+    [[nodiscard]] Optional<size_t> huge_page_containing(size_t page_index) const;
+    [[nodiscard]] bool can_map_huge_page(size_t page_index, PhysicalAddress& paddr) const;
+    [[nodiscard]] bool try_map_huge_page(size_t page_index, ShouldLockVMObject, bool readable, bool writeable);
+
     LockRefPtr<PageDirectory> m_page_directory;
     VirtualRange m_range;
     size_t m_offset_in_vmobject { 0 };
@@ -274,6 +282,7 @@ private:
     bool m_syscall_region : 1 { false };
     bool m_mmapped_from_readable : 1 { false };
     bool m_mmapped_from_writable : 1 { false };
+    bool m_wants_huge_pages : 1 { false };
 
     MemoryType m_memory_type;
 
@@ -827,6 +827,13 @@ ErrorOr<void> IPv4Socket::ioctl(OpenFileDescription&, unsigned request, Userspac
             return copy_to_user(user_ifr, &ifr);
         }
 
+        case SIOCSIFMTU:
+            if (!current_process_credentials->is_superuser())
+                return EPERM;
+            if (ifr.ifr_mtu < 0)
+                return EINVAL;
+            return adapter->change_mtu(ifr.ifr_mtu);
+
         case SIOCGIFFLAGS: {
             // FIXME: stub!
             constexpr short flags = 1;
@@ -852,6 +859,7 @@ ErrorOr<void> IPv4Socket::ioctl(OpenFileDescription&, unsigned request, Userspac
     case SIOCGIFNETMASK:
     case SIOCGIFBRDADDR:
     case SIOCGIFMTU:
+    case SIOCSIFMTU:
     case SIOCGIFFLAGS:
     case SIOCGIFCONF:
     case SIOCGIFNAME:
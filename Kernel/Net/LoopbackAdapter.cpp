@@ -11,6 +11,8 @@ namespace Kernel {
 
 static bool s_loopback_initialized = false;
 
+bool g_loopback_packet_loss_enabled { false };
+
 ErrorOr<NonnullRefPtr<LoopbackAdapter>> LoopbackAdapter::try_create()
 {
     return TRY(adopt_nonnull_ref_or_enomem(new (nothrow) LoopbackAdapter("loop"sv)));
@@ -26,12 +28,42 @@ LoopbackAdapter::LoopbackAdapter(StringView interface_name)
     // by the data-link (Ethernet in this case) or physical layers, we need to subtract it from the MTU.
     set_mtu(65536 - sizeof(EthernetFrameHeader));
     set_mac_address({ 19, 85, 2, 9, 0x55, 0xaa });
+    // Packets never leave the machine, so there is no point in checksumming them, or in splitting them
+    // up into segments only to put them back together right after (if the MTU was lowered).
+    set_checksum_offload(true);
+    set_tcp_segmentation_offload(true);
 }
 
 LoopbackAdapter::~LoopbackAdapter() = default;
 
 void LoopbackAdapter::send_raw(ReadonlyBytes payload)
 {
+    // Like a real link, we can't carry packets that exceed our MTU.
+    if (payload.size() > sizeof(EthernetFrameHeader) + mtu()) {
+        dbgln("LoopbackAdapter: Dropping {} byte packet that exceeds the MTU", payload.size());
+        return;
+    }
+    deliver(payload);
+}
+
+void LoopbackAdapter::send_raw_with_offload(ReadonlyBytes payload, PacketOffload const& offload)
+{
+    // Segmentation offload packets are handed to the receiving side in one piece, the same way other
+    // systems do it for their loopback devices. Everything else has to fit the MTU as usual.
+    if (offload.segment_size != 0) {
+        deliver(payload);
+        return;
+    }
+    send_raw(payload);
+}
+
+void LoopbackAdapter::deliver(ReadonlyBytes payload)
+{
+    if (g_loopback_packet_loss_enabled && m_packets_until_loss.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed) == 1) {
+        m_packets_until_loss.store(packet_loss_interval, AK::MemoryOrder::memory_order_relaxed);
+        dbgln_if(LOOPBACK_DEBUG, "LoopbackAdapter: Dropping {} byte(s) to simulate packet loss.", payload.size());
+        return;
+    }
     dbgln_if(LOOPBACK_DEBUG, "LoopbackAdapter: Sending {} byte(s) to myself.", payload.size());
     did_receive(payload);
 }
@@ -10,6 +10,9 @@
 
 namespace Kernel {
 
+// Set through /sys/kernel/conf/loopback_packet_loss, so tests can exercise loss recovery without a lossy link.
+extern bool g_loopback_packet_loss_enabled;
+
 class LoopbackAdapter final : public NetworkAdapter {
 private:
     LoopbackAdapter(StringView);
@@ -21,11 +24,19 @@ public:
     virtual ErrorOr<void> initialize(Badge<NetworkingManagement>) override { VERIFY_NOT_REACHED(); }
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_offload(ReadonlyBytes, PacketOffload const&) override;
     virtual StringView class_name() const override { return "LoopbackAdapter"sv; }
     virtual Type adapter_type() const override { return Type::Loopback; }
     virtual bool link_up() override { return true; }
     virtual bool link_full_duplex() override { return true; }
     virtual int link_speed() override { return 1000; }
+
+private:
+    void deliver(ReadonlyBytes);
+
+    // While packet loss is enabled, every Nth packet is dropped.
+    static constexpr u32 packet_loss_interval = 16;
+    Atomic<u32> m_packets_until_loss { packet_loss_interval };
 };
 
 }
@@ -4,12 +4,16 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteReader.h>
+#include <AK/HashFunctions.h>
+#include <AK/InternetChecksum.h>
 #include <Kernel/Heap/kmalloc.h>
-#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Library/StdLib.h>
 #include <Kernel/Net/EtherType.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
@@ -21,13 +25,99 @@ NetworkAdapter::NetworkAdapter(StringView interface_name)
 
 NetworkAdapter::~NetworkAdapter() = default;
 
-void NetworkAdapter::send_packet(ReadonlyBytes packet)
+ErrorOr<void> NetworkAdapter::change_mtu(u32 mtu)
+{
+    // RFC 791: Every internet module must be able to forward a datagram of 68 octets without further fragmentation.
+    if (mtu < 68 || mtu > m_max_mtu)
+        return EINVAL;
+    m_mtu = mtu;
+    return {};
+}
+
+void NetworkAdapter::send_packet(ReadonlyBytes packet, PacketOffload const& offload)
 {
     m_packets_out++;
     m_bytes_out += packet.size();
+
+    bool needs_segmentation = offload.segment_size != 0 && packet.size() > static_cast<size_t>(offload.header_size) + offload.segment_size;
+    if (needs_segmentation) {
+        VERIFY(offload.needs_checksum);
+        // NOTE: This can happen when a packet built for an adapter with TSO is retransmitted through another one after a route change.
+        if (!has_tcp_segmentation_offload() || !has_checksum_offload())
+            return send_with_software_segmentation(packet, offload);
+        return send_raw_with_offload(packet, offload);
+    }
+
+    if (offload.needs_checksum) {
+        if (!has_checksum_offload())
+            return send_with_software_checksum(packet, offload);
+        return send_raw_with_offload(packet, { .needs_checksum = true, .checksum_start = offload.checksum_start, .checksum_offset = offload.checksum_offset });
+    }
+
     send_raw(packet);
 }
 
+void NetworkAdapter::send_with_software_checksum(ReadonlyBytes packet, PacketOffload const& offload)
+{
+    VERIFY(static_cast<size_t>(offload.checksum_start) + offload.checksum_offset + sizeof(u16) <= packet.size());
+
+    // The packet may be kept around for retransmission, so we can't complete the checksum in place.
+    auto buffer_or_error = ByteBuffer::copy(packet);
+    if (buffer_or_error.is_error()) {
+        dbgln("Dropping packet as there is not enough memory to compute its checksum");
+        return;
+    }
+    auto buffer = buffer_or_error.release_value();
+
+    // The checksum field already holds the pseudo-header checksum, so summing up everything after checksum_start gives the final value.
+    auto checksum = InternetChecksum(buffer.bytes().slice(offload.checksum_start)).digest();
+    memcpy(buffer.offset_pointer(offload.checksum_start + offload.checksum_offset), &checksum, sizeof(checksum));
+    send_raw(buffer.bytes());
+}
+
+void NetworkAdapter::send_with_software_segmentation(ReadonlyBytes packet, PacketOffload const& offload)
+{
+    VERIFY(offload.header_size > offload.checksum_start);
+    VERIFY(offload.checksum_start >= layer3_payload_offset() + sizeof(IPv4Packet));
+
+    auto headers = packet.trim(offload.header_size);
+    auto payload = packet.slice(offload.header_size);
+    auto tcp_header_size = offload.header_size - offload.checksum_start;
+
+    auto buffer_or_error = ByteBuffer::create_uninitialized(offload.header_size + offload.segment_size);
+    if (buffer_or_error.is_error()) {
+        dbgln("Dropping packet as there is not enough memory to segment it");
+        return;
+    }
+    auto buffer = buffer_or_error.release_value();
+
+    size_t segment_index = 0;
+    for (size_t offset = 0; offset < payload.size(); offset += offload.segment_size, ++segment_index) {
+        auto segment_payload_size = min<size_t>(offload.segment_size, payload.size() - offset);
+        bool is_last_segment = offset + segment_payload_size == payload.size();
+        auto segment = buffer.bytes().trim(offload.header_size + segment_payload_size);
+        headers.copy_to(segment);
+        payload.slice(offset, segment_payload_size).copy_to(segment.slice(offload.header_size));
+
+        auto& ipv4 = *bit_cast<IPv4Packet*>(segment.offset_pointer(layer3_payload_offset()));
+        ipv4.set_length(segment.size() - layer3_payload_offset());
+        ipv4.set_ident(static_cast<u16>(ipv4.ident() + segment_index));
+        ipv4.set_checksum(0);
+        ipv4.set_checksum(ipv4.compute_checksum());
+
+        auto& tcp = *bit_cast<TCPPacket*>(segment.offset_pointer(offload.checksum_start));
+        VERIFY(tcp.header_size() == tcp_header_size);
+        tcp.set_sequence_number(tcp.sequence_number() + offset);
+        // Only the last segment gets to carry the FIN and PSH flags.
+        if (!is_last_segment)
+            tcp.set_flags(tcp.flags() & ~(TCPFlags::FIN | TCPFlags::PSH));
+        tcp.set_checksum(0);
+        tcp.set_checksum(TCPSocket::compute_tcp_checksum(ipv4.source(), ipv4.destination(), tcp, segment_payload_size));
+
+        send_raw(segment);
+    }
+}
+
 void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet)
 {
     size_t size_in_bytes = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -47,7 +137,8 @@ void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet
 void NetworkAdapter::fill_in_ipv4_header(PacketWithTimestamp& packet, IPv4Address const& source_ipv4, MACAddress const& destination_mac, IPv4Address const& destination_ipv4, TransportProtocol protocol, size_t payload_size, u8 type_of_service, u8 ttl)
 {
     size_t ipv4_packet_size = sizeof(IPv4Packet) + payload_size;
-    VERIFY(ipv4_packet_size <= mtu());
+    // NOTE: Only TCP hands us packets that are larger than the MTU, which are then split up by send_packet() (see PacketOffload).
+    VERIFY(ipv4_packet_size <= max(static_cast<size_t>(mtu()), max_ipv4_packet_size));
 
     size_t ethernet_frame_size = ipv4_payload_offset() + payload_size;
     VERIFY(packet.buffer->size() == ethernet_frame_size);
@@ -103,13 +194,36 @@ void NetworkAdapter::fill_in_ipv6_header(PacketWithTimestamp& packet, IPv6Addres
     ipv6.set_hop_limit(hop_limit);
 }
 
+// Hashes the addresses (and ports, for TCP and UDP) of IPv4 packets, so that all packets of a flow end up on the same receive queue.
+static u32 flow_hash(ReadonlyBytes frame)
+{
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet))
+        return 0;
+    auto& eth = *bit_cast<EthernetFrameHeader const*>(frame.data());
+    if (eth.ether_type() != EtherType::IPv4)
+        return 0;
+
+    auto& ipv4 = *static_cast<IPv4Packet const*>(eth.payload());
+    u32 hash = pair_int_hash(ipv4.source().to_u32(), ipv4.destination().to_u32());
+
+    // Only the first fragment of a packet carries the ports, so all fragments have to make do with the addresses.
+    auto protocol = static_cast<TransportProtocol>(ipv4.protocol());
+    if ((protocol != TransportProtocol::TCP && protocol != TransportProtocol::UDP) || ipv4.is_a_fragment())
+        return hash;
+    size_t ports_offset = sizeof(EthernetFrameHeader) + ipv4.internet_header_length() * sizeof(u32);
+    if (frame.size() < ports_offset + sizeof(u32))
+        return hash;
+    return pair_int_hash(hash, ByteReader::load32(frame.offset_pointer(ports_offset)));
+}
+
 void NetworkAdapter::did_receive(ReadonlyBytes payload)
 {
-    InterruptDisabler disabler;
     m_packets_in++;
     m_bytes_in += payload.size();
 
-    if (m_packet_queue_size == max_packet_buffers) {
+    auto queue_index = NetworkTask::receive_queue_for_flow(flow_hash(payload));
+    auto& receive_queue = m_receive_queues[queue_index];
+    if (receive_queue.with([](auto& queue) { return queue.size; }) >= max_packet_buffers) {
         m_packets_dropped++;
         return;
     }
@@ -122,27 +236,71 @@ void NetworkAdapter::did_receive(ReadonlyBytes payload)
 
     memcpy(packet->buffer->data(), payload.data(), payload.size());
 
-    m_packet_queue.append(*packet);
-    m_packet_queue_size++;
+    receive_queue.with([&](auto& queue) {
+        queue.packets.append(*packet);
+        queue.size++;
+    });
 
     if (on_receive)
-        on_receive();
+        on_receive(queue_index);
 }
 
-size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp)
+bool NetworkAdapter::has_queued_packets(size_t queue_index) const
 {
-    InterruptDisabler disabler;
-    if (m_packet_queue.is_empty())
-        return 0;
-    auto packet_with_timestamp = m_packet_queue.take_first();
-    m_packet_queue_size--;
-    packet_timestamp = packet_with_timestamp->timestamp;
-    auto& packet_buffer = packet_with_timestamp->buffer;
-    size_t packet_size = packet_buffer->size();
-    VERIFY(packet_size <= buffer_size);
-    memcpy(buffer, packet_buffer->data(), packet_size);
-    release_packet_buffer(*packet_with_timestamp);
-    return packet_size;
+    return m_receive_queues[queue_index].with([](auto const& queue) { return !queue.packets.is_empty(); });
+}
+
+size_t NetworkAdapter::process_queued_packets(size_t queue_index, size_t budget, Function<void(ReadonlyBytes, UnixDateTime)> const& callback)
+{
+    PacketList batch;
+    size_t batch_size = 0;
+    m_receive_queues[queue_index].with([&](auto& queue) {
+        while (batch_size < budget && !queue.packets.is_empty()) {
+            batch.append(*queue.packets.take_first());
+            ++batch_size;
+        }
+        queue.size -= batch_size;
+    });
+
+    // NOTE: The packets are processed right where they were received into, without copying them out again.
+    while (!batch.is_empty()) {
+        auto packet = batch.take_first();
+        callback(packet->bytes(), packet->timestamp);
+        release_packet_buffer(*packet);
+    }
+    return batch_size;
+}
+
+void NetworkAdapter::schedule_receive_poll(size_t device_queue)
+{
+    if (m_receive_poll_scheduled[device_queue].exchange(true))
+        return;
+    set_receive_interrupt_enabled(device_queue, false);
+    if (on_receive)
+        on_receive(NetworkTask::receive_queue_for_device_queue(device_queue));
+}
+
+size_t NetworkAdapter::poll(size_t receive_queue, size_t budget)
+{
+    size_t polled_frames = 0;
+    for (size_t device_queue = receive_queue; device_queue < m_receive_poll_scheduled.size(); device_queue += NetworkTask::receive_queue_count()) {
+        if (!m_receive_poll_scheduled[device_queue].load())
+            continue;
+
+        auto frames = poll_receive(device_queue, budget);
+        polled_frames += frames;
+        if (frames == budget)
+            continue;
+
+        m_receive_poll_scheduled[device_queue].store(false);
+        set_receive_interrupt_enabled(device_queue, true);
+        // Frames that arrived before the interrupt was turned back on didn't raise one, so pick them up now.
+        frames = poll_receive(device_queue, budget);
+        polled_frames += frames;
+        if (frames == budget)
+            schedule_receive_poll(device_queue);
+    }
+    return polled_frames;
 }
 
 RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
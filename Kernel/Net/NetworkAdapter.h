@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/ByteBuffer.h>
 #include <AK/Function.h>
@@ -24,6 +26,7 @@
 #include <Kernel/Net/IP/IP.h>
 #include <Kernel/Net/IP/IPv4.h>
 #include <Kernel/Net/IP/IPv6.h>
+#include <Kernel/Net/NetworkTask.h>
 
 namespace Kernel {
 
@@ -45,6 +48,21 @@ struct PacketWithTimestamp final : public AtomicRefCounted<PacketWithTimestamp>
     IntrusiveListNode<PacketWithTimestamp, RefPtr<PacketWithTimestamp>> packet_node;
 };
 
+// Work that send_packet() callers leave to the adapter (or to send_packet() itself, if the adapter can't do it).
+struct PacketOffload {
+    // The transport checksum at checksum_start + checksum_offset only covers the pseudo-header so far,
+    // the rest of the packet from checksum_start onwards still has to be added to it.
+    bool needs_checksum { false };
+    u16 checksum_start { 0 };
+    u16 checksum_offset { 0 };
+
+    // If non-zero, this is a TCP over IPv4 packet that has to be split into segments carrying at most
+    // segment_size bytes of payload each, all starting with (an adjusted copy of) the first header_size bytes.
+    // This requires needs_checksum to be set, with checksum_start pointing at the TCP header.
+    u16 segment_size { 0 };
+    u16 header_size { 0 };
+};
+
 class NetworkingManagement;
 class NetworkAdapter
     : public AtomicRefCounted<NetworkAdapter>
@@ -57,6 +75,9 @@ public:
 
     static constexpr i32 LINKSPEED_INVALID = -1;
 
+    // The IPv4 total length field limits how much a single packet handed to send_packet() can carry.
+    static constexpr size_t max_ipv4_packet_size = NumericLimits<u16>::max();
+
     virtual ~NetworkAdapter();
 
     virtual StringView class_name() const = 0;
@@ -92,12 +113,27 @@ public:
     void fill_in_ipv4_header(PacketWithTimestamp&, IPv4Address const&, MACAddress const&, IPv4Address const&, TransportProtocol, size_t, u8 type_of_service, u8 ttl);
     void fill_in_ipv6_header(PacketWithTimestamp&, IPv6Address const&, MACAddress const&, IPv6Address const&, TransportProtocol, size_t, u8 hop_limit);
 
-    size_t dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp);
+    // Takes up to `budget` packets off the receive queue in one go and hands them to `callback` one after another.
+    // Returns the number of packets processed.
+    size_t process_queued_packets(size_t receive_queue, size_t budget, Function<void(ReadonlyBytes, UnixDateTime)> const& callback);
 
-    bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
+    bool has_queued_packets(size_t receive_queue) const;
+
+    // Polls the device queues that NetworkTask::receive_queue_for_device_queue() maps to this receive queue,
+    // handing up to `budget` frames from each of them to did_receive(). Returns the number of frames polled.
+    size_t poll(size_t receive_queue, size_t budget);
 
     u32 mtu() const { return m_mtu; }
-    void set_mtu(u32 mtu) { m_mtu = mtu; }
+    // Drivers set the largest MTU their link supports, change_mtu() (i.e. SIOCSIFMTU) can only go below that.
+    void set_mtu(u32 mtu)
+    {
+        m_mtu = mtu;
+        m_max_mtu = mtu;
+    }
+    ErrorOr<void> change_mtu(u32 mtu);
+
+    bool has_checksum_offload() const { return m_has_checksum_offload; }
+    bool has_tcp_segmentation_offload() const { return m_has_tcp_segmentation_offload; }
 
     u32 packets_in() const { return m_packets_in; }
     u32 bytes_in() const { return m_bytes_in; }
@@ -112,18 +148,34 @@ public:
     constexpr size_t ipv4_payload_offset() const { return layer3_payload_offset() + sizeof(IPv4Packet); }
     constexpr size_t ipv6_payload_offset() const { return layer3_payload_offset() + sizeof(IPv6PacketHeader); }
 
-    Function<void()> on_receive;
+    // Called with the index of the receive queue (see NetworkTask::receive_queue_for_flow()) a packet was put on.
+    Function<void(size_t receive_queue)> on_receive;
 
-    void send_packet(ReadonlyBytes);
+    void send_packet(ReadonlyBytes, PacketOffload const& = {});
 
 protected:
     NetworkAdapter(StringView);
     void set_mac_address(MACAddress const& mac_address) { m_mac_address = mac_address; }
+    void set_checksum_offload(bool enabled) { m_has_checksum_offload = enabled; }
+    void set_tcp_segmentation_offload(bool enabled) { m_has_tcp_segmentation_offload = enabled; }
     void did_receive(ReadonlyBytes);
+
+    // Receive interrupt mitigation, like Linux's NAPI: Instead of draining a device queue from its interrupt handler,
+    // an adapter can mask the queue's receive interrupt and call schedule_receive_poll(). The network task will then
+    // call poll_receive() until it returns less than the budget, which means the device queue ran dry, and only then
+    // turn the interrupt back on. Under load, the adapter thus stays in polling mode and doesn't raise any interrupts.
+    void schedule_receive_poll(size_t device_queue);
+    virtual size_t poll_receive(size_t, size_t) { VERIFY_NOT_REACHED(); }
+    virtual void set_receive_interrupt_enabled(size_t, bool) { VERIFY_NOT_REACHED(); }
     virtual void send_raw(ReadonlyBytes) = 0;
+    // Only called with offloads the adapter has announced via set_checksum_offload() and set_tcp_segmentation_offload().
+    virtual void send_raw_with_offload(ReadonlyBytes, PacketOffload const&) { VERIFY_NOT_REACHED(); }
     void autoconfigure_link_local_ipv6();
 
 private:
+    void send_with_software_checksum(ReadonlyBytes, PacketOffload const&);
+    void send_with_software_segmentation(ReadonlyBytes, PacketOffload const&);
+
     MACAddress m_mac_address;
     // FIXME: Allow for more than one IPv4/IPv6 address each.
     IPv4Address m_ipv4_address;
@@ -136,8 +188,13 @@ private:
 
     using PacketList = IntrusiveList<&PacketWithTimestamp::packet_node>;
 
-    PacketList m_packet_queue;
-    size_t m_packet_queue_size { 0 };
+    struct ReceiveQueue {
+        PacketList packets;
+        size_t size { 0 };
+    };
+
+    Array<SpinlockProtected<ReceiveQueue, LockRank::None>, NetworkTask::max_receive_queue_count> m_receive_queues;
+    Array<Atomic<bool>, NetworkTask::max_receive_queue_count> m_receive_poll_scheduled {};
     SpinlockProtected<PacketList, LockRank::None> m_unused_packets {};
     FixedStringBuffer<IFNAMSIZ> m_name;
     u32 m_packets_in { 0 };
@@ -145,7 +202,10 @@ private:
     u32 m_packets_out { 0 };
     u32 m_bytes_out { 0 };
     u32 m_mtu { 1500 };
+    u32 m_max_mtu { 1500 };
     u32 m_packets_dropped { 0 };
+    bool m_has_checksum_offload { false };
+    bool m_has_tcp_segmentation_offload { false };
 };
 
 }
@@ -30,6 +30,7 @@
 
 namespace Kernel {
 
+static void handle_frame(ReadonlyBytes frame, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
 static void handle_arp(EthernetFrameHeader const&, size_t frame_size, RefPtr<NetworkAdapter> adapter);
 static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
 static void handle_icmp(EthernetFrameHeader const&, IPv4Packet const&, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter);
@@ -42,28 +43,42 @@ static void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_pac
 static void flush_delayed_tcp_acks();
 static void retransmit_tcp_packets();
 
-static Thread* network_task = nullptr;
-static HashTable<NonnullRefPtr<TCPSocket>>* delayed_ack_sockets;
+static Process* network_task_process = nullptr;
+static MutexProtected<HashTable<NonnullRefPtr<TCPSocket>>>* delayed_ack_sockets;
+
+// Adapters are polled for up to this many frames per device queue and round, like NAPI's weight.
+static constexpr size_t receive_poll_budget = 64;
+// The protocol layer works through this many received packets before flushing delayed ACKs and looking for more.
+static constexpr size_t packet_batch_size = 64;
+
+// Every receive queue is drained by its own thread of the network task, each pinned to a CPU of its own.
+static Array<DeprecatedWaitQueue, NetworkTask::max_receive_queue_count>* s_packet_wait_queues;
 
 [[noreturn]] static void NetworkTask_main(void*);
+static void process_receive_queue(size_t queue_index);
 
 void NetworkTask::spawn()
 {
-    auto [_, first_thread] = MUST(Process::create_kernel_process("Network Task"sv, NetworkTask_main, nullptr));
-    network_task = first_thread;
+    auto [process, _] = MUST(Process::create_kernel_process("Network Task"sv, NetworkTask_main, nullptr, 1u << 0));
+    network_task_process = process.ptr();
 }
 
 bool NetworkTask::is_current()
 {
-    return Thread::current() == network_task;
+    return &Thread::current()->process() == network_task_process;
+}
+
+size_t NetworkTask::receive_queue_count()
+{
+    // NOTE: Adapters are initialized (and may receive packets) before the network task exists, but after all processors came up.
+    return max(min<size_t>(Processor::count(), max_receive_queue_count), 1uz);
 }
 
 void NetworkTask_main(void*)
 {
-    delayed_ack_sockets = new HashTable<NonnullRefPtr<TCPSocket>>;
+    delayed_ack_sockets = new MutexProtected<HashTable<NonnullRefPtr<TCPSocket>>>;
+    s_packet_wait_queues = new Array<DeprecatedWaitQueue, NetworkTask::max_receive_queue_count>;
 
-    DeprecatedWaitQueue packet_wait_queue;
-    int pending_packets = 0;
     NetworkingManagement::the().for_each([&](auto& adapter) {
         dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
@@ -72,69 +87,77 @@ void NetworkTask_main(void*)
             adapter.set_ipv4_netmask({ 255, 0, 0, 0 });
         }
 
-        adapter.on_receive = [&]() {
-            pending_packets++;
-            packet_wait_queue.wake_all();
+        adapter.on_receive = [](size_t queue_index) {
+            (*s_packet_wait_queues)[queue_index].wake_all();
         };
     });
 
-    size_t buffer_size = 64 * KiB;
-    auto region_or_error = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer"sv, Memory::Region::Access::ReadWrite);
-    if (region_or_error.is_error())
-        TODO();
-    auto buffer_region = region_or_error.release_value();
+    // This thread takes care of the first receive queue and all timers, the other receive queues get a thread of their own.
+    for (size_t queue_index = 1; queue_index < NetworkTask::receive_queue_count(); ++queue_index) {
+        auto name = MUST(KString::formatted("Network Task #{}", queue_index));
+        (void)MUST(Process::current().create_kernel_thread(name->view(), [queue_index] { process_receive_queue(queue_index); }, THREAD_PRIORITY_NORMAL, 1u << queue_index));
+    }
+    dmesgln("NetworkTask: Processing received packets on {} CPU(s)", NetworkTask::receive_queue_count());
+
+    process_receive_queue(0);
 
-    struct {
-        u8* buffer;
-        UnixDateTime packet_timestamp;
-        RefPtr<NetworkAdapter> adapter;
-    } meta;
+    Process::current().sys$exit(0);
+    VERIFY_NOT_REACHED();
+}
 
-    meta.buffer = (u8*)buffer_region->vaddr().get();
+void process_receive_queue(size_t queue_index)
+{
+    auto& packet_wait_queue = (*s_packet_wait_queues)[queue_index];
+    bool handles_timers = queue_index == 0;
 
     while (!Process::current().is_dying()) {
+        if (handles_timers)
+            retransmit_tcp_packets();
+
+        size_t work_done = 0;
+        NetworkingManagement::the().for_each([&](auto& adapter) {
+            RefPtr<NetworkAdapter> adapter_ptr = adapter;
+            work_done += adapter.poll(queue_index, receive_poll_budget);
+            work_done += adapter.process_queued_packets(queue_index, packet_batch_size, [&](ReadonlyBytes frame, UnixDateTime packet_timestamp) {
+                dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes) on receive queue {}", adapter.name(), frame.size(), queue_index);
+                handle_frame(frame, packet_timestamp, adapter_ptr);
+            });
+        });
+
+        // All segments of a batch that asked for a delayed ACK get acknowledged together.
         flush_delayed_tcp_acks();
-        retransmit_tcp_packets();
-        size_t packet_size = 0;
-        if (!pending_packets) {
+
+        if (work_done == 0) {
+            // NOTE: A wake-up that happens before we start waiting isn't lost, the wait then returns right away.
             auto timeout_time = Duration::from_milliseconds(500);
             auto timeout = Thread::BlockTimeout { false, &timeout_time };
             [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
-            continue;
-        } else {
-            NetworkingManagement::the().for_each([&](auto& adapter) {
-                if (packet_size || !adapter.has_queued_packets()) {
-                    return;
-                }
-                packet_size = adapter.dequeue_packet(meta.buffer, buffer_size, meta.packet_timestamp);
-                pending_packets--;
-                dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
-                meta.adapter = adapter;
-            });
-        }
-        if (packet_size < sizeof(EthernetFrameHeader)) {
-            dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
-            continue;
-        }
-        auto& eth = *(EthernetFrameHeader const*)meta.buffer;
-        dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
-
-        switch (eth.ether_type()) {
-        case EtherType::ARP:
-            handle_arp(eth, packet_size, meta.adapter);
-            break;
-        case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, meta.packet_timestamp, meta.adapter);
-            break;
-        case EtherType::IPv6:
-            handle_ipv6(eth, packet_size, meta.packet_timestamp, meta.adapter);
-            break;
-        default:
-            dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
         }
     }
-    Process::current().sys$exit(0);
-    VERIFY_NOT_REACHED();
+}
+
+void handle_frame(ReadonlyBytes frame, UnixDateTime const& packet_timestamp, RefPtr<NetworkAdapter> adapter)
+{
+    if (frame.size() < sizeof(EthernetFrameHeader)) {
+        dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", frame.size());
+        return;
+    }
+    auto& eth = *(EthernetFrameHeader const*)frame.data();
+    dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), frame.size());
+
+    switch (eth.ether_type()) {
+    case EtherType::ARP:
+        handle_arp(eth, frame.size(), adapter);
+        break;
+    case EtherType::IPv4:
+        handle_ipv4(eth, frame.size(), packet_timestamp, adapter);
+        break;
+    case EtherType::IPv6:
+        handle_ipv6(eth, frame.size(), packet_timestamp, adapter);
+        break;
+    default:
+        dbgln_if(ETHERNET_DEBUG, "NetworkTask: Unknown ethernet type {:#04x}", eth.ether_type());
+    }
 }
 
 void handle_arp(EthernetFrameHeader const& eth, size_t frame_size, RefPtr<NetworkAdapter> adapter)
@@ -474,13 +497,20 @@ void send_delayed_tcp_ack(TCPSocket& socket)
         return;
     }
 
-    delayed_ack_sockets->set(move(socket));
+    delayed_ack_sockets->with_exclusive([&](auto& sockets) {
+        sockets.set(move(socket));
+    });
 }
 
 void flush_delayed_tcp_acks()
 {
+    // NOTE: Receive queue threads add sockets while holding the socket's lock, so we must not hold on to the table while locking sockets.
+    auto sockets = delayed_ack_sockets->with_exclusive([](auto& sockets) {
+        return move(sockets);
+    });
+
     Vector<NonnullRefPtr<TCPSocket>, 32> remaining_sockets;
-    for (auto& socket : *delayed_ack_sockets) {
+    for (auto& socket : sockets) {
         MutexLocker locker(socket->mutex());
         if (socket->should_delay_next_ack()) {
             MUST(remaining_sockets.try_append(*socket));
@@ -489,13 +519,14 @@ void flush_delayed_tcp_acks()
         [[maybe_unused]] auto result = socket->send_ack();
     }
 
-    if (remaining_sockets.size() != delayed_ack_sockets->size()) {
-        delayed_ack_sockets->clear();
-        if (remaining_sockets.size() > 0)
-            dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
+    if (remaining_sockets.is_empty())
+        return;
+    if (remaining_sockets.size() != sockets.size())
+        dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
+    delayed_ack_sockets->with_exclusive([&](auto& delayed_sockets) {
         for (auto&& socket : remaining_sockets)
-            delayed_ack_sockets->set(move(socket));
-    }
+            delayed_sockets.set(move(socket));
+    });
 }
 
 void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, RefPtr<NetworkAdapter> adapter)
@@ -591,18 +622,40 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
 
     socket->receive_tcp_packet(tcp_packet, ipv4_packet.payload_size());
     Optional<u8> send_window_scale;
+    bool sack_permitted = false;
+    Optional<u32> peer_timestamp;
     if (tcp_packet.has_syn()) {
-        tcp_packet.for_each_option([&send_window_scale](auto const& option) {
-            if (option.kind() != TCPOptionKind::WindowScale)
+        tcp_packet.for_each_option([&](auto const& option) {
+            switch (option.kind()) {
+            case TCPOptionKind::WindowScale: {
+                if (option.length() != sizeof(TCPOptionWindowScale))
+                    return;
+                auto scale = static_cast<TCPOptionWindowScale const&>(option).value();
+                if (scale > 14)
+                    return; // Maximum allowed as per RFC7323
+                send_window_scale = scale;
                 return;
-            if (option.length() != sizeof(TCPOptionWindowScale))
+            }
+            case TCPOptionKind::SACKPermitted:
+                if (option.length() == sizeof(TCPOptionSACKPermitted))
+                    sack_permitted = true;
+                return;
+            case TCPOptionKind::Timestamp:
+                if (option.length() == sizeof(TCPOptionTimestamp))
+                    peer_timestamp = static_cast<TCPOptionTimestamp const&>(option).value();
+                return;
+            default:
                 return;
-            auto scale = static_cast<TCPOptionWindowScale const&>(option).value();
-            if (scale > 14)
-                return; // Maximum allowed as per RFC7323
-            send_window_scale = scale;
+            }
         });
     }
+    // Both SACK and timestamps are only used if both sides offered them in their SYN, so this
+    // has to happen before we answer with our own SYN-ACK (which only echoes what the peer offered).
+    auto negotiate_syn_options = [&](TCPSocket& socket) {
+        socket.set_sack_permitted(sack_permitted);
+        if (peer_timestamp.has_value())
+            socket.enable_timestamps(*peer_timestamp);
+    };
 
     switch (socket->state()) {
     case TCPSocket::State::Closed:
@@ -635,6 +688,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            negotiate_syn_options(*client);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             client->set_state(TCPSocket::State::SynReceived);
             if (send_window_scale.has_value())
@@ -650,6 +704,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
         switch (tcp_packet.flags()) {
         case TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            negotiate_syn_options(*socket);
             (void)socket->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             socket->set_state(TCPSocket::State::SynReceived);
             if (send_window_scale.has_value())
@@ -657,6 +712,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             return;
         case TCPFlags::ACK | TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            negotiate_syn_options(*socket);
             (void)socket->send_ack(true);
             socket->set_state(TCPSocket::State::Established);
             socket->set_setup_state(Socket::SetupState::Completed);
@@ -814,6 +870,14 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
         }
 
         if (tcp_packet.sequence_number() != socket->ack_number()) {
+            // With SACK, we keep what arrived after a gap, so the peer only has to resend the missing segments.
+            // Every one of them is acknowledged right away, as that's how the peer learns about the gap (RFC 2018, 4).
+            if (socket->sack_permitted() && payload_size != 0 && !tcp_packet.has_fin()
+                && socket->queue_out_of_order_segment(tcp_packet.sequence_number(), payload_size, { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp)) {
+                dbgln_if(TCP_DEBUG, "Queued out of order packet: seq {} vs. ack {}", tcp_packet.sequence_number(), socket->ack_number());
+                [[maybe_unused]] auto result = socket->send_ack(true);
+                return;
+            }
             dbgln_if(TCP_DEBUG, "Discarding out of order packet: seq {} vs. ack {}", tcp_packet.sequence_number(), socket->ack_number());
             if (socket->duplicate_acks() < TCPSocket::maximum_duplicate_acks) {
                 dbgln_if(TCP_DEBUG, "Sending ACK with same ack number to trigger fast retransmission");
@@ -841,7 +905,13 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
                 socket->set_ack_number(tcp_packet.sequence_number() + payload_size);
                 dbgln_if(TCP_DEBUG, "Got packet with ack_no={}, seq_no={}, payload_size={}, acking it with new ack_no={}, seq_no={}",
                     tcp_packet.ack_number(), tcp_packet.sequence_number(), payload_size, socket->ack_number(), socket->sequence_number());
-                send_delayed_tcp_ack(*socket);
+                if (socket->has_out_of_order_segments()) {
+                    // A segment that fills a gap is acknowledged right away (RFC 5681, 4.2).
+                    socket->deliver_out_of_order_segments();
+                    [[maybe_unused]] auto result = socket->send_ack();
+                } else {
+                    send_delayed_tcp_ack(*socket);
+                }
             }
         }
     }
@@ -6,10 +6,21 @@
 
 #pragma once
 
+#include <AK/Types.h>
+
 namespace Kernel {
 class NetworkTask {
 public:
+    static constexpr size_t max_receive_queue_count = 16;
+
     static void spawn();
     static bool is_current();
+
+    // Received packets are spread over this many queues, each processed by its own thread.
+    static size_t receive_queue_count();
+    // All packets of a flow go to the same queue, so they are processed in order.
+    static size_t receive_queue_for_flow(u32 flow_hash) { return flow_hash % receive_queue_count(); }
+    // Adapters with multiple device queues have each of them polled by a single receive queue thread.
+    static size_t receive_queue_for_device_queue(size_t device_queue) { return device_queue % receive_queue_count(); }
 };
 }
@@ -28,7 +28,7 @@ enum class TCPOptionKind : u8 {
     WindowScale = 3,
     SACKPermitted = 4,
     SACK = 5,
-    Timestamp = 6,
+    Timestamp = 8,
 };
 
 class [[gnu::packed]] TCPOption {
@@ -76,7 +76,64 @@ private:
     NetworkOrdered<u8> m_value;
 };
 
+class [[gnu::packed]] TCPOptionSACKPermitted : public TCPOption {
+public:
+    TCPOptionSACKPermitted()
+        : TCPOption(TCPOptionKind::SACKPermitted, sizeof(TCPOptionSACKPermitted))
+    {
+    }
+};
+
+struct [[gnu::packed]] TCPSACKBlock {
+    NetworkOrdered<u32> left_edge;
+    NetworkOrdered<u32> right_edge;
+};
+
+// RFC 2018, 3: Variable-length list of blocks of data the receiver has queued beyond the cumulative ACK.
+class [[gnu::packed]] TCPOptionSACK : public TCPOption {
+public:
+    // Four blocks fill up the 40 bytes of option space, three if the timestamps option has to fit too.
+    static constexpr size_t max_block_count = 4;
+
+    // The blocks themselves follow right after this header.
+    explicit TCPOptionSACK(size_t block_count)
+        : TCPOption(TCPOptionKind::SACK, sizeof(TCPOption) + block_count * sizeof(TCPSACKBlock))
+    {
+        VERIFY(block_count > 0 && block_count <= max_block_count);
+    }
+
+    size_t block_count() const { return (length() - sizeof(TCPOption)) / sizeof(TCPSACKBlock); }
+
+    TCPSACKBlock const& block(size_t index) const
+    {
+        VERIFY(index < block_count());
+        return reinterpret_cast<TCPSACKBlock const*>(reinterpret_cast<u8 const*>(this) + sizeof(TCPOption))[index];
+    }
+};
+
+// RFC 7323, 3.2
+class [[gnu::packed]] TCPOptionTimestamp : public TCPOption {
+public:
+    TCPOptionTimestamp(u32 value, u32 echo_reply)
+        : TCPOption(TCPOptionKind::Timestamp, sizeof(TCPOptionTimestamp))
+        , m_value(value)
+        , m_echo_reply(echo_reply)
+    {
+    }
+
+    u32 value() const { return m_value; }
+    u32 echo_reply() const { return m_echo_reply; }
+
+private:
+    NetworkOrdered<u32> m_value;
+    NetworkOrdered<u32> m_echo_reply;
+};
+
 static_assert(AssertSize<TCPOptionMSS, 4>());
+static_assert(AssertSize<TCPOptionSACKPermitted, 2>());
+static_assert(AssertSize<TCPSACKBlock, 8>());
+static_assert(AssertSize<TCPOptionSACK, 2>());
+static_assert(AssertSize<TCPOptionTimestamp, 10>());
 
 class [[gnu::packed]] TCPPacket {
 public:
@@ -113,6 +170,7 @@ public:
 
     u16 checksum() const { return m_checksum; }
     void set_checksum(u16 checksum) { m_checksum = checksum; }
+    static constexpr u16 checksum_offset() { return 16; }
 
     u16 urgent() const { return m_urgent; }
     void set_urgent(u16 urgent) { m_urgent = urgent; }
@@ -137,6 +195,8 @@ public:
             }
             if (option->length() < sizeof(TCPOption))
                 return; // minimal option length
+            if (option->length() > (size_t)options_end - (size_t)next_option)
+                return; // Option claims to extend beyond the header
             callback(*option);
             next_option += option->length();
         }
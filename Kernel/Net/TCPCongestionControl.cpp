@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/Net/TCPCongestionControl.h>
+
+namespace Kernel {
+
+// Sequence numbers wrap around, so compare them using serial number arithmetic.
+static bool sequence_number_at_or_after(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) >= 0;
+}
+
+static u64 integer_cube_root(u64 value)
+{
+    // Inputs are bounded well below 2^63, so the root fits in 21 bits and middle^3 can't overflow.
+    u64 low = 0;
+    u64 high = (1 << 21) - 1;
+    while (low < high) {
+        u64 middle = (low + high + 1) / 2;
+        if (middle * middle * middle <= value)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+ErrorOr<NonnullOwnPtr<TCPCongestionControl>> TCPCongestionControl::try_create(TCPCongestionControlAlgorithm algorithm, u32 maximum_segment_size)
+{
+    switch (algorithm) {
+    case TCPCongestionControlAlgorithm::NewReno:
+        return TRY(adopt_nonnull_own_or_enomem(new (nothrow) TCPNewRenoCongestionControl(maximum_segment_size)));
+    case TCPCongestionControlAlgorithm::Cubic:
+        return TRY(adopt_nonnull_own_or_enomem(new (nothrow) TCPCubicCongestionControl(maximum_segment_size)));
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<TCPCongestionControlAlgorithm> TCPCongestionControl::algorithm_from_name(StringView name)
+{
+    if (name == "reno"sv)
+        return TCPCongestionControlAlgorithm::NewReno;
+    if (name == "cubic"sv)
+        return TCPCongestionControlAlgorithm::Cubic;
+    return {};
+}
+
+TCPCongestionControl::TCPCongestionControl(u32 maximum_segment_size)
+    : m_maximum_segment_size(maximum_segment_size)
+{
+    m_congestion_window = initial_window();
+}
+
+u32 TCPCongestionControl::initial_window() const
+{
+    // RFC 5681, 3.1: IW = min(4 * SMSS, max(2 * SMSS, 4380 bytes))
+    return min(4 * m_maximum_segment_size, max(2 * m_maximum_segment_size, 4380u));
+}
+
+void TCPCongestionControl::set_maximum_segment_size(u32 maximum_segment_size)
+{
+    VERIFY(maximum_segment_size > 0);
+    if (m_maximum_segment_size == maximum_segment_size)
+        return;
+    m_maximum_segment_size = maximum_segment_size;
+    m_congestion_window = max(m_congestion_window, initial_window());
+}
+
+TCPCongestionControl::AckResult TCPCongestionControl::on_new_ack(u32 ack_number, u32 acked_bytes, MonotonicTime now)
+{
+    m_duplicate_acks = 0;
+
+    if (m_in_fast_recovery) {
+        if (sequence_number_at_or_after(ack_number, m_recovery_point)) {
+            // Full acknowledgment: everything outstanding when the loss was detected has arrived.
+            m_in_fast_recovery = false;
+            m_congestion_window = m_slow_start_threshold;
+            dbgln_if(TCP_SOCKET_DEBUG, "TCPCongestionControl({}): Leaving fast recovery, cwnd={}", name(), m_congestion_window);
+            return AckResult::None;
+        }
+
+        // Partial acknowledgment: deflate the window by the amount of new data acknowledged,
+        // then add back one segment for the retransmission we're about to send (RFC 6582, 3.2).
+        m_congestion_window -= min(acked_bytes, m_congestion_window);
+        if (acked_bytes >= m_maximum_segment_size)
+            m_congestion_window += m_maximum_segment_size;
+        m_congestion_window = max(m_congestion_window, m_maximum_segment_size);
+        return AckResult::RetransmitNextSegment;
+    }
+
+    if (m_congestion_window < m_slow_start_threshold) {
+        // Slow start, with appropriate byte counting limited to one segment per ACK (RFC 3465).
+        m_congestion_window += min(acked_bytes, m_maximum_segment_size);
+    } else {
+        increase_window_in_congestion_avoidance(acked_bytes, now);
+    }
+    return AckResult::None;
+}
+
+bool TCPCongestionControl::on_duplicate_ack(u32 highest_sequence_number_sent, u32 bytes_in_flight, MonotonicTime now)
+{
+    if (m_in_fast_recovery) {
+        // Every further duplicate ACK means another segment has left the network.
+        m_congestion_window += m_maximum_segment_size;
+        return false;
+    }
+
+    if (++m_duplicate_acks != duplicate_ack_threshold)
+        return false;
+
+    m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight, now);
+    m_congestion_window = m_slow_start_threshold + duplicate_ack_threshold * m_maximum_segment_size;
+    m_recovery_point = highest_sequence_number_sent;
+    m_in_fast_recovery = true;
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPCongestionControl({}): Entering fast recovery, ssthresh={}, cwnd={}", name(), m_slow_start_threshold, m_congestion_window);
+    return true;
+}
+
+void TCPCongestionControl::on_retransmit_timeout(u32 bytes_in_flight, MonotonicTime now)
+{
+    // RFC 5681, 3.1: After a retransmission timeout, restart from a loss window of one segment.
+    m_slow_start_threshold = slow_start_threshold_after_loss(bytes_in_flight, now);
+    m_congestion_window = m_maximum_segment_size;
+    m_in_fast_recovery = false;
+    m_duplicate_acks = 0;
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPCongestionControl({}): Retransmit timeout, ssthresh={}", name(), m_slow_start_threshold);
+}
+
+void TCPNewRenoCongestionControl::increase_window_in_congestion_avoidance(u32 acked_bytes, MonotonicTime)
+{
+    // Grow by one segment per window's worth of acknowledged data, i.e. roughly once per RTT.
+    m_bytes_acked_in_congestion_avoidance += acked_bytes;
+    if (m_bytes_acked_in_congestion_avoidance >= m_congestion_window) {
+        m_bytes_acked_in_congestion_avoidance -= m_congestion_window;
+        m_congestion_window += m_maximum_segment_size;
+    }
+}
+
+u32 TCPNewRenoCongestionControl::slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime)
+{
+    m_bytes_acked_in_congestion_avoidance = 0;
+    // RFC 5681, 3.1: ssthresh = max(FlightSize / 2, 2 * SMSS)
+    return max(bytes_in_flight / 2, 2 * m_maximum_segment_size);
+}
+
+// CUBIC constants (RFC 9438, 4.1), expressed as fractions: beta_cubic = 0.7, C = 0.4.
+static constexpr u64 cubic_beta_numerator = 7;
+static constexpr u64 cubic_beta_denominator = 10;
+static constexpr u64 cubic_c_numerator = 4;
+static constexpr u64 cubic_c_denominator = 10;
+
+// Don't evaluate the cubic function further than this away from K, to keep the arithmetic within 64 bits.
+static constexpr i64 cubic_maximum_time_offset_in_milliseconds = 100'000;
+
+u64 TCPCubicCongestionControl::window_at(i64 milliseconds_since_epoch_start) const
+{
+    // W_cubic(t) = C * (t - K)^3 + W_max, with t in seconds and the window in segments (RFC 9438, 4.2).
+    auto offset = clamp(milliseconds_since_epoch_start - m_k_milliseconds, -cubic_maximum_time_offset_in_milliseconds, cubic_maximum_time_offset_in_milliseconds);
+    i64 offset_cubed = offset * offset * offset;
+    // Convert ms^3 to s^3 (1e9), scale by C and by the segment size to get bytes.
+    i64 delta = offset_cubed * static_cast<i64>(cubic_c_numerator) / static_cast<i64>(cubic_c_denominator) / 1000 * m_maximum_segment_size / 1'000'000;
+    i64 window = static_cast<i64>(m_window_max) + delta;
+    return max(window, static_cast<i64>(m_maximum_segment_size));
+}
+
+void TCPCubicCongestionControl::increase_window_in_congestion_avoidance(u32 acked_bytes, MonotonicTime now)
+{
+    if (!m_epoch_start.has_value()) {
+        m_epoch_start = now;
+        m_reno_window = m_congestion_window;
+        m_reno_bytes_acked = 0;
+        if (m_congestion_window < m_window_max) {
+            // K = cubic_root((W_max - cwnd_epoch) / C), in seconds and segments (RFC 9438, 4.2).
+            u64 segments = (m_window_max - m_congestion_window) / m_maximum_segment_size;
+            m_k_milliseconds = integer_cube_root(segments * cubic_c_denominator * 1'000'000'000 / cubic_c_numerator);
+        } else {
+            m_k_milliseconds = 0;
+            m_window_max = m_congestion_window;
+        }
+    }
+
+    auto elapsed_milliseconds = (now - *m_epoch_start).to_milliseconds();
+    u64 target = window_at(elapsed_milliseconds);
+
+    // Reno-friendly region (RFC 9438, 4.3): grow at least as fast as a Reno sender with
+    // alpha_cubic = 3 * (1 - beta_cubic) / (1 + beta_cubic), which is 9/17 of a segment per RTT.
+    m_reno_bytes_acked += acked_bytes;
+    if (m_reno_bytes_acked >= m_reno_window) {
+        m_reno_bytes_acked -= m_reno_window;
+        m_reno_window += m_maximum_segment_size * 9 / 17;
+    }
+    target = max(target, static_cast<u64>(m_reno_window));
+
+    // Never grow by more than half the window per RTT (RFC 9438, 4.2).
+    target = min(target, static_cast<u64>(m_congestion_window) * 3 / 2);
+
+    if (target > m_congestion_window) {
+        // Spread the growth towards the target over one window's worth of ACKs.
+        u64 increase = (target - m_congestion_window) * acked_bytes / m_congestion_window;
+        m_congestion_window += max(increase, static_cast<u64>(1));
+    }
+}
+
+u32 TCPCubicCongestionControl::slow_start_threshold_after_loss(u32, MonotonicTime)
+{
+    m_epoch_start.clear();
+
+    // Fast convergence (RFC 9438, 4.7): if we lost before reaching the previous maximum,
+    // release some bandwidth for new flows by remembering a lower maximum.
+    if (m_congestion_window < m_window_max)
+        m_window_max = static_cast<u64>(m_congestion_window) * (cubic_beta_denominator + cubic_beta_numerator) / (2 * cubic_beta_denominator);
+    else
+        m_window_max = m_congestion_window;
+
+    u32 new_threshold = static_cast<u64>(m_congestion_window) * cubic_beta_numerator / cubic_beta_denominator;
+    return max(new_threshold, 2 * m_maximum_segment_size);
+}
+
+}
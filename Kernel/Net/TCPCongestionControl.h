@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+enum class TCPCongestionControlAlgorithm {
+    NewReno,
+    Cubic,
+};
+
+// Sender-side congestion control as described in RFC 5681 (slow start, congestion avoidance,
+// fast retransmit/recovery) with the NewReno modification from RFC 6582. Subclasses only decide
+// how the window grows during congestion avoidance and how far it is reduced after a loss.
+class TCPCongestionControl {
+public:
+    static constexpr TCPCongestionControlAlgorithm default_algorithm = TCPCongestionControlAlgorithm::Cubic;
+    static constexpr u32 duplicate_ack_threshold = 3;
+
+    static ErrorOr<NonnullOwnPtr<TCPCongestionControl>> try_create(TCPCongestionControlAlgorithm, u32 maximum_segment_size);
+    static Optional<TCPCongestionControlAlgorithm> algorithm_from_name(StringView);
+
+    virtual ~TCPCongestionControl() = default;
+
+    virtual TCPCongestionControlAlgorithm algorithm() const = 0;
+    virtual StringView name() const = 0;
+
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+    u32 maximum_segment_size() const { return m_maximum_segment_size; }
+    bool in_fast_recovery() const { return m_in_fast_recovery; }
+
+    void set_maximum_segment_size(u32);
+
+    enum class AckResult {
+        None,
+        // The ACK only covered part of the data outstanding when the loss was detected;
+        // the next unacknowledged segment should be retransmitted right away (RFC 6582).
+        RetransmitNextSegment,
+    };
+
+    // Called for an ACK that acknowledges previously unacknowledged data.
+    AckResult on_new_ack(u32 ack_number, u32 acked_bytes, MonotonicTime now);
+
+    // Called for an ACK that acknowledges nothing new while data is outstanding.
+    // Returns true when the duplicate ACK threshold was reached and the first unacknowledged segment should be retransmitted.
+    bool on_duplicate_ack(u32 highest_sequence_number_sent, u32 bytes_in_flight, MonotonicTime now);
+
+    void on_retransmit_timeout(u32 bytes_in_flight, MonotonicTime now);
+
+    u32 duplicate_acks() const { return m_duplicate_acks; }
+
+protected:
+    explicit TCPCongestionControl(u32 maximum_segment_size);
+
+    // Grow the window during congestion avoidance (i.e. once it has reached the slow start threshold).
+    virtual void increase_window_in_congestion_avoidance(u32 acked_bytes, MonotonicTime now) = 0;
+
+    // Return the new slow start threshold after a loss was detected.
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime now) = 0;
+
+    u32 m_maximum_segment_size { 0 };
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { NumericLimits<u32>::max() };
+
+private:
+    u32 initial_window() const;
+
+    bool m_in_fast_recovery { false };
+    u32 m_recovery_point { 0 };
+    u32 m_duplicate_acks { 0 };
+};
+
+class TCPNewRenoCongestionControl final : public TCPCongestionControl {
+public:
+    explicit TCPNewRenoCongestionControl(u32 maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual TCPCongestionControlAlgorithm algorithm() const override { return TCPCongestionControlAlgorithm::NewReno; }
+    virtual StringView name() const override { return "reno"sv; }
+
+private:
+    virtual void increase_window_in_congestion_avoidance(u32 acked_bytes, MonotonicTime) override;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime) override;
+
+    u32 m_bytes_acked_in_congestion_avoidance { 0 };
+};
+
+// CUBIC as described in RFC 9438. All arithmetic is done in integers, as the kernel can't use the FPU.
+class TCPCubicCongestionControl final : public TCPCongestionControl {
+public:
+    explicit TCPCubicCongestionControl(u32 maximum_segment_size)
+        : TCPCongestionControl(maximum_segment_size)
+    {
+    }
+
+    virtual TCPCongestionControlAlgorithm algorithm() const override { return TCPCongestionControlAlgorithm::Cubic; }
+    virtual StringView name() const override { return "cubic"sv; }
+
+private:
+    virtual void increase_window_in_congestion_avoidance(u32 acked_bytes, MonotonicTime) override;
+    virtual u32 slow_start_threshold_after_loss(u32 bytes_in_flight, MonotonicTime) override;
+
+    u64 window_at(i64 milliseconds_since_epoch_start) const;
+
+    // Window size (in bytes) just before the last reduction.
+    u32 m_window_max { 0 };
+    // Time (in milliseconds) it takes to grow back to m_window_max.
+    i64 m_k_milliseconds { 0 };
+    Optional<MonotonicTime> m_epoch_start;
+    // Window a Reno sender would have; CUBIC never grows slower than this (the "Reno-friendly region").
+    u32 m_reno_window { 0 };
+    u32 m_reno_bytes_acked { 0 };
+};
+
+}
@@ -24,6 +24,23 @@
 
 namespace Kernel {
 
+// Sequence numbers wrap around, so compare them using serial number arithmetic.
+static bool sequence_number_before(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) < 0;
+}
+
+static bool sequence_number_at_or_before(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) <= 0;
+}
+
+// RFC 7323, 5.4: Our timestamp clock ticks once per millisecond.
+static u32 current_tcp_timestamp()
+{
+    return static_cast<u32>(TimeManagement::the().monotonic_time().milliseconds());
+}
+
 void TCPSocket::for_each(Function<void(TCPSocket const&)> callback)
 {
     sockets_by_tuple().for_each_shared([&](auto const& it) {
@@ -75,7 +92,10 @@ void TCPSocket::set_state(State new_state)
         // are packets on the way which we wouldn't want a new socket to get hit
         // with, so there's no point in keeping the receive buffer around.
         drop_receive_buffer();
+        m_out_of_order_segments.clear();
+        m_out_of_order_bytes = 0;
 
+        // Nobody is waiting for this timer, so it doesn't hurt to let it fire together with others.
         auto deadline = TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE) + maximum_segment_lifetime;
         auto timer_was_added = TimerQueue::the().add_timer_without_id(*m_timer, CLOCK_MONOTONIC_COARSE, deadline, [&]() {
             dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) TimeWait timer elpased", this);
@@ -83,7 +103,7 @@ void TCPSocket::set_state(State new_state)
                 m_state = State::Closed;
                 do_state_closed();
             }
-        });
+        }, Duration::from_seconds(1));
 
         if (!timer_was_added) [[unlikely]] {
             dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) TimeWait timer deadline is in the past", this);
@@ -185,10 +205,11 @@ void TCPSocket::release_for_accept(NonnullRefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(move(socket));
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer)
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer, NonnullOwnPtr<TCPCongestionControl> congestion_control)
     : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
     , m_last_ack_sent_time(TimeManagement::the().monotonic_time())
     , m_last_retransmit_time(TimeManagement::the().monotonic_time())
+    , m_congestion_control(move(congestion_control))
     , m_timer(timer)
 {
 }
@@ -205,7 +226,9 @@ ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwn
     // Note: Scratch buffer is only used for SOCK_STREAM sockets.
     auto scratch_buffer = TRY(KBuffer::try_create_with_size("TCPSocket: Scratch buffer"sv, 65536));
     auto timer = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Timer));
-    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), timer));
+    // Start out with the default MSS from RFC 1122, protocol_send() updates it once we know the route.
+    auto congestion_control = TRY(TCPCongestionControl::try_create(TCPCongestionControl::default_algorithm, 536));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), timer, move(congestion_control)));
 }
 
 ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
@@ -232,9 +255,27 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
     RoutingDecision routing_decision = route_to(peer_address(), local_address(), adapter);
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
-    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    // Full-sized segments have to leave room for the timestamps option, which is sent on every segment once negotiated.
+    size_t tcp_header_size = sizeof(TCPPacket) + (m_timestamps_enabled ? 2 + sizeof(TCPOptionTimestamp) : 0);
+    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - tcp_header_size;
+    m_congestion_control->set_maximum_segment_size(mss);
+
+    // Don't put more data on the wire than both the peer and the congestion window allow.
+    // If the window is already full, the writer has to wait for ACKs to open it up again (see can_write()).
+    auto bytes_in_flight = m_unacked_packets.with_shared([](auto const& unacked_packets) { return unacked_packets.size; });
+    auto send_window = min<size_t>(m_send_window_size, m_congestion_control->congestion_window());
+    if (send_window <= bytes_in_flight)
+        return set_so_error(EAGAIN);
+    data_length = min(data_length, send_window - bytes_in_flight);
+
+    // With TCP segmentation offload, the adapter splits one large packet into full-sized segments for us.
+    size_t max_payload_size = mss;
+    if (routing_decision.adapter->has_tcp_segmentation_offload()) {
+        auto max_offload_payload_size = NetworkAdapter::max_ipv4_packet_size - sizeof(IPv4Packet) - tcp_header_size;
+        max_payload_size = max(mss, max_offload_payload_size / mss * mss);
+    }
 
-    data_length = min(data_length, mss);
+    data_length = min(data_length, max_payload_size);
     TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
     return data_length;
 }
@@ -255,9 +296,27 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
 
-    bool const has_mss_option = flags & TCPFlags::SYN;
-    bool const has_window_scale_option = flags & TCPFlags::SYN;
-    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0) + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0);
+    bool const is_syn = flags & TCPFlags::SYN;
+    // A SYN offers the SACK-permitted and timestamps options, a SYN-ACK may only include them if the peer's SYN did.
+    bool const is_syn_offer = is_syn && !(flags & TCPFlags::ACK);
+    bool const has_mss_option = is_syn;
+    bool const has_window_scale_option = is_syn;
+    bool const has_sack_permitted_option = is_syn && (is_syn_offer || m_sack_permitted);
+    bool const has_timestamp_option = is_syn_offer || m_timestamps_enabled;
+    // Outside of SYNs, the timestamps option is preceded by two NOPs to keep it 32-bit aligned (RFC 7323, Appendix A).
+    size_t const timestamp_padding = (has_timestamp_option && !is_syn) ? 2 : 0;
+    // RFC 2018, 4: While we hold data beyond a gap, our ACKs tell the peer which blocks we already have.
+    // Data segments go without, so they still fit the MSS that protocol_send() works with.
+    Vector<TCPSACKBlock, TCPOptionSACK::max_block_count> sack_blocks;
+    if (m_sack_permitted && !is_syn && (flags & TCPFlags::ACK) && payload_size == 0 && !m_out_of_order_segments.is_empty())
+        sack_blocks = build_sack_blocks(has_timestamp_option ? TCPOptionSACK::max_block_count - 1 : TCPOptionSACK::max_block_count);
+    bool const has_sack_option = !sack_blocks.is_empty();
+    // The SACK option is preceded by two NOPs as well, since its blocks are 32-bit words.
+    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0)
+        + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0)
+        + (has_sack_permitted_option ? sizeof(TCPOptionSACKPermitted) : 0)
+        + (has_timestamp_option ? timestamp_padding + sizeof(TCPOptionTimestamp) : 0)
+        + (has_sack_option ? 2 + sizeof(TCPOptionSACK) + sack_blocks.size() * sizeof(TCPSACKBlock) : 0);
     size_t const tcp_header_size = sizeof(TCPPacket) + align_up_to(options_size, 4);
     size_t const buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
@@ -266,7 +325,8 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     routing_decision.adapter->fill_in_ipv4_header(*packet, local_address(),
         routing_decision.next_hop, peer_address(), TransportProtocol::TCP,
         buffer_size - ipv4_payload_offset, type_of_service(), ttl());
-    memset(packet->buffer->data() + ipv4_payload_offset, 0, sizeof(TCPPacket));
+    // NOTE: This also fills the padding after the last option with End of Option List markers.
+    memset(packet->buffer->data() + ipv4_payload_offset, 0, tcp_header_size);
     auto& tcp_packet = *(TCPPacket*)(packet->buffer->data() + ipv4_payload_offset);
     VERIFY(local_port());
     tcp_packet.set_source_port(local_port());
@@ -310,21 +370,60 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         memcpy(next_option, &window_scale_option, sizeof(window_scale_option));
         next_option += sizeof(window_scale_option);
     }
-    if ((options_size % 4) != 0)
-        *next_option = to_underlying(TCPOptionKind::End);
+    if (has_sack_permitted_option) {
+        TCPOptionSACKPermitted sack_permitted_option;
+        memcpy(next_option, &sack_permitted_option, sizeof(sack_permitted_option));
+        next_option += sizeof(sack_permitted_option);
+    }
+    if (has_timestamp_option) {
+        for (size_t i = 0; i < timestamp_padding; ++i)
+            *next_option++ = to_underlying(TCPOptionKind::Nop);
+        TCPOptionTimestamp timestamp_option { current_tcp_timestamp(), is_syn_offer ? 0 : m_recent_peer_timestamp };
+        memcpy(next_option, &timestamp_option, sizeof(timestamp_option));
+        next_option += sizeof(timestamp_option);
+    }
+    if (has_sack_option) {
+        *next_option++ = to_underlying(TCPOptionKind::Nop);
+        *next_option++ = to_underlying(TCPOptionKind::Nop);
+        TCPOptionSACK sack_option { sack_blocks.size() };
+        memcpy(next_option, &sack_option, sizeof(sack_option));
+        next_option += sizeof(sack_option);
+        memcpy(next_option, sack_blocks.data(), sack_blocks.size() * sizeof(TCPSACKBlock));
+        next_option += sack_blocks.size() * sizeof(TCPSACKBlock);
+    }
 
-    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    PacketOffload offload;
+    size_t const segment_size = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - tcp_header_size;
+    bool const needs_segmentation = payload_size > segment_size;
+    if (needs_segmentation || routing_decision.adapter->has_checksum_offload()) {
+        // Leave the rest of the checksum to the adapter, send_packet() takes care of it if the adapter can't.
+        offload.needs_checksum = true;
+        offload.checksum_start = ipv4_payload_offset;
+        offload.checksum_offset = TCPPacket::checksum_offset();
+        tcp_packet.set_checksum(compute_tcp_pseudo_header_checksum(local_address(), peer_address(), tcp_header_size + payload_size));
+        if (needs_segmentation) {
+            offload.segment_size = segment_size;
+            offload.header_size = ipv4_payload_offset + tcp_header_size;
+        }
+    } else {
+        tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    }
 
     bool expect_ack { tcp_packet.has_syn() || payload_size > 0 };
     if (expect_ack) {
         bool append_failed { false };
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter });
+            auto now = TimeManagement::the().monotonic_time();
+            bool was_empty = unacked_packets.packets.is_empty();
+            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter, now, static_cast<u32>(payload_size), offload });
             if (result.is_error()) {
                 dbgln("TCPSocket: Dropped outbound packet because try_append() failed");
                 append_failed = true;
                 return;
             }
+            // RFC 6298, 5.1: Start the retransmission timer if it isn't already running.
+            if (was_empty)
+                m_last_retransmit_time = now;
             unacked_packets.size += payload_size;
             enqueue_for_retransmit();
         });
@@ -334,7 +433,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     m_packets_out++;
     m_bytes_out += buffer_size;
-    routing_decision.adapter->send_packet(packet->bytes());
+    routing_decision.adapter->send_packet(packet->bytes(), offload);
     if (!expect_ack)
         routing_decision.adapter->release_packet_buffer(*packet);
 
@@ -343,13 +442,53 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
 void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 {
+    Optional<TCPOptionTimestamp> timestamp_option;
+    TCPOptionSACK const* sack_option = nullptr;
+    if (m_timestamps_enabled || m_sack_permitted) {
+        packet.for_each_option([&](auto const& option) {
+            if (option.kind() == TCPOptionKind::Timestamp && option.length() == sizeof(TCPOptionTimestamp))
+                timestamp_option = static_cast<TCPOptionTimestamp const&>(option);
+            else if (option.kind() == TCPOptionKind::SACK && option.length() >= sizeof(TCPOption) + sizeof(TCPSACKBlock))
+                sack_option = &static_cast<TCPOptionSACK const&>(option);
+        });
+    }
+
+    // RFC 7323, 4.3: Remember the peer's timestamp so we can echo it, but only from segments that
+    // cover the left edge of our receive window, so delayed ACKs echo the oldest unacknowledged segment.
+    if (m_timestamps_enabled && timestamp_option.has_value()) {
+        if (sequence_number_at_or_before(packet.sequence_number(), m_last_ack_number_sent)
+            && !sequence_number_before(timestamp_option->value(), m_recent_peer_timestamp))
+            m_recent_peer_timestamp = timestamp_option->value();
+    }
+
     if (packet.has_ack()) {
         u32 ack_number = packet.ack_number();
+        size_t payload_size = size - packet.header_size();
+        auto now = TimeManagement::the().monotonic_time();
 
         dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
 
+        // The window field of a SYN segment is never scaled (RFC 7323, 2.2).
+        u32 send_window_size = packet.has_syn() ? packet.window_size() : packet.window_size() << m_send_window_scale;
+        if (m_send_window_size != send_window_size) {
+            m_send_window_size = send_window_size;
+            evaluate_block_conditions();
+        }
+
+        // RFC 5681, 2: A duplicate ACK carries no data, doesn't change the window and acknowledges nothing new.
+        bool is_duplicate_ack = ack_number == m_last_ack_number_received
+            && payload_size == 0
+            && !packet.has_syn() && !packet.has_fin() && !packet.has_rst()
+            && packet.window_size() == m_last_window_size_received;
+        m_last_ack_number_received = ack_number;
+        m_last_window_size_received = packet.window_size();
+
+        bool should_retransmit_first_unacked_packet = false;
+        bool has_pending_retransmissions = false;
         int removed = 0;
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+            u32 acked_bytes = 0;
+            Optional<Duration> round_trip_time_sample;
             while (!unacked_packets.packets.is_empty()) {
                 auto& packet = unacked_packets.packets.first();
 
@@ -359,12 +498,13 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
                     auto old_adapter = packet.adapter.strong_ref();
                     if (old_adapter)
                         old_adapter->release_packet_buffer(*packet.buffer);
-                    TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    if (m_send_window_size != tcp_packet.window_size()) {
-                        m_send_window_size = tcp_packet.window_size() << m_send_window_scale;
-                    }
-                    auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
-                    unacked_packets.size -= payload_size;
+                    // Karn's algorithm: Only take samples from segments that were never retransmitted.
+                    if (packet.tx_counter == 0)
+                        round_trip_time_sample = now - packet.sent_time;
+                    if (packet.needs_retransmit)
+                        --unacked_packets.pending_retransmit_count;
+                    unacked_packets.size -= packet.payload_size;
+                    acked_bytes += packet.payload_size;
                     evaluate_block_conditions();
                     unacked_packets.packets.take_first();
                     removed++;
@@ -373,19 +513,183 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
                 }
             }
 
+            // RFC 7323, 4.1: The echoed timestamp gives us an RTT sample even for retransmitted segments.
+            if (removed > 0 && m_timestamps_enabled && timestamp_option.has_value() && timestamp_option->echo_reply() != 0)
+                round_trip_time_sample = Duration::from_milliseconds(current_tcp_timestamp() - timestamp_option->echo_reply());
+
+            if (sack_option && m_sack_permitted)
+                process_sack_option(unacked_packets, *sack_option);
+
+            if (removed > 0) {
+                if (round_trip_time_sample.has_value())
+                    update_round_trip_time(*round_trip_time_sample);
+                // RFC 6298, 5.3: Restart the retransmission timer when new data is acknowledged.
+                m_last_retransmit_time = now;
+                m_retransmit_attempts = 0;
+                if (m_congestion_control->on_new_ack(ack_number, acked_bytes, now) == TCPCongestionControl::AckResult::RetransmitNextSegment)
+                    should_retransmit_first_unacked_packet = true;
+            } else if (is_duplicate_ack && !unacked_packets.packets.is_empty()) {
+                if (m_congestion_control->on_duplicate_ack(m_sequence_number, unacked_packets.size, now)) {
+                    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) fast retransmit after {} duplicate ACKs", this, TCPCongestionControl::duplicate_ack_threshold);
+                    should_retransmit_first_unacked_packet = true;
+                }
+            }
+
+            // With SACK information we know exactly which segments are missing, so during recovery
+            // we only resend the holes instead of waiting for partial ACKs to uncover them one by one.
+            if (m_sack_permitted && m_congestion_control->in_fast_recovery())
+                mark_lost_packets(unacked_packets);
+
             if (unacked_packets.packets.is_empty()) {
                 m_retransmit_attempts = 0;
                 dequeue_for_retransmit();
             }
 
+            has_pending_retransmissions = unacked_packets.pending_retransmit_count > 0;
+
             dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
         });
+
+        if (should_retransmit_first_unacked_packet || has_pending_retransmissions) {
+            auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
+            auto routing_decision = route_to(peer_address(), local_address(), adapter);
+            if (!routing_decision.is_zero()) {
+                m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+                    if (should_retransmit_first_unacked_packet && !unacked_packets.packets.is_empty()) {
+                        // Fast retransmit ignores the congestion window, the lost segment has to go out now.
+                        auto& first_packet = unacked_packets.packets.first();
+                        if (first_packet.needs_retransmit) {
+                            first_packet.needs_retransmit = false;
+                            --unacked_packets.pending_retransmit_count;
+                        }
+                        first_packet.marked_lost = true;
+                        retransmit_packet(first_packet, routing_decision);
+                    }
+                    send_pending_retransmissions(unacked_packets, routing_decision);
+                });
+            }
+        }
     }
 
     m_packets_in++;
     m_bytes_in += packet.header_size() + size;
 }
 
+bool TCPSocket::queue_out_of_order_segment(u32 sequence_number, u32 payload_size, ReadonlyBytes raw_ipv4_packet, UnixDateTime const& packet_timestamp)
+{
+    // Only keep data that lies within the window we advertised, and that we don't have yet.
+    if (!sequence_number_before(m_ack_number, sequence_number))
+        return false;
+    if (sequence_number_before(m_ack_number + available_space_in_receive_buffer(), sequence_number + payload_size))
+        return false;
+    if (m_out_of_order_bytes + raw_ipv4_packet.size() > receive_buffer_size)
+        return false;
+
+    size_t index = 0;
+    for (; index < m_out_of_order_segments.size(); ++index) {
+        auto const& segment = m_out_of_order_segments[index];
+        if (segment.sequence_number == sequence_number) {
+            // A retransmission of something we already have, e.g. because our SACK blocks got lost.
+            m_last_queued_sequence_number = sequence_number;
+            return true;
+        }
+        if (sequence_number_before(sequence_number, segment.sequence_number))
+            break;
+    }
+
+    auto buffer_or_error = KBuffer::try_create_with_bytes("TCPSocket: Out of order segment"sv, raw_ipv4_packet);
+    if (buffer_or_error.is_error())
+        return false;
+    if (m_out_of_order_segments.try_insert(index, OutOfOrderSegment { sequence_number, payload_size, buffer_or_error.release_value(), packet_timestamp }).is_error())
+        return false;
+    m_out_of_order_bytes += raw_ipv4_packet.size();
+    m_last_queued_sequence_number = sequence_number;
+    return true;
+}
+
+void TCPSocket::deliver_out_of_order_segments()
+{
+    while (!m_out_of_order_segments.is_empty()) {
+        auto& segment = m_out_of_order_segments.first();
+        if (sequence_number_before(m_ack_number, segment.sequence_number))
+            return;
+        // Segments that only partially overlap what we already received are dropped. This is allowed
+        // (RFC 2018, 8) and doesn't happen with senders that keep the segment boundaries when retransmitting.
+        if (segment.sequence_number == m_ack_number) {
+            if (!did_receive(peer_address(), peer_port(), segment.raw_ipv4_packet->bytes(), segment.timestamp))
+                return;
+            m_ack_number += segment.payload_size;
+        }
+        m_out_of_order_bytes -= segment.raw_ipv4_packet->size();
+        m_out_of_order_segments.remove(0);
+    }
+}
+
+Vector<TCPSACKBlock, TCPOptionSACK::max_block_count> TCPSocket::build_sack_blocks(size_t max_block_count) const
+{
+    Vector<TCPSACKBlock, TCPOptionSACK::max_block_count> blocks;
+    auto add_block = [&](u32 left_edge, u32 right_edge) {
+        bool contains_last_queued_segment = !sequence_number_before(m_last_queued_sequence_number, left_edge)
+            && sequence_number_before(m_last_queued_sequence_number, right_edge);
+        if (contains_last_queued_segment) {
+            if (blocks.size() == max_block_count)
+                blocks.take_last();
+            blocks.prepend(TCPSACKBlock { left_edge, right_edge });
+        } else if (blocks.size() < max_block_count) {
+            blocks.append(TCPSACKBlock { left_edge, right_edge });
+        }
+    };
+
+    // Adjacent segments are reported as a single block.
+    Optional<u32> left_edge;
+    u32 right_edge = 0;
+    for (auto const& segment : m_out_of_order_segments) {
+        u32 segment_end = segment.sequence_number + segment.payload_size;
+        if (left_edge.has_value() && sequence_number_at_or_before(segment.sequence_number, right_edge)) {
+            if (sequence_number_before(right_edge, segment_end))
+                right_edge = segment_end;
+            continue;
+        }
+        if (left_edge.has_value())
+            add_block(*left_edge, right_edge);
+        left_edge = segment.sequence_number;
+        right_edge = segment_end;
+    }
+    if (left_edge.has_value())
+        add_block(*left_edge, right_edge);
+    return blocks;
+}
+
+void TCPSocket::update_round_trip_time(Duration sample)
+{
+    // RFC 6298, 2: Computing the retransmission timeout.
+    auto round_trip_time = max<i64>(sample.to_microseconds(), 1);
+    if (!m_has_round_trip_time_sample) {
+        m_smoothed_round_trip_time_in_microseconds = round_trip_time;
+        m_round_trip_time_variation_in_microseconds = round_trip_time / 2;
+        m_has_round_trip_time_sample = true;
+    } else {
+        auto deviation = m_smoothed_round_trip_time_in_microseconds - round_trip_time;
+        if (deviation < 0)
+            deviation = -deviation;
+        m_round_trip_time_variation_in_microseconds = (3 * m_round_trip_time_variation_in_microseconds + deviation) / 4;
+        m_smoothed_round_trip_time_in_microseconds = (7 * m_smoothed_round_trip_time_in_microseconds + round_trip_time) / 8;
+    }
+
+    auto timeout = m_smoothed_round_trip_time_in_microseconds + max(clock_granularity_in_microseconds, 4 * m_round_trip_time_variation_in_microseconds);
+    m_retransmission_timeout = clamp(Duration::from_microseconds(timeout), minimum_retransmission_timeout, maximum_retransmission_timeout);
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) RTT sample {}us, SRTT {}us, RTTVAR {}us, RTO {}ms", this, round_trip_time,
+        m_smoothed_round_trip_time_in_microseconds, m_round_trip_time_variation_in_microseconds, m_retransmission_timeout.to_milliseconds());
+}
+
+Optional<Duration> TCPSocket::smoothed_round_trip_time() const
+{
+    if (!m_has_round_trip_time_sample)
+        return {};
+    return Duration::from_microseconds(m_smoothed_round_trip_time_in_microseconds);
+}
+
 bool TCPSocket::should_delay_next_ack() const
 {
     // FIXME: We don't know the MSS here so make a reasonable guess.
@@ -402,7 +706,7 @@ bool TCPSocket::should_delay_next_ack() const
     return true;
 }
 
-NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
+static u32 sum_tcp_pseudo_header(IPv4Address const& source, IPv4Address const& destination, u16 tcp_length)
 {
     union PseudoHeader {
         struct [[gnu::packed]] {
@@ -416,11 +720,7 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
     };
     static_assert(sizeof(PseudoHeader) == 12);
 
-    Checked<u16> packet_size = packet.header_size();
-    packet_size += payload_size;
-    VERIFY(!packet_size.has_overflow());
-
-    PseudoHeader pseudo_header { .header = { source, destination, 0, (u8)TransportProtocol::TCP, packet_size.value() } };
+    PseudoHeader pseudo_header { .header = { source, destination, 0, (u8)TransportProtocol::TCP, tcp_length } };
 
     u32 checksum = 0;
     auto* raw_pseudo_header = pseudo_header.raw;
@@ -429,6 +729,21 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
         if (checksum > 0xffff)
             checksum = (checksum >> 16) + (checksum & 0xffff);
     }
+    return checksum;
+}
+
+NetworkOrdered<u16> TCPSocket::compute_tcp_pseudo_header_checksum(IPv4Address const& source, IPv4Address const& destination, u16 tcp_length)
+{
+    return sum_tcp_pseudo_header(source, destination, tcp_length);
+}
+
+NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const& packet, u16 payload_size)
+{
+    Checked<u16> packet_size = packet.header_size();
+    packet_size += payload_size;
+    VERIFY(!packet_size.has_overflow());
+
+    u32 checksum = sum_tcp_pseudo_header(source, destination, packet_size.value());
     auto* raw_packet = bit_cast<u16*>(&packet);
     for (size_t i = 0; i < packet.header_size() / sizeof(u16); ++i) {
         checksum += AK::convert_between_host_and_network_endian(raw_packet[i]);
@@ -459,6 +774,17 @@ ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*
     MutexLocker locker(mutex());
 
     switch (option) {
+    case TCP_CONGESTION: {
+        auto user_string = static_ptr_cast<char const*>(user_value);
+        auto name = TRY(Process::get_syscall_name_string_fixed_buffer<congestion_control_name_max_length>(user_string, min<size_t>(user_value_size, congestion_control_name_max_length)));
+        auto algorithm = TCPCongestionControl::algorithm_from_name(name.representable_view());
+        if (!algorithm.has_value())
+            return ENOENT;
+        if (*algorithm == m_congestion_control->algorithm())
+            return {};
+        m_congestion_control = TRY(TCPCongestionControl::try_create(*algorithm, m_congestion_control->maximum_segment_size()));
+        return {};
+    }
     default:
         dbgln("setsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -476,6 +802,15 @@ ErrorOr<void> TCPSocket::getsockopt(OpenFileDescription& description, int level,
     TRY(copy_from_user(&size, value_size.unsafe_userspace_ptr()));
 
     switch (option) {
+    case TCP_CONGESTION: {
+        char name[congestion_control_name_max_length] {};
+        auto algorithm_name = m_congestion_control->name();
+        VERIFY(algorithm_name.length() < congestion_control_name_max_length);
+        memcpy(name, algorithm_name.characters_without_null_termination(), algorithm_name.length());
+        size = min<socklen_t>(size, congestion_control_name_max_length);
+        TRY(copy_to_user(static_ptr_cast<char*>(value), name, size));
+        return copy_to_user(value_size, &size);
+    }
     default:
         dbgln("getsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -674,13 +1009,9 @@ void TCPSocket::retransmit_packets()
 {
     auto now = TimeManagement::the().monotonic_time();
 
-    // RFC6298 says we should have at least one second between retransmits. According to
-    // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
-    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
-
-    if (m_last_retransmit_time > now - Duration::from_seconds(retransmit_interval))
+    // The retransmission timeout is derived from the measured round trip time (see update_round_trip_time()),
+    // but never goes below one second. According to RFC1122 we must do exponential backoff - even for SYN packets.
+    if (now < m_last_retransmit_time + m_retransmission_timeout)
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
@@ -695,62 +1026,167 @@ void TCPSocket::retransmit_packets()
         return;
     }
 
+    // RFC 6298, 5.5: Back off the timer.
+    m_retransmission_timeout = min(m_retransmission_timeout + m_retransmission_timeout, maximum_retransmission_timeout);
+
     auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
     auto routing_decision = route_to(peer_address(), local_address(), adapter);
     if (routing_decision.is_zero())
         return;
 
     m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        if (unacked_packets.packets.is_empty())
+            return;
+
+        m_congestion_control->on_retransmit_timeout(unacked_packets.size, now);
+
+        // The peer is allowed to discard data it selectively acknowledged (RFC 2018, 8). Trust the
+        // SACK information on the first timeout, but start over from scratch if we time out again.
+        bool trust_sack_information = m_retransmit_attempts == 1;
+
+        // Everything else still outstanding is presumed lost. The oldest segment goes out right away,
+        // the rest follows as the (now collapsed) congestion window opens up again.
         for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
+            packet.marked_lost = false;
+            if (!trust_sack_information)
+                packet.sacked = false;
+            if (packet.sacked || packet.needs_retransmit)
+                continue;
+            packet.needs_retransmit = true;
+            ++unacked_packets.pending_retransmit_count;
+        }
+        send_pending_retransmissions(unacked_packets, routing_decision);
+    });
+}
+
+void TCPSocket::send_pending_retransmissions(UnackedPackets& unacked_packets, RoutingDecision const& routing_decision)
+{
+    if (unacked_packets.pending_retransmit_count == 0)
+        return;
+
+    // Segments the peer selectively acknowledged have left the network (the "pipe" from RFC 6675).
+    size_t bytes_in_flight = 0;
+    for (auto& packet : unacked_packets.packets) {
+        if (!packet.needs_retransmit && !packet.sacked)
+            bytes_in_flight += packet.payload_size;
+    }
 
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
+    auto congestion_window = m_congestion_control->congestion_window();
+    for (auto& packet : unacked_packets.packets) {
+        if (!packet.needs_retransmit)
+            continue;
+        // Always allow a single segment when nothing is in flight, so we can't stall on a tiny window.
+        if (bytes_in_flight > 0 && bytes_in_flight + packet.payload_size > congestion_window)
+            break;
+        packet.needs_retransmit = false;
+        --unacked_packets.pending_retransmit_count;
+        bytes_in_flight += packet.payload_size;
+        retransmit_packet(packet, routing_decision);
+    }
+}
+
+void TCPSocket::process_sack_option(UnackedPackets& unacked_packets, TCPOptionSACK const& sack_option)
+{
+    for (size_t i = 0; i < sack_option.block_count(); ++i) {
+        auto const& block = sack_option.block(i);
+        u32 left_edge = block.left_edge;
+        u32 right_edge = block.right_edge;
+        // Ignore malformed blocks and blocks covering data we never sent.
+        if (!sequence_number_before(left_edge, right_edge) || sequence_number_before(m_sequence_number, right_edge))
+            continue;
+
+        for (auto& packet : unacked_packets.packets) {
+            if (packet.payload_size == 0 || packet.sacked)
+                continue;
+            u32 packet_start = packet.ack_number - packet.payload_size;
+            if (sequence_number_before(packet_start, left_edge))
+                continue;
+            if (sequence_number_before(right_edge, packet.ack_number))
+                break;
+            packet.sacked = true;
+            if (packet.needs_retransmit) {
+                packet.needs_retransmit = false;
+                --unacked_packets.pending_retransmit_count;
             }
+        }
+    }
+}
 
-            auto packet_buffer = packet.buffer->bytes();
+void TCPSocket::mark_lost_packets(UnackedPackets& unacked_packets)
+{
+    // A simplified version of the loss detection from RFC 6675: Any segment the peer is missing while
+    // it has already received later data is considered lost and retransmitted (once).
+    OutgoingPacket const* last_sacked_packet = nullptr;
+    for (auto& packet : unacked_packets.packets) {
+        if (packet.sacked)
+            last_sacked_packet = &packet;
+    }
+    if (!last_sacked_packet)
+        return;
 
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                TransportProtocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
+    for (auto& packet : unacked_packets.packets) {
+        if (&packet == last_sacked_packet)
+            break;
+        if (packet.sacked || packet.marked_lost)
+            continue;
+        packet.marked_lost = true;
+        if (!packet.needs_retransmit) {
+            packet.needs_retransmit = true;
+            ++unacked_packets.pending_retransmit_count;
         }
-    });
+    }
 }
 
-bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size) const
+void TCPSocket::retransmit_packet(OutgoingPacket& packet, RoutingDecision const& routing_decision)
 {
-    if (!IPv4Socket::can_write(file_description, size))
+    packet.tx_counter++;
+    m_retransmitted_packets++;
+
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
+
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
+
+    auto packet_buffer = packet.buffer->bytes();
+
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        TransportProtocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+    routing_decision.adapter->send_packet(packet_buffer, packet.offload);
+    m_packets_out++;
+    m_bytes_out += packet_buffer.size();
+}
+
+bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 offset) const
+{
+    if (!IPv4Socket::can_write(file_description, offset))
         return false;
 
     if (m_state == State::SynSent || m_state == State::SynReceived)
         return false;
 
-    if (!file_description.is_blocking())
-        return true;
-
+    // Only allow writing while there's room in both the peer's receive window and our congestion window.
+    // This has to match protocol_send(), which refuses to send anything otherwise.
+    auto send_window = min<size_t>(m_send_window_size, m_congestion_control->congestion_window());
     return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
+        return unacked_packets.size < send_window;
     });
 }
 }
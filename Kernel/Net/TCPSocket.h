@@ -15,6 +15,8 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IP/Socket.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPCongestionControl.h>
 #include <Kernel/Time/TimerQueue.h>
 
 namespace Kernel {
@@ -136,6 +138,7 @@ public:
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
+    u32 retransmitted_packets() const { return m_retransmitted_packets; }
 
     void set_send_window_scale(size_t scale)
     {
@@ -143,11 +146,32 @@ public:
         m_send_window_scale = scale;
     }
 
+    // Called with the options of the peer's SYN, before we answer it.
+    void set_sack_permitted(bool sack_permitted) { m_sack_permitted = sack_permitted; }
+    bool sack_permitted() const { return m_sack_permitted; }
+    void enable_timestamps(u32 peer_timestamp)
+    {
+        m_timestamps_enabled = true;
+        m_recent_peer_timestamp = peer_timestamp;
+    }
+    bool timestamps_enabled() const { return m_timestamps_enabled; }
+
+    // Keeps a segment that arrived after a gap in the sequence space around, so we can report it in SACK
+    // blocks and deliver it once the gap has been filled. Returns false if the segment was dropped instead.
+    bool queue_out_of_order_segment(u32 sequence_number, u32 payload_size, ReadonlyBytes raw_ipv4_packet, UnixDateTime const& packet_timestamp);
+    // Delivers the queued segments that have become contiguous with the data received so far.
+    void deliver_out_of_order_segments();
+    bool has_out_of_order_segments() const { return !m_out_of_order_segments.is_empty(); }
+
     // FIXME: Make this configurable?
     static constexpr u32 maximum_duplicate_acks = 5;
     void set_duplicate_acks(u32 acks) { m_duplicate_acks = acks; }
     u32 duplicate_acks() const { return m_duplicate_acks; }
 
+    TCPCongestionControl const& congestion_control() const { return *m_congestion_control; }
+    Duration retransmission_timeout() const { return m_retransmission_timeout; }
+    Optional<Duration> smoothed_round_trip_time() const;
+
     ErrorOr<void> send_ack(bool allow_duplicate = false);
     ErrorOr<void> send_tcp_packet(u16 flags, UserOrKernelBuffer const* = nullptr, size_t = 0, RoutingDecision* = nullptr);
     void receive_tcp_packet(TCPPacket const&, u16 size);
@@ -172,6 +196,8 @@ public:
     virtual bool can_write(OpenFileDescription const&, u64) const override;
 
     static NetworkOrdered<u16> compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const&, u16 payload_size);
+    // Returns the (not yet complemented) checksum of just the pseudo-header, for adapters with checksum offload to finish.
+    static NetworkOrdered<u16> compute_tcp_pseudo_header_checksum(IPv4Address const& source, IPv4Address const& destination, u16 tcp_length);
 
     virtual ErrorOr<void> setsockopt(int level, int option, Userspace<void const*>, socklen_t) override;
     virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
@@ -180,7 +206,7 @@ protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer, NonnullOwnPtr<TCPCongestionControl> congestion_control);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
@@ -198,6 +224,11 @@ private:
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    void update_round_trip_time(Duration sample);
+
+    // Matches TCP_CA_NAME_MAX on other systems, including the null terminator.
+    static constexpr size_t congestion_control_name_max_length = 16;
+
     static constexpr size_t receive_window_scale()
     {
         auto buffer_size_bit_length = AK::log2(receive_buffer_size) + 1;
@@ -218,20 +249,36 @@ private:
     u32 m_bytes_in { 0 };
     u32 m_packets_out { 0 };
     u32 m_bytes_out { 0 };
+    u32 m_retransmitted_packets { 0 };
 
     struct OutgoingPacket {
         u32 ack_number { 0 };
         RefPtr<PacketWithTimestamp> buffer;
         size_t ipv4_payload_offset;
         LockWeakPtr<NetworkAdapter> adapter;
+        MonotonicTime sent_time;
+        u32 payload_size { 0 };
+        PacketOffload offload;
         int tx_counter { 0 };
+        // Set when the packet is presumed lost and should be sent again once the congestion window allows it.
+        bool needs_retransmit { false };
+        // Set when the peer told us via a SACK block that it already has this packet.
+        bool sacked { false };
+        // Set once SACK-based loss detection has scheduled this packet for retransmission, so it only happens once.
+        bool marked_lost { false };
     };
 
     struct UnackedPackets {
         SinglyLinkedList<OutgoingPacket> packets;
         size_t size { 0 };
+        size_t pending_retransmit_count { 0 };
     };
 
+    void process_sack_option(UnackedPackets&, TCPOptionSACK const&);
+    void mark_lost_packets(UnackedPackets&);
+    void retransmit_packet(OutgoingPacket&, RoutingDecision const&);
+    void send_pending_retransmissions(UnackedPackets&, RoutingDecision const&);
+
     MutexProtected<UnackedPackets> m_unacked_packets;
 
     u32 m_duplicate_acks { 0 };
@@ -243,9 +290,48 @@ private:
 
     // FIXME: Make this configurable (sysctl)
     static constexpr u32 maximum_retransmits = 5;
+    // Time at which the retransmission timer was last (re)started.
     MonotonicTime m_last_retransmit_time;
     u32 m_retransmit_attempts { 0 };
 
+    // RFC 6298 retransmission timeout state. The estimators are kept in microseconds.
+    static constexpr Duration initial_retransmission_timeout = Duration::from_seconds(1);
+    static constexpr Duration minimum_retransmission_timeout = Duration::from_seconds(1);
+    static constexpr Duration maximum_retransmission_timeout = Duration::from_seconds(60);
+    static constexpr i64 clock_granularity_in_microseconds = 10'000;
+    bool m_has_round_trip_time_sample { false };
+    i64 m_smoothed_round_trip_time_in_microseconds { 0 };
+    i64 m_round_trip_time_variation_in_microseconds { 0 };
+    Duration m_retransmission_timeout { initial_retransmission_timeout };
+
+    NonnullOwnPtr<TCPCongestionControl> m_congestion_control;
+    u32 m_last_ack_number_received { 0 };
+    u16 m_last_window_size_received { 0 };
+
+    // RFC 2018: Whether the peer accepts SACK options, i.e. whether we may expect them in its ACKs.
+    bool m_sack_permitted { false };
+
+    // RFC 7323: Whether both sides send the timestamps option, and the last timestamp
+    // received from the peer (TS.Recent) which we echo back to it.
+    bool m_timestamps_enabled { false };
+    u32 m_recent_peer_timestamp { 0 };
+
+    struct OutOfOrderSegment {
+        u32 sequence_number { 0 };
+        u32 payload_size { 0 };
+        NonnullOwnPtr<KBuffer> raw_ipv4_packet;
+        UnixDateTime timestamp;
+    };
+
+    Vector<TCPSACKBlock, TCPOptionSACK::max_block_count> build_sack_blocks(size_t max_block_count) const;
+
+    // Segments received beyond the next expected sequence number, sorted by sequence number.
+    // These are only kept if the peer can learn about them through SACK blocks.
+    Vector<OutOfOrderSegment> m_out_of_order_segments;
+    size_t m_out_of_order_bytes { 0 };
+    // RFC 2018, 4: The first SACK block has to cover the most recently queued segment.
+    u32 m_last_queued_sequence_number { 0 };
+
     // Default to maximum window size. receive_tcp_packet() will update from the
     // peer's advertised window size.
     u32 m_send_window_size { 64 * KiB };
@@ -6,6 +6,7 @@
 
 #include <Kernel/Bus/PCI/IDs.h>
 #include <Kernel/Bus/VirtIO/Transport/PCIe/TransportLink.h>
+#include <Kernel/Net/NetworkTask.h>
 #include <Kernel/Net/NetworkingManagement.h>
 #include <Kernel/Net/VirtIO/VirtIONetworkAdapter.h>
 
@@ -40,16 +41,16 @@ static constexpr u64 VIRTIO_NET_F_HOST_USO = (1ull << 56);           // Device c
 static constexpr u64 VIRTIO_NET_F_HASH_REPORT = (1ull << 57);        // Device can report per-packet hash value and a type of calculated hash.
 static constexpr u64 VIRTIO_NET_F_GUEST_HDRLEN = (1ull << 59);       // Driver can provide the exact hdr_len value.
 static constexpr u64 VIRTIO_NET_F_RSS = (1ull << 60);                // Device supports RSS with Toeplitz hash calculation
-static constexpr u64 VIRTIO_NET_F_RSC_EXT = (1ull << 21);            // Device can process duplicated ACKs and report number of coalesced segments and duplicated ACKs.
-static constexpr u64 VIRTIO_NET_F_STANDBY = (1ull << 63);            // Device may act as a standby for a primary device with the same MAC address.
+static constexpr u64 VIRTIO_NET_F_RSC_EXT = (1ull << 61);            // Device can process duplicated ACKs and report number of coalesced segments and duplicated ACKs.
+static constexpr u64 VIRTIO_NET_F_STANDBY = (1ull << 62);            // Device may act as a standby for a primary device with the same MAC address.
 static constexpr u64 VIRTIO_NET_F_SPEED_DUPLEX = (1ull << 63);       // Device reports speed and duplex.
 
 static constexpr u16 VIRTIO_NET_S_LINK_UP = 1;
 static constexpr u16 VIRTIO_NET_S_ANNOUNCE = 2;
 
 static constexpr u8 VIRTIO_NET_HDR_F_NEEDS_CSUM = 1;
-static constexpr u8 VIRTIO_NET_HDR_F_DATA_VALID = 1;
-static constexpr u8 VIRTIO_NET_HDR_F_RSC_INFO = 1;
+static constexpr u8 VIRTIO_NET_HDR_F_DATA_VALID = 2;
+static constexpr u8 VIRTIO_NET_HDR_F_RSC_INFO = 4;
 static constexpr u8 VIRTIO_NET_HDR_GSO_NONE = 0;
 static constexpr u8 VIRTIO_NET_HDR_GSO_TCPV4 = 1;
 static constexpr u8 VIRTIO_NET_HDR_GSO_UDP = 3;
@@ -69,6 +70,17 @@ struct [[gnu::packed]] VirtIONetConfig {
     LittleEndian<u32> supported_hash_types;
 };
 
+static constexpr u8 VIRTIO_NET_OK = 0;
+static constexpr u8 VIRTIO_NET_ERR = 1;
+
+static constexpr u8 VIRTIO_NET_CTRL_MQ = 4;
+static constexpr u8 VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET = 0;
+
+struct [[gnu::packed]] VirtIONetCtrlHeader {
+    u8 net_class;
+    u8 command;
+};
+
 struct [[gnu::packed]] VirtIONetHdr {
     u8 flags;
     u8 gso_type;
@@ -84,12 +96,21 @@ struct [[gnu::packed]] VirtIONetHdr {
 
 using namespace VirtIO;
 
-static constexpr u16 RECEIVEQ = 0;
-static constexpr u16 TRANSMITQ = 1;
+// Queue pair N consists of receiveqN (2 * N) and transmitqN (2 * N + 1), the control queue comes after all of them.
+static constexpr u16 receive_queue_index(size_t queue_pair) { return 2 * queue_pair; }
+static constexpr u16 transmit_queue_index(size_t queue_pair) { return 2 * queue_pair + 1; }
+
+// Every queue pair costs us a set of buffers, and we can't make use of more queue pairs than receive queues anyway.
+static constexpr size_t MAX_QUEUE_PAIRS = NetworkTask::max_receive_queue_count;
 
 static constexpr size_t MAX_RX_FRAME_SIZE = 1514; // Non-jumbo Ethernet frame limit.
-static constexpr size_t RX_BUFFER_SIZE = sizeof(VirtIONetHdr) * MAX_RX_FRAME_SIZE;
+// With VIRTIO_NET_F_MRG_RXBUF, larger frames (e.g. from VIRTIO_NET_F_GUEST_TSO4) are spread over as many buffers as needed.
+static constexpr size_t RX_BUFFER_SIZE = PAGE_SIZE;
+static_assert(RX_BUFFER_SIZE >= sizeof(VirtIONetHdr) + MAX_RX_FRAME_SIZE);
+static constexpr size_t MAX_MERGED_RX_FRAME_SIZE = sizeof(EthernetFrameHeader) + NetworkAdapter::max_ipv4_packet_size;
 static constexpr u16 MAX_INFLIGHT_PACKETS = 128;
+// Enough room for a few dozen maximum-sized TSO packets.
+static constexpr size_t TX_BUFFER_SIZE = 2 * MiB;
 
 UNMAP_AFTER_INIT ErrorOr<bool> VirtIONetworkAdapter::probe(PCI::DeviceIdentifier const& pci_device_identifier)
 {
@@ -115,9 +136,6 @@ UNMAP_AFTER_INIT VirtIONetworkAdapter::VirtIONetworkAdapter(StringView interface
 
 UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize(Badge<NetworkingManagement>)
 {
-    m_rx_buffers = TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Rx buffer"sv, RX_BUFFER_SIZE * MAX_INFLIGHT_PACKETS));
-    m_tx_buffers = TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Tx buffer"sv, RX_BUFFER_SIZE * MAX_INFLIGHT_PACKETS));
-
     return initialize_virtio_resources();
 }
 
@@ -127,6 +145,7 @@ UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize_virtio_resources
     TRY(Device::initialize_virtio_resources());
     m_device_config = TRY(transport_entity().get_config(VirtIO::ConfigurationType::Device));
 
+    u16 max_queue_pairs = 1;
     TRY(negotiate_features([&](u64 supported_features) {
         u64 negotiated = 0;
         if (is_feature_set(supported_features, VIRTIO_NET_F_STATUS))
@@ -137,24 +156,78 @@ UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize_virtio_resources
             negotiated |= VIRTIO_NET_F_SPEED_DUPLEX;
         if (is_feature_set(supported_features, VIRTIO_NET_F_MTU))
             negotiated |= VIRTIO_NET_F_MTU;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_MRG_RXBUF))
+            negotiated |= VIRTIO_NET_F_MRG_RXBUF;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_CSUM)) {
+            negotiated |= VIRTIO_NET_F_CSUM;
+            if (is_feature_set(supported_features, VIRTIO_NET_F_HOST_TSO4))
+                negotiated |= VIRTIO_NET_F_HOST_TSO4;
+        }
+        // NOTE: We don't verify transport checksums of incoming packets, so packets that still need one can be passed on as-is.
+        if (is_feature_set(supported_features, VIRTIO_NET_F_GUEST_CSUM)) {
+            negotiated |= VIRTIO_NET_F_GUEST_CSUM;
+            // Large incoming segments only fit into our receive buffers if they can be merged.
+            if (is_feature_set(supported_features, VIRTIO_NET_F_GUEST_TSO4) && (negotiated & VIRTIO_NET_F_MRG_RXBUF))
+                negotiated |= VIRTIO_NET_F_GUEST_TSO4;
+        }
+        // The number of queue pairs can only be changed through the control queue, which comes after all possible queue pairs.
+        if (is_feature_set(supported_features, VIRTIO_NET_F_MQ | VIRTIO_NET_F_CTRL_VQ)) {
+            auto device_max_queue_pairs = transport_entity().config_read16(*m_device_config, offsetof(VirtIONetConfig, max_virtqueue_pairs));
+            if (device_max_queue_pairs > 1 && device_max_queue_pairs <= MAX_QUEUE_PAIRS) {
+                negotiated |= VIRTIO_NET_F_MQ | VIRTIO_NET_F_CTRL_VQ;
+                max_queue_pairs = device_max_queue_pairs;
+            }
+        }
         return negotiated;
     }));
 
+    set_checksum_offload(is_feature_accepted(VIRTIO_NET_F_CSUM));
+    set_tcp_segmentation_offload(is_feature_accepted(VIRTIO_NET_F_HOST_TSO4));
+
     TRY(handle_device_config_change());
-    TRY(setup_queues(2)); // receive & transmit
+
+    // Use one queue pair per receive queue, so the device can spread out its work as much as we spread out ours.
+    size_t queue_pair_count = min<size_t>(max_queue_pairs, NetworkTask::receive_queue_count());
+    for (size_t i = 0; i < queue_pair_count; ++i) {
+        QueuePair queue_pair;
+        queue_pair.rx_buffers = TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Rx buffer"sv, RX_BUFFER_SIZE * MAX_INFLIGHT_PACKETS));
+        queue_pair.tx_buffers = TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Tx buffer"sv, TX_BUFFER_SIZE));
+        if (is_feature_accepted(VIRTIO_NET_F_MRG_RXBUF))
+            queue_pair.rx_merge_buffer = TRY(KBuffer::try_create_with_size("VirtIONetworkAdapter Rx merge buffer"sv, MAX_MERGED_RX_FRAME_SIZE));
+        TRY(m_queue_pairs.try_append(move(queue_pair)));
+    }
+
+    if (is_feature_accepted(VIRTIO_NET_F_MQ)) {
+        m_control_queue_index = 2 * max_queue_pairs;
+        m_control_buffers = TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Control buffer"sv, PAGE_SIZE));
+        TRY(setup_queues(m_control_queue_index + 1));
+    } else {
+        TRY(setup_queues(2)); // receive & transmit
+    }
 
     finish_init();
 
-    {
+    if (is_feature_accepted(VIRTIO_NET_F_MQ) && m_queue_pairs.size() > 1) {
+        LittleEndian<u16> virtqueue_pairs = m_queue_pairs.size();
+        if (auto result = send_control_command(VIRTIO_NET_CTRL_MQ, VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET, { &virtqueue_pairs, sizeof(virtqueue_pairs) }); result.is_error()) {
+            // The device keeps using only the first queue pair.
+            dmesgln("VirtIONetworkAdapter: Failed to enable {} queue pairs: {}", m_queue_pairs.size(), result.error());
+            m_queue_pairs.shrink(1);
+        }
+    }
+    dmesgln("VirtIONetworkAdapter: Using {} queue pair(s)", m_queue_pairs.size());
+
+    for (size_t i = 0; i < m_queue_pairs.size(); ++i) {
         // Supply receive buffers.
-        auto& rx_queue = get_queue(RECEIVEQ);
+        auto& rx_buffers = *m_queue_pairs[i].rx_buffers;
+        auto& rx_queue = get_queue(receive_queue_index(i));
         SpinlockLocker queue_lock(rx_queue.lock());
         VirtIO::QueueChain chain(rx_queue);
-        while (m_rx_buffers->available_bytes() > RX_BUFFER_SIZE) {
+        while (rx_buffers.available_bytes() > RX_BUFFER_SIZE) {
             // We know that the RingBuffer will not wraparound in this loop. But it's still awkward.
-            auto buffer_start = MUST(m_rx_buffers->reserve_space(RX_BUFFER_SIZE));
+            auto buffer_start = MUST(rx_buffers.reserve_space(RX_BUFFER_SIZE));
             VERIFY(chain.add_buffer_to_chain(buffer_start, RX_BUFFER_SIZE, VirtIO::BufferType::DeviceWritable));
-            supply_chain_and_notify(RECEIVEQ, chain);
+            supply_chain_and_notify(receive_queue_index(i), chain);
         }
     }
 
@@ -197,43 +270,126 @@ void VirtIONetworkAdapter::handle_queue_update(u16 queue_index)
 {
     dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: handle_queue_update {}", queue_index);
 
-    if (queue_index == RECEIVEQ) {
-        // FIXME: Disable interrupts while receiving as recommended by the spec.
-        auto& queue = get_queue(RECEIVEQ);
-        SpinlockLocker queue_lock(queue.lock());
-        size_t used;
-        VirtIO::QueueChain popped_chain = queue.pop_used_buffer_chain(used);
+    // Control commands are rare enough that send_control_command() simply polls for their completion.
+    if (m_control_queue_index.has_value() && queue_index == *m_control_queue_index)
+        return;
 
-        while (!popped_chain.is_empty()) {
-            VERIFY(popped_chain.length() == 1);
-            popped_chain.for_each([&](PhysicalAddress addr, size_t length) {
-                size_t offset = addr.as_ptr() - m_rx_buffers->start_of_region().as_ptr();
-                auto* message = reinterpret_cast<VirtIONetHdr*>(m_rx_buffers->vaddr().offset(offset).as_ptr());
-                did_receive({ message->frame, length - sizeof(VirtIONetHdr) });
-            });
+    size_t queue_pair_index = queue_index / 2;
+    if (queue_pair_index >= m_queue_pairs.size()) {
+        dmesgln("VirtIONetworkAdapter: unexpected update for queue {}", queue_index);
+        return;
+    }
+    auto& queue_pair = m_queue_pairs[queue_pair_index];
 
-            supply_chain_and_notify(RECEIVEQ, popped_chain);
-            popped_chain = queue.pop_used_buffer_chain(used);
-        }
-    } else if (queue_index == TRANSMITQ) {
-        auto& queue = get_queue(TRANSMITQ);
+    if (queue_index == receive_queue_index(queue_pair_index)) {
+        // Received frames are picked up by the network task, see poll_receive().
+        schedule_receive_poll(queue_pair_index);
+    } else {
+        auto& queue = get_queue(queue_index);
         SpinlockLocker queue_lock(queue.lock());
-        SpinlockLocker ringbuffer_lock(m_tx_buffers->lock());
+        SpinlockLocker ringbuffer_lock(queue_pair.tx_buffers->lock());
 
         size_t used;
         VirtIO::QueueChain popped_chain = queue.pop_used_buffer_chain(used);
         do {
-            popped_chain.for_each([this](PhysicalAddress address, size_t length) {
-                m_tx_buffers->reclaim_space(address, length);
+            popped_chain.for_each([&](PhysicalAddress address, size_t length) {
+                queue_pair.tx_buffers->reclaim_space(address, length);
             });
             popped_chain.release_buffer_slots_to_queue();
             popped_chain = queue.pop_used_buffer_chain(used);
         } while (!popped_chain.is_empty());
-    } else {
-        dmesgln("VirtIONetworkAdapter: unexpected update for queue {}", queue_index);
     }
 }
 
+size_t VirtIONetworkAdapter::poll_receive(size_t queue_pair_index, size_t budget)
+{
+    auto& queue = get_queue(receive_queue_index(queue_pair_index));
+    SpinlockLocker queue_lock(queue.lock());
+
+    size_t frames = 0;
+    while (frames < budget) {
+        size_t used;
+        VirtIO::QueueChain popped_chain = queue.pop_used_buffer_chain(used);
+        if (popped_chain.is_empty())
+            break;
+        receive_frame(queue_pair_index, popped_chain, used);
+        ++frames;
+    }
+    return frames;
+}
+
+void VirtIONetworkAdapter::set_receive_interrupt_enabled(size_t queue_pair_index, bool enabled)
+{
+    auto& queue = get_queue(receive_queue_index(queue_pair_index));
+    if (enabled)
+        queue.enable_interrupts();
+    else
+        queue.disable_interrupts();
+}
+
+static u8* buffer_for(Memory::RingBuffer& ring, PhysicalAddress address)
+{
+    size_t offset = address.as_ptr() - ring.start_of_region().as_ptr();
+    return ring.vaddr().offset(offset).as_ptr();
+}
+
+static u8* rx_buffer_for(Memory::RingBuffer& rx_buffers, VirtIO::QueueChain& chain)
+{
+    VERIFY(chain.length() == 1);
+    u8* buffer = nullptr;
+    chain.for_each([&](PhysicalAddress address, size_t) {
+        buffer = buffer_for(rx_buffers, address);
+    });
+    return buffer;
+}
+
+void VirtIONetworkAdapter::receive_frame(size_t queue_pair_index, VirtIO::QueueChain& first_chain, size_t used)
+{
+    auto& queue_pair = m_queue_pairs[queue_pair_index];
+    auto& queue = get_queue(receive_queue_index(queue_pair_index));
+    auto* message = reinterpret_cast<VirtIONetHdr*>(rx_buffer_for(*queue_pair.rx_buffers, first_chain));
+    u16 buffer_count = is_feature_accepted(VIRTIO_NET_F_MRG_RXBUF) ? static_cast<u16>(message->num_buffers) : 1;
+    size_t first_length = used - sizeof(VirtIONetHdr);
+
+    if (buffer_count <= 1) {
+        did_receive({ message->frame, first_length });
+        supply_chain_and_notify(receive_queue_index(queue_pair_index), first_chain);
+        return;
+    }
+
+    // The frame continues in the next buffer_count - 1 used buffers, which don't have a header of their own.
+    size_t frame_size = 0;
+    bool is_valid_frame = true;
+    auto& merge_buffer = *queue_pair.rx_merge_buffer;
+    auto append_to_frame = [&](u8 const* data, size_t length) {
+        if (frame_size + length > merge_buffer.size()) {
+            is_valid_frame = false;
+            return;
+        }
+        memcpy(merge_buffer.data() + frame_size, data, length);
+        frame_size += length;
+    };
+
+    append_to_frame(message->frame, first_length);
+    supply_chain_and_notify(receive_queue_index(queue_pair_index), first_chain);
+
+    for (u16 i = 1; i < buffer_count; ++i) {
+        auto chain = queue.pop_used_buffer_chain(used);
+        if (chain.is_empty()) {
+            dmesgln("VirtIONetworkAdapter: {} of {} buffers missing for a merged frame", buffer_count - i, buffer_count);
+            return;
+        }
+        append_to_frame(rx_buffer_for(*queue_pair.rx_buffers, chain), used);
+        supply_chain_and_notify(receive_queue_index(queue_pair_index), chain);
+    }
+
+    if (!is_valid_frame) {
+        dmesgln("VirtIONetworkAdapter: Dropping merged frame that is larger than {} bytes", merge_buffer.size());
+        return;
+    }
+    did_receive(merge_buffer.bytes().trim(frame_size));
+}
+
 static bool copy_data_to_chain(VirtIO::QueueChain& chain, Memory::RingBuffer& ring, u8 const* data, size_t length)
 {
     UserOrKernelBuffer buf = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data));
@@ -254,26 +410,84 @@ static bool copy_data_to_chain(VirtIO::QueueChain& chain, Memory::RingBuffer& ri
 }
 
 void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
+{
+    send_with_header(payload, {});
+}
+
+void VirtIONetworkAdapter::send_raw_with_offload(ReadonlyBytes payload, PacketOffload const& offload)
+{
+    VirtIONetHdr hdr {};
+    if (offload.needs_checksum) {
+        VERIFY(is_feature_accepted(VIRTIO_NET_F_CSUM));
+        hdr.flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+        hdr.csum_start = offload.checksum_start;
+        hdr.csum_offset = offload.checksum_offset;
+    }
+    if (offload.segment_size != 0) {
+        VERIFY(is_feature_accepted(VIRTIO_NET_F_HOST_TSO4));
+        hdr.gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+        hdr.gso_size = offload.segment_size;
+        hdr.hdr_len = offload.header_size;
+    }
+    send_with_header(payload, hdr);
+}
+
+void VirtIONetworkAdapter::send_with_header(ReadonlyBytes payload, VirtIONetHdr const& hdr)
 {
     dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: send_raw length={}", payload.size());
 
-    auto& queue = get_queue(TRANSMITQ);
+    // Senders on different CPUs use different transmit queues, so they don't contend for the same locks.
+    size_t queue_pair_index = Processor::current_id() % m_queue_pairs.size();
+    auto& tx_buffers = *m_queue_pairs[queue_pair_index].tx_buffers;
+    auto& queue = get_queue(transmit_queue_index(queue_pair_index));
     SpinlockLocker queue_lock(queue.lock());
     VirtIO::QueueChain chain(queue);
 
-    SpinlockLocker ringbuffer_lock(m_tx_buffers->lock());
-    if (m_tx_buffers->available_bytes() < sizeof(VirtIONetHdr) + payload.size()) {
+    SpinlockLocker ringbuffer_lock(tx_buffers.lock());
+    if (tx_buffers.available_bytes() < sizeof(VirtIONetHdr) + payload.size()) {
         // We can drop packets that don't fit to apply back pressure on eager senders.
         dmesgln("VirtIONetworkAdapter: not enough space in the buffer. Dropping packet");
         return;
     }
 
     // FIXME: Handle errors from pushing to the chain and rewind the RingBuffer.
-    VirtIONetHdr hdr {};
-    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, reinterpret_cast<u8*>(&hdr), sizeof(hdr)));
-    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, payload.data(), payload.size()));
+    VERIFY(copy_data_to_chain(chain, tx_buffers, reinterpret_cast<u8 const*>(&hdr), sizeof(hdr)));
+    VERIFY(copy_data_to_chain(chain, tx_buffers, payload.data(), payload.size()));
 
-    supply_chain_and_notify(TRANSMITQ, chain);
+    supply_chain_and_notify(transmit_queue_index(queue_pair_index), chain);
+}
+
+ErrorOr<void> VirtIONetworkAdapter::send_control_command(u8 net_class, u8 command, ReadonlyBytes data)
+{
+    VERIFY(m_control_queue_index.has_value());
+    auto& queue = get_queue(*m_control_queue_index);
+    SpinlockLocker queue_lock(queue.lock());
+    SpinlockLocker ringbuffer_lock(m_control_buffers->lock());
+    VirtIO::QueueChain chain(queue);
+
+    VirtIONetCtrlHeader header { net_class, command };
+    VERIFY(copy_data_to_chain(chain, *m_control_buffers, reinterpret_cast<u8 const*>(&header), sizeof(header)));
+    VERIFY(copy_data_to_chain(chain, *m_control_buffers, data.data(), data.size()));
+    auto ack_address = TRY(m_control_buffers->reserve_space(sizeof(u8)));
+    auto* ack = buffer_for(*m_control_buffers, ack_address);
+    *ack = VIRTIO_NET_ERR;
+    VERIFY(chain.add_buffer_to_chain(ack_address, sizeof(u8), VirtIO::BufferType::DeviceWritable));
+    supply_chain_and_notify(*m_control_queue_index, chain);
+
+    size_t used;
+    auto used_chain = queue.pop_used_buffer_chain(used);
+    while (used_chain.is_empty()) {
+        Processor::wait_check();
+        used_chain = queue.pop_used_buffer_chain(used);
+    }
+    used_chain.for_each([&](PhysicalAddress address, size_t length) {
+        m_control_buffers->reclaim_space(address, length);
+    });
+    used_chain.release_buffer_slots_to_queue();
+
+    if (AK::atomic_load(ack) != VIRTIO_NET_OK)
+        return EIO;
+    return {};
 }
 
 }
@@ -12,6 +12,10 @@
 
 namespace Kernel {
 
+namespace VirtIO {
+struct VirtIONetHdr;
+}
+
 class VirtIONetworkAdapter
     : public VirtIO::Device
     , public NetworkAdapter {
@@ -42,6 +46,13 @@ private:
 
     // NetworkAdapter
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_offload(ReadonlyBytes, PacketOffload const&) override;
+    virtual size_t poll_receive(size_t queue_pair_index, size_t budget) override;
+    virtual void set_receive_interrupt_enabled(size_t queue_pair_index, bool) override;
+
+    void send_with_header(ReadonlyBytes, VirtIO::VirtIONetHdr const&);
+    void receive_frame(size_t queue_pair_index, VirtIO::QueueChain& first_chain, size_t used);
+    ErrorOr<void> send_control_command(u8 net_class, u8 command, ReadonlyBytes data);
 
 private:
     VirtIO::Configuration const* m_device_config { nullptr };
@@ -52,8 +63,17 @@ private:
     i32 m_link_speed { LINKSPEED_INVALID };
     bool m_link_duplex { false };
 
-    OwnPtr<Memory::RingBuffer> m_rx_buffers;
-    OwnPtr<Memory::RingBuffer> m_tx_buffers;
+    struct QueuePair {
+        OwnPtr<Memory::RingBuffer> rx_buffers;
+        OwnPtr<Memory::RingBuffer> tx_buffers;
+        // Frames spread over multiple receive buffers (VIRTIO_NET_F_MRG_RXBUF) are reassembled here.
+        OwnPtr<KBuffer> rx_merge_buffer;
+    };
+    Vector<QueuePair> m_queue_pairs;
+
+    // Only set up with VIRTIO_NET_F_MQ, which is the only thing we need the control queue for.
+    Optional<u16> m_control_queue_index;
+    OwnPtr<Memory::RingBuffer> m_control_buffers;
 };
 
 }
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$epoll_create1(int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~EPOLL_CLOEXEC)
+        return EINVAL;
+
+    auto epoll = TRY(EPoll::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(epoll)));
+    description->set_readable(true);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description), (flags & EPOLL_CLOEXEC) ? FD_CLOEXEC : 0);
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_ctl(int epfd, int op, int fd, Userspace<epoll_event const*> user_event)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto epoll_description = TRY(open_file_description(epfd));
+    auto* epoll = epoll_description->epoll();
+    if (!epoll)
+        return EINVAL;
+    if (fd == epfd)
+        return EINVAL;
+
+    // Watches are removed by fd alone, which may have been closed already.
+    if (op == EPOLL_CTL_DEL) {
+        TRY(epoll->remove_watch(fd));
+        return 0;
+    }
+
+    auto description = TRY(open_file_description(fd));
+    auto event = TRY(copy_typed_from_user(user_event));
+
+    switch (op) {
+    case EPOLL_CTL_ADD:
+        TRY(epoll->add_watch(fd, *description, event));
+        return 0;
+    case EPOLL_CTL_MOD:
+        TRY(epoll->modify_watch(fd, *description, event));
+        return 0;
+    default:
+        return EINVAL;
+    }
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_pwait(Userspace<Syscall::SC_epoll_pwait_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.maxevents <= 0)
+        return EINVAL;
+
+    auto description = TRY(open_file_description(params.epfd));
+    auto* epoll = description->epoll();
+    if (!epoll)
+        return EINVAL;
+
+    Thread::BlockTimeout timeout;
+    bool should_block = true;
+    if (params.timeout) {
+        auto timeout_time = TRY(copy_time_from_user(params.timeout));
+        timeout = Thread::BlockTimeout(false, &timeout_time);
+        should_block = timeout_time != Duration::zero();
+    }
+
+    sigset_t sigmask = {};
+    if (params.sigmask)
+        TRY(copy_from_user(&sigmask, params.sigmask));
+
+    // Every fd can only be watched once, so there can't be more events than open fds.
+    Vector<epoll_event, 32> events;
+    TRY(events.try_resize(min<size_t>(params.maxevents, OpenFileDescriptions::max_open())));
+
+    auto* current_thread = Thread::current();
+
+    u32 previous_signal_mask = 0;
+    if (params.sigmask)
+        previous_signal_mask = current_thread->update_signal_mask(sigmask);
+    ScopeGuard rollback_signal_mask([&]() {
+        if (params.sigmask)
+            current_thread->update_signal_mask(previous_signal_mask);
+    });
+
+    size_t event_count = 0;
+    while (true) {
+        event_count = epoll->collect_ready_events(events.span());
+        if (event_count > 0 || !should_block)
+            break;
+
+        auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+        auto result = current_thread->block<Thread::ReadBlocker>(timeout, *description, unblock_flags);
+        if (result.was_interrupted())
+            return EINTR;
+        // Anything that became ready right before the timeout still counts.
+        if (result == Thread::BlockResult::InterruptedByTimeout)
+            should_block = false;
+    }
+
+    if (event_count > 0)
+        TRY(copy_n_to_user(params.events, events.data(), event_count));
+    return event_count;
+}
+
+}
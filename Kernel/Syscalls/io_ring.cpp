@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$io_ring_create(u32 entries, int flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~O_CLOEXEC)
+        return EINVAL;
+
+    auto ring = TRY(IORing::try_create(*this, entries));
+    auto description = TRY(OpenFileDescription::try_create(move(ring)));
+    description->set_readable(true);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description), (flags & O_CLOEXEC) ? FD_CLOEXEC : 0);
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$io_ring_enter(int fd, u32 to_submit, u32 min_complete)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    auto description = TRY(open_file_description(fd));
+    auto* ring = description->io_ring();
+    if (!ring)
+        return EINVAL;
+    if (!ring->is_owned_by(*this))
+        return EPERM;
+
+    auto submitted = ring->submit(*this, to_submit);
+    if (auto result = ring->wait_for_completions(*this, min_complete); result.is_error() && submitted == 0)
+        return result.release_error();
+    return submitted;
+}
+
+}
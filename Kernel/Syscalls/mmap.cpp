@@ -377,6 +377,14 @@ ErrorOr<FlatPtr> Process::sys$madvise(Userspace<void*> address, size_t size, int
             TRY(vmobject.set_volatile(advice == MADV_SET_VOLATILE, was_purged));
             return was_purged ? 1 : 0;
         }
+        if (advice == MADV_HUGEPAGE || advice == MADV_NOHUGEPAGE) {
+            if (!region->vmobject().is_anonymous() || region->is_shared())
+                return EINVAL;
+            region->set_wants_huge_pages(advice == MADV_HUGEPAGE);
+            // Pages that were faulted in as huge pages before are mapped as such again, or split up if that's no longer wanted.
+            region->remap();
+            return 0;
+        }
         return EINVAL;
     });
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Tasks/Coredump.h>
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/Process.h>
@@ -29,6 +30,9 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
 
+    if ((event_mask & performance_counter_event_mask) && !performance_counters_are_supported())
+        return ENOTSUP;
+
     if (pid == -1) {
         auto credentials = this->credentials();
         if (!credentials->is_superuser())
@@ -55,6 +59,8 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
             return {};
         }));
         g_profiling_event_mask = event_mask;
+        // Counting goes along with the profile timer, so threads have counter totals whenever they are profiled.
+        (void)enable_performance_counters();
         return 0;
     }
 
@@ -79,6 +85,7 @@ ErrorOr<FlatPtr> Process::profiling_enable(pid_t pid, u64 event_mask)
         process->set_profiling(false);
         return ENOTSUP;
     }
+    (void)enable_performance_counters();
     return 0;
 }
 
@@ -94,6 +101,7 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
         ScopedCritical critical;
         if (!TimeManagement::the().disable_profile_timer())
             return ENOTSUP;
+        disable_performance_counters();
         g_profiling_all_threads = false;
         return 0;
     }
@@ -111,6 +119,7 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
     // FIXME: If we enabled the profile timer and it's not supported, how do we disable it now?
     if (!TimeManagement::the().disable_profile_timer())
         return ENOTSUP;
+    disable_performance_counters();
     process->set_profiling(false);
     return 0;
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/FileSystem/Inode.h>
 #include <Kernel/Memory/AnonymousVMObject.h>
 #include <Kernel/Memory/InodeVMObject.h>
 #include <Kernel/Memory/MemoryManager.h>
@@ -64,6 +65,17 @@ ErrorOr<FlatPtr> Process::sys$purge(int mode)
         for (auto& vmobject : vmobjects) {
             purged_page_count += vmobject->release_all_clean_pages();
         }
+
+        Vector<NonnullRefPtr<Inode>> inodes;
+        Inode::all_instances().with([&](auto& all_inodes) {
+            for (auto& inode : all_inodes) {
+                if (inodes.try_append(inode).is_error())
+                    break;
+            }
+        });
+        for (auto& inode : inodes) {
+            purged_page_count += inode->release_unmapped_page_cache_pages();
+        }
     }
     return purged_page_count;
 }
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <AK/NumericLimits.h>
+#include <Kernel/API/POSIX/fcntl.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+// Data is moved in chunks of this size. The data never leaves the kernel: pages of files in the page cache are
+// mapped into the kernel and written out from there, everything else passes through a bounce buffer of this size.
+static constexpr size_t transfer_chunk_size = 64 * KiB;
+
+struct PageCacheMapping {
+    NonnullOwnPtr<Memory::Region> region;
+    size_t offset_in_region { 0 };
+    size_t size { 0 };
+};
+
+// Maps the cached pages holding up to `count` bytes at `offset` of `inode` into the kernel, or returns nothing at the end of the file.
+static ErrorOr<Optional<PageCacheMapping>> map_page_cache_pages(Inode& inode, u64 offset, size_t count)
+{
+    auto file_size = inode.size();
+    if (offset >= file_size)
+        return OptionalNone {};
+    count = min<u64>(count, file_size - offset);
+
+    auto offset_in_page = offset % PAGE_SIZE;
+    auto page_count = ceil_div(offset_in_page + count, PAGE_SIZE);
+    Vector<NonnullRefPtr<Memory::PhysicalRAMPage>, transfer_chunk_size / PAGE_SIZE + 1> pages;
+    for (size_t i = 0; i < page_count; ++i) {
+        auto page = TRY(inode.page_cache_page(offset / PAGE_SIZE + i));
+        // The file may have been truncated in the meantime.
+        if (!page)
+            break;
+        TRY(pages.try_append(page.release_nonnull()));
+    }
+    if (pages.is_empty())
+        return OptionalNone {};
+
+    auto region = TRY(MM.allocate_kernel_region_with_physical_pages(pages, "sendfile"sv, Memory::Region::Access::Read));
+    auto size = min(count, pages.size() * PAGE_SIZE - offset_in_page);
+    return PageCacheMapping { move(region), offset_in_page, size };
+}
+
+static ErrorOr<void> wait_until_readable(OpenFileDescription& description, bool nonblocking)
+{
+    if (description.can_read())
+        return {};
+    if (nonblocking)
+        return EAGAIN;
+    auto unblock_flags = BlockFlags::None;
+    if (Thread::current()->block<Thread::ReadBlocker>({}, description, unblock_flags).was_interrupted())
+        return EINTR;
+    if (!has_flag(unblock_flags, BlockFlags::Read))
+        return EAGAIN;
+    return {};
+}
+
+static ErrorOr<void> wait_until_writable(OpenFileDescription& description, bool nonblocking)
+{
+    while (!description.can_write()) {
+        if (nonblocking)
+            return EAGAIN;
+        auto unblock_flags = BlockFlags::None;
+        if (Thread::current()->block<Thread::WriteBlocker>({}, description, unblock_flags).was_interrupted())
+            return EINTR;
+    }
+    return {};
+}
+
+// Moves up to `count` bytes from `input` to `output` without copying them through userspace.
+// Like read() and write(), this only fails if nothing could be transferred at all.
+static ErrorOr<size_t> transfer_between_descriptions(OpenFileDescription& input, Optional<off_t> input_offset, OpenFileDescription& output, Optional<off_t> output_offset, size_t count, bool nonblocking)
+{
+    bool input_is_nonblocking = nonblocking || !input.is_blocking();
+    bool output_is_nonblocking = nonblocking || !output.is_blocking();
+    bool input_is_seekable = input.file().is_seekable();
+
+    auto* page_cached_input = input.inode();
+    if (page_cached_input && (!page_cached_input->uses_page_cache() || input.is_direct()))
+        page_cached_input = nullptr;
+
+    if (output.should_append() && output.file().is_seekable())
+        TRY(output.seek(0, SEEK_END));
+
+    ByteBuffer bounce_buffer;
+    if (!page_cached_input)
+        bounce_buffer = TRY(ByteBuffer::create_uninitialized(min(count, transfer_chunk_size)));
+
+    size_t total_transferred = 0;
+    auto finish = [&](Error error) -> ErrorOr<size_t> {
+        if (total_transferred > 0)
+            return total_transferred;
+        return error;
+    };
+
+    while (total_transferred < count) {
+        // Once we've moved some data, we return instead of blocking, just like a short read() would.
+        if (auto result = wait_until_writable(output, output_is_nonblocking || total_transferred > 0); result.is_error())
+            return finish(result.release_error());
+        if (auto result = wait_until_readable(input, input_is_nonblocking || total_transferred > 0); result.is_error())
+            return finish(result.release_error());
+
+        auto chunk_size = min(count - total_transferred, transfer_chunk_size);
+        Optional<PageCacheMapping> page_cache_mapping;
+        auto chunk_buffer = UserOrKernelBuffer::for_kernel_buffer(bounce_buffer.data());
+        size_t nread = 0;
+        if (page_cached_input) {
+            auto read_offset = input_offset.has_value() ? input_offset.value() + total_transferred : input.offset();
+            auto mapping_or_error = map_page_cache_pages(*page_cached_input, read_offset, chunk_size);
+            if (mapping_or_error.is_error())
+                return finish(mapping_or_error.release_error());
+            page_cache_mapping = mapping_or_error.release_value();
+            if (!page_cache_mapping.has_value())
+                break;
+            chunk_buffer = UserOrKernelBuffer::for_kernel_buffer(page_cache_mapping->region->vaddr().offset(page_cache_mapping->offset_in_region).as_ptr());
+            nread = page_cache_mapping->size;
+            // Behave like read() would, the offset is given back below if we can't write everything.
+            if (!input_offset.has_value()) {
+                if (auto result = input.seek(nread, SEEK_CUR); result.is_error())
+                    return finish(result.release_error());
+            }
+            Thread::current()->did_file_read(nread);
+        } else {
+            auto nread_or_error = input_offset.has_value()
+                ? input.read(chunk_buffer, input_offset.value() + total_transferred, chunk_size)
+                : input.read(chunk_buffer, chunk_size);
+            if (nread_or_error.is_error())
+                return finish(nread_or_error.release_error());
+            nread = nread_or_error.release_value();
+            if (nread == 0)
+                break;
+        }
+
+        size_t nwritten = 0;
+        while (nwritten < nread) {
+            auto nwritten_or_error = output_offset.has_value()
+                ? output.write(output_offset.value() + total_transferred + nwritten, chunk_buffer.offset(nwritten), nread - nwritten)
+                : output.write(chunk_buffer.offset(nwritten), nread - nwritten);
+            if (!nwritten_or_error.is_error()) {
+                nwritten += nwritten_or_error.value();
+                continue;
+            }
+            if (nwritten_or_error.error().code() == EPIPE)
+                Thread::current()->send_signal(SIGPIPE, &Process::current());
+            if (nwritten_or_error.error().code() != EAGAIN || (input_is_seekable && output_is_nonblocking)) {
+                // Give back whatever we couldn't write, so it'll be read again next time.
+                if (input_is_seekable && !input_offset.has_value())
+                    (void)input.seek(-static_cast<off_t>(nread - nwritten), SEEK_CUR);
+                total_transferred += nwritten;
+                return finish(nwritten_or_error.release_error());
+            }
+            // Data we took out of a pipe or socket can't be put back, so we have to wait until it has all been written.
+            // A blocking output also waits, e.g. for a TCP socket's send window to open up again.
+            if (auto result = wait_until_writable(output, false); result.is_error()) {
+                total_transferred += nwritten;
+                return finish(result.release_error());
+            }
+        }
+        total_transferred += nwritten;
+    }
+
+    return total_transferred;
+}
+
+ErrorOr<FlatPtr> Process::sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> user_offset, size_t count)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    if (count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", out_fd, in_fd, user_offset.ptr(), count);
+
+    auto input = TRY(open_file_description(in_fd));
+    if (!input->is_readable())
+        return EBADF;
+    if (input->is_directory())
+        return EISDIR;
+    auto output = TRY(open_file_description(out_fd));
+    if (!output->is_writable())
+        return EBADF;
+
+    Optional<off_t> offset;
+    if (user_offset) {
+        offset = TRY(copy_typed_from_user(user_offset));
+        if (offset.value() < 0)
+            return EINVAL;
+        if (!input->file().is_seekable())
+            return ESPIPE;
+    }
+
+    if (count == 0)
+        return 0;
+
+    auto nsent = TRY(transfer_between_descriptions(*input, offset, *output, {}, count, false));
+    if (user_offset) {
+        off_t new_offset = offset.value() + nsent;
+        TRY(copy_to_user(user_offset, &new_offset));
+    }
+    return nsent;
+}
+
+ErrorOr<FlatPtr> Process::sys$splice(Userspace<Syscall::SC_splice_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.flags & ~(SPLICE_F_MOVE | SPLICE_F_NONBLOCK | SPLICE_F_MORE | SPLICE_F_GIFT))
+        return EINVAL;
+    if (params.length > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    dbgln_if(IO_DEBUG, "sys$splice({}, {}, {})", params.fd_in, params.fd_out, params.length);
+
+    auto input = TRY(open_file_description(params.fd_in));
+    if (!input->is_readable())
+        return EBADF;
+    if (input->is_directory())
+        return EISDIR;
+    auto output = TRY(open_file_description(params.fd_out));
+    if (!output->is_writable())
+        return EBADF;
+
+    // One end has to be a pipe, sendfile() covers everything else.
+    if (!input->is_fifo() && !output->is_fifo())
+        return EINVAL;
+
+    Userspace<off_t*> user_input_offset { (FlatPtr)params.off_in };
+    Userspace<off_t*> user_output_offset { (FlatPtr)params.off_out };
+
+    Optional<off_t> input_offset;
+    if (user_input_offset) {
+        if (!input->file().is_seekable())
+            return ESPIPE;
+        input_offset = TRY(copy_typed_from_user(user_input_offset));
+        if (input_offset.value() < 0)
+            return EINVAL;
+    }
+    Optional<off_t> output_offset;
+    if (user_output_offset) {
+        if (!output->file().is_seekable())
+            return ESPIPE;
+        output_offset = TRY(copy_typed_from_user(user_output_offset));
+        if (output_offset.value() < 0)
+            return EINVAL;
+    }
+
+    if (params.length == 0)
+        return 0;
+
+    auto ntransferred = TRY(transfer_between_descriptions(*input, input_offset, *output, output_offset, params.length, params.flags & SPLICE_F_NONBLOCK));
+    if (user_input_offset) {
+        off_t new_offset = input_offset.value() + ntransferred;
+        TRY(copy_to_user(user_input_offset, &new_offset));
+    }
+    if (user_output_offset) {
+        off_t new_offset = output_offset.value() + ntransferred;
+        TRY(copy_to_user(user_output_offset, &new_offset));
+    }
+    return ntransferred;
+}
+
+}
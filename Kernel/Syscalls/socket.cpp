@@ -243,6 +243,9 @@ ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*
 
         auto bytes_sent_or_error = socket.sendto(*description, data_buffer, iovs[0].iov_len, flags, user_addr, addr_length);
         if (bytes_sent_or_error.is_error()) {
+            // Someone else might have filled up the socket's send window since we checked, so wait for it again.
+            if (bytes_sent_or_error.error().code() == EAGAIN && description->is_blocking())
+                continue;
             if ((flags & MSG_NOSIGNAL) == 0 && bytes_sent_or_error.error().code() == EPIPE)
                 Thread::current()->send_signal(SIGPIPE, &Process::current());
             return bytes_sent_or_error.release_error();
@@ -30,6 +30,12 @@ public:
         (void)Thread::current()->block<Thread::DeprecatedWaitQueueBlocker>({}, *this, forward<Args>(args)...);
     }
 
+    // Pending signals don't end this wait, only being woken up or the thread having to die do.
+    void wait_forever_uninterruptibly(StringView block_reason = {})
+    {
+        (void)Thread::current()->block<Thread::DeprecatedWaitQueueBlocker>({}, *this, block_reason, Thread::DeprecatedWaitQueueBlocker::Interruptible::No);
+    }
+
 protected:
     virtual bool should_add_blocker(Thread::Blocker& b, void*) override;
 
@@ -9,6 +9,7 @@
 #include <AK/JsonObjectSerializer.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StackUnwinder.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/Arch/SafeMem.h>
 #include <Kernel/FileSystem/Custody.h>
@@ -171,6 +172,12 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
     case PERF_EVENT_FILESYSTEM:
         event.data.filesystem = filesystem_event;
         break;
+    case PERF_EVENT_CYCLES:
+    case PERF_EVENT_INSTRUCTIONS:
+    case PERF_EVENT_CACHE_MISSES:
+    case PERF_EVENT_BRANCH_MISSES:
+        event.data.performance_counter_sample.period = arg1;
+        break;
     default:
         return EINVAL;
     }
@@ -346,6 +353,14 @@ ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
             }
             }
             break;
+        case PERF_EVENT_CYCLES:
+        case PERF_EVENT_INSTRUCTIONS:
+        case PERF_EVENT_CACHE_MISSES:
+        case PERF_EVENT_BRANCH_MISSES:
+            TRY(event_object.add("type"sv, "counter_sample"sv));
+            TRY(event_object.add("counter"sv, performance_counter_name(performance_counter_for_event_type(event.type))));
+            TRY(event_object.add("period"sv, event.data.performance_counter_sample.period));
+            break;
         }
         TRY(event_object.add("pid"sv, event.pid));
         TRY(event_object.add("tid"sv, event.tid));
@@ -69,6 +69,10 @@ struct [[gnu::packed]] SignpostPerformanceEvent {
     FlatPtr arg2;
 };
 
+struct [[gnu::packed]] PerformanceCounterSamplePerformanceEvent {
+    u64 period;
+};
+
 struct [[gnu::packed]] ReadPerformanceEvent {
     int fd;
     size_t size;
@@ -158,6 +162,7 @@ struct [[gnu::packed]] PerformanceEvent {
         KFreePerformanceEvent kfree;
         SignpostPerformanceEvent signpost;
         FilesystemEvent filesystem;
+        PerformanceCounterSamplePerformanceEvent performance_counter_sample;
     } data;
     static constexpr size_t max_stack_frame_count = 64;
     FlatPtr stack[max_stack_frame_count];
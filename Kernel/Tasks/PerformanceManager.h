@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Arch/TrapFrame.h>
 #include <Kernel/Tasks/PerformanceEventBuffer.h>
 #include <Kernel/Tasks/Process.h>
@@ -69,6 +70,16 @@ public:
         }
     }
 
+    static void add_performance_counter_sample_event(Thread& current_thread, RegisterState const& regs, PerformanceCounter counter)
+    {
+        if (current_thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = current_thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto rc = event_buffer->append_with_ip_and_bp(
+                current_thread.pid(), current_thread.tid(), regs, performance_counter_event_type(counter), 0, performance_counter_sample_period(counter), 0, {});
+        }
+    }
+
     static void add_mmap_perf_event(Process& current_process, Memory::Region const& region)
     {
         if (auto* event_buffer = current_process.current_perf_events_buffer()) {
@@ -13,6 +13,7 @@
 #include <Kernel/API/POSIX/sys/limits.h>
 #include <Kernel/API/Syscall.h>
 #include <Kernel/Arch/PageDirectory.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Devices/BaseDevices.h>
 #include <Kernel/Devices/Device.h>
@@ -921,6 +922,7 @@ void Process::finalize()
             if (result.is_error())
                 dmesgln("Failed to write perfcore for pid {}: {}", pid(), result.error());
             TimeManagement::the().disable_profile_timer();
+            disable_performance_counters();
         }
     }
 
@@ -355,6 +355,11 @@ public:
     ErrorOr<FlatPtr> sys$create_inode_watcher(u32 flags);
     ErrorOr<FlatPtr> sys$inode_watcher_add_watch(Userspace<Syscall::SC_inode_watcher_add_watch_params const*> user_params);
     ErrorOr<FlatPtr> sys$inode_watcher_remove_watch(int fd, int wd);
+    ErrorOr<FlatPtr> sys$epoll_create1(int flags);
+    ErrorOr<FlatPtr> sys$epoll_ctl(int epfd, int op, int fd, Userspace<epoll_event const*>);
+    ErrorOr<FlatPtr> sys$epoll_pwait(Userspace<Syscall::SC_epoll_pwait_params const*>);
+    ErrorOr<FlatPtr> sys$io_ring_create(u32 entries, int flags);
+    ErrorOr<FlatPtr> sys$io_ring_enter(int fd, u32 to_submit, u32 min_complete);
     ErrorOr<FlatPtr> sys$dbgputstr(Userspace<char const*>, size_t);
     ErrorOr<FlatPtr> sys$dump_backtrace();
     ErrorOr<FlatPtr> sys$gettid();
@@ -494,6 +499,8 @@ public:
     ErrorOr<FlatPtr> sys$get_stack_bounds(Userspace<FlatPtr*> stack_base, Userspace<size_t*> stack_size);
     ErrorOr<FlatPtr> sys$ptrace(Userspace<Syscall::SC_ptrace_params const*>);
     ErrorOr<FlatPtr> sys$sendfd(int sockfd, int fd);
+    ErrorOr<FlatPtr> sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> offset, size_t count);
+    ErrorOr<FlatPtr> sys$splice(Userspace<Syscall::SC_splice_params const*>);
     ErrorOr<FlatPtr> sys$recvfd(int sockfd, int options);
     ErrorOr<FlatPtr> sys$sysconf(int name);
     ErrorOr<FlatPtr> sys$disown(ProcessID);
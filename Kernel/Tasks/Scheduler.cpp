@@ -8,6 +8,7 @@
 #include <AK/ScopeGuard.h>
 #include <AK/Singleton.h>
 #include <AK/Time.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Arch/TrapFrame.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
@@ -47,7 +48,39 @@ struct ThreadReadyQueues {
     Array<ThreadReadyQueue, count> queues;
 };
 
-static Singleton<RecursiveSpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+static constexpr size_t ready_queues_alignment = 64;
+
+// Every processor owns its own set of ready queues, each protected by its own lock, so that
+// picking the next thread and queueing a runnable thread only touches processor-local state.
+// Idle processors steal work from the busiest processor, and a periodic balancing pass evens
+// out the queue lengths between busy processors.
+// NOTE: Other processors read runnable_count and take the lock, while ticks_until_load_balance is written on every
+//       tick, so each processor's queues get cache lines of their own.
+struct alignas(ready_queues_alignment) ProcessorReadyQueues {
+    Thread* take_next(u32 affinity_mask);
+    Thread* peek_next(u32 affinity_mask);
+    void append(Thread&, u32 cpu, u32 priority);
+    // Returns nothing if the thread isn't queued on this processor (anymore), because it was migrated to another one.
+    Optional<bool> remove(Thread&, u32 cpu);
+
+    RecursiveSpinlockProtected<ThreadReadyQueues, LockRank::None> ready_queues {};
+
+    // Number of threads in ready_queues. This is only updated while holding the lock,
+    // but read without it to cheaply estimate the load of a processor.
+    Atomic<u32> runnable_count { 0 };
+
+    u32 ticks_until_load_balance { 0 };
+};
+
+static_assert(sizeof(ProcessorReadyQueues) % ready_queues_alignment == 0);
+
+static Singleton<Array<ProcessorReadyQueues, MAX_CPU_COUNT>> s_processor_ready_queues;
+
+// Processors that have set up their idle thread and can therefore run threads queued to them.
+static Atomic<u32> s_online_processor_mask { 0 };
+
+// One load balancing pass every 25 ticks (100ms assuming 250 ticks/second).
+static constexpr u32 load_balance_interval_in_ticks = 25;
 
 static RecursiveSpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
@@ -56,7 +89,7 @@ static void dump_thread_list(bool = false);
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into the ready queues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -65,53 +98,56 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static Thread* take_next_from(ThreadReadyQueues& ready_queues, u32 affinity_mask)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
+    auto priority_mask = ready_queues.mask;
+    while (priority_mask != 0) {
+        auto priority = bit_scan_forward(priority_mask);
+        VERIFY(priority > 0);
+        auto& ready_queue = ready_queues.queues[--priority];
+        for (auto& thread : ready_queue.thread_list) {
+            VERIFY(thread.m_runnable_priority == (int)priority);
+            if (thread.is_active())
+                continue;
+            if (!(thread.affinity() & affinity_mask))
+                continue;
+            thread.m_runnable_priority = -1;
+            ready_queue.thread_list.remove(thread);
+            if (ready_queue.thread_list.is_empty())
+                ready_queues.mask &= ~(1u << priority);
+            return &thread;
         }
+        priority_mask &= ~(1u << priority);
+    }
+    return nullptr;
+}
 
-        auto* idle_thread = Processor::idle_thread();
-        idle_thread->set_active(true);
-        return *idle_thread;
-    });
+static void append_to(ThreadReadyQueues& ready_queues, Thread& thread, u32 cpu, u32 priority)
+{
+    VERIFY(thread.m_runnable_priority < 0);
+    thread.m_runnable_priority = (int)priority;
+    thread.m_runnable_processor.store(cpu, AK::MemoryOrder::memory_order_relaxed);
+    VERIFY(!thread.m_ready_queue_node.is_in_list());
+    auto& ready_queue = ready_queues.queues[priority];
+    bool was_empty = ready_queue.thread_list.is_empty();
+    ready_queue.thread_list.append(thread);
+    if (was_empty)
+        ready_queues.mask |= (1u << priority);
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+Thread* ProcessorReadyQueues::take_next(u32 affinity_mask)
 {
-    auto affinity_mask = 1u << Processor::current_id();
+    return ready_queues.with([&](auto& ready_queues) {
+        auto* thread = take_next_from(ready_queues, affinity_mask);
+        if (thread)
+            runnable_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+        return thread;
+    });
+}
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
+Thread* ProcessorReadyQueues::peek_next(u32 affinity_mask)
+{
+    return ready_queues.with([&](auto& ready_queues) -> Thread* {
         auto priority_mask = ready_queues.mask;
         while (priority_mask != 0) {
             auto priority = bit_scan_forward(priority_mask);
@@ -127,56 +163,219 @@ Thread* Scheduler::peek_next_runnable_thread()
             }
             priority_mask &= ~(1u << priority);
         }
-
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
         return nullptr;
     });
 }
 
-bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
+void ProcessorReadyQueues::append(Thread& thread, u32 cpu, u32 priority)
 {
-    if (thread.is_idle_thread())
-        return true;
+    ready_queues.with([&](auto& ready_queues) {
+        append_to(ready_queues, thread, cpu, priority);
+        runnable_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    });
+}
+
+Optional<bool> ProcessorReadyQueues::remove(Thread& thread, u32 cpu)
+{
+    return ready_queues.with([&](auto& ready_queues) -> Optional<bool> {
+        // m_runnable_processor only changes while holding the lock of the processor the thread is queued on.
+        if (thread.m_runnable_processor.load(AK::MemoryOrder::memory_order_relaxed) != cpu)
+            return {};
 
-    return g_ready_queues->with([&](auto& ready_queues) {
         auto priority = thread.m_runnable_priority;
         if (priority < 0) {
             VERIFY(!thread.m_ready_queue_node.is_in_list());
             return false;
         }
 
-        if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
-            return false;
-
         VERIFY(ready_queues.mask & (1u << priority));
         auto& ready_queue = ready_queues.queues[priority];
         thread.m_runnable_priority = -1;
         ready_queue.thread_list.remove(thread);
         if (ready_queue.thread_list.is_empty())
             ready_queues.mask &= ~(1u << priority);
+        runnable_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
         return true;
     });
 }
 
+// Moves up to `count` threads that may run on `to_cpu` from the ready queues of `from_cpu` to those of `to_cpu`.
+// Both sets of queues stay locked during the move (always in processor order, to avoid deadlocks), so that a
+// migrating thread is always queued on exactly one processor.
+static u32 migrate_runnable_threads(u32 from_cpu, u32 to_cpu, u32 count)
+{
+    VERIFY(from_cpu != to_cpu);
+    auto& from_queues = s_processor_ready_queues->at(from_cpu);
+    auto& to_queues = s_processor_ready_queues->at(to_cpu);
+    auto& first_queues = from_cpu < to_cpu ? from_queues : to_queues;
+    auto& second_queues = from_cpu < to_cpu ? to_queues : from_queues;
+
+    return first_queues.ready_queues.with([&](auto& first_ready_queues) {
+        return second_queues.ready_queues.with([&](auto& second_ready_queues) {
+            auto& from_ready_queues = from_cpu < to_cpu ? first_ready_queues : second_ready_queues;
+            auto& to_ready_queues = from_cpu < to_cpu ? second_ready_queues : first_ready_queues;
+
+            u32 moved = 0;
+            for (; moved < count; ++moved) {
+                auto* thread = take_next_from(from_ready_queues, 1u << to_cpu);
+                if (!thread)
+                    break;
+                dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Migrating {} from processor {}", to_cpu, *thread, from_cpu);
+                append_to(to_ready_queues, *thread, to_cpu, thread_priority_to_priority_index(thread->priority()));
+            }
+            from_queues.runnable_count.fetch_sub(moved, AK::MemoryOrder::memory_order_relaxed);
+            to_queues.runnable_count.fetch_add(moved, AK::MemoryOrder::memory_order_relaxed);
+            return moved;
+        });
+    });
+}
+
+static Optional<u32> find_busiest_processor(u32 candidate_mask)
+{
+    Optional<u32> busiest_cpu;
+    u32 busiest_count = 0;
+    while (candidate_mask != 0) {
+        u32 cpu = bit_scan_forward(candidate_mask) - 1;
+        candidate_mask &= ~(1u << cpu);
+        auto count = s_processor_ready_queues->at(cpu).runnable_count.load(AK::MemoryOrder::memory_order_relaxed);
+        if (count > busiest_count) {
+            busiest_cpu = cpu;
+            busiest_count = count;
+        }
+    }
+    return busiest_cpu;
+}
+
+// Looks for a thread that may run on `cpu` in the ready queues of the other processors, starting with the busiest
+// one. `pick` is either take_next, to steal the thread, or peek_next, to only check whether there is one.
+static Thread* find_thread_to_steal(u32 cpu, Thread* (ProcessorReadyQueues::*pick)(u32 affinity_mask))
+{
+    // If none of the busiest processor's threads may run on this processor, move on to the next busiest one.
+    auto candidate_mask = s_online_processor_mask.load(AK::MemoryOrder::memory_order_relaxed) & ~(1u << cpu);
+    while (candidate_mask != 0) {
+        auto busiest_cpu = find_busiest_processor(candidate_mask);
+        if (!busiest_cpu.has_value())
+            return nullptr;
+        if (auto* thread = (s_processor_ready_queues->at(*busiest_cpu).*pick)(1u << cpu)) {
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Found {} on processor {}", cpu, *thread, *busiest_cpu);
+            return thread;
+        }
+        candidate_mask &= ~(1u << *busiest_cpu);
+    }
+    return nullptr;
+}
+
+static u32 select_processor_for(Thread const& thread)
+{
+    auto current_id = Processor::current_id();
+    auto candidate_mask = thread.affinity() & s_online_processor_mask.load(AK::MemoryOrder::memory_order_relaxed);
+    if (candidate_mask == 0)
+        return current_id;
+
+    // Prefer the processor the thread last ran on, as its caches are likely still warm,
+    // unless that processor is noticeably busier than this one.
+    auto last_cpu = thread.cpu();
+    bool can_run_here = (candidate_mask & (1u << current_id)) != 0;
+    if (candidate_mask & (1u << last_cpu)) {
+        if (!can_run_here || last_cpu == current_id)
+            return last_cpu;
+        auto last_cpu_count = s_processor_ready_queues->at(last_cpu).runnable_count.load(AK::MemoryOrder::memory_order_relaxed);
+        auto current_count = s_processor_ready_queues->at(current_id).runnable_count.load(AK::MemoryOrder::memory_order_relaxed);
+        if (last_cpu_count <= current_count + 1)
+            return last_cpu;
+    }
+
+    if (can_run_here)
+        return current_id;
+    return bit_scan_forward(candidate_mask) - 1;
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    auto current_id = Processor::current_id();
+
+    auto* thread = s_processor_ready_queues->at(current_id).take_next(1u << current_id);
+    if (!thread)
+        thread = find_thread_to_steal(current_id, &ProcessorReadyQueues::take_next);
+    if (!thread)
+        thread = Processor::idle_thread();
+
+    // Mark it as active because we are using this thread. This is similar
+    // to comparing it with Processor::current_thread, but when there are
+    // multiple processors there's no easy way to check whether the thread
+    // is actually still needed. This prevents accidental finalization when
+    // a thread is no longer in Running state, but running on another core.
+
+    // We need to mark it active here so that this thread won't be
+    // scheduled on another core if it were to be queued before actually
+    // switching to it.
+    // FIXME: Figure out a better way maybe?
+    thread->set_active(true);
+    return *thread;
+}
+
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled on this processor, including the ones it would steal.
+    auto current_id = Processor::current_id();
+    if (auto* thread = s_processor_ready_queues->at(current_id).peek_next(1u << current_id))
+        return thread;
+    return find_thread_to_steal(current_id, &ProcessorReadyQueues::peek_next);
+}
+
+bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
+{
+    if (thread.is_idle_thread())
+        return true;
+
+    if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
+        return false;
+
+    // The thread might be migrated to another processor by balance_load() while we are looking for it.
+    for (;;) {
+        auto cpu = thread.m_runnable_processor.load(AK::MemoryOrder::memory_order_relaxed);
+        if (auto result = s_processor_ready_queues->at(cpu).remove(thread, cpu); result.has_value())
+            return *result;
+    }
+}
+
 void Scheduler::enqueue_runnable_thread(Thread& thread)
 {
-    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
     auto priority = thread_priority_to_priority_index(thread.priority());
+    auto cpu = select_processor_for(thread);
+    s_processor_ready_queues->at(cpu).append(thread, cpu, priority);
 
-    g_ready_queues->with([&](auto& ready_queues) {
-        VERIFY(thread.m_runnable_priority < 0);
-        thread.m_runnable_priority = (int)priority;
-        VERIFY(!thread.m_ready_queue_node.is_in_list());
-        auto& ready_queue = ready_queues.queues[priority];
-        bool was_empty = ready_queue.thread_list.is_empty();
-        ready_queue.thread_list.append(thread);
-        if (was_empty)
-            ready_queues.mask |= (1u << priority);
-    });
+    // An idle processor only looks at its queues again on its next tick, unless we wake it up.
+    // If the chosen one is busy, another idle processor might steal the thread instead.
+    if (!Processor::smp_wake_idle_processor(cpu))
+        Processor::smp_wake_n_idle_processors(1);
+}
+
+void Scheduler::balance_load()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+
+    auto current_id = Processor::current_id();
+    auto online_mask = s_online_processor_mask.load(AK::MemoryOrder::memory_order_relaxed);
+    if (popcount(online_mask) < 2)
+        return;
+
+    // This only moves threads between ready queues, which doesn't need the scheduler lock.
+    auto busiest_cpu = find_busiest_processor(online_mask & ~(1u << current_id));
+    if (!busiest_cpu.has_value())
+        return;
+
+    auto local_count = s_processor_ready_queues->at(current_id).runnable_count.load(AK::MemoryOrder::memory_order_relaxed);
+    auto busiest_count = s_processor_ready_queues->at(*busiest_cpu).runnable_count.load(AK::MemoryOrder::memory_order_relaxed);
+    if (busiest_count <= local_count + 1)
+        return;
+
+    // Pull over half of the difference, so that both processors end up with a similar amount of work.
+    migrate_runnable_threads(*busiest_cpu, current_id, (busiest_count - local_count) / 2);
 }
 
 UNMAP_AFTER_INIT void Scheduler::start()
@@ -341,6 +540,9 @@ void Scheduler::enter_current(Thread& prev_thread)
     auto* current_thread = Thread::current();
     current_thread->update_time_scheduled(scheduler_time, true, false);
 
+    if (auto counter_values = update_performance_counters_on_current_processor(); counter_values.has_value())
+        prev_thread.add_performance_counter_values(*counter_values);
+
     // NOTE: When doing an exec(), we will context switch from and to the same thread!
     //       In that case, we must not mark the previous thread as inactive.
     if (&prev_thread != current_thread)
@@ -416,6 +618,7 @@ UNMAP_AFTER_INIT void Scheduler::set_idle_thread(Thread* idle_thread)
     idle_thread->set_idle_thread();
     Processor::current().set_idle_thread(*idle_thread);
     Processor::set_current_thread(*idle_thread);
+    s_online_processor_mask.fetch_or(1u << Processor::current_id(), AK::MemoryOrder::memory_order_relaxed);
 }
 
 UNMAP_AFTER_INIT Thread* Scheduler::create_ap_idle_thread(u32 cpu)
@@ -466,6 +669,14 @@ void Scheduler::timer_tick()
         return;
     }
 
+    auto& processor_queues = s_processor_ready_queues->at(Processor::current_id());
+    if (processor_queues.ticks_until_load_balance > 0) {
+        --processor_queues.ticks_until_load_balance;
+    } else {
+        processor_queues.ticks_until_load_balance = load_balance_interval_in_ticks;
+        balance_load();
+    }
+
     if (current_thread->tick())
         return;
 
@@ -552,7 +763,14 @@ TotalTimeScheduled Scheduler::get_total_time_scheduled()
 
 void dump_thread_list(bool with_stack_traces)
 {
-    dbgln("Scheduler thread list for processor {}:", Processor::current_id());
+    dmesgln("Scheduler thread list for processor {}:", Processor::current_id());
+
+    auto online_mask = s_online_processor_mask.load(AK::MemoryOrder::memory_order_relaxed);
+    while (online_mask != 0) {
+        u32 cpu = bit_scan_forward(online_mask) - 1;
+        online_mask &= ~(1u << cpu);
+        dmesgln("  Processor {} has {} runnable threads queued", cpu, s_processor_ready_queues->at(cpu).runnable_count.load(AK::MemoryOrder::memory_order_relaxed));
+    }
 
     auto get_pc = [](Thread& thread) -> FlatPtr {
         if (!thread.current_trap())
@@ -118,7 +118,7 @@ Thread::BlockResult Thread::block_impl(BlockTimeout const& timeout, Blocker& blo
     // Don't let signals unblock threads that are blocked inside a page fault handler.
     // This prevents threads from EINTR'ing the inode read in an inode page fault.
     // FIXME: There's probably a better way to solve this.
-    if (has_unmasked_pending_signals() && !is_handling_page_fault())
+    if (has_unmasked_pending_signals() && blocker.can_be_interrupted() && !is_handling_page_fault())
         return BlockResult::InterruptedBySignal;
 
     SpinlockLocker block_lock(m_block_lock);
@@ -1230,7 +1230,6 @@ void Thread::set_state(State new_state, u8 stop_signal)
 
     if (m_state == Thread::State::Runnable) {
         Scheduler::enqueue_runnable_thread(*this);
-        Processor::smp_wake_n_idle_processors(1);
     } else if (m_state == Thread::State::Stopped) {
         if (previous_state != Thread::State::Running)
             PANIC("Attempting to stop with invalid thread state - {}", state_string(previous_state));
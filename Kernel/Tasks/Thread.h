@@ -21,6 +21,7 @@
 #include <Kernel/API/POSIX/select.h>
 #include <Kernel/API/POSIX/signal_numbers.h>
 #include <Kernel/Arch/ArchSpecificThreadData.h>
+#include <Kernel/Arch/PerformanceCounters.h>
 #include <Kernel/Arch/RegisterState.h>
 #include <Kernel/Arch/ThreadRegisters.h>
 #include <Kernel/Debug.h>
@@ -64,6 +65,7 @@ class Thread
     friend class Process;
     friend class Scheduler;
     friend struct ThreadReadyQueue;
+    friend struct ProcessorReadyQueues;
 
 public:
     static Thread* current()
@@ -444,11 +446,17 @@ public:
 
     class DeprecatedWaitQueueBlocker final : public Blocker {
     public:
-        explicit DeprecatedWaitQueueBlocker(DeprecatedWaitQueue&, StringView block_reason = {});
+        enum class Interruptible {
+            No,
+            Yes,
+        };
+
+        explicit DeprecatedWaitQueueBlocker(DeprecatedWaitQueue&, StringView block_reason = {}, Interruptible = Interruptible::Yes);
         virtual ~DeprecatedWaitQueueBlocker();
 
         virtual Type blocker_type() const override { return Type::Queue; }
         virtual StringView state_string() const override { return m_block_reason.is_null() ? m_block_reason : "Queue"sv; }
+        virtual bool can_be_interrupted() const override { return m_interruptible == Interruptible::Yes; }
         virtual void will_unblock_immediately_without_blocking(UnblockImmediatelyReason) override { }
         virtual bool setup_blocker() override;
 
@@ -457,6 +465,7 @@ public:
     protected:
         DeprecatedWaitQueue& m_wait_queue;
         StringView m_block_reason;
+        Interruptible const m_interruptible { Interruptible::Yes };
         bool m_did_unblock { false };
     };
 
@@ -989,6 +998,14 @@ public:
     u64 time_in_user() const { return m_total_time_scheduled_user.load(AK::MemoryOrder::memory_order_relaxed); }
     u64 time_in_kernel() const { return m_total_time_scheduled_kernel.load(AK::MemoryOrder::memory_order_relaxed); }
 
+    // How much each hardware performance counter advanced while this thread was running, as far as counting was enabled.
+    PerformanceCounterValues const& performance_counter_totals() const { return m_performance_counter_totals; }
+    void add_performance_counter_values(PerformanceCounterValues const& values)
+    {
+        for (size_t i = 0; i < performance_counter_count; ++i)
+            m_performance_counter_totals[i] += values[i];
+    }
+
     ExecutionMode previous_mode() const { return m_previous_mode; }
     bool set_previous_mode(ExecutionMode mode)
     {
@@ -1100,6 +1117,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    Atomic<u32> m_runnable_processor { 0 };
 
     friend class DeprecatedWaitQueue;
 
@@ -1177,6 +1195,7 @@ private:
     Optional<u64> m_last_time_scheduled;
     Atomic<u64> m_total_time_scheduled_user { 0 };
     Atomic<u64> m_total_time_scheduled_kernel { 0 };
+    PerformanceCounterValues m_performance_counter_totals {};
     u32 m_ticks_left { 0 };
     u32 m_times_scheduled { 0 };
     u32 m_ticks_in_user { 0 };
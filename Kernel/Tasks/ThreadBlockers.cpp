@@ -120,9 +120,10 @@ bool Thread::JoinBlocker::unblock(void* value, bool from_add_blocker)
     return true;
 }
 
-Thread::DeprecatedWaitQueueBlocker::DeprecatedWaitQueueBlocker(DeprecatedWaitQueue& wait_queue, StringView block_reason)
+Thread::DeprecatedWaitQueueBlocker::DeprecatedWaitQueueBlocker(DeprecatedWaitQueue& wait_queue, StringView block_reason, Interruptible interruptible)
     : m_wait_queue(wait_queue)
     , m_block_reason(block_reason)
+    , m_interruptible(interruptible)
 {
 }
 
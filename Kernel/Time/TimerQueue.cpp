@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/Singleton.h>
 #include <AK/Time.h>
 #include <Kernel/Sections.h>
@@ -53,9 +54,10 @@ TimerQueue& TimerQueue::the()
 UNMAP_AFTER_INIT TimerQueue::TimerQueue()
 {
     m_ticks_per_second = TimeManagement::the().ticks_per_second();
+    m_nanoseconds_per_tick = max<u64>(1'000'000'000 / m_ticks_per_second, 1);
 }
 
-bool TimerQueue::add_timer_without_id(NonnullRefPtr<Timer> timer, clockid_t clock_id, Duration const& deadline, Function<void()>&& callback)
+bool TimerQueue::add_timer_without_id(NonnullRefPtr<Timer> timer, clockid_t clock_id, Duration const& deadline, Function<void()>&& callback, Duration const& slack)
 {
     if (deadline <= TimeManagement::the().current_time(clock_id))
         return false;
@@ -65,7 +67,7 @@ bool TimerQueue::add_timer_without_id(NonnullRefPtr<Timer> timer, clockid_t cloc
     // *must* be a RefPtr<Timer>. Otherwise, calling cancel_timer() could
     // inadvertently cancel another timer that has been created between
     // returning from the timer handler and a call to cancel_timer().
-    timer->setup(clock_id, deadline, move(callback));
+    timer->setup(clock_id, deadline, move(callback), slack);
 
     SpinlockLocker lock(g_timerqueue_lock);
     timer->m_id = 0; // Don't generate a timer id
@@ -86,31 +88,104 @@ TimerId TimerQueue::add_timer(NonnullRefPtr<Timer>&& timer)
 
 void TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
 {
-    Duration timer_expiration = timer->m_expires;
-
     timer->clear_cancelled();
     timer->clear_callback_finished();
     timer->set_in_use();
 
     auto& queue = queue_for_timer(*timer);
-    if (queue.list.is_empty()) {
-        queue.list.append(timer.leak_ref());
-        queue.next_timer_due = timer_expiration;
-    } else {
-        Timer* following_timer = nullptr;
-        for (auto& t : queue.list) {
-            if (t.m_expires > timer_expiration) {
-                following_timer = &t;
+    if (queue.timer_count == 0)
+        queue.current_tick = tick_at(TimeManagement::the().current_time(queue.clock_id));
+
+    // The first tick that starts after the deadline.
+    auto expiry_tick = tick_at(timer->m_expires) + 1;
+    if (auto slack_ticks = tick_at(timer->m_slack); slack_ticks > 0) {
+        // Round up to a multiple of the largest power of two the slack allows, so timers with similar deadlines end
+        // up in the same slot and get to fire together.
+        u64 granularity = 1ull << (63 - count_leading_zeroes(slack_ticks + 1));
+        expiry_tick = align_up_to(expiry_tick, granularity);
+    }
+    timer->m_expiry_tick = expiry_tick;
+
+    ++queue.timer_count;
+    file_timer_locked(queue, *timer.leak_ref());
+}
+
+void TimerQueue::file_timer_locked(Queue& queue, Timer& timer)
+{
+    auto file_into = [&](Timer::List& list) {
+        list.append(timer);
+        timer.m_list = &list;
+    };
+
+    if (timer.m_expiry_tick <= queue.current_tick) {
+        file_into(queue.near_timers);
+        return;
+    }
+
+    // A timer goes into the level of the highest digit in which its tick differs from the current one, so the
+    // wheel reaches its slot exactly when all the higher digits match.
+    auto differing_bits = timer.m_expiry_tick ^ queue.current_tick;
+    auto level = (63 - count_leading_zeroes(differing_bits)) / wheel_slot_bits;
+    if (level >= wheel_level_count) {
+        file_into(queue.far_timers);
+        return;
+    }
+    auto slot = (timer.m_expiry_tick >> (level * wheel_slot_bits)) % wheel_slot_count;
+    file_into(queue.wheel[level][slot]);
+}
+
+void TimerQueue::refile_timers_locked(Queue& queue, Timer::List& list)
+{
+    while (auto* timer = list.take_first())
+        file_timer_locked(queue, *timer);
+}
+
+void TimerQueue::advance_wheel_locked(Queue& queue, u64 tick)
+{
+    // If the clock jumped (e.g. because the real time was changed), walking the wheel tick by tick would take too
+    // long or even go backwards, so file every timer again instead. Those that are now in the past become near timers.
+    if (tick < queue.current_tick || tick - queue.current_tick > wheel_slot_count) {
+        queue.current_tick = tick;
+        Timer::List timers;
+        auto take_all = [&](Timer::List& list) {
+            while (auto* timer = list.take_first())
+                timers.append(*timer);
+        };
+        for (auto& level : queue.wheel) {
+            for (auto& slot : level)
+                take_all(slot);
+        }
+        take_all(queue.near_timers);
+        take_all(queue.far_timers);
+        refile_timers_locked(queue, timers);
+        return;
+    }
+
+    while (queue.current_tick < tick) {
+        ++queue.current_tick;
+        for (size_t level = 1; level < wheel_level_count; ++level) {
+            auto shift = level * wheel_slot_bits;
+            if ((queue.current_tick & ((1ull << shift) - 1)) != 0)
                 break;
-            }
+            refile_timers_locked(queue, queue.wheel[level][(queue.current_tick >> shift) % wheel_slot_count]);
         }
-        if (following_timer) {
-            bool next_timer_needs_update = queue.list.first() == following_timer;
-            queue.list.insert_before(*following_timer, timer.leak_ref());
-            if (next_timer_needs_update)
-                queue.next_timer_due = timer_expiration;
-        } else {
-            queue.list.append(timer.leak_ref());
+        if ((queue.current_tick & ((1ull << (wheel_level_count * wheel_slot_bits)) - 1)) == 0)
+            refile_timers_locked(queue, queue.far_timers);
+        refile_timers_locked(queue, queue.wheel[0][queue.current_tick % wheel_slot_count]);
+    }
+}
+
+void TimerQueue::collect_due_timers_locked(Queue& queue)
+{
+    // Near timers are compared against their own clock, so they never fire early, even if it runs behind the one
+    // driving the wheel.
+    for (auto it = queue.near_timers.begin(); it != queue.near_timers.end();) {
+        auto& timer = *it;
+        ++it;
+        if (timer.now(true) > timer.m_expires) {
+            queue.near_timers.remove(timer);
+            queue.due_timers.append(timer);
+            timer.m_list = &queue.due_timers;
         }
     }
 }
@@ -133,8 +208,9 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
         timer.clear_in_use();
 
         SpinlockLocker lock(g_timerqueue_lock);
-        if (timer_queue.list.contains(timer)) {
+        if (timer.m_list != &m_timers_executing) {
             // The timer has not fired, remove it
+            VERIFY(timer.m_list);
             VERIFY(timer.ref_count() > 1);
             remove_timer_locked(timer_queue, timer);
             return true;
@@ -145,8 +221,8 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
         // and we don't need to spin. It still holds a reference
         // that will be dropped when it does get a chance to run,
         // but since we called set_cancelled it will only drop its reference
-        VERIFY(m_timers_executing.contains(timer));
         m_timers_executing.remove(timer);
+        timer.m_list = nullptr;
         return true;
     }
 
@@ -160,14 +236,13 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
 
 void TimerQueue::remove_timer_locked(Queue& queue, Timer& timer)
 {
-    bool was_next_timer = (queue.list.first() == &timer);
-    queue.list.remove(timer);
+    timer.m_list->remove(timer);
+    timer.m_list = nullptr;
+    --queue.timer_count;
     auto now = timer.now(false);
     if (timer.m_expires > now)
         timer.m_remaining = timer.m_expires - now;
 
-    if (was_next_timer)
-        update_next_timer_due(queue);
     // Whenever we remove a timer that was still queued (but hasn't been
     // fired) we added a reference to it. So, when removing it from the
     // queue we need to drop that reference.
@@ -179,16 +254,18 @@ void TimerQueue::fire()
     SpinlockLocker lock(g_timerqueue_lock);
 
     auto fire_timers = [&](Queue& queue) {
-        auto* timer = queue.list.first();
-        VERIFY(timer);
-        VERIFY(queue.next_timer_due == timer->m_expires);
-
-        while (timer && timer->now(true) > timer->m_expires) {
-            queue.list.remove(*timer);
+        auto tick = tick_at(TimeManagement::the().current_time(queue.clock_id));
+        if (queue.timer_count == 0) {
+            queue.current_tick = tick;
+            return;
+        }
+        advance_wheel_locked(queue, tick);
+        collect_due_timers_locked(queue);
 
+        while (auto* timer = queue.due_timers.take_first()) {
+            --queue.timer_count;
             m_timers_executing.append(*timer);
-
-            update_next_timer_due(queue);
+            timer->m_list = &m_timers_executing;
 
             lock.unlock();
 
@@ -201,6 +278,7 @@ void TimerQueue::fire()
                     timer->m_callback();
                     SpinlockLocker lock(g_timerqueue_lock);
                     m_timers_executing.remove(*timer);
+                    timer->m_list = nullptr;
                 }
                 timer->clear_in_use();
                 timer->set_callback_finished();
@@ -209,24 +287,11 @@ void TimerQueue::fire()
             });
 
             lock.lock();
-            timer = queue.list.first();
         }
     };
 
-    if (!m_timer_queue_monotonic.list.is_empty())
-        fire_timers(m_timer_queue_monotonic);
-    if (!m_timer_queue_realtime.list.is_empty())
-        fire_timers(m_timer_queue_realtime);
-}
-
-void TimerQueue::update_next_timer_due(Queue& queue)
-{
-    VERIFY(g_timerqueue_lock.is_locked());
-
-    if (auto* next_timer = queue.list.first())
-        queue.next_timer_due = next_timer->m_expires;
-    else
-        queue.next_timer_due = {};
+    fire_timers(m_timer_queue_monotonic);
+    fire_timers(m_timer_queue_realtime);
 }
 
 }
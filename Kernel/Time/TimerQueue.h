@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
@@ -22,11 +23,12 @@ class Timer final : public AtomicRefCounted<Timer> {
     friend class TimerQueue;
 
 public:
-    void setup(clockid_t clock_id, Duration expires, Function<void()>&& callback)
+    void setup(clockid_t clock_id, Duration expires, Function<void()>&& callback, Duration slack = {})
     {
         VERIFY(!is_queued());
         m_clock_id = clock_id;
         m_expires = expires;
+        m_slack = slack;
         m_callback = move(callback);
     }
 
@@ -41,6 +43,10 @@ private:
     TimerId m_id;
     clockid_t m_clock_id;
     Duration m_expires;
+    // How much later than m_expires the timer may fire, so it can share a wakeup with other timers.
+    Duration m_slack {};
+    // The tick of the timing wheel at which this timer fires.
+    u64 m_expiry_tick { 0 };
     Duration m_remaining {};
     Function<void()> m_callback;
     Atomic<bool> m_cancelled { false };
@@ -78,6 +84,10 @@ private:
 public:
     IntrusiveListNode<Timer> m_list_node;
     using List = IntrusiveList<&Timer::m_list_node>;
+
+private:
+    // The list this timer is on, so cancelling it doesn't have to search for it.
+    List* m_list { nullptr };
 };
 
 class TimerQueue {
@@ -88,18 +98,43 @@ public:
     static TimerQueue& the();
 
     TimerId add_timer(NonnullRefPtr<Timer>&&);
-    bool add_timer_without_id(NonnullRefPtr<Timer>, clockid_t, Duration const&, Function<void()>&&);
+    bool add_timer_without_id(NonnullRefPtr<Timer>, clockid_t, Duration const&, Function<void()>&&, Duration const& slack = {});
     bool cancel_timer(Timer& timer, bool* was_in_use = nullptr);
     void fire();
 
 private:
+    // Timers are kept in a hierarchical timing wheel, so adding and cancelling them takes the same time no matter how
+    // many of them are queued. Each level has wheel_slot_count slots, each of which covers wheel_slot_count times as
+    // many ticks as one slot of the level below. Once the wheel reaches a slot on a higher level, its timers are filed
+    // again into the finer levels below, until they end up in a slot of the lowest level and fire when it comes up.
+    static constexpr size_t wheel_slot_bits = 6;
+    static constexpr size_t wheel_slot_count = 1 << wheel_slot_bits;
+    static constexpr size_t wheel_level_count = 5;
+
     struct Queue {
-        Timer::List list;
-        Duration next_timer_due {};
+        clockid_t clock_id;
+        Array<Array<Timer::List, wheel_slot_count>, wheel_level_count> wheel {};
+        // Timers whose tick has already come up, but that aren't due yet according to their own clock.
+        Timer::List near_timers {};
+        // Timers too far out to fit into the wheel, which are filed again every time its top level wraps around.
+        Timer::List far_timers {};
+        // Timers that are due and are about to be handed off to a deferred call.
+        Timer::List due_timers {};
+        u64 current_tick { 0 };
+        size_t timer_count { 0 };
     };
     void remove_timer_locked(Queue&, Timer&);
-    void update_next_timer_due(Queue&);
     void add_timer_locked(NonnullRefPtr<Timer>);
+    void file_timer_locked(Queue&, Timer&);
+    void refile_timers_locked(Queue&, Timer::List&);
+    void advance_wheel_locked(Queue&, u64 tick);
+    void collect_due_timers_locked(Queue&);
+
+    u64 tick_at(Duration const& time) const
+    {
+        auto nanoseconds = time.to_nanoseconds();
+        return nanoseconds > 0 ? static_cast<u64>(nanoseconds) / m_nanoseconds_per_tick : 0;
+    }
 
     Queue& queue_for_timer(Timer& timer)
     {
@@ -118,8 +153,9 @@ private:
 
     u64 m_timer_id_count { 0 };
     u64 m_ticks_per_second { 0 };
-    Queue m_timer_queue_monotonic;
-    Queue m_timer_queue_realtime;
+    u64 m_nanoseconds_per_tick { 0 };
+    Queue m_timer_queue_monotonic { CLOCK_MONOTONIC_COARSE };
+    Queue m_timer_queue_realtime { CLOCK_REALTIME_COARSE };
     Timer::List m_timers_executing;
 };
 
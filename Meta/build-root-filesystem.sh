@@ -119,6 +119,19 @@ if [ -f mnt/usr/Tests/Kernel/TestExt2FS ]; then
     chown 0:0 mnt/usr/Tests/Kernel/TestExt2FS
     chmod 4755 mnt/usr/Tests/Kernel/TestExt2FS
 fi
+# TestExt2FS mounts a copy of this image, as the extent tree code isn't used on the root file system.
+# It needs enough inodes for the large directory test.
+if [ -f mnt/usr/Tests/Kernel/TestExt2FS ]; then
+    if command -v mke2fs >/dev/null; then
+        rm -f mnt/usr/Tests/Kernel/ext2-extents.img
+        dd if=/dev/zero of=mnt/usr/Tests/Kernel/ext2-extents.img bs=1M count=8 2>/dev/null
+        mke2fs -q -F -t ext2 -b 1024 -N 4096 -O extents mnt/usr/Tests/Kernel/ext2-extents.img || die "couldn't create the extents test image"
+        chown 0:0 mnt/usr/Tests/Kernel/ext2-extents.img
+        chmod 0644 mnt/usr/Tests/Kernel/ext2-extents.img
+    else
+        echo "warning: mke2fs is missing, TestExt2FS will skip the extents tests"
+    fi
+fi
 if [ -f mnt/usr/Tests/Kernel/TestMemoryDeviceMmap ]; then
     chown 0:0 mnt/usr/Tests/Kernel/TestMemoryDeviceMmap
     chmod 4755 mnt/usr/Tests/Kernel/TestMemoryDeviceMmap
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Time.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <sys/epoll.h>
+
+static void add_watch(int epoll_fd, int fd, u32 events, u64 data)
+{
+    epoll_event event {};
+    event.events = events;
+    event.data.u64 = data;
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event));
+}
+
+static size_t wait(int epoll_fd, Span<epoll_event> events, int timeout = 0)
+{
+    return MUST(Core::System::epoll_wait(epoll_fd, events, timeout));
+}
+
+TEST_CASE(level_triggered_pipe)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(EPOLL_CLOEXEC));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    add_watch(epoll_fd, pipe_fds[0], EPOLLIN, 42);
+
+    Array<epoll_event, 4> events;
+    EXPECT_EQ(wait(epoll_fd, events), 0u);
+
+    MUST(Core::System::write(pipe_fds[1], "hi"sv.bytes()));
+    // Level-triggered watches are reported for as long as the data hasn't been read.
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(wait(epoll_fd, events), 1u);
+        EXPECT_EQ(events[0].events, static_cast<u32>(EPOLLIN));
+        EXPECT_EQ(events[0].data.u64, 42u);
+    }
+
+    u8 buffer[2];
+    MUST(Core::System::read(pipe_fds[0], { buffer, sizeof(buffer) }));
+    EXPECT_EQ(wait(epoll_fd, events), 0u);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(edge_triggered_pipe)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    add_watch(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLET, 1);
+
+    Array<epoll_event, 4> events;
+    MUST(Core::System::write(pipe_fds[1], "a"sv.bytes()));
+    EXPECT_EQ(wait(epoll_fd, events), 1u);
+    // The data is still there, but nothing changed since the last report.
+    EXPECT_EQ(wait(epoll_fd, events), 0u);
+
+    MUST(Core::System::write(pipe_fds[1], "b"sv.bytes()));
+    EXPECT_EQ(wait(epoll_fd, events), 1u);
+    EXPECT_EQ(events[0].data.u64, 1u);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(oneshot_is_rearmed_by_mod)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    add_watch(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLONESHOT, 7);
+
+    Array<epoll_event, 4> events;
+    MUST(Core::System::write(pipe_fds[1], "a"sv.bytes()));
+    EXPECT_EQ(wait(epoll_fd, events), 1u);
+    EXPECT_EQ(wait(epoll_fd, events), 0u);
+
+    MUST(Core::System::write(pipe_fds[1], "b"sv.bytes()));
+    EXPECT_EQ(wait(epoll_fd, events), 0u);
+
+    epoll_event event {};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.u64 = 8;
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, pipe_fds[0], &event));
+    EXPECT_EQ(wait(epoll_fd, events), 1u);
+    EXPECT_EQ(events[0].data.u64, 8u);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(ctl_errors_and_del)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    EXPECT_EQ(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, pipe_fds[0], &event).error().code(), ENOENT);
+    EXPECT_EQ(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, epoll_fd, &event).error().code(), EINVAL);
+    EXPECT_EQ(Core::System::epoll_ctl(pipe_fds[0], EPOLL_CTL_ADD, pipe_fds[1], &event).error().code(), EINVAL);
+
+    add_watch(epoll_fd, pipe_fds[0], EPOLLIN, 0);
+    EXPECT_EQ(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pipe_fds[0], &event).error().code(), EEXIST);
+
+    MUST(Core::System::write(pipe_fds[1], "a"sv.bytes()));
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr));
+    Array<epoll_event, 4> events;
+    EXPECT_EQ(wait(epoll_fd, events), 0u);
+    EXPECT_EQ(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr).error().code(), ENOENT);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(write_end_and_writer_closing)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    add_watch(epoll_fd, pipe_fds[0], EPOLLIN, 0);
+    add_watch(epoll_fd, pipe_fds[1], EPOLLOUT, 1);
+
+    Array<epoll_event, 4> events;
+    EXPECT_EQ(wait(epoll_fd, events), 1u);
+    EXPECT_EQ(events[0].events, static_cast<u32>(EPOLLOUT));
+    EXPECT_EQ(events[0].data.u64, 1u);
+
+    // Watches keep their file open, so they have to be removed before closing the fd.
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[1], nullptr));
+    MUST(Core::System::close(pipe_fds[1]));
+    // Without any writers left, the read end reports EOF.
+    EXPECT_EQ(wait(epoll_fd, events), 1u);
+    EXPECT_EQ(events[0].events, static_cast<u32>(EPOLLIN));
+    EXPECT_EQ(events[0].data.u64, 0u);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(wait_times_out)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    add_watch(epoll_fd, pipe_fds[0], EPOLLIN, 0);
+
+    Array<epoll_event, 4> events;
+    auto start = MonotonicTime::now();
+    EXPECT_EQ(wait(epoll_fd, events, 100), 0u);
+    EXPECT((MonotonicTime::now() - start).to_milliseconds() >= 90);
+
+    EXPECT_EQ(Core::System::epoll_wait(epoll_fd, events.span().trim(0), 0).error().code(), EINVAL);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
@@ -4,10 +4,17 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteString.h>
+#include <Kernel/API/Ioctl.h>
 #include <LibTest/TestCase.h>
+#include <dirent.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
 #include <sys/statvfs.h>
 #include <unistd.h>
 
@@ -106,3 +113,217 @@ TEST_CASE(test_ext2_writes_and_reads_to_block_ranges)
     write_then_read_block(doubly_indirect_blocks_capacity);
     write_then_read_block(triply_indirect_blocks_capacity - 1);
 }
+
+static void test_sparse_writes_truncate_and_fill(StringView directory)
+{
+    auto test_file_path = ByteString::formatted("{}/.ext2_test", directory);
+
+    auto fd = open(test_file_path.characters(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    VERIFY(fd != -1);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(test_file_path.characters());
+    });
+
+    struct statvfs stvfs;
+    VERIFY(fstatvfs(fd, &stvfs) != -1);
+    size_t block_size = (size_t)stvfs.f_bsize;
+
+    // Writing every other block gives the file many short runs of blocks, which don't fit into the inode
+    // when it is mapped with extents.
+    static constexpr size_t block_count = 2048;
+    char* block_buf = (char*)malloc(block_size);
+    char* read_buf = (char*)malloc(block_size);
+    auto malloc_cleanup_guard = ScopeGuard([&] {
+        free(block_buf);
+        free(read_buf);
+    });
+
+    auto write_block = [&](size_t block) {
+        memset(block_buf, 'a' + (block % 26), block_size);
+        EXPECT_EQ(pwrite(fd, block_buf, block_size, block * block_size), (ssize_t)block_size);
+    };
+    auto expect_block = [&](size_t block, bool is_hole) {
+        memset(block_buf, is_hole ? 0 : 'a' + (block % 26), block_size);
+        EXPECT_EQ(pread(fd, read_buf, block_size, block * block_size), (ssize_t)block_size);
+        EXPECT(memcmp(read_buf, block_buf, block_size) == 0);
+    };
+
+    for (size_t block = 0; block < block_count; block += 2)
+        write_block(block);
+    write_block(block_count - 1);
+    for (size_t block = 0; block < block_count; ++block)
+        expect_block(block, block % 2 && block != block_count - 1);
+
+    // Truncating in the middle of the file has to free the tail, and leave the rest untouched.
+    EXPECT_EQ(ftruncate(fd, (block_count / 2) * block_size + 1), 0);
+    struct stat st;
+    EXPECT_EQ(fstat(fd, &st), 0);
+    EXPECT_EQ(st.st_size, (off_t)((block_count / 2) * block_size + 1));
+    for (size_t block = 0; block < block_count / 2; ++block)
+        expect_block(block, block % 2);
+
+    // Filling in the holes joins the runs back together.
+    for (size_t block = 1; block < block_count / 2; block += 2)
+        write_block(block);
+    for (size_t block = 0; block < block_count / 2; ++block)
+        expect_block(block, false);
+
+    // An empty file must not keep any blocks around.
+    EXPECT_EQ(ftruncate(fd, 0), 0);
+    EXPECT_EQ(fsync(fd), 0);
+    EXPECT_EQ(fstat(fd, &st), 0);
+    EXPECT_EQ(st.st_blocks, 0);
+}
+
+TEST_CASE(test_ext2_sparse_writes_truncate_and_fill)
+{
+    test_sparse_writes_truncate_and_fill("/home/anon"sv);
+}
+
+static size_t count_directory_entries(char const* path)
+{
+    auto* directory = opendir(path);
+    VERIFY(directory);
+    size_t entry_count = 0;
+    while (auto* entry = readdir(directory)) {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+            ++entry_count;
+    }
+    closedir(directory);
+    return entry_count;
+}
+
+static void test_large_directory(StringView parent_directory)
+{
+    static constexpr size_t file_count = 2000;
+
+    auto new_parent_path = ByteString::formatted("{}/.ext2_test_new_parent", parent_directory);
+    auto directory_path = ByteString::formatted("{}/.ext2_test_directory", parent_directory);
+    auto path_of = [&](size_t i) {
+        return ByteString::formatted("{}/file-with-a-long-name-{}", directory_path, i);
+    };
+
+    EXPECT_EQ(mkdir(directory_path.characters(), 0700), 0);
+    EXPECT_EQ(mkdir(new_parent_path.characters(), 0700), 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        for (size_t i = 0; i < file_count; ++i)
+            unlink(path_of(i).characters());
+        rmdir(directory_path.characters());
+        rmdir(new_parent_path.characters());
+    });
+
+    // Enough entries to span many blocks, so the directory gets indexed if the file system supports it.
+    for (size_t i = 0; i < file_count; ++i) {
+        auto fd = open(path_of(i).characters(), O_CREAT | O_EXCL | O_WRONLY, 0600);
+        EXPECT(fd != -1);
+        close(fd);
+    }
+    EXPECT_EQ(open(path_of(0).characters(), O_CREAT | O_EXCL | O_WRONLY, 0600), -1);
+    EXPECT_EQ(errno, EEXIST);
+
+    struct stat st;
+    for (size_t i = 0; i < file_count; ++i)
+        EXPECT_EQ(stat(path_of(i).characters(), &st), 0);
+    EXPECT_EQ(stat(path_of(file_count).characters(), &st), -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    for (size_t i = 0; i < file_count; i += 2)
+        EXPECT_EQ(unlink(path_of(i).characters()), 0);
+    for (size_t i = 0; i < file_count; ++i)
+        EXPECT_EQ(stat(path_of(i).characters(), &st), i % 2 ? 0 : -1);
+    EXPECT_EQ(count_directory_entries(directory_path.characters()), file_count / 2);
+
+    // ".." still has to lead back out after the directory was indexed.
+    struct stat parent_st;
+    EXPECT_EQ(stat(ByteString::formatted("{}/..", directory_path).characters(), &st), 0);
+    EXPECT_EQ(stat(ByteString { parent_directory }.characters(), &parent_st), 0);
+    EXPECT(S_ISDIR(st.st_mode));
+    EXPECT_EQ(st.st_ino, parent_st.st_ino);
+
+    // Moving the indexed directory to another parent has to update its ".." entry.
+    auto moved_directory_path = ByteString::formatted("{}/moved", new_parent_path);
+    EXPECT_EQ(rename(directory_path.characters(), moved_directory_path.characters()), 0);
+    directory_path = moved_directory_path;
+    EXPECT_EQ(stat(ByteString::formatted("{}/..", directory_path).characters(), &st), 0);
+    EXPECT_EQ(stat(new_parent_path.characters(), &parent_st), 0);
+    EXPECT_EQ(st.st_ino, parent_st.st_ino);
+    for (size_t i = 0; i < file_count; ++i)
+        EXPECT_EQ(stat(path_of(i).characters(), &st), i % 2 ? 0 : -1);
+
+    // An emptied indexed directory can be removed, and so can its new parent once it's gone.
+    for (size_t i = 1; i < file_count; i += 2)
+        EXPECT_EQ(unlink(path_of(i).characters()), 0);
+    EXPECT_EQ(count_directory_entries(directory_path.characters()), 0u);
+    EXPECT_EQ(rmdir(directory_path.characters()), 0);
+    EXPECT_EQ(stat(directory_path.characters(), &st), -1);
+    EXPECT_EQ(errno, ENOENT);
+    EXPECT_EQ(rmdir(new_parent_path.characters()), 0);
+}
+
+TEST_CASE(test_ext2_large_directory)
+{
+    test_large_directory("/home/anon"sv);
+}
+
+// The root file system doesn't use extents, so these tests run on a copy of an image that does (see build-root-filesystem.sh).
+TEST_CASE(test_ext2_extents)
+{
+    static constexpr auto EXTENTS_IMAGE_PATH = "/usr/Tests/Kernel/ext2-extents.img";
+    static constexpr auto TEST_IMAGE_PATH = "/tmp/.ext2_extents_test.img";
+    static constexpr auto TEST_MOUNT_PATH = "/tmp/.ext2_extents_test";
+
+    auto source_fd = open(EXTENTS_IMAGE_PATH, O_RDONLY);
+    if (source_fd == -1) {
+        warnln("Skipping, {} is missing", EXTENTS_IMAGE_PATH);
+        return;
+    }
+    auto image_fd = open(TEST_IMAGE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    VERIFY(image_fd != -1);
+    auto image_cleanup_guard = ScopeGuard([&] {
+        close(image_fd);
+        unlink(TEST_IMAGE_PATH);
+    });
+    u8 copy_buffer[64 * KiB];
+    while (true) {
+        auto nread = read(source_fd, copy_buffer, sizeof(copy_buffer));
+        VERIFY(nread >= 0);
+        if (nread == 0)
+            break;
+        VERIFY(write(image_fd, copy_buffer, nread) == nread);
+    }
+    close(source_fd);
+
+    // Make sure the image actually makes the file system use extents, i.e. that the superblock's
+    // s_feature_incompat has EXT3_FEATURE_INCOMPAT_EXTENTS set.
+    static constexpr off_t incompatible_features_offset = 1024 + 0x60;
+    static constexpr u32 extents_feature = 0x40;
+    u32 incompatible_features = 0;
+    EXPECT_EQ(pread(image_fd, &incompatible_features, sizeof(incompatible_features), incompatible_features_offset), (ssize_t)sizeof(incompatible_features));
+    EXPECT(incompatible_features & extents_feature);
+
+    auto devctl_fd = open("/dev/devctl", O_RDONLY);
+    VERIFY(devctl_fd != -1);
+    int loop_device_index = image_fd;
+    EXPECT_EQ(ioctl(devctl_fd, DEVCTL_CREATE_LOOP_DEVICE, &loop_device_index), 0);
+    auto loop_device_fd = open(ByteString::formatted("/dev/loop/{}", loop_device_index).characters(), O_RDONLY);
+    EXPECT(loop_device_fd != -1);
+
+    EXPECT_EQ(mkdir(TEST_MOUNT_PATH, 0700), 0);
+    auto mount_result = mount(loop_device_fd, TEST_MOUNT_PATH, "ext2", 0);
+    EXPECT_EQ(mount_result, 0);
+    // The mounted file system keeps its own reference to the loop device.
+    close(loop_device_fd);
+    EXPECT_EQ(ioctl(devctl_fd, DEVCTL_DESTROY_LOOP_DEVICE, &loop_device_index), 0);
+    close(devctl_fd);
+    auto mount_cleanup_guard = ScopeGuard([&] {
+        if (mount_result == 0)
+            EXPECT_EQ(umount(TEST_MOUNT_PATH), 0);
+        rmdir(TEST_MOUNT_PATH);
+    });
+    if (mount_result != 0)
+        return;
+
+    test_sparse_writes_truncate_and_fill(TEST_MOUNT_PATH);
+    test_large_directory(TEST_MOUNT_PATH);
+}
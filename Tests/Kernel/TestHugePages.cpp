@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Types.h>
+#include <LibTest/TestCase.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static constexpr size_t huge_page_size = 2 * MiB;
+static constexpr size_t mapping_size = 4 * huge_page_size;
+
+// Whether the kernel actually uses huge pages depends on the architecture and on how fragmented physical memory is,
+// so these tests only check that memory behaves the same either way.
+static u8* map_huge_page_aligned_memory()
+{
+    auto* mapping = static_cast<u8*>(mmap(nullptr, mapping_size + huge_page_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, 0, 0));
+    VERIFY(mapping != MAP_FAILED);
+
+    auto address = reinterpret_cast<FlatPtr>(mapping);
+    auto aligned_address = (address + huge_page_size - 1) & ~(huge_page_size - 1);
+    if (aligned_address != address)
+        VERIFY(munmap(mapping, aligned_address - address) == 0);
+    if (auto tail_size = address + huge_page_size - aligned_address; tail_size > 0)
+        VERIFY(munmap(reinterpret_cast<void*>(aligned_address + mapping_size), tail_size) == 0);
+
+    auto* aligned_mapping = reinterpret_cast<u8*>(aligned_address);
+    VERIFY(madvise(aligned_mapping, mapping_size, MADV_HUGEPAGE) == 0);
+    return aligned_mapping;
+}
+
+static void fill(u8* mapping, size_t offset, size_t size)
+{
+    for (size_t i = offset; i < offset + size; i += sizeof(u32))
+        *reinterpret_cast<u32*>(mapping + i) = static_cast<u32>(i);
+}
+
+static bool has_pattern(u8 const* mapping, size_t offset, size_t size)
+{
+    for (size_t i = offset; i < offset + size; i += sizeof(u32)) {
+        if (*reinterpret_cast<u32 const*>(mapping + i) != static_cast<u32>(i))
+            return false;
+    }
+    return true;
+}
+
+TEST_CASE(memory_starts_out_zeroed)
+{
+    auto* mapping = map_huge_page_aligned_memory();
+
+    // Touching a single byte faults in the whole huge page around it.
+    mapping[huge_page_size + 12345] = 1;
+    for (size_t i = 0; i < mapping_size; ++i) {
+        if (i != huge_page_size + 12345 && mapping[i] != 0) {
+            FAIL("Memory was not zeroed");
+            break;
+        }
+    }
+    EXPECT_EQ(munmap(mapping, mapping_size), 0);
+}
+
+TEST_CASE(partial_munmap_keeps_the_rest)
+{
+    auto* mapping = map_huge_page_aligned_memory();
+    fill(mapping, 0, mapping_size);
+
+    // Punch a hole into the middle of a huge page, which has to be split up.
+    auto hole_offset = huge_page_size + 64 * KiB;
+    EXPECT_EQ(munmap(mapping + hole_offset, PAGE_SIZE), 0);
+    EXPECT(has_pattern(mapping, 0, hole_offset));
+    EXPECT(has_pattern(mapping, hole_offset + PAGE_SIZE, mapping_size - hole_offset - PAGE_SIZE));
+
+    // Both halves can still be written to.
+    fill(mapping, 0, hole_offset);
+    fill(mapping, hole_offset + PAGE_SIZE, mapping_size - hole_offset - PAGE_SIZE);
+
+    EXPECT_EQ(munmap(mapping, hole_offset), 0);
+    EXPECT_EQ(munmap(mapping + hole_offset + PAGE_SIZE, mapping_size - hole_offset - PAGE_SIZE), 0);
+}
+
+TEST_CASE(partial_mprotect_keeps_the_rest)
+{
+    auto* mapping = map_huge_page_aligned_memory();
+    fill(mapping, 0, mapping_size);
+
+    EXPECT_EQ(mprotect(mapping + huge_page_size + PAGE_SIZE, PAGE_SIZE, PROT_READ), 0);
+    EXPECT(has_pattern(mapping, 0, mapping_size));
+    fill(mapping, 0, huge_page_size + PAGE_SIZE);
+    fill(mapping, huge_page_size + 2 * PAGE_SIZE, mapping_size - huge_page_size - 2 * PAGE_SIZE);
+    EXPECT(has_pattern(mapping, 0, mapping_size));
+
+    EXPECT_EQ(munmap(mapping, mapping_size), 0);
+}
+
+TEST_CASE(fork_copies_on_write)
+{
+    auto* mapping = map_huge_page_aligned_memory();
+    fill(mapping, 0, mapping_size);
+
+    auto pid = fork();
+    EXPECT(pid >= 0);
+    if (pid == 0) {
+        bool child_saw_parent_data = has_pattern(mapping, 0, mapping_size);
+        memset(mapping + huge_page_size, 0xff, PAGE_SIZE);
+        _exit(child_saw_parent_data && mapping[huge_page_size] == 0xff ? 0 : 1);
+    }
+
+    int status = 0;
+    EXPECT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+
+    // The child's writes must not show up here, and our own writes still have to work.
+    EXPECT(has_pattern(mapping, 0, mapping_size));
+    fill(mapping, 0, mapping_size);
+    EXPECT(has_pattern(mapping, 0, mapping_size));
+
+    EXPECT_EQ(munmap(mapping, mapping_size), 0);
+}
+
+TEST_CASE(nohugepage_keeps_contents)
+{
+    auto* mapping = map_huge_page_aligned_memory();
+    fill(mapping, 0, mapping_size);
+
+    EXPECT_EQ(madvise(mapping, mapping_size, MADV_NOHUGEPAGE), 0);
+    EXPECT(has_pattern(mapping, 0, mapping_size));
+    fill(mapping, 0, mapping_size);
+
+    EXPECT_EQ(munmap(mapping, mapping_size), 0);
+}
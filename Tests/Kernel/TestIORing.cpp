@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+
+TEST_CASE(create_errors)
+{
+    EXPECT_EQ(Core::System::io_ring_create(0, 0).error().code(), EINVAL);
+    EXPECT_EQ(Core::System::io_ring_create(3, 0).error().code(), EINVAL);
+    EXPECT_EQ(Core::System::io_ring_create(IO_RING_MAX_ENTRIES * 2, 0).error().code(), EINVAL);
+    EXPECT_EQ(Core::System::io_ring_create(8, O_NONBLOCK).error().code(), EINVAL);
+
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    EXPECT_EQ(Core::System::io_ring_enter(pipe_fds[0], 0, 0).error().code(), EINVAL);
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+}
+
+TEST_CASE(nop_and_bad_fd)
+{
+    auto ring = MUST(Core::IORing::create(4));
+    EXPECT(ring->queue_nop(1));
+    EXPECT(ring->queue_fsync(-1, 2));
+    EXPECT_EQ(MUST(ring->submit(2)), 2u);
+
+    auto completion = ring->pop_completion();
+    EXPECT(completion.has_value());
+    EXPECT_EQ(completion->user_data, 1u);
+    EXPECT_EQ(completion->result, 0);
+
+    completion = ring->pop_completion();
+    EXPECT(completion.has_value());
+    EXPECT_EQ(completion->user_data, 2u);
+    EXPECT_EQ(completion->result, -EBADF);
+
+    EXPECT(!ring->pop_completion().has_value());
+}
+
+TEST_CASE(submission_queue_full)
+{
+    auto ring = MUST(Core::IORing::create(2));
+    EXPECT(ring->queue_nop(0));
+    EXPECT(ring->queue_nop(1));
+    EXPECT(!ring->queue_nop(2));
+    EXPECT_EQ(ring->queued_submissions(), 2u);
+
+    EXPECT_EQ(MUST(ring->submit()), 2u);
+    EXPECT_EQ(ring->queued_submissions(), 0u);
+    EXPECT_EQ(ring->available_completions(), 2u);
+}
+
+TEST_CASE(file_write_fsync_and_read)
+{
+    auto fd = MUST(Core::System::open("/tmp/io-ring-test"sv, O_RDWR | O_CREAT | O_TRUNC, 0600));
+    MUST(Core::System::unlink("/tmp/io-ring-test"sv));
+
+    auto ring = MUST(Core::IORing::create(4));
+    EXPECT(ring->queue_write(fd, "Well hello friends"sv.bytes(), 0, 1));
+    EXPECT(ring->queue_fsync(fd, 2));
+    EXPECT_EQ(MUST(ring->submit(2)), 2u);
+
+    auto completion = ring->pop_completion();
+    EXPECT_EQ(completion->user_data, 1u);
+    EXPECT_EQ(completion->result, 18);
+    completion = ring->pop_completion();
+    EXPECT_EQ(completion->user_data, 2u);
+    EXPECT_EQ(completion->result, 0);
+
+    // An explicit offset doesn't move the file offset, IO_RING_CURRENT_OFFSET does.
+    u8 buffer[5];
+    EXPECT(ring->queue_read(fd, { buffer, sizeof(buffer) }, 5, 3));
+    EXPECT(ring->queue_read(fd, { buffer, 4 }, IO_RING_CURRENT_OFFSET, 4));
+    EXPECT_EQ(MUST(ring->submit(2)), 2u);
+
+    completion = ring->pop_completion();
+    EXPECT_EQ(completion->user_data, 3u);
+    EXPECT_EQ(completion->result, 5);
+    completion = ring->pop_completion();
+    EXPECT_EQ(completion->user_data, 4u);
+    EXPECT_EQ(completion->result, 4);
+    EXPECT_EQ(StringView(buffer, 4), "Well"sv);
+
+    MUST(Core::System::close(fd));
+}
+
+TEST_CASE(pipe_read_completes_after_write)
+{
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    auto ring = MUST(Core::IORing::create(4));
+
+    // Nothing is in the pipe yet, so the read has to wait, but the ring doesn't.
+    u8 buffer[16];
+    EXPECT(ring->queue_read(pipe_fds[0], { buffer, sizeof(buffer) }, IO_RING_CURRENT_OFFSET, 7));
+    EXPECT_EQ(MUST(ring->submit()), 1u);
+    EXPECT_EQ(ring->available_completions(), 0u);
+
+    MUST(Core::System::write(pipe_fds[1], "ring"sv.bytes()));
+    EXPECT_EQ(MUST(ring->submit(1)), 0u);
+
+    auto completion = ring->pop_completion();
+    EXPECT(completion.has_value());
+    EXPECT_EQ(completion->user_data, 7u);
+    EXPECT_EQ(completion->result, 4);
+    EXPECT_EQ(StringView(buffer, 4), "ring"sv);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+}
+
+TEST_CASE(many_pipe_reads_in_flight)
+{
+    static constexpr size_t pipe_count = 8;
+    Array<Array<int, 2>, pipe_count> pipe_fds;
+    for (auto& fds : pipe_fds)
+        fds = MUST(Core::System::pipe2(0));
+
+    auto ring = MUST(Core::IORing::create(pipe_count));
+    u8 buffers[pipe_count][1];
+    for (size_t i = 0; i < pipe_count; ++i)
+        EXPECT(ring->queue_read(pipe_fds[i][0], { buffers[i], 1 }, IO_RING_CURRENT_OFFSET, i));
+    EXPECT_EQ(MUST(ring->submit()), pipe_count);
+
+    // Complete them in reverse order.
+    for (size_t i = pipe_count; i > 0; --i) {
+        MUST(Core::System::write(pipe_fds[i - 1][1], "x"sv.bytes()));
+        MUST(ring->submit(1));
+        auto completion = ring->pop_completion();
+        EXPECT(completion.has_value());
+        EXPECT_EQ(completion->user_data, i - 1);
+        EXPECT_EQ(completion->result, 1);
+    }
+
+    for (auto& fds : pipe_fds) {
+        MUST(Core::System::close(fds[0]));
+        MUST(Core::System::close(fds[1]));
+    }
+}
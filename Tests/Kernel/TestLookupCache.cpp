@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteString.h>
+#include <AK/StringView.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Both RAMFS and Ext2FS have their lookups cached, so every test runs on both of them.
+static constexpr StringView test_directories[] = { "/tmp/.lookup_cache_test"sv, "/home/anon/.lookup_cache_test"sv };
+
+static void create_file(ByteString const& path)
+{
+    auto fd = open(path.characters(), O_CREAT | O_EXCL | O_WRONLY, 0600);
+    EXPECT(fd != -1);
+    close(fd);
+}
+
+static bool exists(ByteString const& path)
+{
+    struct stat st;
+    return stat(path.characters(), &st) == 0;
+}
+
+static ino_t inode_of(ByteString const& path)
+{
+    struct stat st;
+    EXPECT_EQ(stat(path.characters(), &st), 0);
+    return st.st_ino;
+}
+
+TEST_CASE(missing_name_is_found_after_create)
+{
+    for (auto directory : test_directories) {
+        EXPECT_EQ(mkdir(ByteString(directory).characters(), 0700), 0);
+        auto path = ByteString::formatted("{}/file", directory);
+
+        // Look it up twice, so the second time is answered by the cache.
+        EXPECT(!exists(path));
+        EXPECT(!exists(path));
+        create_file(path);
+        EXPECT(exists(path));
+        EXPECT(exists(path));
+
+        EXPECT_EQ(unlink(path.characters()), 0);
+        EXPECT(!exists(path));
+        EXPECT_EQ(rmdir(ByteString(directory).characters()), 0);
+    }
+}
+
+TEST_CASE(rename_updates_both_names)
+{
+    for (auto directory : test_directories) {
+        EXPECT_EQ(mkdir(ByteString(directory).characters(), 0700), 0);
+        auto old_path = ByteString::formatted("{}/old", directory);
+        auto new_path = ByteString::formatted("{}/new", directory);
+        auto replaced_path = ByteString::formatted("{}/replaced", directory);
+
+        create_file(old_path);
+        create_file(replaced_path);
+        auto old_inode = inode_of(old_path);
+        EXPECT(!exists(new_path));
+
+        EXPECT_EQ(rename(old_path.characters(), new_path.characters()), 0);
+        EXPECT(!exists(old_path));
+        EXPECT_EQ(inode_of(new_path), old_inode);
+
+        // Renaming over an existing name has to replace what that name resolves to.
+        EXPECT_EQ(rename(new_path.characters(), replaced_path.characters()), 0);
+        EXPECT(!exists(new_path));
+        EXPECT_EQ(inode_of(replaced_path), old_inode);
+
+        EXPECT_EQ(unlink(replaced_path.characters()), 0);
+        EXPECT_EQ(rmdir(ByteString(directory).characters()), 0);
+    }
+}
+
+TEST_CASE(recreated_directory_starts_out_empty)
+{
+    for (auto directory : test_directories) {
+        auto path = ByteString::formatted("{}/file", directory);
+
+        EXPECT_EQ(mkdir(ByteString(directory).characters(), 0700), 0);
+        EXPECT(!exists(path));
+        EXPECT_EQ(rmdir(ByteString(directory).characters()), 0);
+
+        EXPECT_EQ(mkdir(ByteString(directory).characters(), 0700), 0);
+        create_file(path);
+        EXPECT(exists(path));
+        EXPECT_EQ(unlink(path.characters()), 0);
+        EXPECT_EQ(rmdir(ByteString(directory).characters()), 0);
+
+        // The directory is gone, so nothing below it can be found anymore.
+        EXPECT(!exists(path));
+        EXPECT_EQ(errno, ENOENT);
+    }
+}
+
+TEST_CASE(name_is_found_again_after_its_inode_was_dropped)
+{
+    for (auto directory : test_directories) {
+        EXPECT_EQ(mkdir(ByteString(directory).characters(), 0700), 0);
+        auto path = ByteString::formatted("{}/file", directory);
+
+        create_file(path);
+        auto inode = inode_of(path);
+
+        // Nothing refers to the file anymore, so syncing lets Ext2FS drop its inode, while the cache still remembers the name.
+        sync();
+        EXPECT_EQ(inode_of(path), inode);
+        // This time, the refreshed entry is used.
+        EXPECT_EQ(inode_of(path), inode);
+
+        EXPECT_EQ(unlink(path.characters()), 0);
+        EXPECT(!exists(path));
+        EXPECT_EQ(rmdir(ByteString(directory).characters()), 0);
+    }
+}
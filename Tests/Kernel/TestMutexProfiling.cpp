@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <LibCore/File.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+static constexpr auto test_file_path = "/tmp/.mutex_profiling_test"sv;
+static constexpr size_t thread_count = 4;
+static constexpr size_t writes_per_thread = 1000;
+
+static void set_mutex_profiling(bool enabled)
+{
+    auto file = MUST(Core::File::open("/sys/kernel/conf/mutex_profiling"sv, Core::File::OpenMode::Write));
+    MUST(file->write_until_depleted(enabled ? "1"sv : "0"sv));
+}
+
+static JsonArray read_mutex_statistics()
+{
+    auto file = MUST(Core::File::open("/sys/kernel/mutexstat"sv, Core::File::OpenMode::Read));
+    auto json = MUST(JsonValue::from_string(MUST(file->read_until_eof())));
+    EXPECT(json.is_array());
+    return json.as_array();
+}
+
+static void* write_to_test_file(void*)
+{
+    auto fd = open(ByteString(test_file_path).characters(), O_WRONLY | O_APPEND);
+    EXPECT(fd >= 0);
+    char byte = 'x';
+    for (size_t i = 0; i < writes_per_thread; ++i)
+        EXPECT_EQ(write(fd, &byte, 1), 1);
+    close(fd);
+    return nullptr;
+}
+
+TEST_CASE(contended_writes_are_profiled)
+{
+    auto fd = open(ByteString(test_file_path).characters(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+    EXPECT(fd >= 0);
+    close(fd);
+
+    set_mutex_profiling(true);
+
+    // Appending to the same file from several threads makes them fight over its inode lock.
+    pthread_t threads[thread_count];
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, write_to_test_file, nullptr), 0);
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    set_mutex_profiling(false);
+    EXPECT_EQ(unlink(ByteString(test_file_path).characters()), 0);
+
+    auto statistics = read_mutex_statistics();
+    EXPECT(statistics.size() > 0);
+    statistics.for_each([](JsonValue const& value) {
+        auto const& entry = value.as_object();
+        EXPECT(entry.get_byte_string("name"sv).has_value());
+        auto acquisitions = entry.get_u64("acquisitions"sv).value();
+        auto contended_acquisitions = entry.get_u64("contended_acquisitions"sv).value();
+        auto blocked_acquisitions = entry.get_u64("blocked_acquisitions"sv).value();
+        EXPECT(contended_acquisitions <= acquisitions);
+        EXPECT(blocked_acquisitions <= contended_acquisitions);
+        EXPECT(entry.get_u64("max_wait_cycles"sv).value() <= entry.get_u64("total_wait_cycles"sv).value());
+        EXPECT(entry.get_u64("max_hold_cycles"sv).value() <= entry.get_u64("total_hold_cycles"sv).value());
+    });
+}
+
+TEST_CASE(nothing_is_recorded_while_disabled)
+{
+    set_mutex_profiling(false);
+    auto before = read_mutex_statistics();
+
+    auto fd = open(ByteString(test_file_path).characters(), O_CREAT | O_TRUNC | O_WRONLY, 0600);
+    EXPECT(fd >= 0);
+    close(fd);
+    EXPECT_EQ(unlink(ByteString(test_file_path).characters()), 0);
+
+    auto after = read_mutex_statistics();
+    EXPECT_EQ(before.size(), after.size());
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <serenity.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// The page cache is only used by block-based file systems, so this can't live in /tmp.
+static constexpr auto test_file_path = "/home/anon/.page_cache_test";
+static constexpr size_t test_file_page_count = 256;
+static constexpr size_t test_file_size = test_file_page_count * PAGE_SIZE;
+
+static u8 pattern_byte(size_t offset)
+{
+    // Every page gets different contents, so mixing up pages doesn't go unnoticed.
+    return static_cast<u8>(offset / PAGE_SIZE + offset * 7);
+}
+
+static int create_test_file()
+{
+    int fd = open(test_file_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    u8 buffer[PAGE_SIZE];
+    for (size_t page = 0; page < test_file_page_count; ++page) {
+        for (size_t i = 0; i < PAGE_SIZE; ++i)
+            buffer[i] = pattern_byte(page * PAGE_SIZE + i);
+        VERIFY(write(fd, buffer, sizeof(buffer)) == sizeof(buffer));
+    }
+    VERIFY(fsync(fd) == 0);
+    return fd;
+}
+
+static bool file_matches_pattern(int fd)
+{
+    u8 buffer[PAGE_SIZE];
+    for (size_t page = 0; page < test_file_page_count; ++page) {
+        if (pread(fd, buffer, sizeof(buffer), page * PAGE_SIZE) != sizeof(buffer))
+            return false;
+        for (size_t i = 0; i < PAGE_SIZE; ++i) {
+            if (buffer[i] != pattern_byte(page * PAGE_SIZE + i))
+                return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE(shared_mapping_is_coherent_with_read_and_write)
+{
+    int fd = create_test_file();
+    auto* mapping = static_cast<u8*>(mmap(nullptr, test_file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    VERIFY(mapping != MAP_FAILED);
+
+    for (size_t offset = 0; offset < test_file_size; offset += 509)
+        EXPECT_EQ(mapping[offset], pattern_byte(offset));
+
+    // Writes show up in the mapping right away.
+    u8 const written_bytes[] = { 0xde, 0xad, 0xbe, 0xef };
+    auto write_offset = 5 * PAGE_SIZE - 2;
+    EXPECT_EQ(pwrite(fd, written_bytes, sizeof(written_bytes), write_offset), static_cast<ssize_t>(sizeof(written_bytes)));
+    EXPECT_EQ(memcmp(mapping + write_offset, written_bytes, sizeof(written_bytes)), 0);
+
+    // Stores to the mapping show up in read() right away, without having to msync() first.
+    mapping[9 * PAGE_SIZE + 17] = 0x42;
+    u8 read_byte = 0;
+    EXPECT_EQ(pread(fd, &read_byte, 1, 9 * PAGE_SIZE + 17), 1);
+    EXPECT_EQ(read_byte, 0x42);
+
+    EXPECT_EQ(munmap(mapping, test_file_size), 0);
+    close(fd);
+    unlink(test_file_path);
+}
+
+TEST_CASE(unmapped_pages_are_evicted_and_read_back)
+{
+    // This test only makes sense as root, as purge() requires it.
+    EXPECT_EQ(geteuid(), 0u);
+
+    int fd = create_test_file();
+    // Bring the whole file into the page cache.
+    EXPECT(file_matches_pattern(fd));
+
+    // None of the pages are mapped, so all of them can be evicted.
+    EXPECT(purge(PURGE_ALL_CLEAN_INODE) >= static_cast<int>(test_file_page_count));
+    EXPECT(file_matches_pattern(fd));
+
+    close(fd);
+    unlink(test_file_path);
+}
+
+TEST_CASE(mapped_pages_are_evicted_and_read_back)
+{
+    // This test only makes sense as root, as purge() requires it.
+    EXPECT_EQ(geteuid(), 0u);
+
+    int fd = create_test_file();
+    auto* mapping = static_cast<u8*>(mmap(nullptr, test_file_size, PROT_READ, MAP_SHARED, fd, 0));
+    VERIFY(mapping != MAP_FAILED);
+    for (size_t offset = 0; offset < test_file_size; offset += PAGE_SIZE)
+        EXPECT_EQ(mapping[offset], pattern_byte(offset));
+
+    // The pages are only held by the page cache and our mapping, so both have to let go of them.
+    EXPECT(purge(PURGE_ALL_CLEAN_INODE) >= static_cast<int>(test_file_page_count));
+
+    // Faulting the pages back in has to bring back the same contents, and keep them coherent with read().
+    for (size_t offset = 0; offset < test_file_size; offset += 509)
+        EXPECT_EQ(mapping[offset], pattern_byte(offset));
+    EXPECT(file_matches_pattern(fd));
+
+    EXPECT_EQ(munmap(mapping, test_file_size), 0);
+    close(fd);
+    unlink(test_file_path);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <LibCore/File.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <sched.h>
+#include <serenity.h>
+#include <unistd.h>
+
+// Many processors (and most emulated ones) don't have performance counters that the kernel supports, in which case
+// these tests only check that this is reported properly.
+
+static u64 volatile s_sink;
+
+static void burn_cycles()
+{
+    u64 value = 0;
+    for (u64 i = 0; i < 100'000'000; ++i)
+        value += i ^ (value >> 3);
+    s_sink = value;
+}
+
+static JsonObject read_current_thread()
+{
+    auto file = MUST(Core::File::open("/sys/kernel/processes"sv, Core::File::OpenMode::Read));
+    auto json = MUST(JsonValue::from_string(MUST(file->read_until_eof())));
+    Optional<JsonObject> current_thread;
+    json.as_object().get_array("processes"sv)->for_each([&](JsonValue const& process_value) {
+        auto const& process = process_value.as_object();
+        if (process.get_i32("pid"sv) != getpid())
+            return;
+        process.get_array("threads"sv)->for_each([&](JsonValue const& thread_value) {
+            if (thread_value.as_object().get_i32("tid"sv) == gettid())
+                current_thread = thread_value.as_object();
+        });
+    });
+    VERIFY(current_thread.has_value());
+    return current_thread.release_value();
+}
+
+TEST_CASE(threads_count_cycles_and_instructions)
+{
+    auto file = MUST(Core::File::open("/sys/kernel/conf/performance_counters"sv, Core::File::OpenMode::Write));
+    if (auto result = file->write_until_depleted("1"sv); result.is_error()) {
+        EXPECT_EQ(result.error().code(), ENOTSUP);
+        return;
+    }
+
+    // Counter totals are updated whenever a thread is switched out.
+    sched_yield();
+    auto before = read_current_thread();
+    burn_cycles();
+    sched_yield();
+    auto after = read_current_thread();
+
+    MUST(file->write_until_depleted("0"sv));
+
+    EXPECT(after.get_u64("cycles"sv).value() > before.get_u64("cycles"sv).value());
+    EXPECT(after.get_u64("instructions"sv).value() - before.get_u64("instructions"sv).value() >= 100'000'000);
+}
+
+TEST_CASE(profile_samples_cycles)
+{
+    if (profiling_enable(getpid(), PERF_EVENT_MMAP | PERF_EVENT_CYCLES) < 0) {
+        EXPECT_EQ(errno, ENOTSUP);
+        return;
+    }
+    burn_cycles();
+    EXPECT_EQ(profiling_disable(getpid()), 0);
+
+    auto file = MUST(Core::File::open(ByteString::formatted("/proc/{}/perf_events", getpid()), Core::File::OpenMode::Read));
+    auto json = MUST(JsonValue::from_string(MUST(file->read_until_eof())));
+    size_t cycle_samples = 0;
+    json.as_object().get_array("events"sv)->for_each([&](JsonValue const& event_value) {
+        auto const& event = event_value.as_object();
+        if (event.get_byte_string("type"sv) != "counter_sample"sv)
+            return;
+        EXPECT_EQ(event.get_byte_string("counter"sv), "cycles"sv);
+        EXPECT(event.get_u64("period"sv).value() > 0);
+        ++cycle_samples;
+    });
+    EXPECT(cycle_samples > 0);
+
+    EXPECT_EQ(profiling_free_buffer(getpid()), 0);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+
+static int create_file_with_contents(ReadonlyBytes contents)
+{
+    char pattern[] = "/tmp/sendfile.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+    MUST(Core::System::write(fd, contents));
+    MUST(Core::System::lseek(fd, 0, SEEK_SET));
+    return fd;
+}
+
+TEST_CASE(sendfile_file_to_socket)
+{
+    auto contents = "Hello, friends! This came straight from the kernel."sv;
+    auto file_fd = create_file_with_contents(contents.bytes());
+
+    int sockets[2];
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, sockets));
+
+    auto nsent = MUST(Core::System::sendfile(sockets[0], file_fd, nullptr, contents.length()));
+    EXPECT_EQ(nsent, contents.length());
+
+    // Without an explicit offset, the file offset advances.
+    EXPECT_EQ(MUST(Core::System::lseek(file_fd, 0, SEEK_CUR)), static_cast<off_t>(contents.length()));
+
+    u8 buffer[128] {};
+    auto nread = MUST(Core::System::read(sockets[1], { buffer, sizeof(buffer) }));
+    EXPECT_EQ(StringView(ReadonlyBytes { buffer, static_cast<size_t>(nread) }), contents);
+
+    MUST(Core::System::close(sockets[0]));
+    MUST(Core::System::close(sockets[1]));
+    MUST(Core::System::close(file_fd));
+}
+
+TEST_CASE(sendfile_with_offset)
+{
+    auto contents = "0123456789"sv;
+    auto file_fd = create_file_with_contents(contents.bytes());
+
+    int sockets[2];
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, sockets));
+
+    off_t offset = 4;
+    auto nsent = MUST(Core::System::sendfile(sockets[0], file_fd, &offset, 100));
+    EXPECT_EQ(nsent, 6u);
+    EXPECT_EQ(offset, 10);
+
+    // With an explicit offset, the file offset is left alone.
+    EXPECT_EQ(MUST(Core::System::lseek(file_fd, 0, SEEK_CUR)), 0);
+
+    u8 buffer[16] {};
+    auto nread = MUST(Core::System::read(sockets[1], { buffer, sizeof(buffer) }));
+    EXPECT_EQ(StringView(ReadonlyBytes { buffer, static_cast<size_t>(nread) }), "456789"sv);
+
+    // Reading at the end of the file sends nothing.
+    EXPECT_EQ(MUST(Core::System::sendfile(sockets[0], file_fd, &offset, 100)), 0u);
+
+    MUST(Core::System::close(sockets[0]));
+    MUST(Core::System::close(sockets[1]));
+    MUST(Core::System::close(file_fd));
+}
+
+TEST_CASE(sendfile_from_page_cache)
+{
+    // Files on block-based file systems are sent straight out of the page cache. Use a file spanning
+    // several transfer chunks and an unaligned offset, so partial pages at both ends are covered too.
+    static constexpr auto file_path = "/home/anon/.sendfile_test"sv;
+    auto contents = MUST(ByteBuffer::create_uninitialized(200 * KiB));
+    for (size_t i = 0; i < contents.size(); ++i)
+        contents[i] = static_cast<u8>(i / PAGE_SIZE + i * 13);
+
+    auto file_fd = MUST(Core::System::open(file_path, O_RDWR | O_CREAT | O_TRUNC, 0644));
+    MUST(Core::System::unlink(file_path));
+    MUST(Core::System::write(file_fd, contents));
+    MUST(Core::System::lseek(file_fd, 1000, SEEK_SET));
+    auto output_fd = create_file_with_contents({});
+
+    size_t count = 150000;
+    auto nsent = MUST(Core::System::sendfile(output_fd, file_fd, nullptr, count));
+    EXPECT_EQ(nsent, count);
+    EXPECT_EQ(MUST(Core::System::lseek(file_fd, 0, SEEK_CUR)), static_cast<off_t>(1000 + count));
+
+    auto sent_contents = MUST(ByteBuffer::create_zeroed(count));
+    EXPECT_EQ(MUST(Core::System::pread(output_fd, sent_contents, 0)), static_cast<ssize_t>(count));
+    EXPECT(sent_contents.bytes() == contents.bytes().slice(1000, count));
+
+    MUST(Core::System::close(output_fd));
+    MUST(Core::System::close(file_fd));
+}
+
+TEST_CASE(splice_through_pipe)
+{
+    auto contents = "Through the pipe and back out again"sv;
+    auto file_fd = create_file_with_contents(contents.bytes());
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+
+    auto nspliced = MUST(Core::System::splice(file_fd, nullptr, pipe_fds[1], nullptr, contents.length()));
+    EXPECT_EQ(nspliced, contents.length());
+
+    u8 buffer[64] {};
+    auto nread = MUST(Core::System::read(pipe_fds[0], { buffer, sizeof(buffer) }));
+    EXPECT_EQ(StringView(ReadonlyBytes { buffer, static_cast<size_t>(nread) }), contents);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(file_fd));
+}
+
+TEST_CASE(splice_requires_a_pipe)
+{
+    auto file_fd = create_file_with_contents("data"sv.bytes());
+
+    int sockets[2];
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, sockets));
+
+    auto result = Core::System::splice(file_fd, nullptr, sockets[0], nullptr, 4);
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), EINVAL);
+
+    auto pipe_fds = MUST(Core::System::pipe2(0));
+    off_t offset = 0;
+    result = Core::System::splice(pipe_fds[0], &offset, sockets[0], nullptr, 4);
+    EXPECT(result.is_error());
+    EXPECT_EQ(result.error().code(), ESPIPE);
+
+    MUST(Core::System::close(pipe_fds[0]));
+    MUST(Core::System::close(pipe_fds[1]));
+    MUST(Core::System::close(sockets[0]));
+    MUST(Core::System::close(sockets[1]));
+    MUST(Core::System::close(file_fd));
+}
@@ -5,14 +5,21 @@
  */
 
 #include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
 #include <LibCore/File.h>
 #include <LibTest/TestCase.h>
+#include <net/if.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <pthread.h>
 #include <semaphore.h>
+#include <string.h>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
 
 static constexpr u16 port = 1337;
+static constexpr u16 bulk_transfer_port = 1340;
+static constexpr size_t bulk_transfer_size = 4 * MiB;
 
 static void* server_handler(void* accept_semaphore)
 {
@@ -50,14 +57,14 @@ static void* server_handler(void* accept_semaphore)
     VERIFY_NOT_REACHED();
 }
 
-static pthread_t start_tcp_server()
+static pthread_t start_tcp_server(void* (*handler)(void*) = server_handler)
 {
     pthread_t thread;
     sem_t accept_semaphore;
 
     int rc = sem_init(&accept_semaphore, 0, 0);
     VERIFY(rc == 0);
-    rc = pthread_create(&thread, nullptr, server_handler, &accept_semaphore);
+    rc = pthread_create(&thread, nullptr, handler, &accept_semaphore);
     VERIFY(rc == 0);
     rc = sem_wait(&accept_semaphore);
     VERIFY(rc == 0);
@@ -141,6 +148,33 @@ TEST_CASE(tcp_bind_connect)
     }
 }
 
+TEST_CASE(tcp_congestion_control_sockopt)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(fd >= 0);
+
+    char name[16] {};
+    socklen_t name_length = sizeof(name);
+    int rc = getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &name_length);
+    EXPECT_EQ(rc, 0);
+    EXPECT_EQ(StringView { name, strlen(name) }, "cubic"sv);
+
+    rc = setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, "reno", 4);
+    EXPECT_EQ(rc, 0);
+
+    name_length = sizeof(name);
+    rc = getsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, name, &name_length);
+    EXPECT_EQ(rc, 0);
+    EXPECT_EQ(StringView { name, strlen(name) }, "reno"sv);
+
+    rc = setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, "vegas", 5);
+    EXPECT_EQ(rc, -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    rc = close(fd);
+    EXPECT_EQ(rc, 0);
+}
+
 TEST_CASE(socket_connect_after_bind)
 {
     unlink("/tmp/tmp-client.test");
@@ -170,3 +204,204 @@ TEST_CASE(socket_connect_after_bind)
     unlink("/tmp/tmp-client.test");
     unlink("/tmp/tmp.test");
 }
+
+static u8 bulk_transfer_byte(size_t offset)
+{
+    return offset % 251;
+}
+
+static JsonObject tcp_socket_statistics(u16 local_port, u16 peer_port)
+{
+    auto file = MUST(Core::File::open("/sys/kernel/net/tcp"sv, Core::File::OpenMode::Read));
+    auto json = MUST(JsonValue::from_string(MUST(file->read_until_eof())));
+    EXPECT(json.is_array());
+    for (auto const& value : json.as_array().values()) {
+        auto const& socket = value.as_object();
+        if (socket.get_u32("local_port"sv).value_or(0) == local_port && socket.get_u32("peer_port"sv).value_or(0) == peer_port)
+            return socket;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+// The statistics of the receiving socket, taken right before bulk_transfer_receiver() closes it.
+static JsonObject s_receiving_socket_statistics;
+
+static void* bulk_transfer_receiver(void* accept_semaphore)
+{
+    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(server_fd >= 0);
+
+    sockaddr_in sin {};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(bulk_transfer_port);
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int rc = bind(server_fd, (sockaddr*)(&sin), sizeof(sin));
+    EXPECT_EQ(rc, 0);
+
+    rc = listen(server_fd, 1);
+    EXPECT_EQ(rc, 0);
+
+    rc = sem_post(reinterpret_cast<sem_t*>(accept_semaphore));
+    VERIFY(rc == 0);
+
+    sockaddr_in peer_address {};
+    socklen_t peer_address_length = sizeof(peer_address);
+    int client_fd = accept(server_fd, (sockaddr*)(&peer_address), &peer_address_length);
+    EXPECT(client_fd >= 0);
+
+    static u8 buffer[64 * KiB];
+    size_t received = 0;
+    size_t corrupted = 0;
+    while (true) {
+        auto nread = recv(client_fd, buffer, sizeof(buffer), 0);
+        EXPECT(nread >= 0);
+        if (nread <= 0)
+            break;
+        for (ssize_t i = 0; i < nread; ++i) {
+            if (buffer[i] != bulk_transfer_byte(received + i))
+                ++corrupted;
+        }
+        received += nread;
+    }
+    EXPECT_EQ(received, bulk_transfer_size);
+    EXPECT_EQ(corrupted, 0u);
+
+    s_receiving_socket_statistics = tcp_socket_statistics(bulk_transfer_port, ntohs(peer_address.sin_port));
+
+    rc = close(client_fd);
+    EXPECT_EQ(rc, 0);
+
+    rc = close(server_fd);
+    EXPECT_EQ(rc, 0);
+
+    pthread_exit(nullptr);
+    VERIFY_NOT_REACHED();
+}
+
+static void set_loopback_packet_loss(bool enabled)
+{
+    auto file = MUST(Core::File::open("/sys/kernel/conf/loopback_packet_loss"sv, Core::File::OpenMode::Write));
+    MUST(file->write_until_depleted(enabled ? "1"sv : "0"sv));
+}
+
+// Sends bulk_transfer_size bytes over loopback and returns the statistics of the sending socket once
+// the receiver got all of them.
+static JsonObject run_bulk_transfer(bool with_packet_loss)
+{
+    pthread_t receiver = start_tcp_server(bulk_transfer_receiver);
+
+    int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT(client_fd >= 0);
+
+    sockaddr_in sin {};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(bulk_transfer_port);
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int rc = connect(client_fd, (sockaddr*)(&sin), sizeof(sin));
+    EXPECT_EQ(rc, 0);
+
+    sockaddr_in local_address {};
+    socklen_t local_address_length = sizeof(local_address);
+    rc = getsockname(client_fd, (sockaddr*)(&local_address), &local_address_length);
+    EXPECT_EQ(rc, 0);
+
+    set_loopback_packet_loss(with_packet_loss);
+
+    static u8 buffer[64 * KiB];
+    size_t sent = 0;
+    while (sent < bulk_transfer_size) {
+        size_t chunk_size = min(sizeof(buffer), bulk_transfer_size - sent);
+        for (size_t i = 0; i < chunk_size; ++i)
+            buffer[i] = bulk_transfer_byte(sent + i);
+        auto nwritten = send(client_fd, buffer, chunk_size, 0);
+        EXPECT(nwritten > 0);
+        if (nwritten <= 0)
+            break;
+        sent += nwritten;
+    }
+
+    // The receiver only finishes once it has seen our FIN, i.e. after everything we sent arrived.
+    rc = shutdown(client_fd, SHUT_WR);
+    EXPECT_EQ(rc, 0);
+    rc = pthread_join(receiver, nullptr);
+    EXPECT_EQ(rc, 0);
+
+    set_loopback_packet_loss(false);
+
+    auto statistics = tcp_socket_statistics(ntohs(local_address.sin_port), bulk_transfer_port);
+
+    rc = close(client_fd);
+    EXPECT_EQ(rc, 0);
+
+    return statistics;
+}
+
+TEST_CASE(tcp_full_sized_segments)
+{
+    auto statistics = run_bulk_transfer(false);
+    EXPECT(statistics.get_bool("sack_permitted"sv).value());
+    EXPECT(statistics.get_bool("timestamps"sv).value());
+
+    // Loopback drops packets that exceed its MTU of almost 64 KiB, so if our full-sized segments
+    // didn't fit, the transfer would have stalled. Check that we actually sent full-sized ones.
+    auto packets_out = statistics.get_u32("packets_out"sv).value();
+    auto bytes_out = statistics.get_u32("bytes_out"sv).value();
+    EXPECT(bytes_out / packets_out > 32 * KiB);
+}
+
+TEST_CASE(tcp_sack_recovers_from_packet_loss)
+{
+    auto statistics = run_bulk_transfer(true);
+    EXPECT(statistics.get_bool("sack_permitted"sv).value());
+    EXPECT(statistics.get_u32("retransmitted_packets"sv).value() > 0);
+}
+
+static int loopback_mtu_request(unsigned request, int mtu = 0)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    EXPECT(fd >= 0);
+
+    ifreq ifr {};
+    strncpy(ifr.ifr_name, "loop", IFNAMSIZ);
+    ifr.ifr_mtu = mtu;
+    int rc = ioctl(fd, request, &ifr);
+    EXPECT_EQ(rc, 0);
+
+    rc = close(fd);
+    EXPECT_EQ(rc, 0);
+    return ifr.ifr_mtu;
+}
+
+TEST_CASE(tcp_segmentation_offload_over_loopback)
+{
+    static constexpr int lowered_mtu = 1500;
+    auto original_mtu = loopback_mtu_request(SIOCGIFMTU);
+    loopback_mtu_request(SIOCSIFMTU, lowered_mtu);
+    EXPECT_EQ(loopback_mtu_request(SIOCGIFMTU), lowered_mtu);
+
+    run_bulk_transfer(false);
+
+    loopback_mtu_request(SIOCSIFMTU, original_mtu);
+
+    // Loopback drops anything larger than its MTU, unless it was handed over as a single segmentation
+    // offload packet. So the receiver only gets segments this large if they took the offload path.
+    auto packets_in = s_receiving_socket_statistics.get_u32("packets_in"sv).value();
+    auto bytes_in = s_receiving_socket_statistics.get_u32("bytes_in"sv).value();
+    EXPECT(bytes_in / packets_in > 2 * static_cast<u32>(lowered_mtu));
+}
+
+TEST_CASE(loopback_mtu_cannot_be_raised)
+{
+    auto original_mtu = loopback_mtu_request(SIOCGIFMTU);
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    EXPECT(fd >= 0);
+    ifreq ifr {};
+    strncpy(ifr.ifr_name, "loop", IFNAMSIZ);
+    ifr.ifr_mtu = original_mtu + 1;
+    EXPECT_EQ(ioctl(fd, SIOCSIFMTU, &ifr), -1);
+    EXPECT_EQ(errno, EINVAL);
+    EXPECT_EQ(close(fd), 0);
+
+    EXPECT_EQ(loopback_mtu_request(SIOCGIFMTU), original_mtu);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Time.h>
+#include <LibTest/TestCase.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+static constexpr size_t sleeper_count = 32;
+
+static Duration monotonic_now()
+{
+    timespec now {};
+    VERIFY(clock_gettime(CLOCK_MONOTONIC, &now) == 0);
+    return Duration::from_timespec(now);
+}
+
+static void* sleep_and_check(void* argument)
+{
+    auto index = reinterpret_cast<FlatPtr>(argument);
+    auto duration = Duration::from_milliseconds(static_cast<i64>(index * 37));
+
+    auto start = monotonic_now();
+    auto deadline = (start + duration).to_timespec();
+    EXPECT_EQ(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr), 0);
+    auto elapsed = monotonic_now() - start;
+
+    EXPECT(elapsed >= duration);
+    // Leave room for the timer tick and a busy system.
+    EXPECT(elapsed < duration + Duration::from_milliseconds(100));
+    return nullptr;
+}
+
+// The sleeps are spread out far enough for some of them to pass through several levels of the timer wheel.
+TEST_CASE(concurrent_sleepers_wake_on_time)
+{
+    pthread_t threads[sleeper_count];
+    for (size_t i = 0; i < sleeper_count; ++i)
+        EXPECT_EQ(pthread_create(&threads[i], nullptr, sleep_and_check, reinterpret_cast<void*>(i + 1)), 0);
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+}
+
+TEST_CASE(far_away_timer_can_be_cancelled)
+{
+    // This is further out than the timer wheel reaches.
+    constexpr unsigned far_away_seconds = 100 * 24 * 60 * 60;
+    EXPECT_EQ(alarm(far_away_seconds), 0u);
+    EXPECT_EQ(alarm(0), far_away_seconds);
+    EXPECT_EQ(alarm(0), 0u);
+}
@@ -6,9 +6,23 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/Array.h>
 #include <errno.h>
 #include <mallocdefs.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
+
+// Small enough to be served from the per-thread chunk caches, and few enough to fit into a single cache bin.
+static constexpr size_t small_allocation_size = 48;
+static constexpr size_t small_allocation_count = 16;
+
+static serenity_malloc_stats malloc_stats()
+{
+    serenity_malloc_stats stats;
+    serenity_get_malloc_stats(&stats);
+    return stats;
+}
 
 TEST_CASE(malloc_limits)
 {
@@ -38,3 +52,87 @@ TEST_CASE(malloc_limits)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+TEST_CASE(thread_cache_serves_repeated_allocations)
+{
+    // Warm up the cache, so the loop below only sees hits.
+    free(malloc(small_allocation_size));
+
+    auto before = malloc_stats();
+    for (size_t i = 0; i < 100; ++i) {
+        auto* ptr = static_cast<u8*>(malloc(small_allocation_size));
+        EXPECT(ptr != nullptr);
+        ptr[0] = static_cast<u8>(i);
+        AK::taint_for_optimizer(ptr);
+        free(ptr);
+    }
+    auto after = malloc_stats();
+
+    EXPECT(after.malloc_calls - before.malloc_calls >= 100);
+    EXPECT(after.free_calls - before.free_calls >= 100);
+    EXPECT(after.thread_cache_allocation_hits - before.thread_cache_allocation_hits >= 100);
+    EXPECT(after.thread_cache_free_hits - before.thread_cache_free_hits >= 100);
+}
+
+static void* allocate_small_chunks(void* argument)
+{
+    auto& chunks = *static_cast<Array<u8*, small_allocation_count>*>(argument);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        chunks[i] = static_cast<u8*>(malloc(small_allocation_size));
+        if (chunks[i])
+            memset(chunks[i], static_cast<int>(i), small_allocation_size);
+    }
+    return nullptr;
+}
+
+TEST_CASE(free_chunks_allocated_on_another_thread)
+{
+    Array<u8*, small_allocation_count> chunks {};
+    pthread_t thread;
+    EXPECT_EQ(pthread_create(&thread, nullptr, allocate_small_chunks, &chunks), 0);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    auto before = malloc_stats();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        EXPECT(chunks[i] != nullptr);
+        for (size_t j = 0; j < small_allocation_size; ++j)
+            EXPECT_EQ(chunks[i][j], static_cast<u8>(i));
+        free(chunks[i]);
+    }
+
+    // The chunks now live in this thread's cache, and have to be handed out again intact.
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        chunks[i] = static_cast<u8*>(malloc(small_allocation_size));
+        EXPECT(chunks[i] != nullptr);
+        memset(chunks[i], 0xaa, small_allocation_size);
+    }
+    for (auto* chunk : chunks)
+        free(chunk);
+    auto after = malloc_stats();
+
+    EXPECT(after.free_calls - before.free_calls >= 2 * small_allocation_count);
+}
+
+static void* allocate_and_free_small_chunks(void*)
+{
+    Array<void*, small_allocation_count> chunks {};
+    for (auto& chunk : chunks)
+        chunk = malloc(small_allocation_size);
+    // These frees fit into the cache, so they are only reported once the cache is flushed when this thread exits.
+    for (auto* chunk : chunks)
+        free(chunk);
+    return nullptr;
+}
+
+TEST_CASE(thread_cache_is_flushed_on_thread_exit)
+{
+    auto before = malloc_stats();
+
+    pthread_t thread;
+    EXPECT_EQ(pthread_create(&thread, nullptr, allocate_and_free_small_chunks, nullptr), 0);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    auto after = malloc_stats();
+    EXPECT(after.free_calls - before.free_calls >= small_allocation_count);
+    EXPECT(after.thread_cache_free_hits - before.thread_cache_free_hits >= small_allocation_count);
+}
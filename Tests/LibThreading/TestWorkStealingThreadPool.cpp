@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/FixedArray.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/WorkStealingDeque.h>
+#include <LibThreading/WorkStealingThreadPool.h>
+
+TEST_CASE(deque_owner_takes_in_lifo_order)
+{
+    Threading::WorkStealingDeque<int> deque(2);
+    for (int i = 0; i < 10; ++i)
+        deque.push(i);
+
+    for (int i = 9; i >= 0; --i)
+        EXPECT_EQ(deque.take().value(), i);
+    EXPECT(!deque.take().has_value());
+    EXPECT(deque.is_empty());
+}
+
+TEST_CASE(deque_thieves_steal_in_fifo_order)
+{
+    Threading::WorkStealingDeque<int> deque(4);
+    for (int i = 0; i < 10; ++i)
+        deque.push(i);
+
+    int value = -1;
+    EXPECT(deque.steal(value) == Threading::WorkStealingDeque<int>::StealResult::Success);
+    EXPECT_EQ(value, 0);
+    EXPECT_EQ(deque.take().value(), 9);
+    EXPECT(deque.steal(value) == Threading::WorkStealingDeque<int>::StealResult::Success);
+    EXPECT_EQ(value, 1);
+}
+
+TEST_CASE(submitted_tasks_all_run)
+{
+    IGNORE_USE_IN_ESCAPING_LAMBDA Atomic<size_t> counter { 0 };
+    Threading::WorkStealingThreadPool pool { 4 };
+    for (size_t i = 0; i < 1000; ++i)
+        pool.submit([&] { counter.fetch_add(1); });
+    pool.wait_for_all();
+    EXPECT_EQ(counter.load(), 1000u);
+}
+
+TEST_CASE(tasks_can_spawn_tasks)
+{
+    IGNORE_USE_IN_ESCAPING_LAMBDA Atomic<size_t> leaves { 0 };
+    Threading::WorkStealingThreadPool pool { 4 };
+
+    // Builds a binary tree of tasks, 2^10 leaves deep.
+    IGNORE_USE_IN_ESCAPING_LAMBDA Function<void(size_t)> spawn_tree = [&](size_t depth) {
+        if (depth == 0) {
+            leaves.fetch_add(1);
+            return;
+        }
+        pool.spawn([&, depth] { spawn_tree(depth - 1); });
+        pool.spawn([&, depth] { spawn_tree(depth - 1); });
+    };
+
+    pool.submit([&] { spawn_tree(10); });
+    pool.wait_for_all();
+    EXPECT_EQ(leaves.load(), 1024u);
+}
+
+TEST_CASE(parallel_for_covers_range_exactly_once)
+{
+    Threading::WorkStealingThreadPool pool { 4 };
+
+    auto hits = MUST(FixedArray<Atomic<u32>>::create(10'000));
+
+    pool.parallel_for(0, hits.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            hits[i].fetch_add(1);
+    });
+
+    for (auto& hit : hits)
+        EXPECT_EQ(hit.load(), 1u);
+}
+
+TEST_CASE(nested_parallel_for)
+{
+    Threading::WorkStealingThreadPool pool { 4 };
+    Atomic<size_t> sum { 0 };
+
+    pool.parallel_for(
+        0, 64, [&](size_t outer_begin, size_t outer_end) {
+            for (size_t i = outer_begin; i < outer_end; ++i) {
+                pool.parallel_for(
+                    0, 100, [&](size_t begin, size_t end) {
+                        sum.fetch_add(end - begin);
+                    },
+                    10);
+            }
+        },
+        1);
+
+    EXPECT_EQ(sum.load(), 6400u);
+}
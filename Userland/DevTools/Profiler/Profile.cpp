@@ -37,11 +37,23 @@ Profile::Profile(Vector<Process> processes, Vector<Event> events)
     , m_events(move(events))
     , m_file_event_nodes(FileEventNode::create(""))
 {
+    bool has_timer_samples = false;
     for (size_t i = 0; i < m_events.size(); ++i) {
-        if (m_events[i].data.has<Event::SignpostData>())
+        auto const& data = m_events[i].data;
+        if (data.has<Event::SignpostData>())
             m_signpost_indices.append(i);
+        if (data.has<Event::SampleData>())
+            has_timer_samples = true;
+        if (auto const* counter_sample = data.get_pointer<Event::CounterSampleData>()) {
+            if (m_counter_sample_periods.set(counter_sample->counter, counter_sample->period) == HashSetResult::InsertedNewEntry)
+                m_sampled_counters.append(counter_sample->counter);
+        }
     }
 
+    // A profile that was only sampled on hardware counters would start out with a rather empty call tree otherwise.
+    if (!has_timer_samples && !m_sampled_counters.is_empty())
+        m_sample_source = m_sampled_counters.first();
+
     m_first_timestamp = m_events.first().timestamp;
     m_last_timestamp = m_events.last().timestamp;
 
@@ -68,6 +80,30 @@ GUI::Model& Profile::signposts_model()
     return *m_signposts_model;
 }
 
+template<typename Callback>
+static void for_each_frame(Profile::Event const& event, bool inverted, Callback callback)
+{
+    if (!inverted) {
+        for (size_t i = 0; i < event.frames.size(); ++i) {
+            if (callback(event.frames.at(i), i == event.frames.size() - 1) == IterationDecision::Break)
+                break;
+        }
+    } else {
+        for (ssize_t i = event.frames.size() - 1; i >= 0; --i) {
+            if (callback(event.frames.at(i), static_cast<size_t>(i) == event.frames.size() - 1) == IterationDecision::Break)
+                break;
+        }
+    }
+}
+
+bool Profile::is_from_sample_source(Event const& event) const
+{
+    auto const* counter_sample = event.data.get_pointer<Event::CounterSampleData>();
+    if (!m_sample_source.has_value())
+        return !counter_sample;
+    return counter_sample && counter_sample->counter == *m_sample_source;
+}
+
 void Profile::rebuild_tree()
 {
     Vector<NonnullRefPtr<ProfileNode>> roots;
@@ -104,6 +140,8 @@ void Profile::rebuild_tree()
     m_filtered_signpost_indices.clear();
     m_file_event_nodes->children().clear();
 
+    Vector<size_t> instruction_sample_indices;
+
     for (size_t event_index = 0; event_index < m_events.size(); ++event_index) {
         auto& event = m_events.at(event_index);
 
@@ -121,6 +159,12 @@ void Profile::rebuild_tree()
             continue;
         }
 
+        if (!is_from_sample_source(event)) {
+            if (auto const* counter_sample = event.data.get_pointer<Event::CounterSampleData>(); counter_sample && counter_sample->counter == "instructions"sv)
+                instruction_sample_indices.append(event_index);
+            continue;
+        }
+
         m_filtered_event_indices.append(event_index);
 
         if (auto* malloc_data = event.data.get_pointer<Event::MallocData>(); malloc_data && !live_allocations.contains(malloc_data->ptr))
@@ -129,25 +173,11 @@ void Profile::rebuild_tree()
         if (event.data.has<Event::FreeData>())
             continue;
 
-        auto for_each_frame = [&]<typename Callback>(Callback callback) {
-            if (!m_inverted) {
-                for (size_t i = 0; i < event.frames.size(); ++i) {
-                    if (callback(event.frames.at(i), i == event.frames.size() - 1) == IterationDecision::Break)
-                        break;
-                }
-            } else {
-                for (ssize_t i = event.frames.size() - 1; i >= 0; --i) {
-                    if (callback(event.frames.at(i), static_cast<size_t>(i) == event.frames.size() - 1) == IterationDecision::Break)
-                        break;
-                }
-            }
-        };
-
         if (!m_show_top_functions) {
             ProfileNode* node = nullptr;
             auto& process_node = find_or_create_process_node(event.pid, event.serial);
             process_node.increment_event_count();
-            for_each_frame([&](Frame const& frame, bool is_innermost_frame) {
+            for_each_frame(event, m_inverted, [&](Frame const& frame, bool is_innermost_frame) {
                 auto const& object_name = frame.object_name;
                 auto const& symbol = frame.symbol;
                 auto const& address = frame.address;
@@ -256,6 +286,42 @@ void Profile::rebuild_tree()
         }
     }
 
+    // Instruction samples only count towards the nodes that cycle samples created, to tell the IPC of each of them.
+    if (has_instructions_per_cycle()) {
+        for (auto event_index : instruction_sample_indices) {
+            auto const& event = m_events.at(event_index);
+            auto const* process = find_process(event.pid, event.serial);
+            auto root = roots.find_if([&](auto& node) { return &node->process() == process; });
+            if (root.is_end())
+                continue;
+            (*root)->increment_instruction_sample_count();
+
+            if (!m_show_top_functions) {
+                ProfileNode* node = root->ptr();
+                for_each_frame(event, m_inverted, [&](Frame const& frame, bool) {
+                    node = node->find_child(frame.symbol);
+                    if (!node)
+                        return IterationDecision::Break;
+                    node->increment_instruction_sample_count();
+                    return IterationDecision::Continue;
+                });
+                continue;
+            }
+
+            HashTable<ProfileNode*> seen_top_functions;
+            for (size_t i = 0; i < event.frames.size(); ++i) {
+                ProfileNode* node = root->ptr();
+                for (size_t j = i; j < event.frames.size(); ++j) {
+                    node = node->find_child(event.frames.at(j).symbol);
+                    if (!node)
+                        break;
+                    if (j != i || seen_top_functions.set(node) == HashSetResult::InsertedNewEntry)
+                        node->increment_instruction_sample_count();
+                }
+            }
+        }
+    }
+
     sort_profile_nodes(roots);
 
     m_roots = move(roots);
@@ -321,6 +387,11 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
 
         if (type_string == "sample"sv) {
             event.data = Event::SampleData {};
+        } else if (type_string == "counter_sample"sv) {
+            event.data = Event::CounterSampleData {
+                .counter = perf_event.get_byte_string("counter"sv).value_or({}),
+                .period = perf_event.get_u64("period"sv).value_or(0),
+            };
         } else if (type_string == "kmalloc"sv) {
             event.data = Event::MallocData {
                 .ptr = perf_event.get_addr("ptr"sv).value_or(0),
@@ -630,6 +701,31 @@ void Profile::set_show_top_functions(bool show)
     rebuild_tree();
 }
 
+void Profile::set_sample_source(Optional<ByteString> sample_source)
+{
+    if (m_sample_source == sample_source)
+        return;
+    m_sample_source = move(sample_source);
+    rebuild_tree();
+    if (m_disassembly_model)
+        m_disassembly_model->invalidate();
+    m_samples_model->invalidate();
+}
+
+bool Profile::has_instructions_per_cycle() const
+{
+    return m_sample_source == "cycles"sv && m_counter_sample_periods.contains("instructions"sv);
+}
+
+Optional<float> Profile::instructions_per_cycle(ProfileNode const& node) const
+{
+    if (!has_instructions_per_cycle() || node.event_count() == 0)
+        return {};
+    auto instructions = static_cast<float>(node.instruction_sample_count()) * m_counter_sample_periods.get("instructions"sv).value();
+    auto cycles = static_cast<float>(node.event_count()) * m_counter_sample_periods.get("cycles"sv).value();
+    return instructions / cycles;
+}
+
 void Profile::set_show_percentages(bool show_percentages)
 {
     if (m_show_percentages == show_percentages)
@@ -91,9 +91,21 @@ public:
     ProfileNode* parent() { return m_parent; }
     ProfileNode const* parent() const { return m_parent; }
 
+    ProfileNode* find_child(ByteString const& symbol)
+    {
+        for (auto& child : m_children) {
+            if (child->symbol() == symbol)
+                return child.ptr();
+        }
+        return nullptr;
+    }
+
     void increment_event_count() { ++m_event_count; }
     void increment_self_count() { ++m_self_count; }
 
+    u32 instruction_sample_count() const { return m_instruction_sample_count; }
+    void increment_instruction_sample_count() { ++m_instruction_sample_count; }
+
     void sort_children();
 
     HashMap<FlatPtr, size_t> const& events_per_address() const { return m_events_per_address; }
@@ -125,6 +137,7 @@ private:
     u32 m_offset { 0 };
     u32 m_event_count { 0 };
     u32 m_self_count { 0 };
+    u32 m_instruction_sample_count { 0 };
     u64 m_timestamp { 0 };
     Vector<NonnullRefPtr<ProfileNode>> m_children;
     HashMap<FlatPtr, size_t> m_events_per_address;
@@ -186,6 +199,11 @@ public:
         struct SampleData {
         };
 
+        struct CounterSampleData {
+            ByteString counter;
+            u64 period { 0 };
+        };
+
         struct MallocData {
             FlatPtr ptr {};
             size_t size {};
@@ -263,7 +281,7 @@ public:
             Variant<OpenEventData, CloseEventData, PreadvEventData, ReadEventData, PreadEventData> data;
         };
 
-        Variant<nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, FilesystemEventData> data { nullptr };
+        Variant<nullptr_t, SampleData, CounterSampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, FilesystemEventData> data { nullptr };
     };
 
     Vector<Event> const& events() const { return m_events; }
@@ -293,6 +311,18 @@ public:
     bool show_percentages() const { return m_show_percentages; }
     void set_show_percentages(bool);
 
+    // Names of the hardware performance counters that the profile has samples of, like "cycles" or "cache_misses".
+    Vector<ByteString> const& sampled_counters() const { return m_sampled_counters; }
+
+    // The call tree is either built from timer samples and all other traced events, or only from the samples of
+    // one hardware performance counter.
+    Optional<ByteString> const& sample_source() const { return m_sample_source; }
+    void set_sample_source(Optional<ByteString>);
+
+    // Only available while the call tree is built from cycle samples, and the profile has instruction samples too.
+    bool has_instructions_per_cycle() const;
+    Optional<float> instructions_per_cycle(ProfileNode const&) const;
+
     Vector<Process> const& processes() const { return m_processes; }
 
     template<typename Callback>
@@ -322,6 +352,7 @@ private:
     Profile(Vector<Process>, Vector<Event>);
 
     void rebuild_tree();
+    bool is_from_sample_source(Event const&) const;
 
     RefPtr<ProfileModel> m_model;
     RefPtr<SamplesModel> m_samples_model;
@@ -351,6 +382,10 @@ private:
 
     NonnullRefPtr<FileEventNode> m_file_event_nodes;
 
+    Vector<ByteString> m_sampled_counters;
+    HashMap<ByteString, u64> m_counter_sample_periods;
+    Optional<ByteString> m_sample_source;
+
     bool m_inverted { false };
     bool m_show_top_functions { false };
     bool m_show_percentages { false };
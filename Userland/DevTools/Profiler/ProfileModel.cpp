@@ -81,6 +81,8 @@ ErrorOr<String> ProfileModel::column_name(int column) const
         return m_profile.show_percentages() ? "% Samples"_string : "# Samples"_string;
     case Column::SelfCount:
         return m_profile.show_percentages() ? "% Self"_string : "# Self"_string;
+    case Column::InstructionsPerCycle:
+        return "IPC"_string;
     case Column::ObjectName:
         return "Object"_string;
     case Column::StackFrame:
@@ -96,7 +98,7 @@ GUI::Variant ProfileModel::data(GUI::ModelIndex const& index, GUI::ModelRole rol
 {
     auto* node = static_cast<ProfileNode*>(index.internal_data());
     if (role == GUI::ModelRole::TextAlignment) {
-        if (index.column() == Column::SampleCount || index.column() == Column::SelfCount)
+        if (index.column() == Column::SampleCount || index.column() == Column::SelfCount || index.column() == Column::InstructionsPerCycle)
             return Gfx::TextAlignment::CenterRight;
     }
     if (role == GUI::ModelRole::Icon) {
@@ -122,6 +124,11 @@ GUI::Variant ProfileModel::data(GUI::ModelIndex const& index, GUI::ModelRole rol
                 return format_percentage(node->self_count(), m_profile.filtered_event_indices().size());
             return node->self_count();
         }
+        if (index.column() == Column::InstructionsPerCycle) {
+            if (auto instructions_per_cycle = m_profile.instructions_per_cycle(*node); instructions_per_cycle.has_value())
+                return ByteString::formatted("{:.2}", *instructions_per_cycle);
+            return "";
+        }
         if (index.column() == Column::ObjectName)
             return node->object_name();
         if (index.column() == Column::StackFrame) {
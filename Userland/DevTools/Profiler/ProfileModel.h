@@ -24,6 +24,7 @@ public:
     enum Column {
         SampleCount,
         SelfCount,
+        InstructionsPerCycle,
         ObjectName,
         StackFrame,
         SymbolAddress,
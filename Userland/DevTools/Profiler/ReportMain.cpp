@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "PercentageFormatting.h"
+#include "Profile.h"
+#include <AK/AnyOf.h>
+#include <AK/HashMap.h>
+#include <AK/QuickSort.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+
+using namespace Profiler;
+
+struct LoadOptions {
+    Optional<pid_t> pid;
+    StringView process_name;
+    Optional<StringView> sample_source;
+};
+
+static ErrorOr<NonnullOwnPtr<Profile>> load_profile(StringView path, LoadOptions const& options)
+{
+    auto profile = TRY(Profile::load_from_perfcore_file(path));
+
+    if (options.sample_source.has_value()) {
+        auto const& sample_source = *options.sample_source;
+        if (sample_source == "timer"sv) {
+            profile->set_sample_source({});
+        } else {
+            if (!any_of(profile->sampled_counters(), [&](auto const& counter) { return counter == sample_source; }))
+                return Error::from_string_literal("Profile has no samples of the requested performance counter");
+            profile->set_sample_source(ByteString { sample_source });
+        }
+    }
+
+    if (options.pid.has_value() || !options.process_name.is_empty()) {
+        bool found_process = false;
+        for (auto const& process : profile->processes()) {
+            if (options.pid.has_value() && process.pid != *options.pid)
+                continue;
+            if (!options.process_name.is_empty() && process.basename != options.process_name)
+                continue;
+            auto end_valid = process.end_valid == EventSerialNumber {} ? EventSerialNumber::max_valid_serial() : process.end_valid;
+            profile->add_process_filter(process.pid, process.start_valid, end_valid);
+            found_process = true;
+        }
+        if (!found_process)
+            return Error::from_string_literal("Profile contains no matching process");
+    }
+
+    if (profile->filtered_event_indices().is_empty())
+        return Error::from_string_literal("Profile contains no matching samples");
+    return profile;
+}
+
+static ByteString node_name(ProfileNode const& node)
+{
+    if (node.is_root())
+        return ByteString::formatted("{} ({})", node.process().basename, node.process().pid);
+    if (node.object_name().is_empty())
+        return node.symbol();
+    return ByteString::formatted("{} [{}]", node.symbol(), node.object_name());
+}
+
+static ByteString format_instructions_per_cycle(Optional<float> instructions_per_cycle)
+{
+    if (!instructions_per_cycle.has_value())
+        return {};
+    return ByteString::formatted("{:.2}", *instructions_per_cycle);
+}
+
+struct FunctionSamples {
+    DeprecatedFlyString object_name;
+    ByteString symbol;
+    u32 self_count { 0 };
+    u32 total_count { 0 };
+    // The IPC of every merged node, weighted by its sample count.
+    float weighted_instructions_per_cycle { 0 };
+};
+
+// The same function in different processes (e.g. in libc.so) is merged, so that profiles of different runs can be compared.
+static Vector<FunctionSamples> collect_top_functions(Profile& profile)
+{
+    profile.set_show_top_functions(true);
+
+    HashMap<ByteString, size_t> function_indices;
+    Vector<FunctionSamples> functions;
+    for (auto const& root : profile.roots()) {
+        for (auto const& node : root->children()) {
+            auto key = ByteString::formatted("{}:{}", node->object_name(), node->symbol());
+            auto index = function_indices.ensure(key, [&] {
+                functions.append({ .object_name = node->object_name(), .symbol = node->symbol() });
+                return functions.size() - 1;
+            });
+            auto& function = functions[index];
+            function.self_count += node->self_count();
+            function.total_count += node->event_count();
+            if (auto instructions_per_cycle = profile.instructions_per_cycle(*node); instructions_per_cycle.has_value())
+                function.weighted_instructions_per_cycle += *instructions_per_cycle * node->event_count();
+        }
+    }
+
+    quick_sort(functions, [](auto const& a, auto const& b) {
+        if (a.self_count != b.self_count)
+            return a.self_count > b.self_count;
+        return a.total_count > b.total_count;
+    });
+    return functions;
+}
+
+static void print_top_functions(Profile& profile, size_t count)
+{
+    auto total = profile.filtered_event_indices().size();
+    auto functions = collect_top_functions(profile);
+    if (count != 0 && functions.size() > count)
+        functions.shrink(count);
+
+    bool has_instructions_per_cycle = profile.has_instructions_per_cycle();
+    out("{:>7} {:>7} {:>8} {:>8} ", "Self%", "Total%", "Self", "Total");
+    if (has_instructions_per_cycle)
+        out("{:>5} ", "IPC");
+    outln("{:<16} {}", "Object", "Symbol");
+
+    for (auto const& function : functions) {
+        out("{:>7} {:>7} {:>8} {:>8} ", format_percentage(function.self_count, total), format_percentage(function.total_count, total), function.self_count, function.total_count);
+        if (has_instructions_per_cycle) {
+            Optional<float> instructions_per_cycle;
+            if (function.total_count != 0)
+                instructions_per_cycle = function.weighted_instructions_per_cycle / function.total_count;
+            out("{:>5} ", format_instructions_per_cycle(instructions_per_cycle));
+        }
+        outln("{:<16} {}", function.object_name, function.symbol);
+    }
+}
+
+static void print_call_tree(Profile const& profile, ProfileNode const& node, size_t depth, size_t total, double min_percent)
+{
+    if (node.event_count() * 100.0 / total < min_percent)
+        return;
+
+    out("{:>7} {:>7} ", format_percentage(node.event_count(), total), format_percentage(node.self_count(), total));
+    if (profile.has_instructions_per_cycle())
+        out("{:>5} ", format_instructions_per_cycle(profile.instructions_per_cycle(node)));
+    outln("{}{}", ByteString::repeated(' ', depth * 2), node_name(node));
+
+    for (auto const& child : node.children())
+        print_call_tree(profile, *child, depth + 1, total, min_percent);
+}
+
+static void print_call_trees(Profile& profile, bool inverted, double min_percent)
+{
+    profile.set_inverted(inverted);
+
+    auto total = profile.filtered_event_indices().size();
+    out("{:>7} {:>7} ", "Total%", "Self%");
+    if (profile.has_instructions_per_cycle())
+        out("{:>5} ", "IPC");
+    outln("{}", inverted ? "Inverted call tree" : "Call tree");
+
+    for (auto const& root : profile.roots())
+        print_call_tree(profile, *root, 0, total, min_percent);
+}
+
+// Prints one line per distinct stack, as "process;outermost;...;innermost count". This is the input format of
+// flame graph tools like flamegraph.pl or speedscope.
+static void print_folded_stacks(ProfileNode const& node, ByteString const& stack)
+{
+    if (node.self_count() != 0)
+        outln("{} {}", stack, node.self_count());
+    for (auto const& child : node.children())
+        print_folded_stacks(*child, ByteString::formatted("{};{}", stack, child->symbol()));
+}
+
+static void print_diff(Profile& baseline_profile, Profile& profile, size_t count)
+{
+    struct FunctionDiff {
+        DeprecatedFlyString object_name;
+        ByteString symbol;
+        double baseline_self_percent { 0 };
+        double self_percent { 0 };
+
+        double delta() const { return self_percent - baseline_self_percent; }
+    };
+
+    HashMap<ByteString, size_t> function_indices;
+    Vector<FunctionDiff> diffs;
+    auto add_functions = [&](Profile& source_profile, double FunctionDiff::*self_percent) {
+        auto total = source_profile.filtered_event_indices().size();
+        for (auto const& function : collect_top_functions(source_profile)) {
+            auto key = ByteString::formatted("{}:{}", function.object_name, function.symbol);
+            auto index = function_indices.ensure(key, [&] {
+                diffs.append({ .object_name = function.object_name, .symbol = function.symbol });
+                return diffs.size() - 1;
+            });
+            diffs[index].*self_percent = function.self_count * 100.0 / total;
+        }
+    };
+    add_functions(baseline_profile, &FunctionDiff::baseline_self_percent);
+    add_functions(profile, &FunctionDiff::self_percent);
+
+    quick_sort(diffs, [](auto const& a, auto const& b) {
+        return AK::abs(a.delta()) > AK::abs(b.delta());
+    });
+    if (count != 0 && diffs.size() > count)
+        diffs.shrink(count);
+
+    outln("Samples: {} -> {}", baseline_profile.filtered_event_indices().size(), profile.filtered_event_indices().size());
+    outln("{:>7} {:>7} {:>7} {:<16} {}", "Base%", "New%", "Delta", "Object", "Symbol");
+    for (auto const& diff : diffs)
+        outln("{:>7.2} {:>7.2} {:>+7.2} {:<16} {}", diff.baseline_self_percent, diff.self_percent, diff.delta(), diff.object_name, diff.symbol);
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    TRY(Core::System::pledge("stdio rpath"));
+
+    StringView report = "top"sv;
+    size_t count = 20;
+    double min_percent = 1;
+    LoadOptions options;
+    Vector<StringView> perfcore_files;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Print reports of perfcore files, as recorded by profile(1).");
+    args_parser.add_option(report, "Report to print: top (the default), tree, inverted, folded or diff", "report", 'r', "report");
+    args_parser.add_option(count, "Number of functions listed by the top and diff reports, 0 for all (default: 20)", "count", 'n', "count");
+    args_parser.add_option(min_percent, "Leave out call tree nodes with fewer samples than this percentage (default: 1)", "min-percent", 'm', "percent");
+    args_parser.add_option(options.pid, "Only include samples of the process with this PID", "pid", 'p', "PID");
+    args_parser.add_option(options.process_name, "Only include samples of processes with this executable name", "process", 'c', "name");
+    args_parser.add_option(options.sample_source, "Use the samples of this hardware performance counter, or of the timer", "source", 's', "source");
+    args_parser.add_positional_argument(perfcore_files, "Perfcore file to report on, or the baseline and the new perfcore file for diff", "perfcore-files");
+    args_parser.parse(arguments);
+
+    if (!first_is_one_of(report, "top"sv, "tree"sv, "inverted"sv, "folded"sv, "diff"sv)) {
+        warnln("Unknown report '{}'", report);
+        return 1;
+    }
+    size_t expected_file_count = report == "diff"sv ? 2 : 1;
+    if (perfcore_files.size() != expected_file_count) {
+        warnln("The {} report takes {} perfcore file{}", report, expected_file_count, expected_file_count == 1 ? "" : "s");
+        return 1;
+    }
+
+    auto profile = TRY(load_profile(perfcore_files.last(), options));
+
+    if (report == "top"sv) {
+        print_top_functions(*profile, count);
+    } else if (report == "tree"sv) {
+        print_call_trees(*profile, false, min_percent);
+    } else if (report == "inverted"sv) {
+        print_call_trees(*profile, true, min_percent);
+    } else if (report == "folded"sv) {
+        for (auto const& root : profile->roots())
+            print_folded_stacks(*root, root->process().basename);
+    } else {
+        auto baseline_profile = TRY(load_profile(perfcore_files.first(), options));
+        print_diff(*baseline_profile, *profile, count);
+    }
+
+    return 0;
+}
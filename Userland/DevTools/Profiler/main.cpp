@@ -22,6 +22,7 @@
 #include <LibCore/Timer.h>
 #include <LibDesktop/Launcher.h>
 #include <LibGUI/Action.h>
+#include <LibGUI/ActionGroup.h>
 #include <LibGUI/Application.h>
 #include <LibGUI/BoxLayout.h>
 #include <LibGUI/Button.h>
@@ -38,6 +39,7 @@
 #include <LibGUI/TreeView.h>
 #include <LibGUI/Window.h>
 #include <LibMain/Main.h>
+#include <errno.h>
 #include <serenity.h>
 #include <string.h>
 
@@ -45,6 +47,19 @@ using namespace Profiler;
 
 static bool generate_profile(pid_t& pid);
 
+static ByteString counter_display_name(ByteString const& counter)
+{
+    if (counter == "cycles"sv)
+        return "&Cycles";
+    if (counter == "instructions"sv)
+        return "&Instructions";
+    if (counter == "cache_misses"sv)
+        return "C&ache Misses";
+    if (counter == "branch_misses"sv)
+        return "&Branch Misses";
+    return counter;
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     int pid = 0;
@@ -301,6 +316,28 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     view_menu->add_action(disassembly_action);
     view_menu->add_action(source_action);
 
+    GUI::ActionGroup sample_source_actions;
+    sample_source_actions.set_exclusive(true);
+    if (!profile->sampled_counters().is_empty()) {
+        view_menu->add_separator();
+        auto sample_source_menu = view_menu->add_submenu("Sample &Source"_string);
+
+        auto add_sample_source_action = [&](ByteString const& title, Optional<ByteString> sample_source) {
+            auto action = GUI::Action::create_checkable(title, [&profile, &tree_view, sample_source](auto&) {
+                profile->set_sample_source(sample_source);
+                tree_view.set_column_visible(ProfileModel::Column::InstructionsPerCycle, profile->has_instructions_per_cycle());
+            });
+            action->set_checked(profile->sample_source() == sample_source);
+            sample_source_actions.add_action(*action);
+            sample_source_menu->add_action(action);
+        };
+
+        add_sample_source_action("&Timer", {});
+        for (auto const& counter : profile->sampled_counters())
+            add_sample_source_action(counter_display_name(counter), counter);
+    }
+    tree_view.set_column_visible(ProfileModel::Column::InstructionsPerCycle, profile->has_instructions_per_cycle());
+
     auto help_menu = window->add_menu("&Help"_string);
     help_menu->add_action(GUI::CommonActions::make_command_palette_action(window));
     help_menu->add_action(GUI::CommonActions::make_help_action([](auto&) {
@@ -366,8 +403,13 @@ bool generate_profile(pid_t& pid)
 
     static constexpr u64 event_mask = PERF_EVENT_SAMPLE | PERF_EVENT_MMAP | PERF_EVENT_MUNMAP | PERF_EVENT_PROCESS_CREATE
         | PERF_EVENT_PROCESS_EXEC | PERF_EVENT_PROCESS_EXIT | PERF_EVENT_THREAD_CREATE | PERF_EVENT_THREAD_EXIT;
+    static constexpr u64 counter_event_mask = PERF_EVENT_CYCLES | PERF_EVENT_INSTRUCTIONS | PERF_EVENT_CACHE_MISSES | PERF_EVENT_BRANCH_MISSES;
 
-    if (profiling_enable(pid, event_mask) < 0) {
+    // Hardware performance counters are sampled as well, if the processor has any that we support.
+    auto rc = profiling_enable(pid, event_mask | counter_event_mask);
+    if (rc < 0 && errno == ENOTSUP)
+        rc = profiling_enable(pid, event_mask);
+    if (rc < 0) {
         int saved_errno = errno;
         GUI::MessageBox::show(nullptr, ByteString::formatted("Unable to profile process {}({}): {}", process_name, pid, strerror(saved_errno)), "Profiler"sv, GUI::MessageBox::Type::Error);
         return false;
@@ -35,6 +35,7 @@ set(HEADERS
     sys/cdefs.h
     sys/device.h
     sys/devices/gpu.h
+    sys/epoll.h
     sys/file.h
     sys/internals.h
     sys/ioctl.h
@@ -45,6 +46,7 @@ set(HEADERS
     sys/ptrace.h
     sys/resource.h
     sys/select.h
+    sys/sendfile.h
     sys/socket.h
     sys/stat.h
     sys/statvfs.h
@@ -151,6 +153,7 @@ set(HEADERS
     ../../../Kernel/API/POSIX/sys/un.h
     ../../../Kernel/API/POSIX/sys/ptrace.h
     ../../../Kernel/API/POSIX/sys/socket.h
+    ../../../Kernel/API/POSIX/sys/epoll.h
     ../../../Kernel/API/POSIX/unistd.h
     ../../../Kernel/API/POSIX/netinet/in.h
     ../../../Kernel/API/POSIX/netinet/tcp.h
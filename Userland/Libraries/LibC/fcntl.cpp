@@ -119,4 +119,11 @@ int posix_fallocate(int fd, off_t offset, off_t len)
     // posix_fallocate does not set errno.
     return -static_cast<int>(syscall(SC_posix_fallocate, fd, offset, len));
 }
+
+ssize_t splice(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t length, unsigned flags)
+{
+    Syscall::SC_splice_params params { fd_in, off_in, fd_out, off_out, length, flags };
+    int rc = syscall(SC_splice, &params);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
 }
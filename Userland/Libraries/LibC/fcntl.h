@@ -37,4 +37,6 @@ int inode_watcher_remove_watch(int fd, int wd);
 int posix_fadvise(int fd, off_t offset, off_t len, int advice);
 int posix_fallocate(int fd, off_t offset, off_t len);
 
+ssize_t splice(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t length, unsigned flags);
+
 __END_DECLS
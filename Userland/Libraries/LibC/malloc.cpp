@@ -53,6 +53,7 @@ static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
 static bool s_scrub_free = true;
 static bool s_profiling = false;
+static bool s_thread_cache_enabled = true;
 
 struct MallocStats {
     size_t number_of_malloc_calls;
@@ -76,6 +77,11 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_cache_allocation_hits;
+    size_t number_of_thread_cache_allocation_misses;
+    size_t number_of_thread_cache_free_hits;
+    size_t number_of_thread_cache_flushes;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -247,6 +253,274 @@ enum class CallerWillInitializeMemory {
 __thread bool __allocation_enabled = true;
 #endif
 
+// NOTE: The caller must hold s_malloc_mutex.
+static ErrorOr<void*> allocate_chunk(Allocator& allocator, size_t good_size, size_t align)
+{
+    ChunkedBlock* block = nullptr;
+    void* ptr = nullptr;
+    for (auto& current : allocator.usable_blocks) {
+        if (current.free_chunks()) {
+            ptr = try_allocate_chunk_aligned(align, current);
+            if (ptr) {
+                block = &current;
+                break;
+            }
+        }
+    }
+
+    if (!block && s_hot_empty_block_count) {
+        g_malloc_stats.number_of_hot_empty_block_hits++;
+        block = s_hot_empty_blocks[--s_hot_empty_block_count];
+        if (block->m_size != good_size) {
+            new (block) ChunkedBlock(good_size);
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+            set_mmap_name(block, ChunkedBlock::block_size, buffer);
+        }
+        allocator.usable_blocks.append(*block);
+    }
+
+    if (!block && s_cold_empty_block_count) {
+        g_malloc_stats.number_of_cold_empty_block_hits++;
+        block = s_cold_empty_blocks[--s_cold_empty_block_count];
+        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
+        bool this_block_was_purged = rc == 1;
+        if (rc < 0) {
+            perror("madvise");
+            VERIFY_NOT_REACHED();
+        }
+        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
+        if (rc < 0) {
+            perror("mprotect");
+            VERIFY_NOT_REACHED();
+        }
+        if (this_block_was_purged || block->m_size != good_size) {
+            if (this_block_was_purged)
+                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
+            new (block) ChunkedBlock(good_size);
+        }
+        allocator.usable_blocks.append(*block);
+    }
+
+    if (!block) {
+        g_malloc_stats.number_of_block_allocs++;
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
+        new (block) ChunkedBlock(good_size);
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
+    }
+
+    if (!ptr) {
+        ptr = try_allocate_chunk_aligned(align, *block);
+    }
+
+    VERIFY(ptr);
+    if (block->is_full()) {
+        g_malloc_stats.number_of_blocks_full++;
+        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
+    }
+    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+
+    return ptr;
+}
+
+// NOTE: The caller must hold s_malloc_mutex.
+static void free_chunk(ChunkedBlock* block, void* ptr)
+{
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = block->m_freelist;
+    block->m_freelist = entry;
+
+    if (block->is_full()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
+        g_malloc_stats.number_of_freed_full_blocks++;
+        allocator->full_blocks.remove(*block);
+        allocator->usable_blocks.prepend(*block);
+    }
+
+    ++block->m_free_chunks;
+
+    if (!block->used_chunks()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
+            g_malloc_stats.number_of_hot_keeps++;
+            allocator->usable_blocks.remove(*block);
+            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
+            return;
+        }
+        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
+            g_malloc_stats.number_of_cold_keeps++;
+            allocator->usable_blocks.remove(*block);
+            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
+            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
+            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+            return;
+        }
+        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
+        g_malloc_stats.number_of_frees++;
+        allocator->usable_blocks.remove(*block);
+        --allocator->block_count;
+        os_free(block, ChunkedBlock::block_size);
+    }
+}
+
+#ifndef NO_TLS
+// Small allocations are served from a per-thread cache of free chunks, so that threads
+// allocating and freeing in a tight loop don't serialize on s_malloc_mutex.
+// Chunks move between a thread cache and the shared ChunkedBlocks in batches.
+static constexpr size_t number_of_thread_cached_size_classes = 7; // 16 up to and including 1008 bytes
+static constexpr size_t thread_cache_bin_capacity = 32;
+static constexpr size_t thread_cache_batch_size = thread_cache_bin_capacity / 2;
+static_assert(number_of_thread_cached_size_classes <= num_size_classes);
+
+struct ThreadCacheBin {
+    size_t count;
+    void* chunks[thread_cache_bin_capacity];
+};
+
+struct ThreadCache {
+    ThreadCacheBin bins[number_of_thread_cached_size_classes];
+
+    // These are folded into g_malloc_stats whenever this thread takes s_malloc_mutex.
+    size_t number_of_malloc_calls;
+    size_t number_of_free_calls;
+    size_t number_of_allocation_hits;
+    size_t number_of_allocation_misses;
+    size_t number_of_free_hits;
+    size_t number_of_flushes;
+};
+
+static __thread ThreadCache s_thread_cache;
+
+// NOTE: The caller must hold s_malloc_mutex.
+static void fold_thread_cache_stats()
+{
+    auto& cache = s_thread_cache;
+    g_malloc_stats.number_of_malloc_calls += exchange(cache.number_of_malloc_calls, 0);
+    g_malloc_stats.number_of_free_calls += exchange(cache.number_of_free_calls, 0);
+    g_malloc_stats.number_of_thread_cache_allocation_hits += exchange(cache.number_of_allocation_hits, 0);
+    g_malloc_stats.number_of_thread_cache_allocation_misses += exchange(cache.number_of_allocation_misses, 0);
+    g_malloc_stats.number_of_thread_cache_free_hits += exchange(cache.number_of_free_hits, 0);
+    g_malloc_stats.number_of_thread_cache_flushes += exchange(cache.number_of_flushes, 0);
+}
+
+static Optional<size_t> thread_cache_bin_index_for(size_t size, size_t align)
+{
+    // Every chunk is at least 16-byte aligned, so only bigger alignments need the slow path.
+    if (align > 16)
+        return {};
+    for (size_t i = 0; i < number_of_thread_cached_size_classes; ++i) {
+        if (size <= size_classes[i])
+            return i;
+    }
+    return {};
+}
+
+static void* allocate_from_thread_cache(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+    if (!s_thread_cache_enabled)
+        return nullptr;
+
+    auto bin_index = thread_cache_bin_index_for(size, align);
+    if (!bin_index.has_value())
+        return nullptr;
+
+    auto& cache = s_thread_cache;
+    auto& bin = cache.bins[*bin_index];
+    size_t good_size = size_classes[*bin_index];
+
+    if (bin.count == 0) {
+        PthreadMutexLocker locker(s_malloc_mutex);
+        ++cache.number_of_allocation_misses;
+        fold_thread_cache_stats();
+
+        auto& allocator = allocators()[*bin_index];
+        while (bin.count < thread_cache_batch_size) {
+            auto chunk_or_error = allocate_chunk(allocator, good_size, 16);
+            if (chunk_or_error.is_error())
+                break;
+            bin.chunks[bin.count++] = chunk_or_error.release_value();
+        }
+        // Let the slow path deal with reporting the error.
+        if (bin.count == 0)
+            return nullptr;
+    } else {
+        ++cache.number_of_allocation_hits;
+    }
+
+    ++cache.number_of_malloc_calls;
+    auto* ptr = bin.chunks[--bin.count];
+
+    if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+
+    return ptr;
+}
+
+static bool free_to_thread_cache(ChunkedBlock& block, void* ptr)
+{
+    if (!s_thread_cache_enabled)
+        return false;
+
+    auto bin_index = thread_cache_bin_index_for(block.bytes_per_chunk(), 1);
+    if (!bin_index.has_value())
+        return false;
+    VERIFY(size_classes[*bin_index] == block.bytes_per_chunk());
+
+    if (s_scrub_free)
+        memset(ptr, FREE_SCRUB_BYTE, block.bytes_per_chunk());
+
+    auto& cache = s_thread_cache;
+    auto& bin = cache.bins[*bin_index];
+
+    if (bin.count == thread_cache_bin_capacity) {
+        PthreadMutexLocker locker(s_malloc_mutex);
+        ++cache.number_of_flushes;
+        fold_thread_cache_stats();
+
+        // Give back the least recently freed half; the most recently freed chunks are the most likely to still be in the CPU cache.
+        for (size_t i = 0; i < thread_cache_batch_size; ++i) {
+            auto* chunk = bin.chunks[i];
+            free_chunk((ChunkedBlock*)((FlatPtr)chunk & ChunkedBlock::block_mask), chunk);
+        }
+        for (size_t i = thread_cache_batch_size; i < bin.count; ++i)
+            bin.chunks[i - thread_cache_batch_size] = bin.chunks[i];
+        bin.count -= thread_cache_batch_size;
+    } else {
+        ++cache.number_of_free_hits;
+    }
+
+    ++cache.number_of_free_calls;
+    bin.chunks[bin.count++] = ptr;
+    return true;
+}
+#endif
+
+void __malloc_flush_thread_cache()
+{
+#ifndef NO_TLS
+    auto& cache = s_thread_cache;
+    PthreadMutexLocker locker(s_malloc_mutex);
+    for (auto& bin : cache.bins) {
+        for (size_t i = 0; i < bin.count; ++i) {
+            auto* chunk = bin.chunks[i];
+            free_chunk((ChunkedBlock*)((FlatPtr)chunk & ChunkedBlock::block_mask), chunk);
+        }
+        bin.count = 0;
+    }
+    fold_thread_cache_stats();
+#endif
+}
+
 static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
 {
 #ifndef NO_TLS
@@ -270,6 +544,11 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         size = 1;
     }
 
+#ifndef NO_TLS
+    if (auto* ptr = allocate_from_thread_cache(size, align, caller_will_initialize_memory))
+        return ptr;
+#endif
+
     g_malloc_stats.number_of_malloc_calls++;
 
     size_t good_size;
@@ -314,77 +593,10 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         return reinterpret_cast<void*>(round_up_to_power_of_two(reinterpret_cast<uintptr_t>(&block->m_slot[0]), align));
     }
 
-    ChunkedBlock* block = nullptr;
-    void* ptr = nullptr;
-    for (auto& current : allocator->usable_blocks) {
-        if (current.free_chunks()) {
-            ptr = try_allocate_chunk_aligned(align, current);
-            if (ptr) {
-                block = &current;
-                break;
-            }
-        }
-    }
-
-    if (!block && s_hot_empty_block_count) {
-        g_malloc_stats.number_of_hot_empty_block_hits++;
-        block = s_hot_empty_blocks[--s_hot_empty_block_count];
-        if (block->m_size != good_size) {
-            new (block) ChunkedBlock(good_size);
-            char buffer[64];
-            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-            set_mmap_name(block, ChunkedBlock::block_size, buffer);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block && s_cold_empty_block_count) {
-        g_malloc_stats.number_of_cold_empty_block_hits++;
-        block = s_cold_empty_blocks[--s_cold_empty_block_count];
-        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
-        bool this_block_was_purged = rc == 1;
-        if (rc < 0) {
-            perror("madvise");
-            VERIFY_NOT_REACHED();
-        }
-        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
-        if (rc < 0) {
-            perror("mprotect");
-            VERIFY_NOT_REACHED();
-        }
-        if (this_block_was_purged || block->m_size != good_size) {
-            if (this_block_was_purged)
-                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
-            new (block) ChunkedBlock(good_size);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block) {
-        g_malloc_stats.number_of_block_allocs++;
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
-        new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
-    }
-
-    if (!ptr) {
-        ptr = try_allocate_chunk_aligned(align, *block);
-    }
-
-    VERIFY(ptr);
-    if (block->is_full()) {
-        g_malloc_stats.number_of_blocks_full++;
-        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
-    }
-    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+    auto* ptr = TRY(allocate_chunk(*allocator, good_size, align));
 
     if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
     return ptr;
 }
@@ -400,11 +612,16 @@ static void free_impl(void* ptr)
     if (!ptr)
         return;
 
-    g_malloc_stats.number_of_free_calls++;
-
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
+#ifndef NO_TLS
+    if (magic == MAGIC_PAGE_HEADER && free_to_thread_cache(*(ChunkedBlock*)block_base, ptr))
+        return;
+#endif
+
+    g_malloc_stats.number_of_free_calls++;
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (magic == MAGIC_BIGALLOC_HEADER) {
@@ -440,46 +657,7 @@ static void free_impl(void* ptr)
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
-    auto* entry = (FreelistEntry*)ptr;
-    entry->next = block->m_freelist;
-    block->m_freelist = entry;
-
-    if (block->is_full()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
-        g_malloc_stats.number_of_freed_full_blocks++;
-        allocator->full_blocks.remove(*block);
-        allocator->usable_blocks.prepend(*block);
-    }
-
-    ++block->m_free_chunks;
-
-    if (!block->used_chunks()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
-            g_malloc_stats.number_of_hot_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
-            return;
-        }
-        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
-            g_malloc_stats.number_of_cold_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
-        allocator->usable_blocks.remove(*block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
-    }
+    free_chunk(block, ptr);
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html
@@ -602,6 +780,8 @@ void __malloc_init()
         s_log_malloc = true;
     if (secure_getenv("LIBC_PROFILE_MALLOC"))
         s_profiling = true;
+    if (secure_getenv("LIBC_NO_MALLOC_THREAD_CACHE"))
+        s_thread_cache_enabled = false;
 
     for (size_t i = 0; i < num_size_classes; ++i) {
         new (&allocators()[i]) Allocator();
@@ -611,8 +791,35 @@ void __malloc_init()
     new (&big_allocators()[0])(BigAllocator);
 }
 
+void serenity_get_malloc_stats(struct serenity_malloc_stats* stats)
+{
+    PthreadMutexLocker locker(s_malloc_mutex);
+#ifndef NO_TLS
+    fold_thread_cache_stats();
+#endif
+
+    *stats = {};
+    stats->malloc_calls = g_malloc_stats.number_of_malloc_calls;
+    stats->free_calls = g_malloc_stats.number_of_free_calls;
+    stats->thread_cache_allocation_hits = g_malloc_stats.number_of_thread_cache_allocation_hits;
+    stats->thread_cache_allocation_misses = g_malloc_stats.number_of_thread_cache_allocation_misses;
+    stats->thread_cache_free_hits = g_malloc_stats.number_of_thread_cache_free_hits;
+    stats->thread_cache_flushes = g_malloc_stats.number_of_thread_cache_flushes;
+    stats->big_allocations = g_malloc_stats.number_of_big_allocs;
+    for (auto const& allocator : allocators())
+        stats->chunked_blocks += allocator.block_count;
+    stats->empty_chunked_blocks = s_hot_empty_block_count + s_cold_empty_block_count;
+}
+
 void serenity_dump_malloc_stats()
 {
+#ifndef NO_TLS
+    {
+        PthreadMutexLocker locker(s_malloc_mutex);
+        fold_thread_cache_stats();
+    }
+#endif
+
     dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
     dbgln();
     dbgln("big alloc hits: {}", g_malloc_stats.number_of_big_allocator_hits);
@@ -634,5 +841,10 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+    dbgln("thread cache allocation hits: {}", g_malloc_stats.number_of_thread_cache_allocation_hits);
+    dbgln("thread cache allocation misses: {}", g_malloc_stats.number_of_thread_cache_allocation_misses);
+    dbgln("thread cache free hits: {}", g_malloc_stats.number_of_thread_cache_free_hits);
+    dbgln("thread cache flushes: {}", g_malloc_stats.number_of_thread_cache_flushes);
 }
 }
@@ -101,6 +101,18 @@ int anon_create(size_t size, int options)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+int io_ring_create(unsigned entries, int flags)
+{
+    int rc = syscall(SC_io_ring_create, entries, flags);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int io_ring_enter(int fd, unsigned to_submit, unsigned min_complete)
+{
+    int rc = syscall(SC_io_ring_enter, fd, to_submit, min_complete);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int setkeymap(char const* name, u32 const* map, u32* const shift_map, u32 const* alt_map, u32 const* altgr_map, u32 const* shift_altgr_map)
 {
     Syscall::SC_setkeymap_params params { map, shift_map, alt_map, altgr_map, shift_altgr_map, { name, strlen(name) } };
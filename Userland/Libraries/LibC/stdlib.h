@@ -22,6 +22,19 @@ __attribute__((malloc)) __attribute__((alloc_size(1, 2))) void* calloc(size_t nm
 size_t malloc_size(void const*);
 size_t malloc_good_size(size_t);
 void serenity_dump_malloc_stats(void);
+
+struct serenity_malloc_stats {
+    size_t malloc_calls;
+    size_t free_calls;
+    size_t thread_cache_allocation_hits;
+    size_t thread_cache_allocation_misses;
+    size_t thread_cache_free_hits;
+    size_t thread_cache_flushes;
+    size_t big_allocations;
+    size_t chunked_blocks;
+    size_t empty_chunked_blocks;
+};
+void serenity_get_malloc_stats(struct serenity_malloc_stats*);
 void free(void*);
 __attribute__((alloc_size(2))) void* realloc(void* ptr, size_t);
 char* getenv(char const* name);
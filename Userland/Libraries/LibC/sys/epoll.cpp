@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <bits/pthread_cancel.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <syscall.h>
+
+extern "C" {
+
+int epoll_create(int size)
+{
+    // The size argument has been a hint ever since Linux 2.6.8, it only has to be positive.
+    if (size <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    return epoll_create1(0);
+}
+
+int epoll_create1(int flags)
+{
+    int rc = syscall(SC_epoll_create1, flags);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event* event)
+{
+    int rc = syscall(SC_epoll_ctl, epfd, op, fd, event);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int epoll_wait(int epfd, struct epoll_event* events, int maxevents, int timeout)
+{
+    return epoll_pwait(epfd, events, maxevents, timeout, nullptr);
+}
+
+int epoll_pwait(int epfd, struct epoll_event* events, int maxevents, int timeout, sigset_t const* sigmask)
+{
+    timespec timeout_ts;
+    timespec* timeout_ptr = &timeout_ts;
+    if (timeout < 0)
+        timeout_ptr = nullptr;
+    else
+        timeout_ts = { timeout / 1000, (timeout % 1000) * 1'000'000 };
+    return epoll_pwait2(epfd, events, maxevents, timeout_ptr, sigmask);
+}
+
+int epoll_pwait2(int epfd, struct epoll_event* events, int maxevents, timespec const* timeout, sigset_t const* sigmask)
+{
+    __pthread_maybe_cancel();
+
+    Syscall::SC_epoll_pwait_params params { epfd, events, maxevents, timeout, sigmask };
+    int rc = syscall(SC_epoll_pwait, &params);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+}
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <AK/BinaryHeap.h>
 #include <AK/Singleton.h>
 #include <AK/TemporaryChange.h>
@@ -20,6 +21,13 @@
 #include <sys/select.h>
 #include <unistd.h>
 
+// epoll only reports the fds that are actually ready, instead of making us (and the kernel) walk all of them on every
+// iteration like poll() does. This matters for processes with many notifiers, like servers with lots of clients.
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+#    define EVENT_LOOP_USES_EPOLL
+#    include <sys/epoll.h>
+#endif
+
 namespace Core {
 
 namespace {
@@ -48,6 +56,24 @@ bool has_flag(int value, int flag)
     return (value & flag) == flag;
 }
 
+NotificationType poll_events_to_notification_type(int revents)
+{
+    NotificationType type = NotificationType::None;
+    if (has_flag(revents, POLLIN))
+        type |= NotificationType::Read;
+    if (has_flag(revents, POLLOUT))
+        type |= NotificationType::Write;
+    if (has_flag(revents, POLLHUP))
+        type |= NotificationType::Read | NotificationType::HangUp;
+    if (has_flag(revents, POLLERR))
+        type |= NotificationType::Error;
+    return type;
+}
+
+#ifdef EVENT_LOOP_USES_EPOLL
+static_assert(EPOLLIN == POLLIN && EPOLLOUT == POLLOUT && EPOLLHUP == POLLHUP && EPOLLERR == POLLERR);
+#endif
+
 class EventLoopTimeout {
 public:
     static constexpr ssize_t INVALID_INDEX = NumericLimits<ssize_t>::max();
@@ -255,6 +281,9 @@ struct ThreadData {
     ThreadData()
     {
         pid = getpid();
+#ifdef EVENT_LOOP_USES_EPOLL
+        initialize_epoll();
+#endif
         initialize_wake_pipe();
     }
 
@@ -263,7 +292,28 @@ struct ThreadData {
         pthread_rwlock_wrlock(&*s_thread_data_lock);
         s_thread_data.remove(s_thread_id);
         pthread_rwlock_unlock(&*s_thread_data_lock);
+#ifdef EVENT_LOOP_USES_EPOLL
+        if (epoll_fd != -1)
+            close(epoll_fd);
+#endif
+    }
+
+#ifdef EVENT_LOOP_USES_EPOLL
+    void initialize_epoll()
+    {
+        if (epoll_fd != -1)
+            close(epoll_fd);
+        notifiers_by_fd.clear();
+        always_ready_fd_count = 0;
+
+        auto result = Core::System::epoll_create1(EPOLL_CLOEXEC);
+        if (result.is_error()) {
+            warnln("\033[31;1mFailed to create event loop epoll instance:\033[0m {}", result.error());
+            VERIFY_NOT_REACHED();
+        }
+        epoll_fd = result.release_value();
     }
+#endif
 
     void initialize_wake_pipe()
     {
@@ -281,17 +331,99 @@ struct ThreadData {
         wake_pipe_fds = result.release_value();
 
         // The wake pipe informs us of POSIX signals as well as manual calls to wake()
+#ifdef EVENT_LOOP_USES_EPOLL
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = wake_pipe_fds[0];
+        MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_pipe_fds[0], &event));
+#else
         VERIFY(poll_fds.size() == 0);
         poll_fds.append({ .fd = wake_pipe_fds[0], .events = POLLIN, .revents = 0 });
         notifier_by_index.append(nullptr);
+#endif
     }
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    // epoll only allows a single registration per fd, so all notifiers on the same fd share one,
+    // which is interested in the union of their events.
+    struct FdNotifiers {
+        Vector<Notifier*, 1> notifiers;
+        u32 registered_events { 0 };
+        // Set for fds that epoll refuses to watch (regular files on Linux), which poll() would always report as ready.
+        bool is_always_ready { false };
+    };
+
+    void add_notifier(Notifier& notifier)
+    {
+        auto& fd_notifiers = notifiers_by_fd.ensure(notifier.fd());
+        bool is_new_fd = fd_notifiers.notifiers.is_empty();
+        fd_notifiers.notifiers.append(&notifier);
+        update_epoll_registration(notifier.fd(), fd_notifiers, is_new_fd);
+    }
+
+    void remove_notifier(Notifier& notifier)
+    {
+        auto it = notifiers_by_fd.find(notifier.fd());
+        VERIFY(it != notifiers_by_fd.end());
+        auto& fd_notifiers = it->value;
+        fd_notifiers.notifiers.remove_first_matching([&](auto* other) { return other == &notifier; });
+        if (!fd_notifiers.notifiers.is_empty()) {
+            update_epoll_registration(it->key, fd_notifiers, false);
+            return;
+        }
+
+        if (fd_notifiers.is_always_ready) {
+            --always_ready_fd_count;
+        } else {
+            // NOTE: This fails if the fd has already been closed, which is fine.
+            (void)Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->key, nullptr);
+        }
+        notifiers_by_fd.remove(it);
+    }
+
+    void update_epoll_registration(int fd, FdNotifiers& fd_notifiers, bool is_new_fd)
+    {
+        u32 events = 0;
+        for (auto* notifier : fd_notifiers.notifiers)
+            events |= notification_type_to_poll_events(notifier->type());
+        if (!is_new_fd && events == fd_notifiers.registered_events)
+            return;
+        fd_notifiers.registered_events = events;
+        if (fd_notifiers.is_always_ready)
+            return;
+
+        epoll_event event {};
+        event.events = events;
+        event.data.fd = fd;
+        auto result = Core::System::epoll_ctl(epoll_fd, is_new_fd ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event);
+        // If the fd has been closed and its number reused since we registered it, the old registration is gone.
+        if (result.is_error() && !is_new_fd && result.error().code() == ENOENT)
+            result = Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+        if (!result.is_error())
+            return;
+
+        if (result.error().code() == EPERM) {
+            fd_notifiers.is_always_ready = true;
+            ++always_ready_fd_count;
+            return;
+        }
+        dbgln("EventLoopImplementationUnix: Failed to watch fd {}: {}", fd, result.error());
+    }
+#endif
+
     // Each thread has its own timers, notifiers and a wake pipe.
     TimeoutSet timeouts;
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    int epoll_fd { -1 };
+    HashMap<int, FdNotifiers> notifiers_by_fd;
+    size_t always_ready_fd_count { 0 };
+    Array<epoll_event, 64> epoll_events;
+#else
     Vector<pollfd> poll_fds;
     HashMap<Notifier*, size_t> notifier_by_ptr;
     Vector<Notifier*> notifier_by_index;
+#endif
 
     // The wake pipe is used to notify another event loop that someone has called wake(), or a signal has been received.
     // wake() writes 0i32 into the pipe, signals write the signal number (guaranteed non-zero).
@@ -381,9 +513,21 @@ retry:
         }
     }
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    // Don't go to sleep while there are fds that are always ready.
+    if (thread_data.always_ready_fd_count > 0) {
+        timeout = 0;
+        should_wait_forever = false;
+    }
+#endif
+
 try_select_again:
     // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
+#ifdef EVENT_LOOP_USES_EPOLL
+    auto error_or_marked_fd_count = System::epoll_wait(thread_data.epoll_fd, thread_data.epoll_events, should_wait_forever ? -1 : timeout);
+#else
     ErrorOr<int> error_or_marked_fd_count = System::poll(thread_data.poll_fds, should_wait_forever ? -1 : timeout);
+#endif
     auto time_after_poll = MonotonicTime::now_coarse();
     // Because POSIX, we might spuriously return from select() with EINTR; just select again.
     if (error_or_marked_fd_count.is_error()) {
@@ -393,9 +537,18 @@ try_select_again:
         VERIFY_NOT_REACHED();
     }
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    auto ready_events = thread_data.epoll_events.span().trim(error_or_marked_fd_count.value());
+    bool woken_by_wake_pipe = any_of(ready_events, [&](auto const& event) {
+        return event.data.fd == thread_data.wake_pipe_fds[0] && has_flag(event.events, EPOLLIN);
+    });
+#else
+    bool woken_by_wake_pipe = has_flag(thread_data.poll_fds[0].revents, POLLIN);
+#endif
+
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (has_flag(thread_data.poll_fds[0].revents, POLLIN)) {
+    if (woken_by_wake_pipe) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -424,28 +577,39 @@ try_select_again:
             goto retry;
     }
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    // Handle file system notifiers by making them normal events.
+    auto post_notifier_activations = [](auto const& fd_notifiers, int revents) {
+        auto ready_type = poll_events_to_notification_type(revents);
+        for (auto* notifier : fd_notifiers.notifiers) {
+            if ((ready_type & notifier->type()) != NotificationType::None)
+                ThreadEventQueue::current().post_event(notifier, Event::Type::NotifierActivation);
+        }
+    };
+    for (auto const& event : ready_events) {
+        if (event.data.fd == thread_data.wake_pipe_fds[0])
+            continue;
+        auto it = thread_data.notifiers_by_fd.find(event.data.fd);
+        if (it != thread_data.notifiers_by_fd.end())
+            post_notifier_activations(it->value, event.events);
+    }
+    if (thread_data.always_ready_fd_count > 0) {
+        for (auto const& it : thread_data.notifiers_by_fd) {
+            if (it.value.is_always_ready)
+                post_notifier_activations(it.value, POLLIN | POLLOUT);
+        }
+    }
+#else
     if (error_or_marked_fd_count.value() != 0) {
         // Handle file system notifiers by making them normal events.
         for (size_t i = 1; i < thread_data.poll_fds.size(); ++i) {
-            auto& revents = thread_data.poll_fds[i].revents;
             auto& notifier = *thread_data.notifier_by_index[i];
-
-            NotificationType type = NotificationType::None;
-            if (has_flag(revents, POLLIN))
-                type |= NotificationType::Read;
-            if (has_flag(revents, POLLOUT))
-                type |= NotificationType::Write;
-            if (has_flag(revents, POLLHUP))
-                type |= NotificationType::Read | NotificationType::HangUp;
-            if (has_flag(revents, POLLERR))
-                type |= NotificationType::Error;
-
-            type &= notifier.type();
-
+            auto type = poll_events_to_notification_type(thread_data.poll_fds[i].revents) & notifier.type();
             if (type != NotificationType::None)
                 ThreadEventQueue::current().post_event(&notifier, Event::Type::NotifierActivation);
         }
     }
+#endif
 
     // Handle expired timers.
     thread_data.timeouts.fire_expired(time_after_poll);
@@ -522,9 +686,14 @@ void EventLoopImplementationUnix::notify_forked_and_in_child()
 {
     auto& thread_data = ThreadData::the();
     thread_data.timeouts.clear();
+#ifdef EVENT_LOOP_USES_EPOLL
+    // The epoll instance is shared with our parent, so we need our own one.
+    thread_data.initialize_epoll();
+#else
     thread_data.poll_fds.clear();
     thread_data.notifier_by_ptr.clear();
     thread_data.notifier_by_index.clear();
+#endif
     thread_data.initialize_wake_pipe();
     if (auto* info = signals_info<false>()) {
         info->signal_handlers.clear();
@@ -680,6 +849,9 @@ void EventLoopManagerUnix::register_notifier(Notifier& notifier)
 {
     auto& thread_data = ThreadData::the();
 
+#ifdef EVENT_LOOP_USES_EPOLL
+    thread_data.add_notifier(notifier);
+#else
     thread_data.notifier_by_ptr.set(&notifier, thread_data.poll_fds.size());
     thread_data.notifier_by_index.append(&notifier);
     thread_data.poll_fds.append({
@@ -687,6 +859,7 @@ void EventLoopManagerUnix::register_notifier(Notifier& notifier)
         .events = notification_type_to_poll_events(notifier.type()),
         .revents = 0,
     });
+#endif
 
     notifier.set_owner_thread(s_thread_id);
 }
@@ -698,6 +871,9 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
         return;
 
     auto& thread_data = *thread_data_ptr;
+#ifdef EVENT_LOOP_USES_EPOLL
+    thread_data.remove_notifier(notifier);
+#else
     auto it = thread_data.notifier_by_ptr.find(&notifier);
     VERIFY(it != thread_data.notifier_by_ptr.end());
 
@@ -711,6 +887,7 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
     }
     thread_data.poll_fds.take_last();
     thread_data.notifier_by_index.take_last();
+#endif
 }
 
 void EventLoopManagerUnix::did_post_event()
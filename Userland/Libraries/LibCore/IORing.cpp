@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/NumericLimits.h>
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+namespace Core {
+
+ErrorOr<NonnullOwnPtr<IORing>> IORing::create(u32 entries)
+{
+    auto fd = TRY(System::io_ring_create(entries, O_CLOEXEC));
+    auto size = round_up_to_power_of_two(IORingLayout::size(entries), PAGE_SIZE);
+    auto data_or_error = System::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data_or_error.is_error()) {
+        (void)System::close(fd);
+        return data_or_error.release_error();
+    }
+    return adopt_nonnull_own_or_enomem(new (nothrow) IORing(fd, data_or_error.release_value(), size));
+}
+
+IORing::IORing(int fd, void* data, size_t size)
+    : m_fd(fd)
+    , m_data(data)
+    , m_size(size)
+    , m_header(*static_cast<IORingHeader*>(data))
+{
+    auto* bytes = static_cast<u8*>(data);
+    m_submissions = reinterpret_cast<IORingSubmission*>(bytes + IORingLayout::submissions_offset());
+    m_completions = reinterpret_cast<IORingCompletion const*>(bytes + IORingLayout::completions_offset(m_header.submission_entries));
+}
+
+IORing::~IORing()
+{
+    MUST(System::munmap(m_data, m_size));
+    MUST(System::close(m_fd));
+}
+
+u32 IORing::queued_submissions() const
+{
+    auto head = AK::atomic_load(&m_header.submission_head, AK::memory_order_acquire);
+    return m_header.submission_tail - head;
+}
+
+bool IORing::queue(IORingSubmission const& submission)
+{
+    if (queued_submissions() >= m_header.submission_entries)
+        return false;
+    auto tail = m_header.submission_tail;
+    m_submissions[tail & (m_header.submission_entries - 1)] = submission;
+    AK::atomic_store(&m_header.submission_tail, tail + 1, AK::memory_order_release);
+    return true;
+}
+
+bool IORing::queue_nop(u64 user_data)
+{
+    return queue({ .opcode = IORingOpcode::Nop, .user_data = user_data });
+}
+
+bool IORing::queue_read(int fd, Bytes buffer, u64 offset, u64 user_data)
+{
+    VERIFY(buffer.size() <= NumericLimits<u32>::max());
+    return queue({
+        .opcode = IORingOpcode::Read,
+        .fd = fd,
+        .offset = offset,
+        .address = reinterpret_cast<FlatPtr>(buffer.data()),
+        .length = static_cast<u32>(buffer.size()),
+        .user_data = user_data,
+    });
+}
+
+bool IORing::queue_write(int fd, ReadonlyBytes buffer, u64 offset, u64 user_data)
+{
+    VERIFY(buffer.size() <= NumericLimits<u32>::max());
+    return queue({
+        .opcode = IORingOpcode::Write,
+        .fd = fd,
+        .offset = offset,
+        .address = reinterpret_cast<FlatPtr>(buffer.data()),
+        .length = static_cast<u32>(buffer.size()),
+        .user_data = user_data,
+    });
+}
+
+bool IORing::queue_fsync(int fd, u64 user_data)
+{
+    return queue({ .opcode = IORingOpcode::Fsync, .fd = fd, .user_data = user_data });
+}
+
+bool IORing::queue_accept(int fd, sockaddr* address, socklen_t* address_length, int flags, u64 user_data)
+{
+    return queue({
+        .opcode = IORingOpcode::Accept,
+        .fd = fd,
+        .address = reinterpret_cast<FlatPtr>(address),
+        .flags = static_cast<u32>(flags),
+        .address_length = reinterpret_cast<FlatPtr>(address_length),
+        .user_data = user_data,
+    });
+}
+
+bool IORing::queue_connect(int fd, sockaddr const* address, socklen_t address_length, u64 user_data)
+{
+    return queue({
+        .opcode = IORingOpcode::Connect,
+        .fd = fd,
+        .address = reinterpret_cast<FlatPtr>(address),
+        .length = static_cast<u32>(address_length),
+        .user_data = user_data,
+    });
+}
+
+ErrorOr<u32> IORing::submit(u32 min_complete)
+{
+    return System::io_ring_enter(m_fd, queued_submissions(), min_complete);
+}
+
+u32 IORing::available_completions() const
+{
+    auto tail = AK::atomic_load(&m_header.completion_tail, AK::memory_order_acquire);
+    return tail - m_header.completion_head;
+}
+
+Optional<IORingCompletion> IORing::pop_completion()
+{
+    if (available_completions() == 0)
+        return {};
+    auto head = m_header.completion_head;
+    auto completion = m_completions[head & (m_header.completion_entries - 1)];
+    // The kernel may reuse the entry as soon as it sees the new head, so the completion has to be copied out first.
+    AK::atomic_store(&m_header.completion_head, head + 1, AK::memory_order_release);
+    return completion;
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <Kernel/API/IORing.h>
+#include <sys/socket.h>
+
+namespace Core {
+
+// A process-side view of an I/O ring, see io_ring_create(2).
+// Operations are queued with the queue_*() functions, and handed to the kernel with submit(). Their results can be
+// collected with pop_completion() once they are done, in whatever order they completed in.
+class IORing {
+    AK_MAKE_NONCOPYABLE(IORing);
+    AK_MAKE_NONMOVABLE(IORing);
+
+public:
+    static ErrorOr<NonnullOwnPtr<IORing>> create(u32 entries);
+    ~IORing();
+
+    int fd() const { return m_fd; }
+    u32 submission_entries() const { return m_header.submission_entries; }
+
+    // These return false if the submission queue is full, in which case submit() has to be called first.
+    // A submission can't describe more than NumericLimits<u32>::max() bytes, so larger buffers have to be split up.
+    bool queue(IORingSubmission const&);
+    bool queue_nop(u64 user_data);
+    bool queue_read(int fd, Bytes, u64 offset, u64 user_data);
+    bool queue_write(int fd, ReadonlyBytes, u64 offset, u64 user_data);
+    bool queue_fsync(int fd, u64 user_data);
+    bool queue_accept(int fd, sockaddr* address, socklen_t* address_length, int flags, u64 user_data);
+    bool queue_connect(int fd, sockaddr const* address, socklen_t address_length, u64 user_data);
+
+    // Hands all queued submissions to the kernel, and waits until at least `min_complete` completions can be popped,
+    // or until there is nothing left to wait for. Returns the number of submissions the kernel took.
+    ErrorOr<u32> submit(u32 min_complete = 0);
+
+    u32 queued_submissions() const;
+    u32 available_completions() const;
+    Optional<IORingCompletion> pop_completion();
+
+private:
+    IORing(int fd, void* data, size_t size);
+
+    int m_fd { -1 };
+    void* m_data { nullptr };
+    size_t m_size { 0 };
+
+    IORingHeader& m_header;
+    IORingSubmission* m_submissions { nullptr };
+    IORingCompletion const* m_completions { nullptr };
+};
+
+}
@@ -38,6 +38,10 @@
 #    include <sys/sysmacros.h>
 #endif
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+#    include <sys/sendfile.h>
+#endif
+
 #if defined(AK_OS_LINUX) && !defined(MFD_CLOEXEC)
 #    include <linux/memfd.h>
 #    include <sys/syscall.h>
@@ -412,6 +416,22 @@ ErrorOr<void> profiling_free_buffer(pid_t pid)
     int rc = ::profiling_free_buffer(pid);
     HANDLE_SYSCALL_RETURN_VALUE("profiling_free_buffer", rc, {});
 }
+
+ErrorOr<int> io_ring_create(u32 entries, int flags)
+{
+    int fd = ::io_ring_create(entries, flags);
+    if (fd < 0)
+        return Error::from_syscall("io_ring_create"sv, -errno);
+    return fd;
+}
+
+ErrorOr<u32> io_ring_enter(int fd, u32 to_submit, u32 min_complete)
+{
+    int rc = ::io_ring_enter(fd, to_submit, min_complete);
+    if (rc < 0)
+        return Error::from_syscall("io_ring_enter"sv, -errno);
+    return static_cast<u32>(rc);
+}
 #endif
 
 #if !defined(AK_OS_BSD_GENERIC)
@@ -1816,6 +1836,47 @@ ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length)
 }
 #endif
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    auto rc = ::sendfile(out_fd, in_fd, offset, count);
+    if (rc < 0)
+        return Error::from_syscall("sendfile"sv, -errno);
+    return static_cast<size_t>(rc);
+}
+
+ErrorOr<size_t> splice(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t length, unsigned flags)
+{
+    auto rc = ::splice(fd_in, off_in, fd_out, off_out, length, flags);
+    if (rc < 0)
+        return Error::from_syscall("splice"sv, -errno);
+    return static_cast<size_t>(rc);
+}
+
+ErrorOr<int> epoll_create1(int flags)
+{
+    auto fd = ::epoll_create1(flags);
+    if (fd < 0)
+        return Error::from_syscall("epoll_create1"sv, -errno);
+    return fd;
+}
+
+ErrorOr<void> epoll_ctl(int epfd, int op, int fd, struct epoll_event* event)
+{
+    if (::epoll_ctl(epfd, op, fd, event) < 0)
+        return Error::from_syscall("epoll_ctl"sv, -errno);
+    return {};
+}
+
+ErrorOr<size_t> epoll_wait(int epfd, Span<struct epoll_event> events, int timeout)
+{
+    auto rc = ::epoll_wait(epfd, events.data(), static_cast<int>(min(events.size(), static_cast<size_t>(NumericLimits<int>::max()))), timeout);
+    if (rc < 0)
+        return Error::from_syscall("epoll_wait"sv, -errno);
+    return static_cast<size_t>(rc);
+}
+#endif
+
 // This constant is copied from LibFileSystem. We cannot use or even include it directly,
 // because that would cause a dependency of LibCore on LibFileSystem, effectively rendering
 // the distinction between these libraries moot.
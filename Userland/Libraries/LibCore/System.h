@@ -49,6 +49,10 @@
 #    include <Kernel/API/Unshare.h>
 #endif
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+#    include <sys/epoll.h>
+#endif
+
 namespace Core::System {
 
 #ifdef AK_OS_SERENITY
@@ -73,6 +77,9 @@ ErrorOr<void> disown(pid_t pid);
 ErrorOr<void> profiling_enable(pid_t, u64 event_mask);
 ErrorOr<void> profiling_disable(pid_t);
 ErrorOr<void> profiling_free_buffer(pid_t);
+ErrorOr<int> io_ring_create(u32 entries, int flags);
+// Returns the number of submissions the kernel took off of the submission queue.
+ErrorOr<u32> io_ring_enter(int fd, u32 to_submit, u32 min_complete);
 #else
 inline ErrorOr<void> unveil(StringView, StringView)
 {
@@ -285,6 +292,18 @@ ErrorOr<AddressInfoVector> getaddrinfo(char const* nodename, char const* servnam
 ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length);
 #endif
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+// Copies data between two file descriptors within the kernel, without passing it through a userspace buffer.
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
+// Like sendfile(), but one of the file descriptors has to refer to a pipe.
+ErrorOr<size_t> splice(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t length, unsigned flags = 0);
+
+ErrorOr<int> epoll_create1(int flags);
+ErrorOr<void> epoll_ctl(int epfd, int op, int fd, struct epoll_event* event);
+// Returns the number of entries at the start of `events` that were filled in.
+ErrorOr<size_t> epoll_wait(int epfd, Span<struct epoll_event> events, int timeout);
+#endif
+
 unsigned hardware_concurrency();
 u64 physical_memory_bytes();
 
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/FixedArray.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+
+namespace Threading {
+
+// A Chase-Lev work-stealing deque, following "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al., 2013).
+// The owning thread pushes and takes at the bottom end without taking any locks, any other thread may steal from the top end.
+// T has to be trivially copyable, usually it's a pointer to the actual work item.
+template<typename T>
+requires(IsTriviallyCopyable<T>)
+class WorkStealingDeque {
+    AK_MAKE_NONCOPYABLE(WorkStealingDeque);
+    AK_MAKE_NONMOVABLE(WorkStealingDeque);
+
+public:
+    explicit WorkStealingDeque(size_t initial_capacity = 64)
+    {
+        VERIFY(initial_capacity > 0 && is_power_of_two(initial_capacity));
+        auto buffer = make<Buffer>(initial_capacity);
+        m_buffer.store(buffer.ptr(), AK::MemoryOrder::memory_order_relaxed);
+        m_buffers.append(move(buffer));
+    }
+
+    // Only callable from the owning thread.
+    void push(T value)
+    {
+        auto bottom = m_bottom.load(AK::MemoryOrder::memory_order_relaxed);
+        auto top = m_top.load(AK::MemoryOrder::memory_order_acquire);
+        auto* buffer = m_buffer.load(AK::MemoryOrder::memory_order_relaxed);
+        if (bottom - top > static_cast<i64>(buffer->capacity()) - 1)
+            buffer = grow(*buffer, top, bottom);
+        buffer->put(bottom, value);
+        AK::atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+        m_bottom.store(bottom + 1, AK::MemoryOrder::memory_order_relaxed);
+    }
+
+    // Only callable from the owning thread. Takes the most recently pushed value.
+    Optional<T> take()
+    {
+        auto bottom = m_bottom.load(AK::MemoryOrder::memory_order_relaxed) - 1;
+        auto* buffer = m_buffer.load(AK::MemoryOrder::memory_order_relaxed);
+        m_bottom.store(bottom, AK::MemoryOrder::memory_order_relaxed);
+        AK::atomic_thread_fence(AK::MemoryOrder::memory_order_seq_cst);
+        auto top = m_top.load(AK::MemoryOrder::memory_order_relaxed);
+
+        if (top > bottom) {
+            // The deque was already empty.
+            m_bottom.store(bottom + 1, AK::MemoryOrder::memory_order_relaxed);
+            return {};
+        }
+
+        T value = buffer->get(bottom);
+        if (top == bottom) {
+            // This was the last element, so we're racing against thieves for it.
+            bool won = m_top.compare_exchange_strong(top, top + 1, AK::MemoryOrder::memory_order_seq_cst);
+            m_bottom.store(bottom + 1, AK::MemoryOrder::memory_order_relaxed);
+            if (!won)
+                return {};
+        }
+        return value;
+    }
+
+    enum class StealResult {
+        Success,
+        Empty,
+        // Another thread took the element we were trying to steal, trying again might succeed.
+        Contended,
+    };
+
+    // Callable from any thread. Takes the least recently pushed value.
+    StealResult steal(T& value)
+    {
+        auto top = m_top.load(AK::MemoryOrder::memory_order_acquire);
+        AK::atomic_thread_fence(AK::MemoryOrder::memory_order_seq_cst);
+        auto bottom = m_bottom.load(AK::MemoryOrder::memory_order_acquire);
+        if (top >= bottom)
+            return StealResult::Empty;
+
+        auto* buffer = m_buffer.load(AK::MemoryOrder::memory_order_acquire);
+        T stolen_value = buffer->get(top);
+        if (!m_top.compare_exchange_strong(top, top + 1, AK::MemoryOrder::memory_order_seq_cst))
+            return StealResult::Contended;
+        value = stolen_value;
+        return StealResult::Success;
+    }
+
+    // This is only a snapshot, the deque may be modified concurrently.
+    bool is_empty() const
+    {
+        auto bottom = m_bottom.load(AK::MemoryOrder::memory_order_relaxed);
+        auto top = m_top.load(AK::MemoryOrder::memory_order_relaxed);
+        return top >= bottom;
+    }
+
+private:
+    class Buffer {
+    public:
+        explicit Buffer(size_t capacity)
+            : m_elements(MUST(FixedArray<Atomic<T>>::create(capacity)))
+            , m_mask(capacity - 1)
+        {
+        }
+
+        size_t capacity() const { return m_elements.size(); }
+        T get(i64 index) const { return m_elements[index & m_mask].load(AK::MemoryOrder::memory_order_relaxed); }
+        void put(i64 index, T value) { m_elements[index & m_mask].store(value, AK::MemoryOrder::memory_order_relaxed); }
+
+    private:
+        FixedArray<Atomic<T>> m_elements;
+        size_t m_mask { 0 };
+    };
+
+    Buffer* grow(Buffer const& old_buffer, i64 top, i64 bottom)
+    {
+        auto new_buffer = make<Buffer>(old_buffer.capacity() * 2);
+        for (auto i = top; i < bottom; ++i)
+            new_buffer->put(i, old_buffer.get(i));
+        auto* new_buffer_ptr = new_buffer.ptr();
+        // Thieves may still be reading from the old buffer, so we can only free it once the deque goes away.
+        m_buffers.append(move(new_buffer));
+        m_buffer.store(new_buffer_ptr, AK::MemoryOrder::memory_order_release);
+        return new_buffer_ptr;
+    }
+
+    // Keep the thieves' and the owner's end on separate cache lines.
+    alignas(64) Atomic<i64> m_top { 0 };
+    alignas(64) Atomic<i64> m_bottom { 0 };
+    Atomic<Buffer*> m_buffer { nullptr };
+    Vector<NonnullOwnPtr<Buffer>> m_buffers;
+};
+
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/System.h>
+#include <LibThreading/WorkStealingThreadPool.h>
+#include <sched.h>
+
+namespace Threading {
+
+static thread_local WorkStealingThreadPool const* s_current_pool = nullptr;
+static thread_local size_t s_current_worker_index = 0;
+static thread_local u32 s_steal_seed = 0;
+
+// How often an idle worker looks for work before it goes to sleep.
+static constexpr size_t idle_spin_count = 64;
+
+WorkStealingThreadPool::WorkStealingThreadPool(Optional<size_t> concurrency)
+    : m_work_available(m_mutex)
+    , m_all_work_done(m_mutex)
+{
+    auto worker_count = max(concurrency.value_or(Core::System::hardware_concurrency()), 1uz);
+    for (size_t i = 0; i < worker_count; ++i)
+        m_workers.append(make<Worker>());
+
+    // Only start the workers once all deques exist, as they immediately start stealing from each other.
+    for (size_t i = 0; i < worker_count; ++i) {
+        m_workers[i]->thread = Thread::construct([this, i]() -> intptr_t {
+            worker_loop(i);
+            return 0;
+        },
+            "WorkStealingThreadPool worker"sv);
+        m_workers[i]->thread->start();
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+    {
+        MutexLocker locker(m_mutex);
+        m_should_exit.store(true, AK::MemoryOrder::memory_order_release);
+        m_work_available.broadcast();
+    }
+    for (auto& worker : m_workers)
+        (void)worker->thread->join();
+
+    // Drop whatever was still queued; nobody is going to run it anymore.
+    for (auto& worker : m_workers) {
+        while (true) {
+            auto task = worker->deque.take();
+            if (!task.has_value())
+                break;
+            delete *task;
+        }
+    }
+    m_submitted_tasks.with_locked([](auto& queue) {
+        while (!queue.is_empty())
+            delete queue.dequeue();
+    });
+}
+
+Optional<size_t> WorkStealingThreadPool::current_worker_index() const
+{
+    if (s_current_pool != this)
+        return {};
+    return s_current_worker_index;
+}
+
+void WorkStealingThreadPool::submit(Task task)
+{
+    enqueue(new Task(move(task)), {});
+}
+
+void WorkStealingThreadPool::spawn(Task task)
+{
+    enqueue(new Task(move(task)), current_worker_index());
+}
+
+void WorkStealingThreadPool::enqueue(Task* task, Optional<size_t> worker_index)
+{
+    m_unfinished_task_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    // NOTE: The queued count is bumped before the task becomes visible, so a worker that sees
+    //       the count drop to zero can't miss a task (see worker_loop()).
+    m_queued_task_count.fetch_add(1, AK::MemoryOrder::memory_order_seq_cst);
+
+    if (worker_index.has_value()) {
+        m_workers[*worker_index]->deque.push(task);
+    } else {
+        m_submitted_tasks.with_locked([&](auto& queue) {
+            queue.enqueue(task);
+        });
+    }
+
+    if (m_sleeping_worker_count.load(AK::MemoryOrder::memory_order_seq_cst) > 0)
+        wake_one_worker();
+}
+
+void WorkStealingThreadPool::wake_one_worker()
+{
+    MutexLocker locker(m_mutex);
+    m_work_available.signal();
+}
+
+WorkStealingThreadPool::Task* WorkStealingThreadPool::find_task(Optional<size_t> worker_index)
+{
+    if (worker_index.has_value()) {
+        if (auto task = m_workers[*worker_index]->deque.take(); task.has_value())
+            return *task;
+    }
+
+    auto* submitted_task = m_submitted_tasks.with_locked([](auto& queue) -> Task* {
+        if (queue.is_empty())
+            return nullptr;
+        return queue.dequeue();
+    });
+    if (submitted_task)
+        return submitted_task;
+
+    // Start stealing at a pseudo-random victim so thieves don't all pile onto the same worker.
+    if (s_steal_seed == 0)
+        s_steal_seed = static_cast<u32>(reinterpret_cast<FlatPtr>(&s_steal_seed)) | 1;
+    s_steal_seed ^= s_steal_seed << 13;
+    s_steal_seed ^= s_steal_seed >> 17;
+    s_steal_seed ^= s_steal_seed << 5;
+
+    auto worker_count = m_workers.size();
+    auto first_victim = s_steal_seed % worker_count;
+    for (size_t i = 0; i < worker_count; ++i) {
+        auto victim = (first_victim + i) % worker_count;
+        if (worker_index.has_value() && victim == *worker_index)
+            continue;
+        auto& deque = m_workers[victim]->deque;
+        while (true) {
+            Task* task = nullptr;
+            auto result = deque.steal(task);
+            if (result == WorkStealingDeque<Task*>::StealResult::Success)
+                return task;
+            if (result == WorkStealingDeque<Task*>::StealResult::Empty)
+                break;
+        }
+    }
+    return nullptr;
+}
+
+void WorkStealingThreadPool::run_task(Task* task)
+{
+    m_queued_task_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+    (*task)();
+    delete task;
+
+    if (m_unfinished_task_count.fetch_sub(1, AK::MemoryOrder::memory_order_acq_rel) == 1) {
+        MutexLocker locker(m_mutex);
+        m_all_work_done.broadcast();
+    }
+}
+
+bool WorkStealingThreadPool::try_run_one_task(Optional<size_t> worker_index)
+{
+    auto* task = find_task(worker_index);
+    if (!task)
+        return false;
+    run_task(task);
+    return true;
+}
+
+void WorkStealingThreadPool::worker_loop(size_t worker_index)
+{
+    s_current_pool = this;
+    s_current_worker_index = worker_index;
+
+    while (!m_should_exit.load(AK::MemoryOrder::memory_order_acquire)) {
+        bool found_work = false;
+        for (size_t i = 0; i < idle_spin_count; ++i) {
+            if (try_run_one_task(worker_index)) {
+                found_work = true;
+                break;
+            }
+            sched_yield();
+        }
+        if (found_work)
+            continue;
+
+        MutexLocker locker(m_mutex);
+        m_sleeping_worker_count.fetch_add(1, AK::MemoryOrder::memory_order_seq_cst);
+        while (m_queued_task_count.load(AK::MemoryOrder::memory_order_seq_cst) == 0 && !m_should_exit.load(AK::MemoryOrder::memory_order_acquire))
+            m_work_available.wait();
+        m_sleeping_worker_count.fetch_sub(1, AK::MemoryOrder::memory_order_seq_cst);
+    }
+
+    s_current_pool = nullptr;
+}
+
+void WorkStealingThreadPool::wait_for_all()
+{
+    VERIFY(!current_worker_index().has_value());
+
+    MutexLocker locker(m_mutex);
+    m_all_work_done.wait_while([this] {
+        return m_unfinished_task_count.load(AK::MemoryOrder::memory_order_acquire) > 0;
+    });
+}
+
+void WorkStealingThreadPool::help_while(Function<bool()> condition)
+{
+    auto worker_index = current_worker_index();
+    while (condition()) {
+        if (!try_run_one_task(worker_index))
+            sched_yield();
+    }
+}
+
+void WorkStealingThreadPool::parallel_for(size_t begin, size_t end, Function<void(size_t, size_t)> const& body, size_t grain_size)
+{
+    if (begin >= end)
+        return;
+
+    // By default, aim for a few chunks per worker so that stealing can even out uneven chunks.
+    if (grain_size == 0)
+        grain_size = max((end - begin) / (8 * m_workers.size()), 1uz);
+
+    Atomic<size_t> pending_chunks { 0 };
+    Function<void(size_t, size_t)> split = [&](size_t chunk_begin, size_t chunk_end) {
+        // Keep the lower half for ourselves and hand out the upper half, so the largest
+        // pieces of work end up at the top of our deque, where thieves take from.
+        while (chunk_end - chunk_begin > grain_size) {
+            auto middle = chunk_begin + (chunk_end - chunk_begin) / 2;
+            pending_chunks.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            spawn([&split, &pending_chunks, middle, chunk_end] {
+                split(middle, chunk_end);
+                pending_chunks.fetch_sub(1, AK::MemoryOrder::memory_order_release);
+            });
+            chunk_end = middle;
+        }
+        body(chunk_begin, chunk_end);
+    };
+
+    split(begin, end);
+    help_while([&] {
+        return pending_chunks.load(AK::MemoryOrder::memory_order_acquire) > 0;
+    });
+}
+
+}
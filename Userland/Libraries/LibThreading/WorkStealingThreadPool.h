@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Queue.h>
+#include <AK/Vector.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/MutexProtected.h>
+#include <LibThreading/Thread.h>
+#include <LibThreading/WorkStealingDeque.h>
+
+namespace Threading {
+
+// A thread pool for many small, possibly nested tasks.
+// Unlike ThreadPool, every worker has its own lock-free deque: tasks spawned from within a task stay on the
+// spawning worker (and are run most-recent-first, which is cache friendly), while idle workers steal the oldest
+// tasks from busy ones. Only tasks submitted from outside of the pool go through a shared, mutex-protected queue.
+class WorkStealingThreadPool {
+    AK_MAKE_NONCOPYABLE(WorkStealingThreadPool);
+    AK_MAKE_NONMOVABLE(WorkStealingThreadPool);
+
+public:
+    using Task = Function<void()>;
+
+    explicit WorkStealingThreadPool(Optional<size_t> concurrency = {});
+    ~WorkStealingThreadPool();
+
+    size_t worker_count() const { return m_workers.size(); }
+
+    // Queue a task from any thread. It will be picked up in submission order relative to other submitted tasks.
+    void submit(Task);
+
+    // Queue a task from within a task running on this pool; it goes onto the current worker's own deque.
+    // When called from any other thread, this behaves like submit().
+    void spawn(Task);
+
+    // Blocks until every submitted and spawned task has finished.
+    // Must not be called from within a task, use parallel_for() or a counter and help_while() there instead.
+    void wait_for_all();
+
+    // Runs tasks from the pool on the calling thread while `condition` returns true.
+    // This is how a task waits for tasks it spawned without tying up its worker.
+    void help_while(Function<bool()> condition);
+
+    // Calls `body` with disjoint subranges of [begin, end) of at most `grain_size` elements, in parallel,
+    // and returns once all of them have been processed. The range is split recursively, so idle workers
+    // steal large chunks first. May be called from outside the pool as well as from within a task.
+    void parallel_for(size_t begin, size_t end, Function<void(size_t chunk_begin, size_t chunk_end)> const& body, size_t grain_size = 0);
+
+    // Returns the index of the worker the calling thread is, if it's one of ours.
+    Optional<size_t> current_worker_index() const;
+
+private:
+    struct Worker {
+        RefPtr<Thread> thread;
+        WorkStealingDeque<Task*> deque;
+    };
+
+    void enqueue(Task*, Optional<size_t> worker_index);
+    Task* find_task(Optional<size_t> worker_index);
+    bool try_run_one_task(Optional<size_t> worker_index);
+    void run_task(Task*);
+    void worker_loop(size_t worker_index);
+    void wake_one_worker();
+
+    Vector<NonnullOwnPtr<Worker>> m_workers;
+    MutexProtected<Queue<Task*>> m_submitted_tasks;
+
+    // Tasks that have been queued but not started yet, workers only go to sleep when this is 0.
+    Atomic<size_t> m_queued_task_count { 0 };
+    // Tasks that have been queued but not finished yet.
+    Atomic<size_t> m_unfinished_task_count { 0 };
+    Atomic<size_t> m_sleeping_worker_count { 0 };
+
+    Mutex m_mutex;
+    ConditionVariable m_work_available;
+    ConditionVariable m_all_work_done;
+    Atomic<bool> m_should_exit { false };
+};
+
+}
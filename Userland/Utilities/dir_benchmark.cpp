@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteString.h>
+#include <AK/ScopeGuard.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct Result {
+    u64 create_ns_per_entry {};
+    u64 lookup_ns_per_entry {};
+    u64 miss_ns_per_entry {};
+    u64 unlink_ns_per_entry {};
+};
+
+static ErrorOr<Result> benchmark(ByteString const& directory, size_t entry_count, size_t lookup_rounds);
+
+static u64 nanoseconds_per_entry(Core::ElapsedTimer const& timer, size_t entry_count)
+{
+    return timer.elapsed_time().to_nanoseconds() / entry_count;
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    ByteString directory = ".";
+    Vector<size_t> entry_counts;
+    size_t lookup_rounds = 4;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Measure how the cost of creating, looking up and removing directory entries grows with the size of the directory.");
+    args_parser.add_option(directory, "Path to a directory where we can create the benchmark directories", "directory", 'd', "directory");
+    args_parser.add_option(entry_counts, "A comma-separated list of directory sizes", "entries", 'n', "entries");
+    args_parser.add_option(lookup_rounds, "How many times every entry is looked up", "lookup-rounds", 'r', "lookup-rounds");
+    args_parser.parse(arguments);
+
+    if (entry_counts.is_empty())
+        entry_counts = { 100, 1000, 5000, 10000, 20000 };
+    if (lookup_rounds == 0)
+        lookup_rounds = 1;
+
+    outln("{:>8} {:>12} {:>12} {:>12} {:>12}", "entries", "create ns", "lookup ns", "miss ns", "unlink ns");
+    for (auto entry_count : entry_counts) {
+        if (entry_count == 0)
+            continue;
+        auto result = TRY(benchmark(ByteString::formatted("{}/dir_benchmark.tmp", directory), entry_count, lookup_rounds));
+        outln("{:>8} {:>12} {:>12} {:>12} {:>12}", entry_count, result.create_ns_per_entry, result.lookup_ns_per_entry, result.miss_ns_per_entry, result.unlink_ns_per_entry);
+    }
+
+    return 0;
+}
+
+ErrorOr<Result> benchmark(ByteString const& directory, size_t entry_count, size_t lookup_rounds)
+{
+    TRY(Core::System::mkdir(directory, 0700));
+
+    Vector<ByteString> paths;
+    Vector<ByteString> missing_paths;
+    TRY(paths.try_ensure_capacity(entry_count));
+    TRY(missing_paths.try_ensure_capacity(entry_count));
+    for (size_t i = 0; i < entry_count; ++i) {
+        paths.unchecked_append(ByteString::formatted("{}/entry-{:08}", directory, i));
+        missing_paths.unchecked_append(ByteString::formatted("{}/missing-{:08}", directory, i));
+    }
+
+    size_t created_count = 0;
+    auto directory_cleanup = ScopeGuard([&] {
+        for (size_t i = 0; i < created_count; ++i)
+            (void)Core::System::unlink(paths[i]);
+        auto void_or_error = Core::System::rmdir(directory);
+        if (void_or_error.is_error())
+            warnln("{}", void_or_error.release_error());
+    });
+
+    Result result;
+
+    auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+    for (auto const& path : paths) {
+        auto fd = TRY(Core::System::open(path, O_CREAT | O_EXCL | O_WRONLY, 0600));
+        TRY(Core::System::close(fd));
+        ++created_count;
+    }
+    result.create_ns_per_entry = nanoseconds_per_entry(timer, entry_count);
+
+    timer.start();
+    for (size_t round = 0; round < lookup_rounds; ++round) {
+        for (auto const& path : paths)
+            (void)TRY(Core::System::stat(path));
+    }
+    result.lookup_ns_per_entry = nanoseconds_per_entry(timer, entry_count * lookup_rounds);
+
+    // Names that don't exist can't be answered by finding them early in the directory.
+    timer.start();
+    for (auto const& path : missing_paths) {
+        auto stat_or_error = Core::System::stat(path);
+        if (!stat_or_error.is_error())
+            return Error::from_errno(EEXIST);
+        if (stat_or_error.error().code() != ENOENT)
+            return stat_or_error.release_error();
+    }
+    result.miss_ns_per_entry = nanoseconds_per_entry(timer, entry_count);
+
+    timer.start();
+    for (; created_count > 0; --created_count)
+        TRY(Core::System::unlink(paths[created_count - 1]));
+    result.unlink_ns_per_entry = nanoseconds_per_entry(timer, entry_count);
+
+    return result;
+}
@@ -45,6 +45,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     u64 physical_uncommitted = json.get_u64("physical_uncommitted"sv).value_or(0);
     u32 kmalloc_call_count = json.get_u32("kmalloc_call_count"sv).value_or(0);
     u32 kfree_call_count = json.get_u32("kfree_call_count"sv).value_or(0);
+    u64 huge_pages_mapped = json.get_u64("huge_pages_mapped"sv).value_or(0);
+    u64 huge_page_faults = json.get_u64("huge_page_faults"sv).value_or(0);
+    u64 huge_page_fallbacks = json.get_u64("huge_page_fallbacks"sv).value_or(0);
+    u64 huge_page_splits = json.get_u64("huge_page_splits"sv).value_or(0);
 
     u64 kmalloc_bytes_total = kmalloc_allocated + kmalloc_available;
     u64 physical_pages_total = physical_allocated + physical_available;
@@ -66,5 +70,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     outln("Kmalloc call count: {}", kmalloc_call_count);
     outln("Kfree call count: {}", kfree_call_count);
     outln("Kmalloc/Kfree delta: {}", TRY(String::formatted("{:+}", kmalloc_call_count - kfree_call_count)));
+    outln("Huge pages mapped: {}", huge_pages_mapped);
+    outln("Huge page faults: {} ({} fell back to regular pages)", huge_page_faults, huge_page_fallbacks);
+    outln("Huge page splits: {}", huge_page_splits);
     return 0;
 }
@@ -54,6 +54,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 event_mask |= PERF_EVENT_SYSCALL;
             else if (event_type == "filesystem")
                 event_mask |= PERF_EVENT_FILESYSTEM;
+            else if (event_type == "cycles")
+                event_mask |= PERF_EVENT_CYCLES;
+            else if (event_type == "instructions")
+                event_mask |= PERF_EVENT_INSTRUCTIONS;
+            else if (event_type == "cache_misses")
+                event_mask |= PERF_EVENT_CACHE_MISSES;
+            else if (event_type == "branch_misses")
+                event_mask |= PERF_EVENT_BRANCH_MISSES;
             else {
                 warnln("Unknown event type '{}' specified.", event_type);
                 exit(1);
@@ -66,6 +74,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     auto print_types = [] {
         outln();
         outln("Event type can be one of: sample, context_switch, page_fault, syscall, filesystem, kmalloc and kfree.");
+        outln("Hardware counter samples can be taken with: cycles, instructions, cache_misses and branch_misses.");
     };
 
     if (!args_parser.parse(arguments, Core::ArgsParser::FailureBehavior::PrintUsage)) {
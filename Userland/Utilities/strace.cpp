@@ -164,6 +164,7 @@ HANDLE(SIOCGIFNETMASK)
 HANDLE(SIOCSIFNETMASK)
 HANDLE(SIOCGIFBRDADDR)
 HANDLE(SIOCGIFMTU)
+HANDLE(SIOCSIFMTU)
 HANDLE(SIOCGIFFLAGS)
 HANDLE(SIOCGIFCONF)
 HANDLE(SIOCADDRT)